@@ -8,13 +8,18 @@
 #   with existing code
 
 from habitat_sim._ext.habitat_sim_bindings import (
+    Buffer,
+    BufferPool,
     CameraSensor,
     CameraSensorSpec,
     ConfigurationGroup,
+    DataType,
     GreedyFollowerCodes,
     GreedyGeodesicFollowerImpl,
     MultiGoalShortestPath,
     PathFinder,
+    Profiler,
+    ProfilerStats,
     RigidState,
     SceneGraph,
     SceneNode,
@@ -6,6 +6,8 @@ from habitat_sim._ext.habitat_sim_bindings import (
     DEFAULT_LIGHTING_KEY,
     NO_LIGHT_KEY,
     Camera,
+    DepthFormat,
+    DepthProcessing,
     LightInfo,
     LightPositionModel,
     Renderer,
@@ -16,6 +18,8 @@ __all__ = [
     "Camera",
     "Renderer",
     "RenderTarget",
+    "DepthFormat",
+    "DepthProcessing",
     "LightPositionModel",
     "LightInfo",
     "DEFAULT_LIGHTING_KEY",
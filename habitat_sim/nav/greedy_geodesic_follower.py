@@ -4,8 +4,9 @@ import attr
 import numpy as np
 
 from habitat_sim import errors, scene
-from habitat_sim.agent.agent import Agent
+from habitat_sim.agent.agent import Agent, AgentState
 from habitat_sim.agent.controls.controls import ActuationSpec
+from habitat_sim.bindings import RigidState  # type: ignore
 from habitat_sim.nav import (  # type: ignore
     GreedyFollowerCodes,
     GreedyGeodesicFollowerImpl,
@@ -196,6 +197,52 @@ class GreedyGeodesicFollower(object):
 
         return path
 
+    def find_paths(
+        self,
+        start_states: List[AgentState],
+        goal_positions: List[np.ndarray],
+        max_threads: int = 0,
+    ) -> List[Optional[List[Any]]]:
+        r"""Finds the sequences of actions that greedily follow the geodesic
+        shortest path for many (start state, goal) pairs at once
+
+        :param start_states: The agent states to start from
+        :param goal_positions: The goal positions, one per start state
+        :param max_threads: Upper bound on the number of worker threads used
+            for the navmesh queries. :py:`0` uses all hardware threads
+        :return: One list of actions per pair, each ending with :py:`None`,
+            or :py:`None` for pairs where no path was found.
+
+        Every goal's geodesic distance is computed once and reused for the
+        whole trajectory and the navmesh queries of all pairs are batched, so
+        this is much faster than calling :ref:`find_path` for each pair when
+        generating many trajectories. The paths can differ slightly from
+        those of :ref:`find_path`.
+
+        .. note-warning::
+
+            Do not use this method if the agent has actuation noise.
+        """
+        assert len(start_states) == len(
+            goal_positions
+        ), "Need exactly one goal position per start state"
+
+        paths = self.impl.find_paths(
+            [
+                RigidState(quat_to_magnum(state.rotation), state.position)
+                for state in start_states
+            ],
+            goal_positions,
+            max_threads,
+        )
+
+        return [
+            list(map(lambda v: self.action_mapping[v], path))
+            if len(path) > 0
+            else None
+            for path in paths
+        ]
+
     def reset(self) -> None:
         self.impl.reset()
         self.last_goal = None
@@ -5,7 +5,7 @@
 # LICENSE file in the root directory of this source tree.
 
 from os import path as osp
-from typing import Union
+from typing import Optional, Union
 
 import attr
 import numba
@@ -18,6 +18,9 @@ try:
 except ImportError:
     torch = None
 
+from habitat_sim._ext.habitat_sim_bindings import (
+    RedwoodNoiseModelCPUImpl as NativeRedwoodNoiseModelCPUImpl,
+)
 from habitat_sim._ext.habitat_sim_bindings import SensorType
 from habitat_sim.bindings import cuda_enabled
 from habitat_sim.registry import registry
@@ -99,6 +102,11 @@ def _simulate(gt_depth, model, noise_multiplier):
 
 @attr.s(auto_attribs=True)
 class RedwoodNoiseModelCPUImpl:
+    r"""Numba implementation of the noise model. Kept as a reference for
+    :ref:`NativeRedwoodNoiseModelCPUImpl`, which is faster, doesn't hold the GIL
+    and is deterministic for a given seed.
+    """
+
     model: np.ndarray
     noise_multiplier: float
 
@@ -113,6 +121,9 @@ class RedwoodNoiseModelCPUImpl:
 @attr.s(auto_attribs=True, kw_only=True)
 class RedwoodDepthNoiseModel(SensorNoiseModel):
     noise_multiplier: float = 1.0
+    #: Seed of the CPU implementation. Drawn from numpy's global random state
+    #: if :py:`None`
+    seed: Optional[int] = None
 
     def __attrs_post_init__(self) -> None:
         dist = np.load(
@@ -124,7 +135,14 @@ class RedwoodDepthNoiseModel(SensorNoiseModel):
                 dist, self.gpu_device_id, self.noise_multiplier
             )
         else:
-            self._impl = RedwoodNoiseModelCPUImpl(dist, self.noise_multiplier)
+            seed = (
+                np.random.randint(np.iinfo(np.int64).max)
+                if self.seed is None
+                else self.seed
+            )
+            self._impl = NativeRedwoodNoiseModelCPUImpl(
+                dist, self.noise_multiplier, seed
+            )
 
     @staticmethod
     def is_valid_sensor_type(sensor_type: SensorType) -> bool:
@@ -142,7 +160,7 @@ class RedwoodDepthNoiseModel(SensorNoiseModel):
                 )
                 return noisy_depth
         else:
-            return self._impl.simulate(gt_depth)
+            return self._impl.simulate_from_cpu(gt_depth)
 
     def apply(self, gt_depth: Union[ndarray, "Tensor"]) -> Union[ndarray, "Tensor"]:
         r"""Alias of `simulate()` to conform to base-class and expected API"""
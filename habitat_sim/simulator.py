@@ -7,6 +7,7 @@
 import time
 from collections import OrderedDict
 from collections.abc import MutableMapping
+from concurrent.futures import ThreadPoolExecutor
 from os import path as osp
 from typing import Any, Dict, List
 from typing import MutableMapping as MutableMapping_T
@@ -28,13 +29,15 @@ except ImportError:
 
 import habitat_sim.errors
 from habitat_sim.agent.agent import Agent, AgentConfiguration, AgentState
-from habitat_sim.bindings import cuda_enabled
+from habitat_sim.bindings import BufferPool, DataType, cuda_enabled
+from habitat_sim.gfx import DepthFormat
 from habitat_sim.logging import logger
 from habitat_sim.metadata import MetadataMediator
 from habitat_sim.nav import GreedyGeodesicFollower, NavMeshSettings, PathFinder
-from habitat_sim.sensor import SensorSpec, SensorType
+from habitat_sim.sensor import CameraSensor, SensorSpec, SensorType
 from habitat_sim.sensors.noise_models import make_sensor_noise_model
 from habitat_sim.sim import SimulatorBackend, SimulatorConfiguration
+from habitat_sim.utils import profiling_utils
 from habitat_sim.utils.common import quat_from_angle_axis
 
 # TODO maybe clean up types with TypeVars
@@ -78,6 +81,8 @@ class Simulator(SimulatorBackend):
         default=0.0, init=False
     )  # track the compute time of each step
     __last_state: Dict[int, AgentState] = attr.ib(factory=dict, init=False)
+    # copies mapped sensor readbacks into their buffers off the main thread
+    __readback_pool: Optional[ThreadPoolExecutor] = attr.ib(default=None, init=False)
 
     @staticmethod
     def _sanitize_config(config: Configuration) -> None:
@@ -125,6 +130,10 @@ class Simulator(SimulatorBackend):
 
         self.__sensors = []
 
+        if self.__readback_pool is not None:
+            self.__readback_pool.shutdown()
+            self.__readback_pool = None
+
         for agent in self.agents:
             agent.close()
             del agent
@@ -328,6 +337,7 @@ class Simulator(SimulatorBackend):
     ) -> Dict[int, Dict[str, Union[ndarray, "Tensor"]]]:
         ...
 
+    @profiling_utils.NativeRangeContext("Simulator.get_sensor_observations")
     def get_sensor_observations(
         self, agent_ids: Union[int, List[int]] = 0
     ) -> Union[
@@ -340,22 +350,66 @@ class Simulator(SimulatorBackend):
         else:
             return_single = False
 
+        # Draw every sensor and start its readback before waiting on any of
+        # them, so the GPU renders the next sensor while the previous one is
+        # transferred
+        pending: List["Sensor"] = []
         for agent_id in agent_ids:
             agent_sensorsuite = self.__sensors[agent_id]
+            self.__draw_observations(agent_id)
             for _sensor_uuid, sensor in agent_sensorsuite.items():
-                sensor.draw_observation()
+                if sensor._read_observation_async():
+                    pending.append(sensor)
+
+        # Map each finished readback on this (the GL) thread and copy it out
+        # on a worker thread while the next one is mapped
+        if len(pending) > 1:
+            if self.__readback_pool is None:
+                self.__readback_pool = ThreadPoolExecutor()
+            copies = []
+            for sensor in pending:
+                sensor._map_observation()
+                copies.append(
+                    self.__readback_pool.submit(sensor._copy_mapped_observation)
+                )
+            for copy in copies:
+                copy.result()
+        else:
+            for sensor in pending:
+                sensor._map_observation()
+                sensor._copy_mapped_observation()
 
         # As backport. All Dicts are ordered in Python >= 3.7
         observations: Dict[int, Dict[str, Union[ndarray, "Tensor"]]] = OrderedDict()
-        for agent_id in agent_ids:
-            agent_observations: Dict[str, Union[ndarray, "Tensor"]] = {}
-            for sensor_uuid, sensor in self.__sensors[agent_id].items():
-                agent_observations[sensor_uuid] = sensor.get_observation()
-            observations[agent_id] = agent_observations
+        with profiling_utils.NativeRangeContext("Simulator.convert_observations"):
+            for agent_id in agent_ids:
+                agent_observations: Dict[str, Union[ndarray, "Tensor"]] = {}
+                for sensor_uuid, sensor in self.__sensors[agent_id].items():
+                    if sensor in pending:
+                        agent_observations[sensor_uuid] = sensor._unmap_observation()
+                    else:
+                        agent_observations[sensor_uuid] = sensor.get_observation()
+                observations[agent_id] = agent_observations
         if return_single:
             return next(iter(observations.values()))
         return observations
 
+    def __draw_observations(self, agent_id: int) -> None:
+        r"""Draws all sensors of an agent, culling the scene once for camera
+        sensors that share a pose and projection, see
+        :ref:`CameraSensor.draw_observations`. Equivalent to calling
+        :ref:`Sensor.draw_observation` on each of them.
+        """
+        camera_sensors = []
+        for sensor in self.__sensors[agent_id].values():
+            if isinstance(sensor._sensor_object, CameraSensor):
+                sensor._check_drawable()
+                camera_sensors.append(sensor._sensor_object)
+            else:
+                sensor.draw_observation()
+        if camera_sensors:
+            CameraSensor.draw_observations(self, camera_sensors)
+
     @property
     def _default_agent(self) -> Agent:
         # TODO Deprecate and remove
@@ -393,6 +447,7 @@ class Simulator(SimulatorBackend):
     ) -> Dict[int, Dict[str, Union[bool, ndarray, "Tensor"]]]:
         ...
 
+    @profiling_utils.NativeRangeContext("Simulator.step")
     def step(
         self,
         action: Union[str, int, MutableMapping_T[int, Union[str, int]]],
@@ -473,6 +528,19 @@ class Simulator(SimulatorBackend):
         self.step_world(dt)
 
 
+# Observation memory of depth sensors for each DepthProcessing.format
+_DEPTH_DATA_TYPES = {
+    DepthFormat.FLOAT: DataType.FLOAT,
+    DepthFormat.HALF: DataType.FLOAT16,
+    DepthFormat.UNSIGNED_SHORT: DataType.UINT16,
+}
+_DEPTH_PIXEL_FORMATS = {
+    DepthFormat.FLOAT: mn.PixelFormat.R32F,
+    DepthFormat.HALF: mn.PixelFormat.R16F,
+    DepthFormat.UNSIGNED_SHORT: mn.PixelFormat.R16UI,
+}
+
+
 class Sensor:
     r"""Wrapper around habitat_sim.Sensor
 
@@ -511,25 +579,21 @@ class Sensor:
                     resolution[0], resolution[1], 4, dtype=torch.uint8, device=device
                 )
         else:
+            resolution = self._spec.resolution
             if self._spec.sensor_type == SensorType.SEMANTIC:
-                self._buffer = np.empty(
-                    (self._spec.resolution[0], self._spec.resolution[1]),
-                    dtype=np.uint32,
-                )
+                shape = [resolution[0], resolution[1]]
+                data_type = DataType.UINT32
             elif self._spec.sensor_type == SensorType.DEPTH:
-                self._buffer = np.empty(
-                    (self._spec.resolution[0], self._spec.resolution[1]),
-                    dtype=np.float32,
-                )
+                shape = [resolution[0], resolution[1]]
+                data_type = _DEPTH_DATA_TYPES[self._spec.depth_processing.format]
             else:
-                self._buffer = np.empty(
-                    (
-                        self._spec.resolution[0],
-                        self._spec.resolution[1],
-                        self._spec.channels,
-                    ),
-                    dtype=np.uint8,
-                )
+                shape = [resolution[0], resolution[1], self._spec.channels]
+                data_type = DataType.UINT8
+            # Every frame is read into a buffer of the pool that no earlier
+            # observation still views, so observations stay valid while they
+            # are held and are never copied
+            self._buffer_pool = BufferPool(shape, data_type)
+            self._acquire_buffer()
 
         noise_model_kwargs = self._spec.noise_model_kwargs
         self._noise_model = make_sensor_noise_model(
@@ -542,9 +606,7 @@ class Sensor:
             self._spec.noise_model, self._spec.uuid
         )
 
-    def draw_observation(self) -> None:
-        # sanity check:
-
+    def _check_drawable(self) -> None:
         # see if the sensor is attached to a scene graph, otherwise it is invalid,
         # and cannot make any observation
         if not self._sensor_object.object:
@@ -553,12 +615,20 @@ class Sensor:
                  (has it been detached from a scene node?)"
             )
 
+        if (
+            self._spec.sensor_type == SensorType.SEMANTIC
+            and self._sim.semantic_scene is None
+        ):
+            raise RuntimeError(
+                "SemanticSensor observation requested but no SemanticScene is loaded"
+            )
+
+    def draw_observation(self) -> None:
+        # sanity check:
+        self._check_drawable()
+
         # get the correct scene graph based on application
         if self._spec.sensor_type == SensorType.SEMANTIC:
-            if self._sim.semantic_scene is None:
-                raise RuntimeError(
-                    "SemanticSensor observation requested but no SemanticScene is loaded"
-                )
             scene = self._sim.get_active_semantic_scene_graph()
         else:  # SensorType is DEPTH or any other type
             scene = self._sim.get_active_scene_graph()
@@ -593,6 +663,59 @@ class Sensor:
                 self._sensor_object, self._sim.get_active_scene_graph(), render_flags
             )
 
+    def _acquire_buffer(self) -> None:
+        # np.asarray views the pooled buffer through the buffer protocol and
+        # pins it until the array and every view of it are gone
+        self._buffer = np.asarray(self._buffer_pool.acquire())
+
+    def _buffer_view(self) -> mn.MutableImageView2D:
+        size = self._sensor_object.framebuffer_size
+        if self._spec.sensor_type == SensorType.SEMANTIC:
+            return mn.MutableImageView2D(mn.PixelFormat.R32UI, size, self._buffer)
+        elif self._spec.sensor_type == SensorType.DEPTH:
+            return mn.MutableImageView2D(
+                _DEPTH_PIXEL_FORMATS[self._spec.depth_processing.format],
+                size,
+                self._buffer,
+            )
+        else:
+            return mn.MutableImageView2D(
+                mn.PixelFormat.RGBA8_UNORM,
+                size,
+                self._buffer.reshape(self._spec.resolution[0], -1),
+            )
+
+    def _read_observation_async(self) -> bool:
+        r"""Starts reading the drawn frame back into a pixel buffer without
+        waiting for the GPU. Finish with :ref:`_map_observation`,
+        :ref:`_copy_mapped_observation` and :ref:`_unmap_observation`.
+
+        :return: False if the readback has to go through :ref:`get_observation`
+        """
+        tgt = self._sensor_object.render_target
+        if self._spec.gpu2gpu_transfer or not hasattr(tgt, "read_frame_rgba_async"):
+            return False
+
+        if self._spec.sensor_type == SensorType.SEMANTIC:
+            tgt.read_frame_object_id_async()
+        elif self._spec.sensor_type == SensorType.DEPTH:
+            tgt.read_frame_depth_async()
+        else:
+            tgt.read_frame_rgba_async()
+        return True
+
+    def _map_observation(self) -> None:
+        self._acquire_buffer()
+        self._sensor_object.render_target.map_read_frame()
+
+    def _copy_mapped_observation(self) -> None:
+        # releases the GIL and makes no GL calls, safe on a worker thread
+        self._sensor_object.render_target.copy_read_frame(self._buffer_view())
+
+    def _unmap_observation(self) -> Union[ndarray, "Tensor"]:
+        self._sensor_object.render_target.unmap_read_frame()
+        return self._noise_model(np.flip(self._buffer, axis=0))
+
     def get_observation(self) -> Union[ndarray, "Tensor"]:
 
         tgt = self._sensor_object.render_target
@@ -608,24 +731,13 @@ class Sensor:
 
                 obs = self._buffer.flip(0)
         else:
-            size = self._sensor_object.framebuffer_size
-
+            self._acquire_buffer()
             if self._spec.sensor_type == SensorType.SEMANTIC:
-                tgt.read_frame_object_id(
-                    mn.MutableImageView2D(mn.PixelFormat.R32UI, size, self._buffer)
-                )
+                tgt.read_frame_object_id(self._buffer_view())
             elif self._spec.sensor_type == SensorType.DEPTH:
-                tgt.read_frame_depth(
-                    mn.MutableImageView2D(mn.PixelFormat.R32F, size, self._buffer)
-                )
+                tgt.read_frame_depth(self._buffer_view())
             else:
-                tgt.read_frame_rgba(
-                    mn.MutableImageView2D(
-                        mn.PixelFormat.RGBA8_UNORM,
-                        size,
-                        self._buffer.reshape(self._spec.resolution[0], -1),
-                    )
-                )
+                tgt.read_frame_rgba(self._buffer_view())
 
             obs = np.flip(self._buffer, axis=0)
 
@@ -55,9 +55,11 @@ path/to/nvidia/nsight-systems/bin/nsys profile --sample=none --trace=cuda,nvtx
 """
 import os
 from contextlib import ContextDecorator
+from typing import Optional
 
 import attr
 
+from habitat_sim.bindings import Profiler
 from habitat_sim.logging import logger
 
 _env_var = os.environ.get("HABITAT_PROFILING", "0")
@@ -174,3 +176,38 @@ class RangeContext(ContextDecorator):
 
     def __exit__(self, *exc) -> None:
         range_pop()
+
+
+class NativeRangeContext(ContextDecorator):
+    r"""Times a range into the simulator's own profiler,
+    :ref:`habitat_sim.bindings.Profiler`, next to its native scoped timers. Use
+    as a function decorator or in a with statement. Unlike
+    :ref:`RangeContext`, this needs neither torch nor an attached profiler.
+    It records only while the profiler is enabled.
+
+    Example usage:
+
+    Profiler.set_enabled(True)
+    with profiling_utils.NativeRangeContext("collect_rollout_steps"):
+        collect_rollout_steps()
+    for stats in Profiler.stats():
+        print(stats)
+    Profiler.write_chrome_trace("trace.json")  # open in chrome://tracing
+    """
+
+    def __init__(self, name: str) -> None:
+        self._name = name
+        self._start: Optional[int] = None
+
+    def _recreate_cm(self) -> "NativeRangeContext":
+        # a fresh instance per decorated call, so calls may recurse or run on
+        # several threads at once
+        return NativeRangeContext(self._name)
+
+    def __enter__(self) -> "NativeRangeContext":
+        self._start = Profiler.now() if Profiler.is_enabled() else None
+        return self
+
+    def __exit__(self, *exc) -> None:
+        if self._start is not None:
+            Profiler.record(self._name, self._start, Profiler.now())
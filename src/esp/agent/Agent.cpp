@@ -7,6 +7,7 @@
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 
+#include "esp/core/Profiler.h"
 #include "esp/scene/ObjectControls.h"
 #include "esp/sensor/Sensor.h"
 
@@ -33,6 +34,7 @@ Agent::~Agent() {
 }
 
 bool Agent::act(const std::string& actionName) {
+  ESP_PROFILE_SCOPE("Agent::act");
   if (hasAction(actionName)) {
     const ActionSpec& actionSpec = *configuration_.actionSpace.at(actionName);
     if (BodyActions.find(actionSpec.name) != BodyActions.end()) {
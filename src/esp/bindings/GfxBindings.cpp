@@ -88,6 +88,18 @@ void initGfxBindings(py::module& m) {
           R"(Draw given scene using the visual sensor)", "visualSensor"_a,
           "scene"_a,
           "flags"_a = RenderCamera::Flag{RenderCamera::Flag::FrustumCulling})
+      .def(
+          "draw",
+          [](Renderer& self,
+             const std::vector<sensor::VisualSensor*>& visualSensors,
+             scene::SceneGraph& sceneGraph, RenderCamera::Flag flags) {
+            self.draw(visualSensors, sceneGraph, RenderCamera::Flags{flags});
+          },
+          R"(Draw given scene into the render target of each of the visual
+          sensors, culling once per distinct camera frustum. The render
+          targets must have been entered before.)",
+          "visualSensors"_a, "scene"_a,
+          "flags"_a = RenderCamera::Flag{RenderCamera::Flag::FrustumCulling})
       .def(
           "draw",
           [](Renderer& self, RenderCamera& camera,
@@ -98,6 +110,26 @@ void initGfxBindings(py::module& m) {
           "flags"_a = RenderCamera::Flag{RenderCamera::Flag::FrustumCulling})
       .def("bind_render_target", &Renderer::bindRenderTarget);
 
+  py::enum_<DepthFormat>(m, "DepthFormat",
+                         R"(Storage format of processed depth values)")
+      .value("FLOAT", DepthFormat::Float)
+      .value("HALF", DepthFormat::Half)
+      .value("UNSIGNED_SHORT", DepthFormat::UnsignedShort);
+
+  py::class_<DepthProcessing>(
+      m, "DepthProcessing",
+      R"(Clipping, normalization and output format fused into the CPU depth
+      unprojection. Depth is clamped to [min_depth, max_depth], optionally
+      normalized to [0, 1] and stored as float32, float16 or uint16, the
+      latter in millimeters unless normalized.)")
+      .def(py::init())
+      .def_readwrite("min_depth", &DepthProcessing::minDepth)
+      .def_readwrite("max_depth", &DepthProcessing::maxDepth)
+      .def_readwrite("normalize", &DepthProcessing::normalize)
+      .def_readwrite("format", &DepthProcessing::format)
+      .def(py::self == py::self)
+      .def(py::self != py::self);
+
   py::class_<RenderTarget>(m, "RenderTarget")
       .def("__enter__",
            [](RenderTarget& self) {
@@ -112,6 +144,27 @@ void initGfxBindings(py::module& m) {
       .def("read_frame_depth", &RenderTarget::readFrameDepth)
       .def("read_frame_object_id", &RenderTarget::readFrameObjectId)
       .def("blit_rgba_to_default", &RenderTarget::blitRgbaToDefault)
+      .def_property_readonly("depth_processing",
+                             &RenderTarget::depthProcessing)
+#ifndef MAGNUM_TARGET_WEBGL
+      .def("read_frame_rgba_async", &RenderTarget::readFrameRgbaAsync,
+           R"(Starts reading the RGBA frame into a pixel buffer without
+           waiting for rendering to finish.)")
+      .def("read_frame_depth_async", &RenderTarget::readFrameDepthAsync,
+           R"(Starts reading the depth frame into a pixel buffer without
+           waiting for rendering to finish.)")
+      .def("read_frame_object_id_async",
+           &RenderTarget::readFrameObjectIdAsync,
+           R"(Starts reading the object id frame into a pixel buffer without
+           waiting for rendering to finish.)")
+      .def("map_read_frame", &RenderTarget::mapReadFrame,
+           R"(Waits for the last asynchronous read and maps its pixels.)")
+      .def("copy_read_frame", &RenderTarget::copyReadFrame,
+           R"(Copies the mapped pixels into passed img. Makes no GL calls and
+           releases the GIL, so it can run on a worker thread.)",
+           "img"_a, py::call_guard<py::gil_scoped_release>())
+      .def("unmap_read_frame", &RenderTarget::unmapReadFrame)
+#endif
 #ifdef ESP_BUILD_WITH_CUDA
       .def("read_frame_rgba_gpu",
            [](RenderTarget& self, size_t devPtr) {
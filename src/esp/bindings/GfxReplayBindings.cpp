@@ -7,6 +7,7 @@
 #include <Magnum/PythonBindings.h>
 #include <Magnum/SceneGraph/PythonBindings.h>
 
+#include "esp/gfx/replay/KeyframeStream.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/gfx/replay/ReplayManager.h"
 
@@ -41,6 +42,10 @@ void initGfxReplayBindings(py::module& m) {
           },
           R"(Get a previously-added user transform. See also ReplayManager.add_user_transform_to_keyframe.)")
 
+      .def(
+          "set_snapshot_interval", &Player::setSnapshotInterval,
+          R"(Keep a snapshot of the scene at every interval-th keyframe once it has been set, or pass 0 to keep none. Seeking starts from the closest snapshot.)")
+
       .def(
           "close", &Player::close,
           R"(Unload all keyframes. The Player is unusable after it is closed.)");
@@ -85,6 +90,48 @@ void initGfxReplayBindings(py::module& m) {
           },
           R"(Write all saved keyframes to a file, then discard the keyframes.)")
 
+      .def(
+          "set_snapshot_interval",
+          [](ReplayManager& self, int interval) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->setSnapshotInterval(interval);
+          },
+          R"(Save every interval-th keyframe as a snapshot of the full scene, or pass 0 to save none. A Player can seek to a snapshot without applying the keyframes before it.)")
+
+      .def(
+          "start_streaming_keyframes_to_file",
+          [](ReplayManager& self, const std::string& filepath,
+             float translationPrecision, std::uint32_t intraInterval) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            KeyframeStreamFormat format;
+            format.translationPrecision = translationPrecision;
+            format.intraInterval = intraInterval;
+            self.getRecorder()->startStreamingKeyframesToFile(filepath, format);
+          },
+          "filepath"_a, "translation_precision"_a = 1.0e-4f,
+          "intra_interval"_a = 64,
+          R"(Write saved keyframes to a compact binary file, and every keyframe saved from now on as soon as it is saved. Translations are quantized to translation_precision meters; seeking decodes at most intra_interval keyframes. read_keyframes_from_file reads the file.)")
+
+      .def(
+          "stop_streaming_keyframes",
+          [](ReplayManager& self) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->stopStreamingKeyframes();
+          },
+          R"(Finish the file started by start_streaming_keyframes_to_file.)")
+
       .def("read_keyframes_from_file", &ReplayManager::readKeyframesFromFile,
            R"(Create a Player object from a replay file.)");
 }
@@ -1,4 +1,7 @@
 #include "esp/bindings/bindings.h"
+
+#include <pybind11/numpy.h>
+
 #include "esp/physics/PhysicsManager.h"
 #include "esp/physics/RigidObject.h"
 
@@ -48,6 +51,69 @@ void initPhysicsBindings(py::module& m) {
       .def_readonly("hits", &RaycastResults::hits)
       .def_readonly("ray", &RaycastResults::ray)
       .def("has_hits", &RaycastResults::hasHits);
+
+  // ==== enum object RaycastMode ====
+  py::enum_<RaycastMode>(m, "RaycastMode")
+      .value("CLOSEST", RaycastMode::Closest)
+      .value("ANY", RaycastMode::Any);
+
+  // ==== struct object RaycastBatchResults ====
+  // The arrays view the results without a copy and keep them alive
+  py::class_<RaycastBatchResults, RaycastBatchResults::ptr>(
+      m, "RaycastBatchResults",
+      R"(One hit per ray of a batch cast with Simulator.cast_rays, as numpy
+      arrays indexed by ray. The arrays view the results, which are
+      overwritten when passed to the next cast_rays call. Arrays taken before a
+      cast with a different number of rays are invalid.)")
+      .def(py::init(&RaycastBatchResults::create<>))
+      .def("__len__", &RaycastBatchResults::size)
+      .def_property_readonly(
+          "hits",
+          [](py::object self) {
+            auto& results = self.cast<RaycastBatchResults&>();
+            return py::array_t<bool>(
+                results.size(),
+                reinterpret_cast<const bool*>(results.hits.data()), self);
+          },
+          R"(Whether each ray hit something.)")
+      .def_property_readonly(
+          "object_ids",
+          [](py::object self) {
+            auto& results = self.cast<RaycastBatchResults&>();
+            return py::array_t<int>(results.size(), results.objectIds.data(),
+                                    self);
+          },
+          R"(The id of the object hit by each ray. Stage hits and misses are
+          -1.)")
+      .def_property_readonly(
+          "points",
+          [](py::object self) {
+            auto& results = self.cast<RaycastBatchResults&>();
+            return py::array_t<float>(
+                {results.size(), size_t(3)},
+                {sizeof(Magnum::Vector3), sizeof(float)},
+                results.points.data()->data(), self);
+          },
+          R"(The N x 3 impact points in world space.)")
+      .def_property_readonly(
+          "normals",
+          [](py::object self) {
+            auto& results = self.cast<RaycastBatchResults&>();
+            return py::array_t<float>(
+                {results.size(), size_t(3)},
+                {sizeof(Magnum::Vector3), sizeof(float)},
+                results.normals.data()->data(), self);
+          },
+          R"(The N x 3 collision object normals at the points of impact.)")
+      .def_property_readonly(
+          "ray_distances",
+          [](py::object self) {
+            auto& results = self.cast<RaycastBatchResults&>();
+            return py::array_t<double>(results.size(),
+                                       results.rayDistances.data(), self);
+          },
+          R"(Distance along each ray direction from the ray origin, in units
+          of ray length.)");
 }
 
 }  // namespace physics
@@ -13,6 +13,7 @@
 #include <utility>
 
 #include "esp/sensor/CameraSensor.h"
+#include "esp/sensor/RedwoodNoiseModelCPU.h"
 #include "esp/sensor/VisualSensor.h"
 #ifdef ESP_BUILD_WITH_CUDA
 #include "esp/sensor/RedwoodNoiseModel.h"
@@ -39,8 +40,11 @@ namespace sensor {
 
 void initSensorBindings(py::module& m) {
   // ==== Observation ====
-  // NOLINTNEXTLINE(bugprone-unused-raii)
-  py::class_<Observation, Observation::ptr>(m, "Observation");
+  py::class_<Observation, Observation::ptr>(m, "Observation")
+      .def(py::init(&Observation::create<>))
+      .def_readonly("buffer", &Observation::buffer,
+                    R"(The observation data, use np.asarray() to view it
+                    without a copy)");
 
   // TODO fill out other SensorTypes
   // ==== enum SensorType ====
@@ -94,6 +98,7 @@ void initSensorBindings(py::module& m) {
              SensorSpec>(m, "CameraSensorSpec", py::dynamic_attr())
       .def(py::init(&CameraSensorSpec::create<>))
       .def_readwrite("channels", &CameraSensorSpec::channels)
+      .def_readwrite("depth_processing", &CameraSensorSpec::depthProcessing)
       .def_readwrite("observation_space", &CameraSensorSpec::observationSpace);
 
   // ==== Sensor ====
@@ -165,7 +170,21 @@ void initSensorBindings(py::module& m) {
           R"(The distance to the near clipping plane for this CameraSensor uses.)")
       .def_property(
           "far_plane_dist", &CameraSensor::getFar, &CameraSensor::setFar,
-          R"(The distance to the far clipping plane for this CameraSensor uses.)");
+          R"(The distance to the far clipping plane for this CameraSensor uses.)")
+      .def_static(
+          "draw_observations", &CameraSensor::drawObservations, "sim"_a,
+          "sensors"_a,
+          R"(Draw the observations of several CameraSensors at once, culling the scene once for sensors that share a pose and projection. Returns the number of sensors drawn.)");
+
+  py::class_<RedwoodNoiseModelCPUImpl, RedwoodNoiseModelCPUImpl::uptr>(
+      m, "RedwoodNoiseModelCPUImpl")
+      .def(py::init(&RedwoodNoiseModelCPUImpl::create_unique<
+                    const Eigen::Ref<const Eigen::RowMatrixXf>&, float,
+                    uint64_t, unsigned int>),
+           "model"_a, "noise_multiplier"_a, "seed"_a = 0, "max_threads"_a = 0)
+      .def("simulate_from_cpu", &RedwoodNoiseModelCPUImpl::simulateFromCPU,
+           py::call_guard<py::gil_scoped_release>())
+      .def("seed", &RedwoodNoiseModelCPUImpl::seed, "seed"_a);
 
 #ifdef ESP_BUILD_WITH_CUDA
   py::class_<RedwoodNoiseModelGPUImpl, RedwoodNoiseModelGPUImpl::uptr>(
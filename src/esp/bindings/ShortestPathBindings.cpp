@@ -36,7 +36,8 @@ void initShortestPathBindings(py::module& m) {
       .def_readwrite("requested_start", &ShortestPath::requestedStart)
       .def_readwrite("requested_end", &ShortestPath::requestedEnd)
       .def_readwrite("points", &ShortestPath::points)
-      .def_readwrite("geodesic_distance", &ShortestPath::geodesicDistance);
+      .def_readwrite("geodesic_distance", &ShortestPath::geodesicDistance)
+      .def_readwrite("partial", &ShortestPath::partial);
 
   py::class_<MultiGoalShortestPath, MultiGoalShortestPath::ptr>(
       m, "MultiGoalShortestPath")
@@ -46,7 +47,13 @@ void initShortestPathBindings(py::module& m) {
                     &MultiGoalShortestPath::setRequestedEnds)
       .def_readwrite("points", &MultiGoalShortestPath::points)
       .def_readwrite("geodesic_distance",
-                     &MultiGoalShortestPath::geodesicDistance);
+                     &MultiGoalShortestPath::geodesicDistance)
+      .def_readwrite("partial", &MultiGoalShortestPath::partial);
+
+  py::class_<GeodesicDistanceField, GeodesicDistanceField::ptr>(
+      m, "GeodesicDistanceField")
+      .def_property_readonly("goals", &GeodesicDistanceField::getGoals)
+      .def_property_readonly("num_nodes", &GeodesicDistanceField::getNumNodes);
 
   py::class_<NavMeshSettings, NavMeshSettings::ptr>(m, "NavMeshSettings")
       .def(py::init(&NavMeshSettings::create<>))
@@ -64,6 +71,7 @@ void initShortestPathBindings(py::module& m) {
       .def_readwrite("detail_sample_dist", &NavMeshSettings::detailSampleDist)
       .def_readwrite("detail_sample_max_error",
                      &NavMeshSettings::detailSampleMaxError)
+      .def_readwrite("tile_size", &NavMeshSettings::tileSize)
       .def_readwrite("filter_low_hanging_obstacles",
                      &NavMeshSettings::filterLowHangingObstacles)
       .def_readwrite("filter_ledge_spans", &NavMeshSettings::filterLedgeSpans)
@@ -71,6 +79,17 @@ void initShortestPathBindings(py::module& m) {
                      &NavMeshSettings::filterWalkableLowHeightSpans)
       .def("set_defaults", &NavMeshSettings::setDefaults);
 
+  py::class_<NavigablePointFilter, NavigablePointFilter::ptr>(
+      m, "NavigablePointFilter")
+      .def(py::init(&NavigablePointFilter::create<>))
+      .def_readwrite("island_id", &NavigablePointFilter::islandId)
+      .def_readwrite("min_island_radius",
+                     &NavigablePointFilter::minIslandRadius)
+      .def_readwrite("min_height", &NavigablePointFilter::minHeight)
+      .def_readwrite("max_height", &NavigablePointFilter::maxHeight)
+      .def_readwrite("min_obstacle_distance",
+                     &NavigablePointFilter::minObstacleDistance);
+
   py::class_<PathFinder, PathFinder::ptr>(m, "PathFinder")
       .def(py::init(&PathFinder::create<>))
       .def("get_bounds", &PathFinder::bounds)
@@ -78,13 +97,73 @@ void initShortestPathBindings(py::module& m) {
       .def("get_topdown_view", &PathFinder::getTopDownView,
            R"(Returns the topdown view of the PathFinder's navmesh.)",
            "meters_per_pixel"_a, "height"_a)
+      .def("get_topdown_views", &PathFinder::getTopDownViews,
+           R"(Returns one topdown view of the PathFinder's navmesh per height,
+          all computed in a single pass.)",
+           "meters_per_pixel"_a, "heights"_a)
       .def("get_random_navigable_point", &PathFinder::getRandomNavigablePoint,
            "max_tries"_a = 10)
+      .def("sample_navigable_points", &PathFinder::sampleNavigablePoints,
+           R"(Samples navigable points uniformly by area in parallel. The
+          result only depends on the seed and the navmesh.)",
+           "num_points"_a, "seed"_a, "filter"_a = NavigablePointFilter(),
+           "max_tries"_a = 100, "max_threads"_a = 0,
+           py::call_guard<py::gil_scoped_release>())
       .def("find_path", py::overload_cast<ShortestPath&>(&PathFinder::findPath),
            "path"_a)
       .def("find_path",
            py::overload_cast<MultiGoalShortestPath&>(&PathFinder::findPath),
            "path"_a)
+      .def(
+          "find_paths",
+          [](PathFinder& self, const std::vector<ShortestPath::ptr>& paths,
+             unsigned int maxThreads) {
+            // Solve on copies so the GIL isn't needed by the worker threads,
+            // then write the results back into the python objects
+            std::vector<ShortestPath> batch(paths.size());
+            for (size_t i = 0; i < paths.size(); ++i) {
+              batch[i].requestedStart = paths[i]->requestedStart;
+              batch[i].requestedEnd = paths[i]->requestedEnd;
+            }
+            int numFound = 0;
+            {
+              py::gil_scoped_release release;
+              numFound = self.findPaths(batch, maxThreads);
+            }
+            for (size_t i = 0; i < paths.size(); ++i) {
+              paths[i]->points = std::move(batch[i].points);
+              paths[i]->geodesicDistance = batch[i].geodesicDistance;
+              paths[i]->partial = batch[i].partial;
+            }
+            return numFound;
+          },
+          R"(Solves a list of ShortestPath queries in parallel. Returns the
+          number of queries for which a path exists.)",
+          "paths"_a, "max_threads"_a = 0)
+      .def("set_path_search_limits", &PathFinder::setPathSearchLimits,
+           R"(Sets the number of path polygons and search nodes the path
+          searches grow up to. Searches exceeding them return partial paths.)",
+           "max_path_polys"_a = 65536, "max_search_nodes"_a = 65535)
+      .def("geodesic_distances",
+           py::overload_cast<const std::vector<vec3f>&,
+                             const std::vector<vec3f>&, unsigned int>(
+               &PathFinder::geodesicDistances),
+           R"(Returns the geodesic distance between each pair of
+          (starts[i], ends[i]), computed in parallel.)",
+           "starts"_a, "ends"_a, "max_threads"_a = 0,
+           py::call_guard<py::gil_scoped_release>())
+      .def("build_geodesic_distance_field",
+           &PathFinder::buildGeodesicDistanceField,
+           R"(Precomputes the geodesic distance field to a set of goals.)",
+           "goals"_a, "edge_sample_spacing"_a = 0.5)
+      .def("geodesic_distance", &PathFinder::geodesicDistance,
+           R"(Looks up the geodesic distance from pt to the closest goal of a
+          precomputed GeodesicDistanceField.)",
+           "field"_a, "pt"_a)
+      .def("save_geodesic_distance_field",
+           &PathFinder::saveGeodesicDistanceField, "field"_a, "path"_a)
+      .def("load_geodesic_distance_field",
+           &PathFinder::loadGeodesicDistanceField, "path"_a)
       .def("try_step", &PathFinder::tryStep<Magnum::Vector3>, "start"_a,
            "end"_a)
       .def("try_step", &PathFinder::tryStep<vec3f>, "start"_a, "end"_a)
@@ -95,7 +174,16 @@ void initShortestPathBindings(py::module& m) {
       .def("snap_point", &PathFinder::snapPoint<Magnum::Vector3>)
       .def("snap_point", &PathFinder::snapPoint<vec3f>)
       .def("island_radius", &PathFinder::islandRadius, "pt"_a)
+      .def("island_id", &PathFinder::islandId, "pt"_a)
       .def_property_readonly("is_loaded", &PathFinder::isLoaded)
+      .def_property_readonly("supports_tile_updates",
+                             &PathFinder::supportsTileUpdates)
+      .def_property_readonly("has_pending_tile_updates",
+                             &PathFinder::hasPendingTileUpdates)
+      .def("apply_tile_updates", &PathFinder::applyTileUpdates,
+           R"(Swaps navmesh tiles rebuilt in the background into the navmesh.
+          Returns whether an update was applied.)",
+           "wait"_a = false, py::call_guard<py::gil_scoped_release>())
       .def_property_readonly("navigable_area", &PathFinder::getNavigableArea)
       .def("build_navmesh_vertices",
            [](PathFinder& self) { return self.getNavMeshData()->vbo; })
@@ -114,7 +202,33 @@ void initShortestPathBindings(py::module& m) {
            "pt"_a, "max_search_radius"_a = 2.0)
       .def("is_navigable", &PathFinder::isNavigable,
            R"(Checks to see if the agent can stand at the specified point.)",
-           "pt"_a, "max_y_delta"_a = 0.5);
+           "pt"_a, "max_y_delta"_a = 0.5)
+      .def("build_obstacle_distance_field",
+           &PathFinder::buildObstacleDistanceField,
+           R"(Precomputes the distance to the closest obstacle so that
+          distance_to_closest_obstacle becomes a lookup.)",
+           "cell_size"_a = 0.05, "max_distance"_a = 1.0)
+      .def_property_readonly("has_obstacle_distance_field",
+                             &PathFinder::hasObstacleDistanceField)
+      .def("clear_obstacle_distance_field",
+           &PathFinder::clearObstacleDistanceField)
+      .def("save_obstacle_distance_field",
+           &PathFinder::saveObstacleDistanceField, "path"_a)
+      .def("load_obstacle_distance_field",
+           &PathFinder::loadObstacleDistanceField, "path"_a)
+      .def("snap_points", &PathFinder::snapPoints,
+           R"(Snaps a list of points to the navmesh in parallel.)", "pts"_a,
+           "max_threads"_a = 0, py::call_guard<py::gil_scoped_release>())
+      .def("is_navigable_batch", &PathFinder::isNavigableBatch,
+           R"(Checks a list of points for navigability in parallel.)", "pts"_a,
+           "max_y_delta"_a = 0.5, "max_threads"_a = 0,
+           py::call_guard<py::gil_scoped_release>())
+      .def("distances_to_closest_obstacle",
+           &PathFinder::distancesToClosestObstacle,
+           R"(Returns the distance to the closest obstacle for a list of
+          points, computed in parallel.)",
+           "pts"_a, "max_search_radius"_a = 2.0, "max_threads"_a = 0,
+           py::call_guard<py::gil_scoped_release>());
 
   // this enum is used by GreedyGeodesicFollowerImpl so it needs to be defined
   // before it
@@ -153,6 +267,10 @@ void initShortestPathBindings(py::module& m) {
            py::overload_cast<const core::RigidState&, const Mn::Vector3&>(
                &GreedyGeodesicFollowerImpl::findPath),
            py::return_value_policy::move)
+      .def("find_paths", &GreedyGeodesicFollowerImpl::findPaths,
+           R"(Finds the paths for many (start, end) pairs at once, reusing one
+          geodesic distance field per end and batching the navmesh queries.)",
+           "starts"_a, "ends"_a, "max_threads"_a = 0)
       .def("reset", &GreedyGeodesicFollowerImpl::reset);
 }
 
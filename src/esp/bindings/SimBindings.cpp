@@ -10,11 +10,13 @@
 
 #include <Magnum/PythonBindings.h>
 #include <Magnum/SceneGraph/PythonBindings.h>
+#include <pybind11/numpy.h>
 
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/gfx/replay/ReplayManager.h"
 #include "esp/scene/SemanticScene.h"
+#include "esp/sim/BatchSimulator.h"
 #include "esp/sim/Simulator.h"
 #include "esp/sim/SimulatorConfiguration.h"
 
@@ -282,6 +284,53 @@ void initSimBindings(py::module& m) {
           "cast_ray", &Simulator::castRay, "ray"_a, "max_distance"_a = 100.0,
           "scene_id"_a = 0,
           R"(Cast a ray into the collidable scene and return hit results. Physics must be enabled. max_distance in units of ray length.)")
+      .def(
+          "cast_rays",
+          [](Simulator& self,
+             py::array_t<float, py::array::c_style | py::array::forcecast>
+                 origins,
+             py::array_t<float, py::array::c_style | py::array::forcecast>
+                 directions,
+             float maxDistance, esp::physics::RaycastMode mode,
+             esp::physics::RaycastBatchResults::ptr results, int sceneID) {
+            if (directions.ndim() != 2 || directions.shape(1) != 3) {
+              throw py::value_error{"directions must be an N x 3 array"};
+            }
+            const size_t numRays = directions.shape(0);
+            const bool sharedOrigin =
+                origins.ndim() == 1 && origins.shape(0) == 3;
+            if (!sharedOrigin &&
+                (origins.ndim() != 2 || size_t(origins.shape(0)) != numRays ||
+                 origins.shape(1) != 3)) {
+              throw py::value_error{
+                  "origins must be a 3-vector or an N x 3 array"};
+            }
+
+            std::vector<esp::geo::Ray> rays(numRays);
+            const float* origin = origins.data();
+            const float* direction = directions.data();
+            for (size_t i = 0; i < numRays; ++i, direction += 3) {
+              rays[i].origin = Magnum::Vector3{origin[0], origin[1], origin[2]};
+              rays[i].direction =
+                  Magnum::Vector3{direction[0], direction[1], direction[2]};
+              if (!sharedOrigin) {
+                origin += 3;
+              }
+            }
+            if (!results) {
+              results = esp::physics::RaycastBatchResults::create();
+            }
+            {
+              py::gil_scoped_release release;
+              self.castRays({rays.data(), rays.size()}, *results, maxDistance,
+                            mode, sceneID);
+            }
+            return results;
+          },
+          "origins"_a, "directions"_a, "max_distance"_a = 100.0,
+          "mode"_a = esp::physics::RaycastMode::Closest, "results"_a = nullptr,
+          "scene_id"_a = 0,
+          R"(Cast a batch of rays into the collidable scene and return one hit per ray, the closest one or, with mode RaycastMode.ANY, the first one found, which is cheaper. origins is a 3-vector shared by all rays or an N x 3 array, directions an N x 3 array. The rays are split across threads. Pass the results of a previous call as results to reuse them. Physics must be enabled. max_distance in units of ray length.)")
       .def("set_object_bb_draw", &Simulator::setObjectBBDraw, "draw_bb"_a,
            "object_id"_a, "scene_id"_a = 0,
            R"(Enable or disable bounding box visualization for an object.)")
@@ -293,6 +342,14 @@ void initSimBindings(py::module& m) {
           "recompute_navmesh", &Simulator::recomputeNavMesh, "pathfinder"_a,
           "navmesh_settings"_a, "include_static_objects"_a = false,
           R"(Recompute the NavMesh for a given PathFinder instance using configured NavMeshSettings. Optionally include all MotionType::STATIC objects in the navigability constraints.)")
+      .def(
+          "update_navmesh_async", &Simulator::updateNavMeshAsync,
+          "pathfinder"_a,
+          R"(Start rebuilding, in the background, only the NavMesh tiles affected by MotionType::STATIC objects added, removed or moved since the last recompute_navmesh/update_navmesh_async. Requires a NavMesh recomputed with NavMeshSettings.tile_size > 0. Use apply_navmesh_updates to swap the result in.)")
+      .def(
+          "apply_navmesh_updates", &Simulator::applyNavMeshUpdates,
+          "pathfinder"_a, "wait"_a = false,
+          R"(Swap a NavMesh update started by update_navmesh_async into the PathFinder if it is done, or block until it is if wait is True. Returns whether an update was applied.)")
 #ifdef ESP_BUILD_WITH_VHACD
       .def(
           "apply_convex_hull_decomposition",
@@ -329,6 +386,54 @@ void initSimBindings(py::module& m) {
           &Simulator::getNumActiveContactPoints,
           R"(The number of contact points that were active during the last step. An object resting on another object will involve several active contact points. Once both objects are asleep, the contact points are inactive. This count can be used as a metric for the complexity/cost of collision-handling in the current scene.)");
   ;
+
+  // ==== BatchSimulator ====
+  py::class_<BatchSimulator, BatchSimulator::ptr>(
+      m, "BatchSimulator",
+      R"(Runs a batch of environments in one process, sharing one GL context,
+      one renderer and one asset cache. Each environment has one agent with
+      the given sensors.)")
+      .def(py::init([](const std::vector<SimulatorConfiguration>& cfgs,
+                       const std::vector<sensor::SensorSpec::ptr>& sensorSpecs,
+                       metadata::MetadataMediator::ptr metadataMediator) {
+             agent::AgentConfiguration agentConfig;
+             agentConfig.sensorSpecifications = sensorSpecs;
+             return BatchSimulator::create(cfgs, agentConfig,
+                                           std::move(metadataMediator));
+           }),
+           "configs"_a, "sensor_specifications"_a,
+           "metadata_mediator"_a = nullptr)
+      .def_property_readonly("num_environments",
+                             &BatchSimulator::numEnvironments)
+      .def("environment", &BatchSimulator::environment, "env_index"_a,
+           py::return_value_policy::reference_internal,
+           R"(The simulator of one environment, for anything not batched.)")
+      .def("reset", &BatchSimulator::reset)
+      .def("act", &BatchSimulator::act, "actions"_a, "max_threads"_a = 0,
+           py::call_guard<py::gil_scoped_release>(),
+           R"(Applies one action to the agent of every environment in
+           parallel. An empty action name leaves that agent in place. Returns
+           whether each action was known.)")
+      .def("step_world", &BatchSimulator::stepWorld, "dt"_a = 1.0 / 60.0)
+      .def(
+          "get_observations",
+          [](BatchSimulator& self, unsigned int maxThreads) {
+            std::map<std::string, sensor::Observation> observations;
+            {
+              py::gil_scoped_release release;
+              self.getObservations(observations, maxThreads);
+            }
+            std::map<std::string, core::Buffer::ptr> buffers;
+            for (auto& it : observations) {
+              buffers[it.first] = it.second.buffer;
+            }
+            return buffers;
+          },
+          "max_threads"_a = 0,
+          R"(Renders every sensor of every environment. Returns one Buffer
+          per sensor uuid, shaped [num_environments, height, width, channels]
+          (no channels for depth and semantic); view it with np.asarray()
+          without a copy.)");
 }
 
 }  // namespace sim
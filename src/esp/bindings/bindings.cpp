@@ -6,8 +6,11 @@
 
 #include "esp/assets/ResourceManager.h"
 #include "esp/core//random.h"
+#include "esp/core/Buffer.h"
+#include "esp/core/BufferPool.h"
 #include "esp/core/Check.h"
 #include "esp/core/Configuration.h"
+#include "esp/core/Profiler.h"
 #include "esp/core/RigidState.h"
 
 namespace py = pybind11;
@@ -91,6 +94,127 @@ void initCoreBindings(py::module& m) {
       .def("has_value", &Configuration::hasValue)
       .def("remove_value", &Configuration::removeValue);
 
+  // ==== enum DataType ====
+  py::enum_<DataType>(m, "DataType")
+      .value("NONE", DataType::DT_NONE)
+      .value("INT8", DataType::DT_INT8)
+      .value("UINT8", DataType::DT_UINT8)
+      .value("INT16", DataType::DT_INT16)
+      .value("UINT16", DataType::DT_UINT16)
+      .value("INT32", DataType::DT_INT32)
+      .value("UINT32", DataType::DT_UINT32)
+      .value("INT64", DataType::DT_INT64)
+      .value("UINT64", DataType::DT_UINT64)
+      .value("FLOAT", DataType::DT_FLOAT)
+      .value("DOUBLE", DataType::DT_DOUBLE)
+      .value("FLOAT16", DataType::DT_FLOAT16);
+
+  // ==== class Buffer ====
+  // Exported through the buffer protocol, so np.asarray(buffer) views the
+  // data without a copy and keeps the buffer pinned while the array lives
+  py::class_<Buffer, Buffer::ptr>(m, "Buffer", py::buffer_protocol())
+      .def_buffer([](Buffer& self) -> py::buffer_info {
+        std::string format;
+        size_t itemSize = 0;
+        switch (self.dataType) {
+#define ESP_BUFFER_FORMAT(dt, T)                 \
+  case DataType::dt:                             \
+    format = py::format_descriptor<T>::format(); \
+    itemSize = sizeof(T);                        \
+    break;
+          ESP_BUFFER_FORMAT(DT_INT8, int8_t)
+          ESP_BUFFER_FORMAT(DT_UINT8, uint8_t)
+          ESP_BUFFER_FORMAT(DT_INT16, int16_t)
+          ESP_BUFFER_FORMAT(DT_UINT16, uint16_t)
+          ESP_BUFFER_FORMAT(DT_INT32, int32_t)
+          ESP_BUFFER_FORMAT(DT_UINT32, uint32_t)
+          ESP_BUFFER_FORMAT(DT_INT64, int64_t)
+          ESP_BUFFER_FORMAT(DT_UINT64, uint64_t)
+          ESP_BUFFER_FORMAT(DT_FLOAT, float)
+          ESP_BUFFER_FORMAT(DT_DOUBLE, double)
+#undef ESP_BUFFER_FORMAT
+          case DataType::DT_FLOAT16:
+            // no C++ type, numpy's half
+            format = "e";
+            itemSize = 2;
+            break;
+          default:
+            throw std::runtime_error("Buffer has no data type");
+        }
+        // C-contiguous strides
+        std::vector<size_t> strides(self.shape.size());
+        size_t stride = itemSize;
+        for (size_t i = self.shape.size(); i-- > 0;) {
+          strides[i] = stride;
+          stride *= self.shape[i];
+        }
+        return py::buffer_info(self.data.data(), itemSize, format,
+                               self.shape.size(), self.shape, strides);
+      })
+      .def_readonly("shape", &Buffer::shape)
+      .def_readonly("data_type", &Buffer::dataType);
+
+  // ==== class BufferPool ====
+  py::class_<BufferPool, BufferPool::ptr>(
+      m, "BufferPool",
+      R"(A ring of equally shaped Buffers handed out in turn. A buffer is
+      only reused once nothing, such as a numpy array viewing it, holds it
+      anymore.)")
+      .def(py::init(&BufferPool::create<const std::vector<size_t>&, DataType,
+                                        size_t>),
+           "shape"_a, "data_type"_a, "num_buffers"_a = 3)
+      .def("acquire", &BufferPool::acquire,
+           R"(Returns the next buffer that is not pinned, growing the pool if
+           all of them are.)")
+      .def_property_readonly("size", &BufferPool::size)
+      .def_property_readonly("num_free", &BufferPool::numFree);
+
+  // ==== class Profiler ====
+  py::class_<Profiler::Stats>(m, "ProfilerStats")
+      .def_readonly("name", &Profiler::Stats::name)
+      .def_readonly("count", &Profiler::Stats::count)
+      .def_readonly("total_ms", &Profiler::Stats::totalMs)
+      .def_readonly("min_ms", &Profiler::Stats::minMs)
+      .def_readonly("max_ms", &Profiler::Stats::maxMs)
+      .def_readonly("mean_ms", &Profiler::Stats::meanMs)
+      .def("__repr__", [](const Profiler::Stats& self) {
+        return py::str(
+                   "ProfilerStats({}: {} calls, {:.3f} ms total, {:.3f} ms "
+                   "mean)")
+            .format(self.name, self.count, self.totalMs, self.meanMs);
+      });
+
+  py::class_<Profiler>(
+      m, "Profiler",
+      R"(Scoped timers inside the simulator, from stepping physics to reading
+      back sensor observations. Disabled by default, in which case they cost
+      next to nothing.)")
+      .def_static("is_enabled", &Profiler::isEnabled)
+      .def_static("set_enabled", &Profiler::setEnabled, "enabled"_a)
+      .def_static("now", &Profiler::now,
+                  R"(Current time in nanoseconds, in the clock of recorded
+                  events.)")
+      .def_static(
+          "record",
+          [](const std::string& name, std::int64_t start, std::int64_t end) {
+            Profiler::record(Profiler::internName(name), start, end);
+          },
+          "name"_a, "start"_a, "end"_a,
+          R"(Records an event timed with now() on the calling thread.)")
+      .def_static("capacity", &Profiler::capacity)
+      .def_static("set_capacity", &Profiler::setCapacity, "capacity"_a,
+                  R"(Sets the number of events kept per thread. Drops all
+                  recorded events.)")
+      .def_static("clear", &Profiler::clear)
+      .def_static("stats", &Profiler::stats,
+                  R"(Recorded events aggregated by name, most total time
+                  first.)")
+      .def_static("chrome_trace", &Profiler::chromeTrace)
+      .def_static("write_chrome_trace", &Profiler::writeChromeTrace,
+                  "filename"_a,
+                  R"(Writes the recorded events as a Chrome trace, to be
+                  opened in chrome://tracing or Perfetto.)");
+
   // ==== struct RigidState ===
   py::class_<RigidState, RigidState::ptr>(m, "RigidState")
       .def(py::init(&RigidState::create<>))
@@ -25,6 +25,7 @@ enum class DataType {
   DT_UINT64 = 8,
   DT_FLOAT = 9,
   DT_DOUBLE = 10,
+  DT_FLOAT16 = 11,
 };
 
 class Buffer {
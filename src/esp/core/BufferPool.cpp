@@ -0,0 +1,48 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BufferPool.h"
+
+namespace esp {
+namespace core {
+
+BufferPool::BufferPool(const std::vector<size_t>& shape,
+                       DataType dataType,
+                       size_t numBuffers)
+    : shape_{shape}, dataType_{dataType} {
+  buffers_.reserve(numBuffers);
+  for (size_t i = 0; i < numBuffers; ++i) {
+    buffers_.emplace_back(Buffer::create(shape_, dataType_));
+  }
+}
+
+Buffer::ptr BufferPool::acquire() {
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    const size_t idx = (next_ + i) % buffers_.size();
+    // the pool holds the only reference, nobody can be reading it
+    if (buffers_[idx].use_count() == 1) {
+      next_ = (idx + 1) % buffers_.size();
+      return buffers_[idx];
+    }
+  }
+
+  VLOG(1) << "BufferPool::acquire(): all " << buffers_.size()
+          << " buffers are pinned, growing the pool";
+  buffers_.emplace_back(Buffer::create(shape_, dataType_));
+  next_ = 0;
+  return buffers_.back();
+}
+
+size_t BufferPool::numFree() const {
+  size_t numFree = 0;
+  for (const Buffer::ptr& buffer : buffers_) {
+    if (buffer.use_count() == 1) {
+      ++numFree;
+    }
+  }
+  return numFree;
+}
+
+}  // namespace core
+}  // namespace esp
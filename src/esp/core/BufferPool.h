@@ -0,0 +1,67 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_BUFFERPOOL_H_
+#define ESP_CORE_BUFFERPOOL_H_
+
+#include "esp/core/Buffer.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief A ring of equally shaped @ref Buffer instances handed out in turn.
+ *
+ * A buffer is pinned for as long as anything outside the pool holds a
+ * reference to it, for example an @ref sensor::Observation or a numpy array
+ * viewing it through the Python buffer protocol, and is only written again
+ * after it was released. Observations can thus be held while the next frames
+ * are rendered into other buffers, without copying them out. If every buffer
+ * is pinned, @ref acquire() grows the ring.
+ *
+ * Not thread safe; buffers may be released from any thread though.
+ */
+class BufferPool {
+ public:
+  /**
+   * @brief Constructor
+   * @param shape Shape of every buffer
+   * @param dataType Element type of every buffer
+   * @param numBuffers Number of buffers allocated upfront, 3 allows holding
+   * one frame while another one is being written
+   */
+  BufferPool(const std::vector<size_t>& shape,
+             DataType dataType,
+             size_t numBuffers = 3);
+
+  /**
+   * @brief Returns the next buffer that is not pinned, allocating a new one if
+   * all of them are
+   */
+  Buffer::ptr acquire();
+
+  /** @brief Number of buffers in the ring */
+  size_t size() const { return buffers_.size(); }
+
+  /** @brief Number of buffers not currently pinned */
+  size_t numFree() const;
+
+  const std::vector<size_t>& shape() const { return shape_; }
+  DataType dataType() const { return dataType_; }
+
+ private:
+  std::vector<size_t> shape_;
+  DataType dataType_;
+  std::vector<Buffer::ptr> buffers_;
+  // where the search for a free buffer starts, so buffers are reused in turn
+  size_t next_ = 0;
+
+  ESP_SMART_POINTERS(BufferPool)
+};
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_BUFFERPOOL_H_
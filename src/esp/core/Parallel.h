@@ -0,0 +1,82 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_PARALLEL_H_
+#define ESP_CORE_PARALLEL_H_
+
+/** @file
+ * @brief Minimal fork-join helpers for running independent work items across
+ * CPU cores.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Number of worker threads to use for a batch of @p numItems.
+ *
+ * @param numItems Number of independent work items in the batch
+ * @param maxThreads Upper bound on the number of threads. 0 means use
+ * std::thread::hardware_concurrency()
+ *
+ * @return A worker count in [1, max(numItems, 1)]
+ */
+inline unsigned int numWorkerThreads(size_t numItems,
+                                     unsigned int maxThreads = 0) {
+  unsigned int numThreads = maxThreads;
+  if (numThreads == 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (numItems < numThreads) {
+    numThreads = std::max<unsigned int>(1, static_cast<unsigned int>(numItems));
+  }
+  return numThreads;
+}
+
+/**
+ * @brief Calls @p fn(workerIdx, itemIdx) for every itemIdx in [0, numItems)
+ * using @p numWorkers threads and returns once all items are done.
+ *
+ * Items are handed out dynamically, so uneven per-item cost is balanced
+ * across workers. The calling thread participates as worker 0, so with
+ * @p numWorkers == 1 no thread is spawned. @p workerIdx is in [0, numWorkers)
+ * and can be used to index per-worker scratch state.
+ */
+template <typename Fn>
+void parallelFor(size_t numItems, unsigned int numWorkers, Fn&& fn) {
+  if (numWorkers <= 1 || numItems <= 1) {
+    for (size_t i = 0; i < numItems; ++i) {
+      fn(0u, i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> nextItem{0};
+  auto work = [&nextItem, &fn, numItems](unsigned int workerIdx) {
+    for (size_t i = nextItem++; i < numItems; i = nextItem++) {
+      fn(workerIdx, i);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numWorkers - 1);
+  for (unsigned int w = 1; w < numWorkers; ++w) {
+    threads.emplace_back(work, w);
+  }
+  work(0);
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_PARALLEL_H_
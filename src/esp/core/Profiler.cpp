@@ -0,0 +1,254 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+namespace esp {
+namespace core {
+
+namespace {
+
+// Events of one thread. The lock is only ever contended while events are
+// being collected, recording itself stays thread local.
+struct EventRing {
+  std::mutex mutex;
+  std::vector<Profiler::Event> events;
+  // total number of events recorded, the next one goes to written % size
+  std::size_t written = 0;
+  unsigned int thread = 0;
+};
+
+struct Registry {
+  std::mutex mutex;
+  // owned here so events of finished threads are kept
+  std::vector<std::shared_ptr<EventRing>> rings;
+  // rings of finished threads holding events, reused by new threads
+  std::vector<std::shared_ptr<EventRing>> freeRings;
+  std::size_t capacity = 1 << 16;
+  unsigned int nextThread = 0;
+  std::unordered_set<std::string> names;
+};
+
+Registry& registry() {
+  static Registry instance;
+  return instance;
+}
+
+// Hands the ring of a thread back to the registry when the thread exits, so
+// short-lived threads don't each keep a ring alive. Rings without events are
+// dropped, the others are appended to by the next new thread.
+struct RingOwner {
+  std::shared_ptr<EventRing> ring;
+
+  RingOwner() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock{reg.mutex};
+    if (!reg.freeRings.empty()) {
+      ring = std::move(reg.freeRings.back());
+      reg.freeRings.pop_back();
+      return;
+    }
+    ring = std::make_shared<EventRing>();
+    ring->events.resize(reg.capacity);
+    ring->thread = reg.nextThread++;
+    reg.rings.push_back(ring);
+  }
+
+  ~RingOwner() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock{reg.mutex};
+    bool hasEvents;
+    {
+      std::lock_guard<std::mutex> ringLock{ring->mutex};
+      hasEvents = ring->written != 0;
+    }
+    if (hasEvents) {
+      reg.freeRings.push_back(std::move(ring));
+    } else {
+      reg.rings.erase(std::find(reg.rings.begin(), reg.rings.end(), ring));
+    }
+  }
+};
+
+EventRing& threadRing() {
+  thread_local RingOwner owner;
+  return *owner.ring;
+}
+
+template <class Fn>
+void forEachRing(Fn&& fn) {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> lock{reg.mutex};
+  for (const std::shared_ptr<EventRing>& ring : reg.rings) {
+    std::lock_guard<std::mutex> ringLock{ring->mutex};
+    fn(*ring);
+  }
+}
+
+void appendJsonString(std::string& out, const char* str) {
+  out += '"';
+  for (; *str; ++str) {
+    const char c = *str;
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+}  // namespace
+
+std::atomic<bool> Profiler::enabled_{false};
+
+void Profiler::setEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::record(const char* name,
+                      std::int64_t start,
+                      std::int64_t end) {
+  EventRing& ring = threadRing();
+  std::lock_guard<std::mutex> lock{ring.mutex};
+  if (ring.events.empty()) {
+    return;
+  }
+  ring.events[ring.written % ring.events.size()] =
+      Event{name, start, end, ring.thread};
+  ++ring.written;
+}
+
+const char* Profiler::internName(const std::string& name) {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> lock{reg.mutex};
+  // nodes of an unordered_set never move, so the pointer stays valid
+  return reg.names.insert(name).first->c_str();
+}
+
+std::size_t Profiler::numThreadBuffers() {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> lock{reg.mutex};
+  return reg.rings.size();
+}
+
+std::size_t Profiler::capacity() {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> lock{reg.mutex};
+  return reg.capacity;
+}
+
+void Profiler::setCapacity(std::size_t capacity) {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> lock{reg.mutex};
+  reg.capacity = capacity;
+  for (const std::shared_ptr<EventRing>& ring : reg.rings) {
+    std::lock_guard<std::mutex> ringLock{ring->mutex};
+    ring->events.assign(capacity, Event{});
+    ring->written = 0;
+  }
+}
+
+void Profiler::clear() {
+  forEachRing([](EventRing& ring) { ring.written = 0; });
+}
+
+std::vector<Profiler::Event> Profiler::events() {
+  std::vector<Event> result;
+  forEachRing([&result](EventRing& ring) {
+    const std::size_t size = ring.events.size();
+    const std::size_t count = std::min(ring.written, size);
+    for (std::size_t i = ring.written - count; i != ring.written; ++i) {
+      result.push_back(ring.events[i % size]);
+    }
+  });
+  return result;
+}
+
+std::vector<Profiler::Stats> Profiler::stats() {
+  // by name contents, runtime names may be interned more than once
+  std::map<std::string, Stats> byName;
+  for (const Event& event : events()) {
+    const double ms = (event.end - event.start) * 1.0e-6;
+    Stats& stats = byName[event.name];
+    if (stats.count == 0) {
+      stats.name = event.name;
+      stats.minMs = ms;
+      stats.maxMs = ms;
+    } else {
+      stats.minMs = std::min(stats.minMs, ms);
+      stats.maxMs = std::max(stats.maxMs, ms);
+    }
+    ++stats.count;
+    stats.totalMs += ms;
+  }
+
+  std::vector<Stats> result;
+  result.reserve(byName.size());
+  for (auto& it : byName) {
+    it.second.meanMs = it.second.totalMs / it.second.count;
+    result.push_back(std::move(it.second));
+  }
+  std::sort(result.begin(), result.end(), [](const Stats& a, const Stats& b) {
+    return a.totalMs > b.totalMs;
+  });
+  return result;
+}
+
+std::string Profiler::chromeTrace() {
+  const std::vector<Event> allEvents = events();
+  std::int64_t epoch = 0;
+  if (!allEvents.empty()) {
+    epoch = std::min_element(allEvents.begin(), allEvents.end(),
+                             [](const Event& a, const Event& b) {
+                               return a.start < b.start;
+                             })
+                ->start;
+  }
+
+  // complete events, timestamps in microseconds
+  std::string out = "{\"traceEvents\":[";
+  char numbers[96];
+  for (std::size_t i = 0; i != allEvents.size(); ++i) {
+    const Event& event = allEvents[i];
+    if (i) {
+      out += ',';
+    }
+    out += "\n{\"name\":";
+    appendJsonString(out, event.name);
+    std::snprintf(numbers, sizeof(numbers),
+                  ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,"
+                  "\"ts\":%.3f,\"dur\":%.3f}",
+                  event.thread, (event.start - epoch) * 1.0e-3,
+                  (event.end - event.start) * 1.0e-3);
+    out += numbers;
+  }
+  out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return out;
+}
+
+bool Profiler::writeChromeTrace(const std::string& filename) {
+  std::ofstream file{filename};
+  if (!file) {
+    return false;
+  }
+  file << chromeTrace();
+  return bool(file);
+}
+
+}  // namespace core
+}  // namespace esp
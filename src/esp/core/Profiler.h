@@ -0,0 +1,162 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_PROFILER_H_
+#define ESP_CORE_PROFILER_H_
+
+/** @file
+ * @brief Scoped timers recording where the time of a simulation step goes,
+ * see @ref esp::core::Profiler.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Runtime toggleable profiler collecting @ref ScopedTimer events.
+ *
+ * Always compiled in; while disabled, which is the default, a timer costs a
+ * single relaxed atomic load. While enabled, each thread records into its own
+ * ring buffer of the last @ref capacity() events, so threads never contend
+ * and long runs keep the most recent events. The events can be aggregated
+ * with @ref stats() or exported as a Chrome trace, viewable in
+ * chrome://tracing or Perfetto, with @ref writeChromeTrace().
+ *
+ * Event names are not copied. Use string literals, or @ref internName() for
+ * names created at runtime.
+ */
+class Profiler {
+ public:
+  /** @brief One timed scope */
+  struct Event {
+    const char* name;
+    //! nanoseconds since an arbitrary, process-wide epoch
+    std::int64_t start;
+    std::int64_t end;
+    //! small integer identifying the recording thread, threads started
+    //! after another one exited may reuse its number
+    unsigned int thread;
+  };
+
+  /** @brief Aggregated timings of all recorded events of one name */
+  struct Stats {
+    std::string name;
+    std::size_t count = 0;
+    double totalMs = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    double meanMs = 0.0;
+  };
+
+  /** @brief Whether timers record events */
+  static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /** @brief Enables or disables recording; recorded events are kept */
+  static void setEnabled(bool enabled);
+
+  /** @brief Current time in the clock of @ref Event */
+  static std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /**
+   * @brief Records an event on the calling thread's ring buffer
+   *
+   * Records even if the profiler is disabled; @ref ScopedTimer checks that
+   * when the scope is entered.
+   */
+  static void record(const char* name, std::int64_t start, std::int64_t end);
+
+  /**
+   * @brief Returns a pointer to a copy of @p name that lives as long as the
+   * process, the same one for equal names
+   */
+  static const char* internName(const std::string& name);
+
+  /**
+   * @brief Number of ring buffers currently allocated
+   *
+   * A thread gets a ring when it first records. When the thread exits, its
+   * ring is freed if empty and otherwise reused by the next recording thread,
+   * so there are never more rings than threads recording at the same time.
+   */
+  static std::size_t numThreadBuffers();
+
+  /** @brief Number of events kept per thread */
+  static std::size_t capacity();
+
+  /**
+   * @brief Sets the number of events kept per thread. Drops all recorded
+   * events.
+   */
+  static void setCapacity(std::size_t capacity);
+
+  /** @brief Drops all recorded events */
+  static void clear();
+
+  /** @brief All recorded events of all threads, oldest first per thread */
+  static std::vector<Event> events();
+
+  /** @brief Recorded events aggregated by name, most total time first */
+  static std::vector<Stats> stats();
+
+  /** @brief Recorded events in the Chrome trace event JSON format */
+  static std::string chromeTrace();
+
+  /**
+   * @brief Writes @ref chromeTrace() to @p filename
+   * @return false if the file could not be written
+   */
+  static bool writeChromeTrace(const std::string& filename);
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+/**
+ * @brief Records the time between its construction and destruction as a
+ * @ref Profiler event, if the profiler is enabled at construction
+ */
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(const char* name)
+      : name_{Profiler::isEnabled() ? name : nullptr},
+        start_{name_ ? Profiler::now() : 0} {}
+
+  ~ScopedTimer() {
+    if (name_) {
+      Profiler::record(name_, start_, Profiler::now());
+    }
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  const char* name_;
+  std::int64_t start_;
+};
+
+}  // namespace core
+}  // namespace esp
+
+#define ESP_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ESP_PROFILE_CONCAT(a, b) ESP_PROFILE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Times the rest of the enclosing scope as @p name, a string literal
+ */
+#define ESP_PROFILE_SCOPE(name)                                 \
+  ::esp::core::ScopedTimer ESP_PROFILE_CONCAT(espProfileScope, \
+                                              __LINE__)(name)
+
+#endif  // ESP_CORE_PROFILER_H_
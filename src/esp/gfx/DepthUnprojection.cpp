@@ -4,6 +4,10 @@
 
 #include "DepthUnprojection.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Reference.h>
 #include <Corrade/Utility/Resource.h>
@@ -104,26 +108,124 @@ Mn::Vector2 calculateDepthUnprojection(const Mn::Matrix4& projectionMatrix) {
          0.5f;
 }
 
+std::size_t depthFormatSize(DepthFormat format) {
+  switch (format) {
+    case DepthFormat::Float:
+      return sizeof(Mn::Float);
+    case DepthFormat::Half:
+    case DepthFormat::UnsignedShort:
+      return sizeof(Mn::UnsignedShort);
+  }
+  CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+}
+
+void unprojectDepth(const Mn::Vector2& unprojection,
+                    Cr::Containers::ArrayView<Mn::Float> depth) {
+  unprojectDepth(unprojection, {}, depth, depth);
+}
+
+namespace {
+
+/* Depth is non-negative and finite here, so unlike Mn::Math::packHalf() this
+   needs no branches for NaNs and denormals and vectorizes like the rest of
+   the loop. Values below the smallest normal half flush to zero, values
+   above the largest one become infinity. */
+inline Mn::UnsignedShort packDepthHalf(Mn::Float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const std::uint32_t magnitude = bits & 0x7fffffffu;
+  // rebias the exponent from 127 to 15 and round the dropped mantissa bits
+  std::uint32_t half = (magnitude - (112u << 23) + 0x1000u) >> 13;
+  half = magnitude < (113u << 23) ? 0u : half;
+  half = magnitude >= (143u << 23) ? 0x7c00u : half;
+  return Mn::UnsignedShort(((bits >> 16) & 0x8000u) | half);
+}
+
+/* Processes the depth in blocks small enough to stay in L1. All of a block
+   is read before any of it is written, which makes the in-place case safe
+   for outputs no larger than the input and keeps both loops free of
+   aliasing, so the compiler vectorizes them. */
+template <class T, class Convert>
+inline void unprojectDepthBlocks(const Mn::Vector2& unprojection,
+                                 const DepthProcessing& processing,
+                                 Mn::Float scale,
+                                 Cr::Containers::ArrayView<const Mn::Float> in,
+                                 T* out,
+                                 Convert convert) {
+  constexpr std::size_t BlockSize = 256;
+  const Mn::Float a = unprojection[0];
+  const Mn::Float b = unprojection[1];
+  const Mn::Float minDepth = processing.minDepth;
+  const Mn::Float maxDepth = processing.maxDepth;
+  const Mn::Float offset = processing.normalize ? minDepth : 0.0f;
+
+  Mn::Float block[BlockSize];
+  for (std::size_t begin = 0; begin < in.size(); begin += BlockSize) {
+    const std::size_t count = std::min(BlockSize, in.size() - begin);
+    const Mn::Float* blockIn = in.data() + begin;
+    for (std::size_t i = 0; i != count; ++i) {
+      const Mn::Float d = blockIn[i];
+      /* Checking the input for the far plane is equivalent to checking the
+         output as the separate pass used to, without a second pass */
+      const Mn::Float z = d == 1.0f ? 0.0f : b / (d + a);
+      block[i] = (Mn::Math::clamp(z, minDepth, maxDepth) - offset) * scale;
+    }
+    T* blockOut = out + begin;
+    for (std::size_t i = 0; i != count; ++i) {
+      blockOut[i] = convert(block[i]);
+    }
+  }
+}
+
+}  // namespace
+
 /* Clang doesn't have target_clones yet: https://reviews.llvm.org/D51650 */
 #if defined(CORRADE_TARGET_X86) && defined(__GNUC__) && __GNUC__ >= 6
 __attribute__((target_clones("default", "sse4.2", "avx2")))
 #endif
 void unprojectDepth(const Mn::Vector2& unprojection,
-                    Cr::Containers::ArrayView<Mn::Float> depth) {
-  for (Mn::Float& d : depth) {
-    d = unprojection[1] / (d + unprojection[0]);
-  }
-
-  /* Change pixels on the far plane to be 0. Done in a separate loop to allow
-     the optimizer to vectorize the above better.  */
-  const Mn::Float farDepth = unprojection[1] / (1.0f + unprojection[0]);
-  for (Mn::Float& d : depth) {
-    /* We can afford using == for comparison as 1.0f has an exact
-       representation, the depth was cleared to exactly this value and the
-       calculation is done exactly the same way in both cases -- thus the
-       result should be bit-exact. */
-    if (d == farDepth)
-      d = 0.0f;
+                    const DepthProcessing& processing,
+                    Cr::Containers::ArrayView<const Mn::Float> depth,
+                    Cr::Containers::ArrayView<void> output) {
+  CORRADE_ASSERT(
+      output.size() >= depth.size() * depthFormatSize(processing.format),
+      "gfx::unprojectDepth(): expected at least"
+          << depth.size() * depthFormatSize(processing.format)
+          << "output bytes but got" << output.size(), );
+  CORRADE_ASSERT(!processing.normalize ||
+                     (processing.maxDepth > processing.minDepth &&
+                      processing.maxDepth != Mn::Constants::inf()),
+                 "gfx::unprojectDepth(): normalization needs a finite depth "
+                 "range", );
+
+  const Mn::Float scale =
+      processing.normalize
+          ? 1.0f / (processing.maxDepth - processing.minDepth)
+          : 1.0f;
+  switch (processing.format) {
+    case DepthFormat::Float:
+      unprojectDepthBlocks(unprojection, processing, scale, depth,
+                           static_cast<Mn::Float*>(output.data()),
+                           [](Mn::Float value) { return value; });
+      return;
+    case DepthFormat::Half:
+      unprojectDepthBlocks(unprojection, processing, scale, depth,
+                           static_cast<Mn::UnsignedShort*>(output.data()),
+                           [](Mn::Float value) {
+                             return packDepthHalf(value);
+                           });
+      return;
+    case DepthFormat::UnsignedShort:
+      // millimeters, or the full range if normalized
+      unprojectDepthBlocks(
+          unprojection, processing,
+          scale * (processing.normalize ? 65535.0f : 1000.0f), depth,
+          static_cast<Mn::UnsignedShort*>(output.data()),
+          [](Mn::Float value) {
+            return Mn::UnsignedShort(
+                Mn::Math::clamp(value + 0.5f, 0.0f, 65535.0f));
+          });
+      return;
   }
 }
 
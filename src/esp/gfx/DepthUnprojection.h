@@ -7,6 +7,7 @@
 
 #include <Corrade/Containers/EnumSet.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/Math/Constants.h>
 
 namespace esp {
 namespace gfx {
@@ -146,11 +147,81 @@ Magnum::Vector2 calculateDepthUnprojection(
 See @ref calculateDepthUnprojection() for the full algorithm explanation.
 Additionally to applying that calculation, if the input depth is at the far
 plane (of value @cpp 1.0f @ce), it's set to @cpp 0.0f @ce on output as
-consumers expect zeros for things that are too far.
+consumers expect zeros for things that are too far. Equivalent to the fused
+overload below with a default-constructed @ref DepthProcessing.
 */
 void unprojectDepth(const Magnum::Vector2& unprojection,
                     Corrade::Containers::ArrayView<Magnum::Float> depth);
 
+/**
+@brief Storage format of processed depth values
+@see @ref DepthProcessing
+*/
+enum class DepthFormat : Magnum::UnsignedByte {
+  /** 32-bit float, in meters or normalized */
+  Float = 0,
+
+  /** 16-bit half float, in meters or normalized */
+  Half,
+
+  /**
+   * 16-bit unsigned integer, in millimeters or, if normalized, mapping
+   * @f$ [ 0 ; 1 ] @f$ to the full range. Saturates at @cpp 65535 @ce.
+   */
+  UnsignedShort
+};
+
+/**
+@brief Size in bytes of one depth value stored as @p format
+*/
+std::size_t depthFormatSize(DepthFormat format);
+
+/**
+@brief Post processing fused into @ref unprojectDepth()
+
+The default-constructed value leaves the unprojected depth untouched, in
+meters as 32-bit floats.
+*/
+struct DepthProcessing {
+  /** Depth is clamped to @f$ [ minDepth ; maxDepth ] @f$ */
+  Magnum::Float minDepth = 0.0f;
+  /** Depth is clamped to @f$ [ minDepth ; maxDepth ] @f$ */
+  Magnum::Float maxDepth = Magnum::Constants::inf();
+  /**
+   * Map @f$ [ minDepth ; maxDepth ] @f$ to @f$ [ 0 ; 1 ] @f$. Expects
+   * @ref maxDepth to be finite.
+   */
+  bool normalize = false;
+  /** Storage format of the output */
+  DepthFormat format = DepthFormat::Float;
+
+  bool operator==(const DepthProcessing& other) const {
+    return minDepth == other.minDepth && maxDepth == other.maxDepth &&
+           normalize == other.normalize && format == other.format;
+  }
+  bool operator!=(const DepthProcessing& other) const {
+    return !operator==(other);
+  }
+};
+
+/**
+@brief Unproject and post process depth values in a single pass
+@param[in] unprojection Unprojection coefficients from
+    @ref calculateDepthUnprojection()
+@param[in] processing   Clipping, normalization and output format
+@param[in] depth        Depth values in range @f$ [ 0 ; 1 ] @f$
+@param[out] output      At least @cpp depth.size() @ce values in
+    @ref DepthProcessing::format. May be the memory of @p depth itself.
+
+Far plane pixels become @cpp 0.0f @ce as in the overload above before they
+are clipped, normalized and converted, so every pixel is read and written
+exactly once.
+*/
+void unprojectDepth(const Magnum::Vector2& unprojection,
+                    const DepthProcessing& processing,
+                    Corrade::Containers::ArrayView<const Magnum::Float> depth,
+                    Corrade::Containers::ArrayView<void> output);
+
 }  // namespace gfx
 }  // namespace esp
 
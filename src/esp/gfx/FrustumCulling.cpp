@@ -0,0 +1,219 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "FrustumCulling.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+
+#include "esp/core/Parallel.h"
+
+namespace Mn = Magnum;
+namespace Cr = Corrade;
+
+namespace esp {
+namespace gfx {
+
+Cr::Containers::Optional<int> rangeFrustum(const Mn::Range3D& range,
+                                           const Mn::Frustum& frustum,
+                                           int frustumPlaneIndex) {
+  const Mn::Vector3 center = range.min() + range.max();
+  const Mn::Vector3 extent = range.max() - range.min();
+
+  for (int iPlane = 0; iPlane < 6; ++iPlane) {
+    int index = (iPlane + frustumPlaneIndex) % 6;
+    const Mn::Vector4& plane = frustum[index];
+
+    const Mn::Vector3 absPlaneNormal = Mn::Math::abs(plane.xyz());
+
+    const float d = Mn::Math::dot(center, plane.xyz());
+    const float r = Mn::Math::dot(extent, absPlaneNormal);
+    if (d + r < -2.0 * plane.w())
+      return Cr::Containers::Optional<int>{index};
+  }
+
+  return Cr::Containers::NullOpt;
+}
+
+void AABBArrays::resize(std::size_t size) {
+  for (std::vector<Mn::Float>* coordinates :
+       {&minX, &minY, &minZ, &maxX, &maxY, &maxZ}) {
+    coordinates->resize(size);
+  }
+}
+
+namespace {
+
+constexpr std::size_t BlockSize = 256;
+// Splitting shorter lists costs more in thread startup than it saves
+constexpr std::size_t ParallelChunkSize = 16384;
+
+// The frustum planes, one array per coefficient. w is -2 times the plane
+// distance, the threshold for the doubled centers and extents.
+struct CullingPlanes {
+  Mn::Float nx[6], ny[6], nz[6];
+  Mn::Float ax[6], ay[6], az[6];
+  Mn::Float w[6];
+};
+
+// Same operations in the same order as rangeFrustum(), so both agree even
+// for boxes touching a plane
+inline bool isOutside(Mn::Float cx,
+                      Mn::Float cy,
+                      Mn::Float cz,
+                      Mn::Float ex,
+                      Mn::Float ey,
+                      Mn::Float ez,
+                      Mn::Float nx,
+                      Mn::Float ny,
+                      Mn::Float nz,
+                      Mn::Float ax,
+                      Mn::Float ay,
+                      Mn::Float az,
+                      Mn::Float w) {
+  const Mn::Float d = cx * nx + cy * ny + cz * nz;
+  const Mn::Float r = ex * ax + ey * ay + ez * az;
+  return d + r < w;
+}
+
+/* Clang doesn't have target_clones yet: https://reviews.llvm.org/D51650 */
+#if defined(CORRADE_TARGET_X86) && defined(__GNUC__) && __GNUC__ >= 6
+__attribute__((target_clones("default", "sse4.2", "avx2")))
+#endif
+std::size_t cullAABBRange(const CullingPlanes& planes,
+                          const AABBArrays& aabbs,
+                          std::size_t begin,
+                          std::size_t end,
+                          Mn::UnsignedByte* planeIndices,
+                          Mn::UnsignedByte* visible) {
+  // doubled box centers and extents of a block
+  Mn::Float cx[BlockSize], cy[BlockSize], cz[BlockSize];
+  Mn::Float ex[BlockSize], ey[BlockSize], ez[BlockSize];
+  // bit p set if plane p culls the box
+  std::uint32_t masks[BlockSize];
+
+  std::size_t numVisible = 0;
+  for (std::size_t blockBegin = begin; blockBegin < end;
+       blockBegin += BlockSize) {
+    const std::size_t count = std::min(BlockSize, end - blockBegin);
+    const Mn::Float* minX = aabbs.minX.data() + blockBegin;
+    const Mn::Float* minY = aabbs.minY.data() + blockBegin;
+    const Mn::Float* minZ = aabbs.minZ.data() + blockBegin;
+    const Mn::Float* maxX = aabbs.maxX.data() + blockBegin;
+    const Mn::Float* maxY = aabbs.maxY.data() + blockBegin;
+    const Mn::Float* maxZ = aabbs.maxZ.data() + blockBegin;
+    Mn::UnsignedByte* blockPlaneIndices = planeIndices + blockBegin;
+    Mn::UnsignedByte* blockVisible = visible + blockBegin;
+
+    for (std::size_t i = 0; i != count; ++i) {
+      cx[i] = minX[i] + maxX[i];
+      cy[i] = minY[i] + maxY[i];
+      cz[i] = minZ[i] + maxZ[i];
+      ex[i] = maxX[i] - minX[i];
+      ey[i] = maxY[i] - minY[i];
+      ez[i] = maxZ[i] - minZ[i];
+    }
+
+    // Temporal coherence: the plane that culled a box last frame likely
+    // still does. If it culls the whole block, the other planes are skipped.
+    std::size_t numCulledByLast = 0;
+    for (std::size_t i = 0; i != count; ++i) {
+      const unsigned int p = blockPlaneIndices[i];
+      const bool outside =
+          isOutside(cx[i], cy[i], cz[i], ex[i], ey[i], ez[i], planes.nx[p],
+                    planes.ny[p], planes.nz[p], planes.ax[p], planes.ay[p],
+                    planes.az[p], planes.w[p]);
+      masks[i] = std::uint32_t(outside) << p;
+      numCulledByLast += outside;
+    }
+    if (numCulledByLast == count) {
+      std::fill_n(blockVisible, count, Mn::UnsignedByte(0));
+      continue;
+    }
+
+    // All six planes, branch free so each plane vectorizes over the boxes
+    for (unsigned int p = 0; p != 6; ++p) {
+      const Mn::Float nx = planes.nx[p], ny = planes.ny[p], nz = planes.nz[p];
+      const Mn::Float ax = planes.ax[p], ay = planes.ay[p], az = planes.az[p];
+      const Mn::Float w = planes.w[p];
+      for (std::size_t i = 0; i != count; ++i) {
+        masks[i] |= std::uint32_t(isOutside(cx[i], cy[i], cz[i], ex[i], ey[i],
+                                            ez[i], nx, ny, nz, ax, ay, az, w))
+                    << p;
+      }
+    }
+
+    for (std::size_t i = 0; i != count; ++i) {
+      const std::uint32_t mask = masks[i];
+      if (!mask) {
+        blockVisible[i] = 1;
+        ++numVisible;
+        continue;
+      }
+      blockVisible[i] = 0;
+      // the first culling plane starting from last frame's, as
+      // rangeFrustum() reports
+      unsigned int p = blockPlaneIndices[i];
+      while (!(mask & (1u << p))) {
+        p = (p + 1) % 6;
+      }
+      blockPlaneIndices[i] = Mn::UnsignedByte(p);
+    }
+  }
+  return numVisible;
+}
+
+}  // namespace
+
+std::size_t cullAABBs(
+    const Mn::Frustum& frustum,
+    const AABBArrays& aabbs,
+    Cr::Containers::ArrayView<Mn::UnsignedByte> frustumPlaneIndices,
+    Cr::Containers::ArrayView<Mn::UnsignedByte> visible,
+    unsigned int maxThreads) {
+  const std::size_t count = aabbs.size();
+  CORRADE_ASSERT(frustumPlaneIndices.size() >= count && visible.size() >= count,
+                 "gfx::cullAABBs(): expected" << count
+                     << "plane indices and visibilities but got"
+                     << frustumPlaneIndices.size() << "and" << visible.size(),
+                 0);
+
+  CullingPlanes planes;
+  for (unsigned int p = 0; p != 6; ++p) {
+    const Mn::Vector4& plane = frustum[p];
+    planes.nx[p] = plane.x();
+    planes.ny[p] = plane.y();
+    planes.nz[p] = plane.z();
+    planes.ax[p] = Mn::Math::abs(plane.x());
+    planes.ay[p] = Mn::Math::abs(plane.y());
+    planes.az[p] = Mn::Math::abs(plane.z());
+    planes.w[p] = -2.0f * plane.w();
+  }
+
+  const std::size_t numChunks =
+      (count + ParallelChunkSize - 1) / ParallelChunkSize;
+  if (numChunks <= 1) {
+    return cullAABBRange(planes, aabbs, 0, count, frustumPlaneIndices.data(),
+                         visible.data());
+  }
+
+  std::vector<std::size_t> numVisible(numChunks);
+  core::parallelFor(
+      numChunks, core::numWorkerThreads(numChunks, maxThreads),
+      [&](unsigned int, std::size_t chunk) {
+        const std::size_t begin = chunk * ParallelChunkSize;
+        numVisible[chunk] = cullAABBRange(
+            planes, aabbs, begin, std::min(begin + ParallelChunkSize, count),
+            frustumPlaneIndices.data(), visible.data());
+      });
+  return std::accumulate(numVisible.begin(), numVisible.end(),
+                         std::size_t{0});
+}
+
+}  // namespace gfx
+}  // namespace esp
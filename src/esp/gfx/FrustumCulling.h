@@ -0,0 +1,93 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_FRUSTUMCULLING_H_
+#define ESP_GFX_FRUSTUMCULLING_H_
+
+/** @file
+ * @brief Frustum culling of axis-aligned bounding boxes, one at a time with
+ * @ref esp::gfx::rangeFrustum() or in bulk with @ref esp::gfx::cullAABBs()
+ */
+
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/Math/Range.h>
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief do frustum culling with temporal coherence
+ * @param range, the axis-aligned bounding box
+ * @param frustum, the frustum
+ * @param frustumPlaneIndex, the frustum plane in last frame that culled the
+ * aabb (default: 0)
+ * @return NullOpt if aabb intersects the frustum, otherwise the fustum plane
+ * that culls the aabb
+ */
+Corrade::Containers::Optional<int> rangeFrustum(const Magnum::Range3D& range,
+                                                const Magnum::Frustum& frustum,
+                                                int frustumPlaneIndex = 0);
+
+/**
+ * @brief Axis-aligned bounding boxes in a structure-of-arrays layout
+ *
+ * Every corner coordinate is stored in its own contiguous array, so
+ * @ref cullAABBs() tests consecutive boxes against a plane at full SIMD
+ * width.
+ */
+struct AABBArrays {
+  /** @brief Number of boxes */
+  std::size_t size() const { return minX.size(); }
+
+  /** @brief Sets the number of boxes, shrinking keeps the allocation */
+  void resize(std::size_t size);
+
+  /** @brief Sets box @p i */
+  void set(std::size_t i, const Magnum::Range3D& range) {
+    minX[i] = range.min().x();
+    minY[i] = range.min().y();
+    minZ[i] = range.min().z();
+    maxX[i] = range.max().x();
+    maxY[i] = range.max().y();
+    maxZ[i] = range.max().z();
+  }
+
+  std::vector<Magnum::Float> minX, minY, minZ, maxX, maxY, maxZ;
+};
+
+/**
+ * @brief Culls a list of boxes against a frustum at once
+ * @param frustum              The frustum
+ * @param aabbs                Boxes to cull
+ * @param frustumPlaneIndices  For every box, the frustum plane that culled it
+ *    last time. Updated for the boxes culled now.
+ * @param visible              Set to 1 for every box intersecting the
+ *    frustum and 0 for every culled one
+ * @param maxThreads           Upper bound on the number of threads, 0 means
+ *    std::thread::hardware_concurrency(). Only lists of tens of thousands
+ *    of boxes are worth splitting and are split.
+ * @return The number of visible boxes
+ *
+ * Gives the same results as @ref rangeFrustum() called on every box. Boxes
+ * are tested in blocks: first every box against the plane that culled it
+ * last time, then, unless that culled all of them, every box against all six
+ * planes, without branches, eight boxes at a time with AVX2. Static scenes
+ * thus keep the benefit of the temporal coherence.
+ */
+std::size_t cullAABBs(
+    const Magnum::Frustum& frustum,
+    const AABBArrays& aabbs,
+    Corrade::Containers::ArrayView<Magnum::UnsignedByte> frustumPlaneIndices,
+    Corrade::Containers::ArrayView<Magnum::UnsignedByte> visible,
+    unsigned int maxThreads = 0);
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_FRUSTUMCULLING_H_
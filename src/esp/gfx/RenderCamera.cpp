@@ -9,8 +9,10 @@
 #include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/SceneGraph/Drawable.h>
+#include "esp/core/Profiler.h"
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/DrawableGroup.h"
+#include "esp/gfx/FrustumCulling.h"
 #include "esp/scene/SceneGraph.h"
 
 namespace Mn = Magnum;
@@ -19,36 +21,6 @@ namespace Cr = Corrade;
 namespace esp {
 namespace gfx {
 
-/**
- * @brief do frustum culling with temporal coherence
- * @param range, the axis-aligned bounding box
- * @param frustum, the frustum
- * @param frustumPlaneIndex, the frustum plane in last frame that culled the
- * aabb (default: 0)
- * @return NullOpt if aabb intersects the frustum, otherwise the fustum plane
- * that culls the aabb
- */
-Cr::Containers::Optional<int> rangeFrustum(const Mn::Range3D& range,
-                                           const Mn::Frustum& frustum,
-                                           int frustumPlaneIndex = 0) {
-  const Mn::Vector3 center = range.min() + range.max();
-  const Mn::Vector3 extent = range.max() - range.min();
-
-  for (int iPlane = 0; iPlane < 6; ++iPlane) {
-    int index = (iPlane + frustumPlaneIndex) % 6;
-    const Mn::Vector4& plane = frustum[index];
-
-    const Mn::Vector3 absPlaneNormal = Mn::Math::abs(plane.xyz());
-
-    const float d = Mn::Math::dot(center, plane.xyz());
-    const float r = Mn::Math::dot(extent, absPlaneNormal);
-    if (d + r < -2.0 * plane.w())
-      return Cr::Containers::Optional<int>{index};
-  }
-
-  return Cr::Containers::NullOpt;
-}
-
 RenderCamera::RenderCamera(scene::SceneNode& node) : MagnumCamera{node} {
   node.setType(scene::SceneNodeType::CAMERA);
   setAspectRatioPolicy(Mn::SceneGraph::AspectRatioPolicy::NotPreserved);
@@ -110,30 +82,46 @@ RenderCamera& RenderCamera::setOrthoProjectionMatrix(int width,
 size_t RenderCamera::cull(
     std::vector<std::pair<std::reference_wrapper<Mn::SceneGraph::Drawable3D>,
                           Mn::Matrix4>>& drawableTransforms) {
+  ESP_PROFILE_SCOPE("RenderCamera::cull");
   // camera frustum relative to world origin
   const Mn::Frustum frustum =
       Mn::Frustum::fromMatrix(projectionMatrix() * cameraMatrix());
 
-  auto newEndIter = std::remove_if(
-      drawableTransforms.begin(), drawableTransforms.end(),
-      [&](const std::pair<std::reference_wrapper<Mn::SceneGraph::Drawable3D>,
-                          Mn::Matrix4>& a) {
-        // obtain the absolute aabb
-        auto& node = static_cast<scene::SceneNode&>(a.first.get().object());
-        // This updates the AABB for dynamic objects if needed
-        node.setClean();
-        const Mn::Range3D& aabb = node.getAbsoluteAABB();
-
-        Cr::Containers::Optional<int> culledPlane =
-            rangeFrustum(aabb, frustum, node.getFrustumPlaneIndex());
-        if (culledPlane) {
-          node.setFrustumPlaneIndex(*culledPlane);
-        }
-        // if it has value, it means the aabb is culled
-        return (culledPlane != Cr::Containers::NullOpt);
-      });
+  // gather the absolute aabbs in a layout the culling vectorizes over
+  const size_t count = drawableTransforms.size();
+  cullingAABBs_.resize(count);
+  cullingPlaneIndices_.resize(count);
+  cullingVisible_.resize(count);
+  for (size_t i = 0; i != count; ++i) {
+    auto& node = static_cast<scene::SceneNode&>(
+        drawableTransforms[i].first.get().object());
+    // This updates the AABB for dynamic objects if needed
+    node.setClean();
+    cullingAABBs_.set(i, node.getAbsoluteAABB());
+    cullingPlaneIndices_[i] = node.getFrustumPlaneIndex();
+  }
 
-  return (newEndIter - drawableTransforms.begin());
+  const size_t numVisible = cullAABBs(
+      frustum, cullingAABBs_, {cullingPlaneIndices_.data(), count},
+      {cullingVisible_.data(), count});
+
+  // move the visible ones to the front, keeping their order, and remember
+  // which plane culled the others
+  size_t end = 0;
+  for (size_t i = 0; i != count; ++i) {
+    if (cullingVisible_[i]) {
+      if (end != i) {
+        drawableTransforms[end] = drawableTransforms[i];
+      }
+      ++end;
+    } else {
+      static_cast<scene::SceneNode&>(drawableTransforms[i].first.get().object())
+          .setFrustumPlaneIndex(cullingPlaneIndices_[i]);
+    }
+  }
+  CORRADE_INTERNAL_ASSERT(end == numVisible);
+
+  return numVisible;
 }
 
 size_t RenderCamera::removeNonObjects(
@@ -154,19 +142,24 @@ size_t RenderCamera::removeNonObjects(
 }
 
 uint32_t RenderCamera::draw(MagnumDrawableGroup& drawables, Flags flags) {
-  previousNumVisibleDrawables_ = drawables.size();
   if (flags == Flags()) {  // empty set
+    previousNumVisibleDrawables_ = drawables.size();
     MagnumCamera::draw(drawables);
     return drawables.size();
   }
 
-  if (flags & Flag::UseDrawableIdAsObjectId) {
-    useDrawableIds_ = true;
+  DrawableTransforms drawableTransforms = visibleDrawables(drawables, flags);
+  uint32_t numDrawn = draw(drawableTransforms, flags);
+  if (!(flags & Flag::FrustumCulling)) {
+    previousNumVisibleDrawables_ = drawables.size();
   }
+  return numDrawn;
+}
 
-  std::vector<std::pair<std::reference_wrapper<Mn::SceneGraph::Drawable3D>,
-                        Mn::Matrix4>>
-      drawableTransforms = drawableTransformations(drawables);
+RenderCamera::DrawableTransforms RenderCamera::visibleDrawables(
+    MagnumDrawableGroup& drawables,
+    Flags flags) {
+  DrawableTransforms drawableTransforms = drawableTransformations(drawables);
 
   if (flags & Flag::ObjectsOnly) {
     // draw just the OBJECTS
@@ -177,11 +170,21 @@ uint32_t RenderCamera::draw(MagnumDrawableGroup& drawables, Flags flags) {
 
   if (flags & Flag::FrustumCulling) {
     // draw just the visible part
-    previousNumVisibleDrawables_ = cull(drawableTransforms);
+    size_t numVisible = cull(drawableTransforms);
     // erase all items that did not pass the frustum visibility test
-    drawableTransforms.erase(
-        drawableTransforms.begin() + previousNumVisibleDrawables_,
-        drawableTransforms.end());
+    drawableTransforms.erase(drawableTransforms.begin() + numVisible,
+                             drawableTransforms.end());
+  }
+  return drawableTransforms;
+}
+
+uint32_t RenderCamera::draw(DrawableTransforms& drawableTransforms,
+                            Flags flags) {
+  ESP_PROFILE_SCOPE("RenderCamera::draw");
+  previousNumVisibleDrawables_ = drawableTransforms.size();
+
+  if (flags & Flag::UseDrawableIdAsObjectId) {
+    useDrawableIds_ = true;
   }
 
   MagnumCamera::draw(drawableTransforms);
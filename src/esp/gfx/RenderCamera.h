@@ -9,6 +9,7 @@
 
 #include "esp/core/esp.h"
 #include "esp/geo/geo.h"
+#include "esp/gfx/FrustumCulling.h"
 #include "esp/scene/SceneNode.h"
 
 namespace esp {
@@ -43,6 +44,14 @@ class RenderCamera : public MagnumCamera {
   typedef Corrade::Containers::EnumSet<Flag> Flags;
   CORRADE_ENUMSET_FRIEND_OPERATORS(Flags)
 
+  /**
+   * @brief Drawables paired with their transformation relative to the camera
+   */
+  typedef std::vector<
+      std::pair<std::reference_wrapper<Magnum::SceneGraph::Drawable3D>,
+                Magnum::Matrix4>>
+      DrawableTransforms;
+
   /**
    * @brief Constructor
    * @param node, the scene node to which the camera is attached
@@ -150,6 +159,31 @@ class RenderCamera : public MagnumCamera {
    */
   uint32_t draw(MagnumDrawableGroup& drawables, Flags flags = {});
 
+  /**
+   * @brief Collects the drawables the next draw pass would render
+   * @param drawables, a drawable group containing all the drawables
+   * @param flags, @ref Flag::ObjectsOnly and @ref Flag::FrustumCulling are
+   * applied here
+   * @return the remaining drawables and their camera relative transformation
+   *
+   * The result only depends on the camera transformation and projection, so
+   * it can be drawn by any camera with the same ones, see
+   * @ref draw(DrawableTransforms&, Flags).
+   */
+  DrawableTransforms visibleDrawables(MagnumDrawableGroup& drawables,
+                                      Flags flags);
+
+  /**
+   * @brief Overload function to render a list of drawables computed by
+   * @ref visibleDrawables()
+   * @param drawableTransforms, drawables and their camera relative
+   * transformation
+   * @param flags, only @ref Flag::UseDrawableIdAsObjectId is used, the list
+   * is not culled again
+   * @return the number of drawables that are drawn
+   */
+  uint32_t draw(DrawableTransforms& drawableTransforms, Flags flags = {});
+
   /**
    * @brief performs the frustum culling
    * @param drawableTransforms, a vector of pairs of Drawable3D object and its
@@ -207,6 +241,11 @@ class RenderCamera : public MagnumCamera {
  protected:
   size_t previousNumVisibleDrawables_ = 0;
   bool useDrawableIds_ = false;
+
+  // scratch space of cull(), kept to not allocate every frame
+  AABBArrays cullingAABBs_;
+  std::vector<Magnum::UnsignedByte> cullingPlaneIndices_;
+  std::vector<Magnum::UnsignedByte> cullingVisible_;
   ESP_SMART_POINTERS(RenderCamera)
 };
 
@@ -2,6 +2,8 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/BufferImage.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
@@ -20,8 +22,11 @@
 #include "RenderTarget.h"
 #include "magnum.h"
 
+#include "esp/core/Profiler.h"
 #include "esp/gfx/DepthUnprojection.h"
 
+#include <cstring>
+
 #ifdef ESP_BUILD_WITH_CUDA
 #include <cuda_gl_interop.h>
 #include <cuda_runtime.h>
@@ -195,12 +200,25 @@ struct RenderTarget::Impl {
       depthUnprojectionFrameBuffer_.mapForRead(UnprojectedDepthBuffer)
           .read(framebuffer_.viewport(), view);
     } else {
+      // Float output is processed in place, smaller formats need the raw
+      // depth elsewhere first
+      Cr::Containers::ArrayView<void> depth = view.data();
+      if (depthProcessing_.format != DepthFormat::Float) {
+        const std::size_t depthSize =
+            std::size_t(view.size().product()) * sizeof(Mn::Float);
+        if (depthScratch_.size() != depthSize) {
+          depthScratch_ = Cr::Containers::Array<char>{depthSize};
+        }
+        depth = depthScratch_;
+      }
       Mn::MutableImageView2D depthBufferView{
           Mn::GL::PixelFormat::DepthComponent, Mn::GL::PixelType::Float,
-          view.size(), view.data()};
+          view.size(), depth};
       framebuffer_.read(framebuffer_.viewport(), depthBufferView);
-      unprojectDepth(depthUnprojection_,
-                     Cr::Containers::arrayCast<Mn::Float>(view.data()));
+      unprojectDepth(depthUnprojection_, depthProcessing_,
+                     Cr::Containers::arrayCast<const Mn::Float>(
+                         depthBufferView.data()),
+                     view.data());
     }
   }
 
@@ -217,6 +235,113 @@ struct RenderTarget::Impl {
     return framebuffer_.viewport().size();
   }
 
+  void setDepthUnprojection(const Mn::Vector2& depthUnprojection) {
+    depthUnprojection_ = depthUnprojection;
+  }
+
+  Flags flags() const { return flags_; }
+
+  DepthShader* depthShader() const { return depthShader_; }
+
+  void setDepthProcessing(const DepthProcessing& processing) {
+    CORRADE_ASSERT(processing == DepthProcessing{} || !depthShader_,
+                   "RenderTarget::Impl::setDepthProcessing(): depth post "
+                   "processing needs depth to be unprojected on the CPU", );
+    depthProcessing_ = processing;
+  }
+
+  const DepthProcessing& depthProcessing() const { return depthProcessing_; }
+
+#ifndef MAGNUM_TARGET_WEBGL
+  void readFrameRgbaAsync() {
+    CORRADE_ASSERT(
+        flags_ & Flag::RgbaBuffer,
+        "RenderTarget::Impl::readFrameRgbaAsync(): this render target "
+        "was not created with rgba render buffer enabled.", );
+
+    framebuffer_.mapForRead(RgbaBuffer)
+        .read(framebuffer_.viewport(),
+              readbackImage(Mn::GL::PixelFormat::RGBA,
+                            Mn::GL::PixelType::UnsignedByte),
+              Mn::GL::BufferUsage::StreamRead);
+    asyncRead_ = AsyncRead::Pixels;
+  }
+
+  void readFrameDepthAsync() {
+    CORRADE_ASSERT(
+        flags_ & Flag::DepthTexture,
+        "RenderTarget::Impl::readFrameDepthAsync(): this render target "
+        "was not created with depth texture enabled.", );
+    if (depthShader_) {
+      unprojectDepthGPU();
+      depthUnprojectionFrameBuffer_.mapForRead(UnprojectedDepthBuffer)
+          .read(framebuffer_.viewport(),
+                readbackImage(Mn::GL::PixelFormat::Red,
+                              Mn::GL::PixelType::Float),
+                Mn::GL::BufferUsage::StreamRead);
+      asyncRead_ = AsyncRead::Pixels;
+    } else {
+      framebuffer_.read(framebuffer_.viewport(),
+                        readbackImage(Mn::GL::PixelFormat::DepthComponent,
+                                      Mn::GL::PixelType::Float),
+                        Mn::GL::BufferUsage::StreamRead);
+      asyncRead_ = AsyncRead::ProjectedDepth;
+    }
+  }
+
+  void readFrameObjectIdAsync() {
+    CORRADE_ASSERT(
+        flags_ & Flag::ObjectIdBuffer,
+        "RenderTarget::Impl::readFrameObjectIdAsync(): this render target "
+        "was not created with objectId render buffer enabled.", );
+
+    framebuffer_.mapForRead(ObjectIdBuffer)
+        .read(framebuffer_.viewport(),
+              readbackImage(Mn::GL::PixelFormat::RedInteger,
+                            Mn::GL::PixelType::UnsignedInt),
+              Mn::GL::BufferUsage::StreamRead);
+    asyncRead_ = AsyncRead::Pixels;
+  }
+
+  void mapReadFrame() {
+    CORRADE_ASSERT(asyncRead_ != AsyncRead::None,
+                   "RenderTarget::Impl::mapReadFrame(): no read in flight", );
+
+    mappedFrame_ = readbackImage_->buffer().map(
+        0, readbackImage_->dataSize(), Mn::GL::Buffer::MapFlag::Read);
+  }
+
+  void copyReadFrame(const Mn::MutableImageView2D& view) const {
+    CORRADE_ASSERT(mappedFrame_,
+                   "RenderTarget::Impl::copyReadFrame(): no frame mapped", );
+    // Unprojected straight out of the mapped memory, the output size is
+    // checked by unprojectDepth()
+    if (asyncRead_ == AsyncRead::ProjectedDepth) {
+      unprojectDepth(depthUnprojection_, depthProcessing_,
+                     Cr::Containers::arrayCast<const Mn::Float>(mappedFrame_),
+                     view.data());
+      return;
+    }
+
+    // All read formats have four byte pixels, so the rows are tightly packed
+    // and land at the front of the view, as with the synchronous reads
+    CORRADE_ASSERT(view.data().size() >= mappedFrame_.size(),
+                   "RenderTarget::Impl::copyReadFrame(): expected a view of"
+                       << mappedFrame_.size() << "bytes but got"
+                       << view.data().size(), );
+
+    std::memcpy(view.data(), mappedFrame_.data(), mappedFrame_.size());
+  }
+
+  void unmapReadFrame() {
+    if (mappedFrame_) {
+      readbackImage_->buffer().unmap();
+      mappedFrame_ = nullptr;
+    }
+    asyncRead_ = AsyncRead::None;
+  }
+#endif
+
 #ifdef ESP_BUILD_WITH_CUDA
   void readFrameRgbaGPU(uint8_t* devPtr) {
     // TODO: Consider implementing the GPU read functions with EGLImage
@@ -314,6 +439,9 @@ struct RenderTarget::Impl {
   Mn::GL::Framebuffer framebuffer_;
 
   Mn::Vector2 depthUnprojection_;
+  DepthProcessing depthProcessing_;
+  // raw depth of the CPU path when the output format is smaller than it
+  Cr::Containers::Array<char> depthScratch_;
   DepthShader* depthShader_;
   Mn::GL::Renderbuffer unprojectedDepth_;
   Mn::GL::Mesh depthUnprojectionMesh_;
@@ -321,6 +449,30 @@ struct RenderTarget::Impl {
 
   Flags flags_;
 
+#ifndef MAGNUM_TARGET_WEBGL
+  // Pixel buffer for the asynchronous reads. Reallocated only if the format
+  // changes, which it doesn't for a render target used by a single sensor.
+  Mn::GL::BufferImage2D& readbackImage(Mn::GL::PixelFormat format,
+                                       Mn::GL::PixelType type) {
+    if (!readbackImage_ || readbackImage_->format() != format ||
+        readbackImage_->type() != type) {
+      readbackImage_.emplace(format, type);
+    }
+    return *readbackImage_;
+  }
+
+  enum class AsyncRead {
+    None,
+    //! Read pixels are copied as they are
+    Pixels,
+    //! Read pixels are depth buffer values still to be unprojected
+    ProjectedDepth
+  };
+  AsyncRead asyncRead_ = AsyncRead::None;
+  Cr::Containers::Optional<Mn::GL::BufferImage2D> readbackImage_;
+  Cr::Containers::ArrayView<char> mappedFrame_;
+#endif
+
 #ifdef ESP_BUILD_WITH_CUDA
   cudaGraphicsResource_t colorBufferCugl_ = nullptr;
   cudaGraphicsResource_t objecIdBufferCugl_ = nullptr;
@@ -350,17 +502,48 @@ void RenderTarget::renderExit() {
 }
 
 void RenderTarget::readFrameRgba(const Mn::MutableImageView2D& view) {
+  ESP_PROFILE_SCOPE("RenderTarget::readFrameRgba");
   pimpl_->readFrameRgba(view);
 }
 
 void RenderTarget::readFrameDepth(const Mn::MutableImageView2D& view) {
+  ESP_PROFILE_SCOPE("RenderTarget::readFrameDepth");
   pimpl_->readFrameDepth(view);
 }
 
 void RenderTarget::readFrameObjectId(const Mn::MutableImageView2D& view) {
+  ESP_PROFILE_SCOPE("RenderTarget::readFrameObjectId");
   pimpl_->readFrameObjectId(view);
 }
 
+#ifndef MAGNUM_TARGET_WEBGL
+void RenderTarget::readFrameRgbaAsync() {
+  pimpl_->readFrameRgbaAsync();
+}
+
+void RenderTarget::readFrameDepthAsync() {
+  pimpl_->readFrameDepthAsync();
+}
+
+void RenderTarget::readFrameObjectIdAsync() {
+  pimpl_->readFrameObjectIdAsync();
+}
+
+void RenderTarget::mapReadFrame() {
+  ESP_PROFILE_SCOPE("RenderTarget::mapReadFrame");
+  pimpl_->mapReadFrame();
+}
+
+void RenderTarget::copyReadFrame(const Mn::MutableImageView2D& view) const {
+  ESP_PROFILE_SCOPE("RenderTarget::copyReadFrame");
+  pimpl_->copyReadFrame(view);
+}
+
+void RenderTarget::unmapReadFrame() {
+  pimpl_->unmapReadFrame();
+}
+#endif
+
 void RenderTarget::blitRgbaToDefault() {
   pimpl_->blitRgbaToDefault();
 }
@@ -369,6 +552,26 @@ Mn::Vector2i RenderTarget::framebufferSize() const {
   return pimpl_->framebufferSize();
 }
 
+void RenderTarget::setDepthUnprojection(const Mn::Vector2& depthUnprojection) {
+  pimpl_->setDepthUnprojection(depthUnprojection);
+}
+
+RenderTarget::Flags RenderTarget::flags() const {
+  return pimpl_->flags();
+}
+
+DepthShader* RenderTarget::depthShader() const {
+  return pimpl_->depthShader();
+}
+
+void RenderTarget::setDepthProcessing(const DepthProcessing& processing) {
+  pimpl_->setDepthProcessing(processing);
+}
+
+const DepthProcessing& RenderTarget::depthProcessing() const {
+  return pimpl_->depthProcessing();
+}
+
 #ifdef ESP_BUILD_WITH_CUDA
 void RenderTarget::readFrameRgbaGPU(uint8_t* devPtr) {
   pimpl_->readFrameRgbaGPU(devPtr);
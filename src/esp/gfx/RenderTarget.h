@@ -103,6 +103,40 @@ class RenderTarget {
    */
   Magnum::Vector2i framebufferSize() const;
 
+  /**
+   * @brief The flags the render target was created with
+   */
+  Flags flags() const;
+
+  /**
+   * @brief The DepthShader unprojecting depth on the GPU, nullptr if depth is
+   * unprojected on the CPU
+   */
+  DepthShader* depthShader() const;
+
+  /**
+   * @brief Sets the depth unprojection parameters, e.g. when the target is
+   * reused for a sensor with a different projection. See @ref
+   * calculateDepthUnprojection()
+   */
+  void setDepthUnprojection(const Magnum::Vector2& depthUnprojection);
+
+  /**
+   * @brief Sets the clipping, normalization and output format applied while
+   * depth is unprojected, see @ref unprojectDepth()
+   *
+   * Expects the render target to unproject depth on the CPU, i.e. to have
+   * been created without a DepthShader, unless @p processing is the default.
+   * The views passed to @ref readFrameDepth() and @ref copyReadFrame() are
+   * then expected in @ref DepthProcessing::format.
+   */
+  void setDepthProcessing(const DepthProcessing& processing);
+
+  /**
+   * @brief The depth post processing set with @ref setDepthProcessing()
+   */
+  const DepthProcessing& depthProcessing() const;
+
   /**
    * @brief Retrieve the RGBA rendering results.
    *
@@ -116,7 +150,8 @@ class RenderTarget {
    *
    * @param[in, out] view Preallocated memory that will be populated with the
    * result.  The PixelFormat of the image must only specify the R channel,
-   * generally @ref Magnum::PixelFormat::R32F
+   * generally @ref Magnum::PixelFormat::R32F, or match
+   * @ref depthProcessing()
    */
   void readFrameDepth(const Magnum::MutableImageView2D& view);
 
@@ -132,6 +167,52 @@ class RenderTarget {
    */
   void readFrameObjectId(const Magnum::MutableImageView2D& view);
 
+#ifndef MAGNUM_TARGET_WEBGL
+  /**
+   * @brief Starts reading the RGBA rendering results into a pixel buffer
+   * owned by this render target without waiting for the GPU.
+   *
+   * Only one asynchronous read can be in flight per render target. Retrieve
+   * the result with @ref mapReadFrame(), @ref copyReadFrame() and @ref
+   * unmapReadFrame().
+   */
+  void readFrameRgbaAsync();
+
+  /**
+   * @brief Starts reading the depth rendering results without waiting for
+   * the GPU. See @ref readFrameRgbaAsync().
+   */
+  void readFrameDepthAsync();
+
+  /**
+   * @brief Starts reading the ObjectID rendering results without waiting for
+   * the GPU. See @ref readFrameRgbaAsync().
+   */
+  void readFrameObjectIdAsync();
+
+  /**
+   * @brief Waits for the read started by one of the readFrame*Async()
+   * functions and maps the pixel buffer into CPU memory.
+   */
+  void mapReadFrame();
+
+  /**
+   * @brief Copies the pixels mapped by @ref mapReadFrame() into @p view.
+   *
+   * Depth is unprojected on the CPU here if there is no DepthShader. Makes no
+   * GL calls, so it can run on any thread until @ref unmapReadFrame().
+   *
+   * @param[in, out] view Preallocated memory in the pixel format the
+   * corresponding synchronous read function expects
+   */
+  void copyReadFrame(const Magnum::MutableImageView2D& view) const;
+
+  /**
+   * @brief Unmaps the pixel buffer mapped by @ref mapReadFrame().
+   */
+  void unmapReadFrame();
+#endif
+
   /**
    * @brief Blits the rgba buffer from internal FBO to default frame buffer
    * which in case of EmscriptenApplication will be a canvas element.
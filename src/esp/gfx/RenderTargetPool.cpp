@@ -0,0 +1,59 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RenderTargetPool.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+RenderTarget::uptr RenderTargetPool::acquire(
+    const Mn::Vector2i& size,
+    const Mn::Vector2& depthUnprojection,
+    DepthShader* depthShader,
+    RenderTarget::Flags flags,
+    const DepthProcessing& depthProcessing) {
+  RenderTarget::uptr target = nullptr;
+  auto found = freeTargets_.find(
+      Key{size.x(), size.y(), RenderTarget::Flags::UnderlyingType(flags),
+          depthShader});
+  if (found != freeTargets_.end() && !found->second.empty()) {
+    target = std::move(found->second.back());
+    found->second.pop_back();
+    target->setDepthUnprojection(depthUnprojection);
+  } else {
+    target = RenderTarget::create_unique(size, depthUnprojection, depthShader,
+                                         flags);
+    ++numAllocated_;
+  }
+  target->setDepthProcessing(depthProcessing);
+  return target;
+}
+
+void RenderTargetPool::release(RenderTarget::uptr&& target) {
+  if (!target) {
+    return;
+  }
+#ifndef MAGNUM_TARGET_WEBGL
+  // a readback still in flight would be mapped by the next sensor
+  target->unmapReadFrame();
+#endif
+  const Mn::Vector2i size = target->framebufferSize();
+  freeTargets_[Key{size.x(), size.y(),
+                   RenderTarget::Flags::UnderlyingType(target->flags()),
+                   target->depthShader()}]
+      .push_back(std::move(target));
+}
+
+size_t RenderTargetPool::numFree() const {
+  size_t count = 0;
+  for (const auto& it : freeTargets_) {
+    count += it.second.size();
+  }
+  return count;
+}
+
+}  // namespace gfx
+}  // namespace esp
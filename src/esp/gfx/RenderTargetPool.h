@@ -0,0 +1,74 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_RENDERTARGETPOOL_H_
+#define ESP_GFX_RENDERTARGETPOOL_H_
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "esp/core/esp.h"
+#include "esp/gfx/RenderTarget.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Keeps render targets that are no longer bound to a sensor, so the
+ * next sensor of the same shape reuses their framebuffer and renderbuffers
+ * instead of allocating new ones.
+ *
+ * Targets are keyed by size, flags and whether depth is unprojected on the
+ * GPU. Removing and adding sensors, or changing their resolution on
+ * reconfigure, thus only allocates GL objects for shapes not seen before.
+ *
+ * Not thread safe, acquire and release on the GL thread.
+ */
+class RenderTargetPool {
+ public:
+  RenderTargetPool() = default;
+
+  /**
+   * @brief Returns a released render target matching @p size, @p flags and
+   * @p depthShader, or a new one if there is none
+   *
+   * The target is set up for @p depthUnprojection and @p depthProcessing
+   * either way.
+   */
+  RenderTarget::uptr acquire(const Magnum::Vector2i& size,
+                             const Magnum::Vector2& depthUnprojection,
+                             DepthShader* depthShader,
+                             RenderTarget::Flags flags,
+                             const DepthProcessing& depthProcessing = {});
+
+  /**
+   * @brief Gives a render target back for the next @ref acquire() of the
+   * same shape. A readback still mapped is dropped.
+   */
+  void release(RenderTarget::uptr&& target);
+
+  /** @brief Number of released targets waiting to be reused */
+  size_t numFree() const;
+
+  /** @brief Number of targets allocated by @ref acquire() so far */
+  size_t numAllocated() const { return numAllocated_; }
+
+  /** @brief Destroys all released targets */
+  void clear() { freeTargets_.clear(); }
+
+ private:
+  // size, flags and whether depth is unprojected by depthShader
+  typedef std::tuple<int, int, int, DepthShader*> Key;
+
+  std::map<Key, std::vector<RenderTarget::uptr>> freeTargets_;
+  size_t numAllocated_ = 0;
+
+  ESP_SMART_POINTERS(RenderTargetPool)
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_RENDERTARGETPOOL_H_
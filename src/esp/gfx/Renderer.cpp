@@ -4,6 +4,8 @@
 
 #include "Renderer.h"
 
+#include <algorithm>
+
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
@@ -17,8 +19,10 @@
 #include <Magnum/Image.h>
 #include <Magnum/PixelFormat.h>
 
+#include "esp/core/Profiler.h"
 #include "esp/gfx/DepthUnprojection.h"
 #include "esp/gfx/RenderTarget.h"
+#include "esp/gfx/RenderTargetPool.h"
 #include "esp/gfx/magnum.h"
 #include "esp/sensor/VisualSensor.h"
 
@@ -28,7 +32,10 @@ namespace esp {
 namespace gfx {
 
 struct Renderer::Impl {
-  explicit Impl(Flags flags) : depthShader_{nullptr}, flags_{flags} {
+  explicit Impl(Flags flags)
+      : depthShader_{nullptr},
+        renderTargetPool_{RenderTargetPool::create()},
+        flags_{flags} {
     Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::DepthTest);
     Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
   }
@@ -37,12 +44,9 @@ struct Renderer::Impl {
   void draw(RenderCamera& camera,
             scene::SceneGraph& sceneGraph,
             RenderCamera::Flags flags) {
-    for (auto& it : sceneGraph.getDrawableGroups()) {
-      // TODO: remove || true
-      if (it.second.prepareForDraw(camera) || true) {
-        camera.draw(it.second, flags);
-      }
-    }
+    forEachPreparedGroup(camera, sceneGraph, [&](DrawableGroup& group) {
+      camera.draw(group, flags);
+    });
   }
 
   void draw(sensor::VisualSensor& visualSensor,
@@ -51,6 +55,44 @@ struct Renderer::Impl {
     draw(*visualSensor.getRenderCamera(), sceneGraph, flags);
   }
 
+  void draw(const std::vector<sensor::VisualSensor*>& visualSensors,
+            scene::SceneGraph& sceneGraph,
+            RenderCamera::Flags flags) {
+    // Group the sensors by the camera they see the scene through. Only
+    // exactly equal matrices are shared, which is the case for sensors
+    // attached with the same pose and spec.
+    std::vector<std::vector<sensor::VisualSensor*>> frustumGroups;
+    for (sensor::VisualSensor* visualSensor : visualSensors) {
+      RenderCamera& camera = *visualSensor->getRenderCamera();
+      auto sameFrustum = [&camera](
+                             const std::vector<sensor::VisualSensor*>& group) {
+        RenderCamera& groupCamera = *group.front()->getRenderCamera();
+        return groupCamera.cameraMatrix() == camera.cameraMatrix() &&
+               groupCamera.projectionMatrix() == camera.projectionMatrix();
+      };
+      auto found =
+          std::find_if(frustumGroups.begin(), frustumGroups.end(), sameFrustum);
+      if (found == frustumGroups.end()) {
+        frustumGroups.emplace_back(1, visualSensor);
+      } else {
+        found->push_back(visualSensor);
+      }
+    }
+
+    for (const std::vector<sensor::VisualSensor*>& group : frustumGroups) {
+      RenderCamera& cullingCamera = *group.front()->getRenderCamera();
+      forEachPreparedGroup(
+          cullingCamera, sceneGraph, [&](DrawableGroup& drawables) {
+            RenderCamera::DrawableTransforms drawableTransforms =
+                cullingCamera.visibleDrawables(drawables, flags);
+            for (sensor::VisualSensor* visualSensor : group) {
+              visualSensor->renderTarget().renderReEnter();
+              visualSensor->getRenderCamera()->draw(drawableTransforms, flags);
+            }
+          });
+    }
+  }
+
   void bindRenderTarget(sensor::VisualSensor& sensor) {
     auto depthUnprojection = sensor.depthUnprojection();
     CORRADE_ASSERT(depthUnprojection,
@@ -87,13 +129,40 @@ struct Renderer::Impl {
         break;
     }
 
-    sensor.bindRenderTarget(RenderTarget::create_unique(
-        sensor.framebufferSize(), *depthUnprojection, depthShader_.get(),
-        renderTargetFlags_));
+    // the current target first, so rebinding at the same size reuses it
+    sensor.releaseRenderTarget();
+    // post processed depth is unprojected on the CPU in the same pass
+    auto depthProcessing = sensor.depthProcessing();
+    sensor.bindRenderTarget(
+        renderTargetPool_->acquire(
+            sensor.framebufferSize(), *depthUnprojection,
+            depthProcessing ? nullptr : depthShader_.get(), renderTargetFlags_,
+            depthProcessing ? *depthProcessing : DepthProcessing{}),
+        renderTargetPool_);
+  }
+
+  std::shared_ptr<RenderTargetPool> renderTargetPool() {
+    return renderTargetPool_;
   }
 
  private:
+  // Calls drawFn on every drawable group of sceneGraph that is ready to be
+  // drawn with camera
+  template <class DrawFn>
+  void forEachPreparedGroup(RenderCamera& camera,
+                            scene::SceneGraph& sceneGraph,
+                            DrawFn&& drawFn) {
+    for (auto& it : sceneGraph.getDrawableGroups()) {
+      // TODO: remove || true
+      if (it.second.prepareForDraw(camera) || true) {
+        drawFn(it.second);
+      }
+    }
+  }
+
   std::unique_ptr<DepthShader> depthShader_;
+  // after the shader its targets use, so it is destroyed first
+  RenderTargetPool::ptr renderTargetPool_;
   const Flags flags_;
 };
 
@@ -103,18 +172,31 @@ Renderer::Renderer(Flags flags)
 void Renderer::draw(RenderCamera& camera,
                     scene::SceneGraph& sceneGraph,
                     RenderCamera::Flags flags) {
+  ESP_PROFILE_SCOPE("Renderer::draw");
   pimpl_->draw(camera, sceneGraph, flags);
 }
 
 void Renderer::draw(sensor::VisualSensor& visualSensor,
                     scene::SceneGraph& sceneGraph,
                     RenderCamera::Flags flags) {
+  ESP_PROFILE_SCOPE("Renderer::draw");
   pimpl_->draw(visualSensor, sceneGraph, flags);
 }
 
+void Renderer::draw(const std::vector<sensor::VisualSensor*>& visualSensors,
+                    scene::SceneGraph& sceneGraph,
+                    RenderCamera::Flags flags) {
+  ESP_PROFILE_SCOPE("Renderer::draw");
+  pimpl_->draw(visualSensors, sceneGraph, flags);
+}
+
 void Renderer::bindRenderTarget(sensor::VisualSensor& sensor) {
   pimpl_->bindRenderTarget(sensor);
 }
 
+std::shared_ptr<RenderTargetPool> Renderer::renderTargetPool() {
+  return pimpl_->renderTargetPool();
+}
+
 }  // namespace gfx
 }  // namespace esp
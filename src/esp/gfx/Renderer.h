@@ -13,6 +13,8 @@
 namespace esp {
 namespace gfx {
 
+class RenderTargetPool;
+
 class Renderer {
  public:
   enum class Flag {
@@ -43,11 +45,34 @@ class Renderer {
             scene::SceneGraph& sceneGraph,
             RenderCamera::Flags flags = {RenderCamera::Flag::FrustumCulling});
 
+  /**
+   * @brief Draw the scene graph with each of the visual sensors provided by
+   * user, into the sensor's @ref RenderTarget
+   *
+   * Culling is done once per distinct camera transformation and projection
+   * and the visible drawables are reused by every sensor sharing them, such
+   * as color, depth and semantic sensors mounted at the same pose. Each
+   * render target is bound with @ref RenderTarget::renderReEnter(), so the
+   * caller is expected to have cleared them with
+   * @ref RenderTarget::renderEnter() first.
+   */
+  void draw(const std::vector<sensor::VisualSensor*>& visualSensors,
+            scene::SceneGraph& sceneGraph,
+            RenderCamera::Flags flags = {RenderCamera::Flag::FrustumCulling});
+
   /**
    * @brief Binds a @ref RenderTarget to the sensor
+   *
+   * The target comes from @ref renderTargetPool(), and goes back to it once
+   * the sensor is rebound, e.g. after a resolution change, or destroyed.
    */
   void bindRenderTarget(sensor::VisualSensor& sensor);
 
+  /**
+   * @brief The render targets released by sensors of this renderer
+   */
+  std::shared_ptr<RenderTargetPool> renderTargetPool();
+
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(Renderer)
 };
 
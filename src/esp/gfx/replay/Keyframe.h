@@ -55,6 +55,10 @@ struct Keyframe {
   std::vector<std::pair<RenderAssetInstanceKey, RenderAssetInstanceState>>
       stateUpdates;
   std::unordered_map<std::string, Transform> userTransforms;
+  // A snapshot holds the full scene instead of changes: every loaded asset,
+  // a creation and a state update for every live instance, and no
+  // deletions. Instances it doesn't create are deleted when it is applied.
+  bool isSnapshot = false;
 };
 
 }  // namespace replay
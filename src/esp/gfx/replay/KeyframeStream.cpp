@@ -0,0 +1,605 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "KeyframeStream.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Magnum/Math/Constants.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Quaternion.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+namespace {
+
+constexpr char HeaderMagic[4] = {'H', 'S', 'K', 'F'};
+constexpr char FooterMagic[4] = {'H', 'S', 'K', 'I'};
+constexpr std::uint32_t Version = 2;
+// magic, version, translation precision, intra interval
+constexpr std::size_t HeaderSize = 16;
+// index offset, number of keyframes, magic
+constexpr std::size_t FooterSize = 16;
+
+// what a state update stores, beyond the instance key
+enum : std::uint8_t {
+  TranslationChanged = 1 << 0,
+  RotationChanged = 1 << 1,
+  SemanticIdChanged = 1 << 2,
+  AllChanged = TranslationChanged | RotationChanged | SemanticIdChanged
+};
+
+// the three smallest components of a unit quaternion are within 1/sqrt(2)
+const float RotationScale = 32767.0f * Mn::Constants::sqrt2();
+
+class Encoder {
+ public:
+  explicit Encoder(std::string& out) : out_(out) {}
+
+  // little-endian regardless of the host
+  template <class T>
+  void raw(const T& value) {
+    const T le = Cr::Utility::Endianness::littleEndian(value);
+    out_.append(reinterpret_cast<const char*>(&le), sizeof(T));
+  }
+
+  void varint(std::uint64_t value) {
+    while (value >= 0x80) {
+      out_ += char(value | 0x80);
+      value >>= 7;
+    }
+    out_ += char(value);
+  }
+
+  // zigzag, so small negative values stay short too
+  void signedVarint(std::int64_t value) {
+    varint((std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63));
+  }
+
+  void string(const std::string& value) {
+    varint(value.size());
+    out_ += value;
+  }
+
+  void vector3(const Mn::Vector3& value) {
+    raw(value.x());
+    raw(value.y());
+    raw(value.z());
+  }
+
+  void vector3(const vec3f& value) {
+    raw(value.x());
+    raw(value.y());
+    raw(value.z());
+  }
+
+ private:
+  std::string& out_;
+};
+
+// Bounds checked; once anything is out of bounds, everything after reads
+// zero and ok() is false
+class Decoder {
+ public:
+  Decoder(const char* begin, const char* end) : pos_(begin), end_(end) {}
+
+  bool ok() const { return ok_; }
+
+  bool atEnd() const { return pos_ == end_; }
+
+  template <class T>
+  T raw() {
+    T value{};
+    if (std::size_t(end_ - pos_) < sizeof(T)) {
+      ok_ = false;
+      return value;
+    }
+    std::memcpy(&value, pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return Cr::Utility::Endianness::littleEndian(value);
+  }
+
+  std::uint64_t varint() {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64 && pos_ != end_; shift += 7) {
+      const std::uint8_t byte = *pos_++;
+      value |= std::uint64_t(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  std::int64_t signedVarint() {
+    const std::uint64_t value = varint();
+    return std::int64_t(value >> 1) ^ -std::int64_t(value & 1);
+  }
+
+  // a number of elements, each taking at least a byte, so corrupted counts
+  // can't make the caller reserve huge arrays
+  std::size_t count() {
+    const std::uint64_t value = varint();
+    if (value > std::uint64_t(end_ - pos_)) {
+      ok_ = false;
+      return 0;
+    }
+    return std::size_t(value);
+  }
+
+  std::string string() {
+    const std::size_t size = count();
+    std::string value(pos_, size);
+    pos_ += size;
+    return value;
+  }
+
+  Mn::Vector3 vector3() {
+    const float x = raw<float>();
+    const float y = raw<float>();
+    const float z = raw<float>();
+    return {x, y, z};
+  }
+
+ private:
+  const char* pos_;
+  const char* end_;
+  bool ok_ = true;
+};
+
+std::int32_t quantizeTranslation(float value, float precision) {
+  const double steps = std::round(double(value) / precision);
+  return std::int32_t(
+      Mn::Math::clamp(steps, double(std::numeric_limits<std::int32_t>::min()),
+                      double(std::numeric_limits<std::int32_t>::max())));
+}
+
+QuantizedInstanceState quantize(const RenderAssetInstanceState& state,
+                                 float translationPrecision) {
+  QuantizedInstanceState quantized;
+  for (int i = 0; i != 3; ++i) {
+    quantized.translation[i] = quantizeTranslation(
+        state.absTransform.translation[i], translationPrecision);
+  }
+
+  const Mn::Quaternion& rotation = state.absTransform.rotation;
+  const float length = rotation.length();
+  const Mn::Vector4 components =
+      length > 0.0f
+          ? Mn::Vector4{rotation.vector(), rotation.scalar()} / length
+          : Mn::Vector4{0.0f, 0.0f, 0.0f, 1.0f};
+  int largest = 0;
+  for (int i = 1; i != 4; ++i) {
+    if (std::abs(components[i]) > std::abs(components[largest])) {
+      largest = i;
+    }
+  }
+  // q and -q are the same rotation, make the omitted component positive
+  const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+  for (int i = 0, j = 0; i != 4; ++i) {
+    if (i != largest) {
+      quantized.rotation[j++] = std::int16_t(std::round(Mn::Math::clamp(
+          sign * components[i] * RotationScale, -32767.0f, 32767.0f)));
+    }
+  }
+  quantized.rotationLargest = std::uint8_t(largest);
+
+  quantized.semanticId = state.semanticId;
+  return quantized;
+}
+
+RenderAssetInstanceState dequantize(const QuantizedInstanceState& quantized,
+                                    float translationPrecision) {
+  RenderAssetInstanceState state;
+  for (int i = 0; i != 3; ++i) {
+    state.absTransform.translation[i] =
+        float(double(quantized.translation[i]) * translationPrecision);
+  }
+
+  Mn::Vector4 components;
+  float sumOfSquares = 0.0f;
+  for (int i = 0, j = 0; i != 4; ++i) {
+    if (i != quantized.rotationLargest) {
+      components[i] = quantized.rotation[j++] / RotationScale;
+      sumOfSquares += components[i] * components[i];
+    }
+  }
+  components[quantized.rotationLargest] =
+      std::sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+  state.absTransform.rotation =
+      Mn::Quaternion{components.xyz(), components.w()};
+
+  state.semanticId = quantized.semanticId;
+  return state;
+}
+
+}  // namespace
+
+KeyframeStreamWriter::KeyframeStreamWriter(const std::string& filepath,
+                                           const KeyframeStreamFormat& format)
+    : file_{filepath, std::ios::binary | std::ios::trunc}, format_{format} {
+  if (!file_) {
+    LOG(ERROR) << "KeyframeStreamWriter: unable to open " << filepath
+               << " for writing";
+    file_.close();
+    return;
+  }
+  format_.intraInterval = std::max(format_.intraInterval, 1u);
+
+  std::string header;
+  Encoder encoder{header};
+  header.append(HeaderMagic, 4);
+  encoder.raw(Version);
+  encoder.raw(format_.translationPrecision);
+  encoder.raw(format_.intraInterval);
+  file_.write(header.data(), header.size());
+  offset_ = header.size();
+}
+
+KeyframeStreamWriter::~KeyframeStreamWriter() {
+  close();
+}
+
+void KeyframeStreamWriter::writeKeyframe(const Keyframe& keyframe) {
+  if (!isOpen()) {
+    return;
+  }
+  // intra keyframes and snapshots are decoded without the ones before
+  if (chunkOffsets_.size() % format_.intraInterval == 0 ||
+      keyframe.isSnapshot) {
+    states_.clear();
+  }
+
+  chunk_.clear();
+  Encoder encoder{chunk_};
+
+  encoder.raw(std::uint8_t(keyframe.isSnapshot));
+
+  encoder.varint(keyframe.loads.size());
+  for (const auto& assetInfo : keyframe.loads) {
+    encoder.varint(std::uint32_t(assetInfo.type));
+    encoder.string(assetInfo.filepath);
+    encoder.vector3(assetInfo.frame.up());
+    encoder.vector3(assetInfo.frame.front());
+    encoder.vector3(assetInfo.frame.origin());
+    encoder.raw(assetInfo.virtualUnitToMeters);
+    encoder.raw(std::uint8_t(assetInfo.requiresLighting |
+                             assetInfo.splitInstanceMesh << 1));
+  }
+
+  // instance keys are mostly increasing, store their differences
+  RenderAssetInstanceKey previousKey = 0;
+  encoder.varint(keyframe.creations.size());
+  for (const auto& pair : keyframe.creations) {
+    const auto& creation = pair.second;
+    encoder.signedVarint(std::int64_t(pair.first) - previousKey);
+    previousKey = pair.first;
+    encoder.string(creation.filepath);
+    encoder.raw(std::uint8_t(bool(creation.scale)));
+    if (creation.scale) {
+      encoder.vector3(*creation.scale);
+    }
+    encoder.varint(
+        esp::assets::RenderAssetInstanceCreationInfo::Flags::UnderlyingType(
+            creation.flags));
+    encoder.string(creation.lightSetupKey);
+  }
+
+  previousKey = 0;
+  encoder.varint(keyframe.deletions.size());
+  for (const auto instanceKey : keyframe.deletions) {
+    encoder.signedVarint(std::int64_t(instanceKey) - previousKey);
+    previousKey = instanceKey;
+    states_.erase(instanceKey);
+  }
+
+  previousKey = 0;
+  encoder.varint(keyframe.stateUpdates.size());
+  for (const auto& pair : keyframe.stateUpdates) {
+    encoder.signedVarint(std::int64_t(pair.first) - previousKey);
+    previousKey = pair.first;
+
+    const QuantizedInstanceState state =
+        quantize(pair.second, format_.translationPrecision);
+    // an instance not seen since the last intra keyframe is stored whole
+    QuantizedInstanceState base;
+    std::uint8_t changed = AllChanged;
+    auto found = states_.find(pair.first);
+    if (found != states_.end()) {
+      base = found->second;
+      changed = 0;
+      if (!std::equal(state.translation, state.translation + 3,
+                      base.translation)) {
+        changed |= TranslationChanged;
+      }
+      if (state.rotationLargest != base.rotationLargest ||
+          !std::equal(state.rotation, state.rotation + 3, base.rotation)) {
+        changed |= RotationChanged;
+      }
+      if (state.semanticId != base.semanticId) {
+        changed |= SemanticIdChanged;
+      }
+    }
+
+    encoder.raw(changed);
+    if (changed & TranslationChanged) {
+      for (int i = 0; i != 3; ++i) {
+        encoder.signedVarint(std::int64_t(state.translation[i]) -
+                             base.translation[i]);
+      }
+    }
+    if (changed & RotationChanged) {
+      encoder.raw(state.rotationLargest);
+      for (int i = 0; i != 3; ++i) {
+        encoder.raw(state.rotation[i]);
+      }
+    }
+    if (changed & SemanticIdChanged) {
+      encoder.signedVarint(state.semanticId);
+    }
+    states_[pair.first] = state;
+  }
+
+  encoder.varint(keyframe.userTransforms.size());
+  for (const auto& pair : keyframe.userTransforms) {
+    encoder.string(pair.first);
+    encoder.vector3(pair.second.translation);
+    encoder.vector3(pair.second.rotation.vector());
+    encoder.raw(pair.second.rotation.scalar());
+  }
+
+  const std::uint32_t chunkSize =
+      Cr::Utility::Endianness::littleEndian(std::uint32_t(chunk_.size()));
+  file_.write(reinterpret_cast<const char*>(&chunkSize), sizeof(chunkSize));
+  file_.write(chunk_.data(), chunk_.size());
+  file_.flush();
+  chunkOffsets_.push_back(offset_);
+  offset_ += sizeof(chunkSize) + chunk_.size();
+}
+
+void KeyframeStreamWriter::close() {
+  if (!isOpen()) {
+    return;
+  }
+  std::string footer;
+  Encoder encoder{footer};
+  for (const std::uint64_t offset : chunkOffsets_) {
+    encoder.raw(offset);
+  }
+  encoder.raw(offset_);
+  encoder.raw(std::uint32_t(chunkOffsets_.size()));
+  footer.append(FooterMagic, 4);
+  file_.write(footer.data(), footer.size());
+  file_.close();
+}
+
+KeyframeStreamReader::KeyframeStreamReader(const std::string& filepath) {
+  if (!isKeyframeStream(filepath)) {
+    LOG(ERROR) << "KeyframeStreamReader: " << filepath
+               << " is not a keyframe stream";
+    return;
+  }
+  data_ = Cr::Utility::Directory::mapRead(filepath);
+  if (data_.size() < HeaderSize) {
+    LOG(ERROR) << "KeyframeStreamReader: unable to map " << filepath;
+    return;
+  }
+
+  Decoder header{data_.data() + 4, data_.data() + HeaderSize};
+  const std::uint32_t version = header.raw<std::uint32_t>();
+  format_.translationPrecision = header.raw<float>();
+  format_.intraInterval = header.raw<std::uint32_t>();
+  if (version != Version || !(format_.translationPrecision > 0.0f) ||
+      format_.intraInterval == 0) {
+    LOG(ERROR) << "KeyframeStreamReader: unsupported version " << version
+               << " or corrupted header in " << filepath;
+    return;
+  }
+
+  const std::uint64_t size = data_.size();
+  // the index footer, if the writer was closed
+  if (size >= HeaderSize + FooterSize &&
+      std::memcmp(data_.data() + size - 4, FooterMagic, 4) == 0) {
+    Decoder footer{data_.data() + size - FooterSize, data_.data() + size};
+    const std::uint64_t indexOffset = footer.raw<std::uint64_t>();
+    const std::uint32_t numKeyframes = footer.raw<std::uint32_t>();
+    if (indexOffset >= HeaderSize &&
+        indexOffset + std::uint64_t(numKeyframes) * 8 == size - FooterSize) {
+      Decoder index{data_.data() + indexOffset,
+                    data_.data() + size - FooterSize};
+      for (std::uint32_t i = 0; i != numKeyframes; ++i) {
+        const std::uint64_t offset = index.raw<std::uint64_t>();
+        if (offset < HeaderSize || offset + 4 > indexOffset) {
+          break;
+        }
+        Decoder chunk{data_.data() + offset, data_.data() + indexOffset};
+        if (offset + 4 + chunk.raw<std::uint32_t>() > indexOffset) {
+          break;
+        }
+        chunkOffsets_.push_back(offset);
+      }
+      if (chunkOffsets_.size() != numKeyframes) {
+        chunkOffsets_.clear();
+      }
+    }
+  }
+
+  // otherwise walk the chunks up to the last complete one
+  if (chunkOffsets_.empty()) {
+    std::uint64_t offset = HeaderSize;
+    while (offset + 4 <= size) {
+      Decoder chunk{data_.data() + offset, data_.data() + size};
+      const std::uint64_t end = offset + 4 + chunk.raw<std::uint32_t>();
+      if (end > size) {
+        break;
+      }
+      chunkOffsets_.push_back(offset);
+      offset = end;
+    }
+    LOG(WARNING) << "KeyframeStreamReader: " << filepath
+                 << " has no index, recovered " << chunkOffsets_.size()
+                 << " keyframes";
+  }
+  isOpen_ = true;
+}
+
+bool KeyframeStreamReader::isKeyframeStream(const std::string& filepath) {
+  std::ifstream file{filepath, std::ios::binary};
+  char magic[4]{};
+  file.read(magic, 4);
+  return file && std::memcmp(magic, HeaderMagic, 4) == 0;
+}
+
+bool KeyframeStreamReader::readKeyframe(int index, Keyframe& keyframe) {
+  CORRADE_ASSERT(index >= 0 && index < getNumKeyframes(),
+                 "KeyframeStreamReader::readKeyframe(): index" << index
+                     << "out of range for" << getNumKeyframes()
+                     << "keyframes",
+                 false);
+  keyframe = Keyframe{};
+
+  // the deltas need the states as of the previous keyframe, decode from the
+  // last intra keyframe or snapshot unless reading in order
+  const int interval = int(format_.intraInterval);
+  int first = index - index % interval;
+  for (int i = index; i > first; --i) {
+    if (isSnapshot(i)) {
+      first = i;
+      break;
+    }
+  }
+  if (decodedIndex_ >= first && decodedIndex_ < index) {
+    first = decodedIndex_ + 1;
+  }
+  for (int i = first; i != index; ++i) {
+    if (!decodeKeyframe(i, nullptr)) {
+      decodedIndex_ = -1;
+      return false;
+    }
+  }
+  if (!decodeKeyframe(index, &keyframe)) {
+    decodedIndex_ = -1;
+    return false;
+  }
+  decodedIndex_ = index;
+  return true;
+}
+
+bool KeyframeStreamReader::isSnapshot(int index) const {
+  CORRADE_ASSERT(index >= 0 && index < getNumKeyframes(),
+                 "KeyframeStreamReader::isSnapshot(): index" << index
+                     << "out of range for" << getNumKeyframes()
+                     << "keyframes",
+                 false);
+  const std::uint64_t offset = chunkOffsets_[index];
+  Decoder chunk{data_.data() + offset, data_.data() + data_.size()};
+  return chunk.raw<std::uint32_t>() && chunk.raw<std::uint8_t>();
+}
+
+bool KeyframeStreamReader::decodeKeyframe(int index, Keyframe* keyframe) {
+  // keyframes before the requested one only update the states
+  Keyframe skipped;
+  Keyframe& out = keyframe ? *keyframe : skipped;
+
+  const std::uint64_t offset = chunkOffsets_[index];
+  Decoder header{data_.data() + offset, data_.data() + data_.size()};
+  const std::uint32_t chunkSize = header.raw<std::uint32_t>();
+  const char* begin = data_.data() + offset + sizeof(chunkSize);
+  Decoder decoder{begin, begin + chunkSize};
+
+  out.isSnapshot = decoder.raw<std::uint8_t>();
+  if (index % format_.intraInterval == 0 || out.isSnapshot) {
+    states_.clear();
+  }
+
+  out.loads.resize(decoder.count());
+  for (auto& assetInfo : out.loads) {
+    assetInfo.type = esp::assets::AssetType(decoder.varint());
+    assetInfo.filepath = decoder.string();
+    const Mn::Vector3 up = decoder.vector3();
+    const Mn::Vector3 front = decoder.vector3();
+    const Mn::Vector3 origin = decoder.vector3();
+    assetInfo.frame = geo::CoordinateFrame{
+        vec3f{up.x(), up.y(), up.z()}, vec3f{front.x(), front.y(), front.z()},
+        vec3f{origin.x(), origin.y(), origin.z()}};
+    assetInfo.virtualUnitToMeters = decoder.raw<float>();
+    const std::uint8_t flags = decoder.raw<std::uint8_t>();
+    assetInfo.requiresLighting = flags & 1;
+    assetInfo.splitInstanceMesh = flags & 2;
+  }
+
+  RenderAssetInstanceKey previousKey = 0;
+  out.creations.resize(decoder.count());
+  for (auto& pair : out.creations) {
+    auto& creation = pair.second;
+    pair.first = previousKey += decoder.signedVarint();
+    creation.filepath = decoder.string();
+    if (decoder.raw<std::uint8_t>()) {
+      creation.scale = decoder.vector3();
+    }
+    creation.flags = esp::assets::RenderAssetInstanceCreationInfo::Flags(
+        esp::assets::RenderAssetInstanceCreationInfo::Flag(decoder.varint()));
+    creation.lightSetupKey = decoder.string();
+  }
+
+  previousKey = 0;
+  out.deletions.resize(decoder.count());
+  for (auto& instanceKey : out.deletions) {
+    instanceKey = previousKey += decoder.signedVarint();
+    states_.erase(instanceKey);
+  }
+
+  previousKey = 0;
+  out.stateUpdates.resize(decoder.count());
+  for (auto& pair : out.stateUpdates) {
+    pair.first = previousKey += decoder.signedVarint();
+    QuantizedInstanceState& state = states_[pair.first];
+    const std::uint8_t changed = decoder.raw<std::uint8_t>();
+    if (changed & TranslationChanged) {
+      for (int i = 0; i != 3; ++i) {
+        state.translation[i] =
+            std::int32_t(state.translation[i] + decoder.signedVarint());
+      }
+    }
+    if (changed & RotationChanged) {
+      state.rotationLargest = decoder.raw<std::uint8_t>();
+      for (int i = 0; i != 3; ++i) {
+        state.rotation[i] = decoder.raw<std::int16_t>();
+      }
+      if (state.rotationLargest > 3) {
+        return false;
+      }
+    }
+    if (changed & SemanticIdChanged) {
+      state.semanticId = std::int32_t(decoder.signedVarint());
+    }
+    pair.second = dequantize(state, format_.translationPrecision);
+  }
+
+  const std::size_t numUserTransforms = decoder.count();
+  for (std::size_t i = 0; i != numUserTransforms && decoder.ok(); ++i) {
+    std::string name = decoder.string();
+    Transform& transform = out.userTransforms[std::move(name)];
+    transform.translation = decoder.vector3();
+    const Mn::Vector3 vector = decoder.vector3();
+    transform.rotation = Mn::Quaternion{vector, decoder.raw<float>()};
+  }
+
+  return decoder.ok() && decoder.atEnd();
+}
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
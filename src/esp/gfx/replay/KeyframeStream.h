@@ -0,0 +1,181 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_REPLAY_KEYFRAMESTREAM_H_
+#define ESP_GFX_REPLAY_KEYFRAMESTREAM_H_
+
+#include "Keyframe.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Directory.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+/**
+ * @brief Settings of a binary keyframe stream, stored in its header
+ */
+struct KeyframeStreamFormat {
+  /**
+   * @brief Step translations are quantized to, in meters
+   *
+   * Translations are stored as integer multiples of it, in the range of
+   * +/- 2^31 steps.
+   */
+  float translationPrecision = 1.0e-4f;
+
+  /**
+   * @brief Number of keyframes between two keyframes that are decoded
+   * without the ones before
+   *
+   * State updates are stored as deltas to the previous state of the same
+   * instance, except in every intraInterval-th keyframe and in snapshots
+   * (see @ref Keyframe::isSnapshot), so reading one keyframe decodes at most
+   * this many.
+   */
+  std::uint32_t intraInterval = 64;
+};
+
+/**
+ * @brief A @ref RenderAssetInstanceState as stored in a keyframe stream
+ */
+struct QuantizedInstanceState {
+  std::int32_t translation[3]{};
+  //! the three smallest quaternion components, the largest is implied
+  std::int16_t rotation[3]{};
+  //! index of the omitted component, xyzw
+  std::uint8_t rotationLargest = 3;
+  std::int32_t semanticId = ID_UNDEFINED;
+};
+
+/**
+ * @brief Compact binary replay format, an alternative to the JSON written by
+ * @ref Recorder::writeSavedKeyframesToFile
+ *
+ * The file is a header, one length-prefixed chunk per keyframe and a footer
+ * indexing the chunks:
+ *
+ * - Translations are quantized to
+ *   @ref KeyframeStreamFormat::translationPrecision and rotations to 16 bits
+ *   per component (smallest three).
+ * - State updates store only what changed since the instance's previous
+ *   update, translations as variable length deltas.
+ * - Loads, creations, deletions and user transforms are stored as is, user
+ *   transforms in full precision.
+ *
+ * All integers and floats are stored little-endian, on any host.
+ */
+class KeyframeStreamWriter {
+ public:
+  /**
+   * @brief Opens @p filepath for writing, replacing it, and writes the header
+   *
+   * Check @ref isOpen() for success.
+   */
+  explicit KeyframeStreamWriter(const std::string& filepath,
+                                const KeyframeStreamFormat& format = {});
+
+  /** @brief Calls @ref close() */
+  ~KeyframeStreamWriter();
+
+  KeyframeStreamWriter(const KeyframeStreamWriter&) = delete;
+  KeyframeStreamWriter& operator=(const KeyframeStreamWriter&) = delete;
+
+  /** @brief Whether the file is open for writing */
+  bool isOpen() const { return file_.is_open(); }
+
+  /** @brief Number of keyframes written so far */
+  int getNumKeyframes() const { return int(chunkOffsets_.size()); }
+
+  /**
+   * @brief Encodes @p keyframe, appends it and flushes it to the file
+   *
+   * The file is readable up to the last written keyframe even if it is
+   * never closed.
+   */
+  void writeKeyframe(const Keyframe& keyframe);
+
+  /** @brief Writes the index footer and closes the file */
+  void close();
+
+ private:
+  std::ofstream file_;
+  KeyframeStreamFormat format_;
+  std::uint64_t offset_ = 0;
+  std::vector<std::uint64_t> chunkOffsets_;
+  // the most recent state of every instance, the base of the deltas
+  std::unordered_map<RenderAssetInstanceKey, QuantizedInstanceState> states_;
+  std::string chunk_;
+};
+
+/**
+ * @brief Reads a file written by @ref KeyframeStreamWriter
+ *
+ * The file is memory-mapped and keyframes are only decoded when read.
+ * Reading keyframes in order decodes each of them once.
+ */
+class KeyframeStreamReader {
+ public:
+  /**
+   * @brief Memory-maps @p filepath and reads its index
+   *
+   * A file whose writer was not closed has no index; its chunks are then
+   * scanned up to the last complete one. Check @ref isOpen() for success.
+   */
+  explicit KeyframeStreamReader(const std::string& filepath);
+
+  /** @brief Whether @p filepath starts like a keyframe stream */
+  static bool isKeyframeStream(const std::string& filepath);
+
+  /** @brief Whether the file was mapped and its index read */
+  bool isOpen() const { return isOpen_; }
+
+  /** @brief Number of keyframes in the file */
+  int getNumKeyframes() const { return int(chunkOffsets_.size()); }
+
+  /**
+   * @brief Whether keyframe @p index is a snapshot, without decoding it
+   *
+   * See @ref Keyframe::isSnapshot.
+   */
+  bool isSnapshot(int index) const;
+
+  /** @brief The format the file was written with */
+  const KeyframeStreamFormat& format() const { return format_; }
+
+  /**
+   * @brief Decodes keyframe @p index into @p keyframe
+   * @return false if the keyframe is corrupted
+   */
+  bool readKeyframe(int index, Keyframe& keyframe);
+
+ private:
+  bool decodeKeyframe(int index, Keyframe* keyframe);
+
+  Corrade::Containers::Array<const char,
+                             Corrade::Utility::Directory::MapDeleter>
+      data_;
+  bool isOpen_ = false;
+  KeyframeStreamFormat format_;
+  std::vector<std::uint64_t> chunkOffsets_;
+  // the most recent state of every instance, the base of the deltas
+  std::unordered_map<RenderAssetInstanceKey, QuantizedInstanceState> states_;
+  // index of the last decoded keyframe, whose states_ are current
+  int decodedIndex_ = -1;
+};
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
+
+#endif
@@ -3,6 +3,7 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "Player.h"
+#include "KeyframeStream.h"
 
 #include "esp/assets/ResourceManager.h"
 #include "esp/core/esp.h"
@@ -10,6 +11,9 @@
 
 #include <rapidjson/document.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace esp {
 namespace gfx {
 namespace replay {
@@ -30,6 +34,13 @@ void Player::readKeyframesFromFile(const std::string& filepath) {
                << " not found.";
     return;
   }
+  if (KeyframeStreamReader::isKeyframeStream(filepath)) {
+    auto reader = std::make_unique<KeyframeStreamReader>(filepath);
+    if (reader->isOpen()) {
+      streamReader_ = std::move(reader);
+    }
+    return;
+  }
   try {
     auto newDoc = esp::io::parseJsonFile(filepath);
     readKeyframesFromJsonDocument(newDoc);
@@ -49,31 +60,81 @@ int Player::getKeyframeIndex() const {
 }
 
 int Player::getNumKeyframes() const {
+  if (streamReader_) {
+    return streamReader_->getNumKeyframes();
+  }
   return keyframes_.size();
 }
 
 void Player::setKeyframeIndex(int frameIndex) {
   ASSERT(frameIndex == -1 ||
          (frameIndex >= 0 && frameIndex < getNumKeyframes()));
+  if (frameIndex == frameIndex_) {
+    return;
+  }
+  if (frameIndex == -1) {
+    clearFrame();
+    return;
+  }
+
+  // The closest snapshot at or before the keyframe: the closest built one,
+  // unless a recorded one comes after it. Going forward from the current
+  // keyframe is shorter if it comes after both.
+  const int currentIndex = frameIndex > frameIndex_ ? frameIndex_ : -1;
+  auto built = snapshots_.upper_bound(frameIndex);
+  int snapshotIndex =
+      built == snapshots_.begin() ? -1 : std::prev(built)->first;
+  for (int i = frameIndex; i > std::max(snapshotIndex, currentIndex); --i) {
+    if (isRecordedSnapshot(i)) {
+      snapshotIndex = i;
+      break;
+    }
+  }
 
-  if (frameIndex < frameIndex_) {
+  Keyframe storage;
+  const Keyframe* keyframe = nullptr;
+  if (snapshotIndex > currentIndex) {
+    auto found = snapshots_.find(snapshotIndex);
+    keyframe = found != snapshots_.end()
+                   ? &found->second
+                   : &readKeyframe(snapshotIndex, storage);
+    applySnapshot(*keyframe);
+    frameIndex_ = snapshotIndex;
+  } else if (currentIndex == -1) {
     clearFrame();
   }
 
   while (frameIndex_ < frameIndex) {
-    applyKeyframe(keyframes_[++frameIndex_]);
+    keyframe = &readKeyframe(++frameIndex_, storage);
+    applyKeyframe(*keyframe);
+    if (snapshotInterval_ > 0 && frameIndex_ % snapshotInterval_ == 0 &&
+        !keyframe->isSnapshot) {
+      snapshots_.emplace(frameIndex_, makeSnapshot(keyframe->userTransforms));
+    }
+  }
+
+  if (streamReader_) {
+    streamUserTransforms_ = keyframe->userTransforms;
   }
 }
 
+void Player::setSnapshotInterval(int interval) {
+  ASSERT(interval >= 0);
+  snapshotInterval_ = interval;
+  snapshots_.clear();
+}
+
 bool Player::getUserTransform(const std::string& name,
                               Magnum::Vector3* translation,
                               Magnum::Quaternion* rotation) const {
   ASSERT(frameIndex_ >= 0 && frameIndex_ < getNumKeyframes());
   ASSERT(translation);
   ASSERT(rotation);
-  const auto& keyframe = keyframes_[frameIndex_];
-  const auto& it = keyframe.userTransforms.find(name);
-  if (it != keyframe.userTransforms.end()) {
+  const auto& userTransforms = streamReader_
+                                   ? streamUserTransforms_
+                                   : keyframes_[frameIndex_].userTransforms;
+  const auto& it = userTransforms.find(name);
+  if (it != userTransforms.end()) {
     *translation = it->second.translation;
     *rotation = it->second.rotation;
     return true;
@@ -85,6 +146,8 @@ bool Player::getUserTransform(const std::string& name,
 void Player::close() {
   clearFrame();
   keyframes_.clear();
+  streamReader_.reset();
+  snapshots_.clear();
 }
 
 void Player::clearFrame() {
@@ -92,14 +155,36 @@ void Player::clearFrame() {
     // TODO: use NodeDeletionHelper to safely delete nodes owned by the Player.
     // the deletion here is unsafe because a Player may persist beyond the
     // lifetime of these nodes.
-    delete pair.second;
+    delete pair.second.node;
   }
   createdInstances_.clear();
   assetInfos_.clear();
+  streamUserTransforms_.clear();
   frameIndex_ = -1;
 }
 
+const Keyframe& Player::readKeyframe(int frameIndex, Keyframe& storage) {
+  if (!streamReader_) {
+    return keyframes_[frameIndex];
+  }
+  if (!streamReader_->readKeyframe(frameIndex, storage)) {
+    LOG(ERROR) << "Player::readKeyframe: keyframe " << frameIndex
+               << " is corrupted, skipping it.";
+  }
+  return storage;
+}
+
+bool Player::isRecordedSnapshot(int frameIndex) const {
+  return streamReader_ ? streamReader_->isSnapshot(frameIndex)
+                       : keyframes_[frameIndex].isSnapshot;
+}
+
 void Player::applyKeyframe(const Keyframe& keyframe) {
+  if (keyframe.isSnapshot) {
+    applySnapshot(keyframe);
+    return;
+  }
+
   for (const auto& assetInfo : keyframe.loads) {
     ASSERT(assetInfos_.count(assetInfo.filepath) == 0);
     if (failedFilepaths_.count(assetInfo.filepath)) {
@@ -109,30 +194,8 @@ void Player::applyKeyframe(const Keyframe& keyframe) {
   }
 
   for (const auto& pair : keyframe.creations) {
-    const auto& creation = pair.second;
-    if (!assetInfos_.count(creation.filepath)) {
-      if (!failedFilepaths_.count(creation.filepath)) {
-        LOG(WARNING) << "Player: missing asset info for [" << creation.filepath
-                     << "]";
-        failedFilepaths_.insert(creation.filepath);
-      }
-      continue;
-    }
-    ASSERT(assetInfos_.count(creation.filepath));
-    auto node = loadAndCreateRenderAssetInstanceCallback(
-        assetInfos_[creation.filepath], creation);
-    if (!node) {
-      if (!failedFilepaths_.count(creation.filepath)) {
-        LOG(WARNING) << "Player: load failed for asset [" << creation.filepath
-                     << "]";
-        failedFilepaths_.insert(creation.filepath);
-      }
-      continue;
-    }
-
-    const auto& instanceKey = pair.first;
-    ASSERT(createdInstances_.count(instanceKey) == 0);
-    createdInstances_[instanceKey] = node;
+    ASSERT(createdInstances_.count(pair.first) == 0);
+    createInstance(pair.first, pair.second);
   }
 
   for (const auto& deletionInstanceKey : keyframe.deletions) {
@@ -143,11 +206,73 @@ void Player::applyKeyframe(const Keyframe& keyframe) {
       continue;
     }
 
-    auto node = it->second;
+    auto node = it->second.node;
     delete node;
     createdInstances_.erase(deletionInstanceKey);
   }
 
+  applyStateUpdates(keyframe);
+}
+
+void Player::applySnapshot(const Keyframe& snapshot) {
+  assetInfos_.clear();
+  for (const auto& assetInfo : snapshot.loads) {
+    if (failedFilepaths_.count(assetInfo.filepath)) {
+      continue;
+    }
+    assetInfos_[assetInfo.filepath] = assetInfo;
+  }
+
+  // keep the instances that are in the snapshot, delete the others
+  std::set<RenderAssetInstanceKey> instanceKeys;
+  for (const auto& pair : snapshot.creations) {
+    instanceKeys.insert(pair.first);
+  }
+  for (auto it = createdInstances_.begin(); it != createdInstances_.end();) {
+    if (instanceKeys.count(it->first)) {
+      ++it;
+    } else {
+      delete it->second.node;
+      it = createdInstances_.erase(it);
+    }
+  }
+
+  for (const auto& pair : snapshot.creations) {
+    if (!createdInstances_.count(pair.first)) {
+      createInstance(pair.first, pair.second);
+    }
+  }
+
+  applyStateUpdates(snapshot);
+}
+
+void Player::createInstance(
+    RenderAssetInstanceKey instanceKey,
+    const esp::assets::RenderAssetInstanceCreationInfo& creation) {
+  if (!assetInfos_.count(creation.filepath)) {
+    if (!failedFilepaths_.count(creation.filepath)) {
+      LOG(WARNING) << "Player: missing asset info for [" << creation.filepath
+                   << "]";
+      failedFilepaths_.insert(creation.filepath);
+    }
+    return;
+  }
+  auto node = loadAndCreateRenderAssetInstanceCallback(
+      assetInfos_[creation.filepath], creation);
+  if (!node) {
+    if (!failedFilepaths_.count(creation.filepath)) {
+      LOG(WARNING) << "Player: load failed for asset [" << creation.filepath
+                   << "]";
+      failedFilepaths_.insert(creation.filepath);
+    }
+    return;
+  }
+
+  createdInstances_[instanceKey] =
+      CreatedInstance{node, creation, Corrade::Containers::NullOpt};
+}
+
+void Player::applyStateUpdates(const Keyframe& keyframe) {
   for (const auto& pair : keyframe.stateUpdates) {
     const auto& it = createdInstances_.find(pair.first);
     if (it == createdInstances_.end()) {
@@ -155,12 +280,30 @@ void Player::applyKeyframe(const Keyframe& keyframe) {
       // creation
       continue;
     }
-    auto node = it->second;
+    auto node = it->second.node;
     const auto& state = pair.second;
     node->setTranslation(state.absTransform.translation);
     node->setRotation(state.absTransform.rotation);
     setSemanticIdForSubtree(node, state.semanticId);
+    it->second.state = state;
+  }
+}
+
+Keyframe Player::makeSnapshot(
+    const std::unordered_map<std::string, Transform>& userTransforms) const {
+  Keyframe snapshot;
+  snapshot.isSnapshot = true;
+  for (const auto& pair : assetInfos_) {
+    snapshot.loads.push_back(pair.second);
+  }
+  for (const auto& pair : createdInstances_) {
+    snapshot.creations.emplace_back(pair.first, pair.second.creation);
+    if (pair.second.state) {
+      snapshot.stateUpdates.emplace_back(pair.first, *pair.second.state);
+    }
   }
+  snapshot.userTransforms = userTransforms;
+  return snapshot;
 }
 
 void Player::setSemanticIdForSubtree(esp::scene::SceneNode* rootNode,
@@ -13,8 +13,10 @@
 #include <rapidjson/document.h>
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace esp {
@@ -24,6 +26,8 @@ class SceneNode;
 namespace gfx {
 namespace replay {
 
+class KeyframeStreamReader;
+
 /**
  * @brief Playback for "render replay".
  *
@@ -56,6 +60,10 @@ class Player {
   /**
    * @brief Read keyframes. See also @ref Recorder::writeSavedKeyframesToFile.
    * After calling this, use @ref setKeyframeIndex to set a keyframe.
+   *
+   * Binary keyframe streams (see @ref Recorder::startStreamingKeyframesToFile)
+   * are detected and memory-mapped; their keyframes are decoded as they are
+   * set instead of all being read up front.
    * @param filepath
    */
   void readKeyframesFromFile(const std::string& filepath);
@@ -73,9 +81,25 @@ class Player {
   /**
    * @brief Set a keyframe by index, or pass -1 to clear the currently-set
    * keyframe.
+   *
+   * Starts from the closest snapshot at or before the keyframe, unless the
+   * currently-set keyframe is closer, then applies the keyframes after it.
+   * Instances that exist both before and after are kept, not re-created. See
+   * also @ref setSnapshotInterval.
    */
   void setKeyframeIndex(int frameIndex);
 
+  /**
+   * @brief Keep a snapshot of the scene at every @p interval -th keyframe,
+   * or pass 0 to keep none. The default is 32.
+   *
+   * Snapshots are built when their keyframes are first set, so seeking to an
+   * already visited part of the replay applies at most one snapshot and
+   * @p interval - 1 keyframes. Snapshots saved by the @ref Recorder (see
+   * @ref Recorder::setSnapshotInterval) are used as well.
+   */
+  void setSnapshotInterval(int interval);
+
   /**
    * @brief Get a user transform. See @ref Recorder::addUserTransformToKeyframe
    * for usage tips.
@@ -94,12 +118,22 @@ class Player {
    */
   void debugSetKeyframes(std::vector<Keyframe>&& keyframes) {
     keyframes_ = std::move(keyframes);
+    snapshots_.clear();
   }
 
  private:
   void readKeyframesFromJsonDocument(const rapidjson::Document& d);
   void clearFrame();
+  const Keyframe& readKeyframe(int frameIndex, Keyframe& storage);
+  bool isRecordedSnapshot(int frameIndex) const;
   void applyKeyframe(const Keyframe& keyframe);
+  void applySnapshot(const Keyframe& snapshot);
+  void createInstance(
+      RenderAssetInstanceKey instanceKey,
+      const esp::assets::RenderAssetInstanceCreationInfo& creation);
+  void applyStateUpdates(const Keyframe& keyframe);
+  Keyframe makeSnapshot(
+      const std::unordered_map<std::string, Transform>& userTransforms) const;
   static void setSemanticIdForSubtree(esp::scene::SceneNode* rootNode,
                                       int semanticId);
 
@@ -107,8 +141,19 @@ class Player {
       loadAndCreateRenderAssetInstanceCallback;
   int frameIndex_ = -1;
   std::vector<Keyframe> keyframes_;
+  std::unique_ptr<KeyframeStreamReader> streamReader_;
+  // user transforms of the set keyframe, when reading a stream
+  std::unordered_map<std::string, Transform> streamUserTransforms_;
+  // snapshots built by the Player, by keyframe index
+  std::map<int, Keyframe> snapshots_;
+  int snapshotInterval_ = 32;
   std::map<std::string, esp::assets::AssetInfo> assetInfos_;
-  std::map<RenderAssetInstanceKey, scene::SceneNode*> createdInstances_;
+  struct CreatedInstance {
+    scene::SceneNode* node = nullptr;
+    esp::assets::RenderAssetInstanceCreationInfo creation;
+    Corrade::Containers::Optional<RenderAssetInstanceState> state;
+  };
+  std::map<RenderAssetInstanceKey, CreatedInstance> createdInstances_;
   std::set<std::string> failedFilepaths_;
 
   ESP_SMART_POINTERS(Player)
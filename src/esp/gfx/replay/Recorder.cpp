@@ -15,7 +15,7 @@ namespace replay {
 
 /**
  * @brief Helper class to get notified when a SceneNode is about to be
- * destroyed.
+ * destroyed, and when it or one of its ancestors moves.
  */
 class NodeDeletionHelper : public Magnum::SceneGraph::AbstractFeature3D {
  public:
@@ -28,6 +28,10 @@ class NodeDeletionHelper : public Magnum::SceneGraph::AbstractFeature3D {
     recorder_->onDeleteRenderAssetInstance(node);
   }
 
+  // Called when the node gets dirty, that is on its first transformation
+  // change since it was last cleaned. Recorder cleans it when sampling it.
+  void markDirty() override { recorder_->onRenderAssetInstanceDirty(node); }
+
  private:
   Recorder* recorder_ = nullptr;
   const scene::SceneNode* node = nullptr;
@@ -44,6 +48,7 @@ Recorder::~Recorder() {
 
 void Recorder::onLoadRenderAsset(const esp::assets::AssetInfo& assetInfo) {
   getKeyframe().loads.push_back(assetInfo);
+  loadedAssets_.push_back(assetInfo);
 }
 
 void Recorder::onCreateRenderAssetInstance(
@@ -61,13 +66,22 @@ void Recorder::onCreateRenderAssetInstance(
   // manually later if necessary.
   NodeDeletionHelper* deletionHelper = new NodeDeletionHelper{*node, this};
 
+  instanceSlots_[node] = instanceRecords_.size();
   instanceRecords_.emplace_back(InstanceRecord{
-      node, instanceKey, Corrade::Containers::NullOpt, deletionHelper});
+      node, instanceKey, Corrade::Containers::NullOpt, deletionHelper,
+      creation});
 }
 
 void Recorder::saveKeyframe() {
   updateInstanceStates();
+  if (snapshotInterval_ > 0 && numSavedKeyframes_ % snapshotInterval_ == 0) {
+    makeSnapshot(&getKeyframe());
+  }
+  ++numSavedKeyframes_;
   advanceKeyframe();
+  if (streamWriter_) {
+    streamSavedKeyframes();
+  }
 }
 
 void Recorder::addUserTransformToKeyframe(const std::string& name,
@@ -76,19 +90,43 @@ void Recorder::addUserTransformToKeyframe(const std::string& name,
   getKeyframe().userTransforms[name] = Transform{translation, rotation};
 }
 
-void Recorder::addLoadsCreationsDeletions(KeyframeIterator begin,
-                                          KeyframeIterator end,
+void Recorder::setSnapshotInterval(int interval) {
+  ASSERT(interval >= 0);
+  snapshotInterval_ = interval;
+  numSavedKeyframes_ = 0;
+}
+
+void Recorder::addLoadsCreationsDeletions(const Keyframe& src,
                                           Keyframe* dest) {
   ASSERT(dest);
-  for (KeyframeIterator curr = begin; curr != end; curr++) {
-    const auto& keyframe = *curr;
-    dest->loads.insert(dest->loads.end(), keyframe.loads.begin(),
-                       keyframe.loads.end());
-    dest->creations.insert(dest->creations.end(), keyframe.creations.begin(),
-                           keyframe.creations.end());
-    for (const auto& deletionInstanceKey : keyframe.deletions) {
-      checkAndAddDeletion(dest, deletionInstanceKey);
-    }
+  if (src.isSnapshot) {
+    // the snapshot supersedes everything before it
+    dest->loads.clear();
+    dest->creations.clear();
+    dest->deletions.clear();
+  }
+  dest->loads.insert(dest->loads.end(), src.loads.begin(), src.loads.end());
+  dest->creations.insert(dest->creations.end(), src.creations.begin(),
+                         src.creations.end());
+  for (const auto& deletionInstanceKey : src.deletions) {
+    checkAndAddDeletion(dest, deletionInstanceKey);
+  }
+}
+
+void Recorder::makeSnapshot(Keyframe* keyframe) {
+  ASSERT(keyframe);
+  keyframe->isSnapshot = true;
+  keyframe->loads = loadedAssets_;
+  keyframe->creations.clear();
+  keyframe->deletions.clear();
+  keyframe->stateUpdates.clear();
+  for (const auto& instanceRecord : instanceRecords_) {
+    keyframe->creations.emplace_back(instanceRecord.instanceKey,
+                                     instanceRecord.creation);
+    // updateInstanceStates() just set the recent state of every instance
+    ASSERT(instanceRecord.recentState);
+    keyframe->stateUpdates.emplace_back(instanceRecord.instanceKey,
+                                        *instanceRecord.recentState);
   }
 }
 
@@ -115,7 +153,20 @@ void Recorder::onDeleteRenderAssetInstance(const scene::SceneNode* node) {
 
   checkAndAddDeletion(&getKeyframe(), instanceKey);
 
-  instanceRecords_.erase(instanceRecords_.begin() + index);
+  // swap-remove, so deleting is O(1) regardless of the number of instances
+  instanceSlots_.erase(node);
+  if (index != int(instanceRecords_.size()) - 1) {
+    instanceRecords_[index] = std::move(instanceRecords_.back());
+    instanceSlots_[instanceRecords_[index].node] = index;
+  }
+  instanceRecords_.pop_back();
+}
+
+void Recorder::onRenderAssetInstanceDirty(const scene::SceneNode* node) {
+  int index = findInstance(node);
+  if (index != ID_UNDEFINED) {
+    instanceRecords_[index].isDirty = true;
+  }
 }
 
 Keyframe& Recorder::getKeyframe() {
@@ -127,18 +178,13 @@ RenderAssetInstanceKey Recorder::getNewInstanceKey() {
 }
 
 int Recorder::findInstance(const scene::SceneNode* queryNode) {
-  auto it = std::find_if(instanceRecords_.begin(), instanceRecords_.end(),
-                         [&queryNode](const InstanceRecord& record) {
-                           return record.node == queryNode;
-                         });
-
-  return it == instanceRecords_.end() ? ID_UNDEFINED
-                                      : int(it - instanceRecords_.begin());
+  auto it = instanceSlots_.find(queryNode);
+  return it == instanceSlots_.end() ? ID_UNDEFINED : it->second;
 }
 
-RenderAssetInstanceState Recorder::getInstanceState(
-    const scene::SceneNode* node) {
-  const auto absTransformMat = node->absoluteTransformation();
+RenderAssetInstanceState Recorder::getInstanceState(scene::SceneNode* node) {
+  // also cleans the node, so its next move marks it dirty again
+  const auto& absTransformMat = node->getAbsoluteTransformation();
   Transform absTransform{
       absTransformMat.translation(),
       Magnum::Quaternion::fromMatrix(absTransformMat.rotationShear())};
@@ -148,7 +194,15 @@ RenderAssetInstanceState Recorder::getInstanceState(
 
 void Recorder::updateInstanceStates() {
   for (auto& instanceRecord : instanceRecords_) {
+    // Only moved instances need their transformation sampled again. Semantic
+    // id changes don't mark nodes dirty, but are cheap to check.
+    if (!instanceRecord.isDirty && instanceRecord.recentState &&
+        instanceRecord.recentState->semanticId ==
+            instanceRecord.node->getSemanticId()) {
+      continue;
+    }
     auto state = getInstanceState(instanceRecord.node);
+    instanceRecord.isDirty = false;
     if (!instanceRecord.recentState || state != instanceRecord.recentState) {
       getKeyframe().stateUpdates.push_back(
           std::make_pair(instanceRecord.instanceKey, state));
@@ -178,15 +232,59 @@ std::string Recorder::writeSavedKeyframesToString() {
 }
 
 void Recorder::consolidateSavedKeyframes() {
-  // consolidate saved keyframes into current keyframe
-  addLoadsCreationsDeletions(savedKeyframes_.begin(), savedKeyframes_.end(),
-                             &getKeyframe());
+  // consolidate saved keyframes into current keyframe, which comes after them
+  Keyframe consolidated;
+  for (const auto& keyframe : savedKeyframes_) {
+    addLoadsCreationsDeletions(keyframe, &consolidated);
+  }
+  addLoadsCreationsDeletions(getKeyframe(), &consolidated);
+  getKeyframe().loads = std::move(consolidated.loads);
+  getKeyframe().creations = std::move(consolidated.creations);
+  getKeyframe().deletions = std::move(consolidated.deletions);
   // clear instanceRecord.recentState to ensure updates get included in the next
   // saved keyframe.
   for (auto& instanceRecord : instanceRecords_) {
     instanceRecord.recentState = Corrade::Containers::NullOpt;
   }
   savedKeyframes_.clear();
+  // the next file starts with a snapshot
+  numSavedKeyframes_ = 0;
+}
+
+void Recorder::startStreamingKeyframesToFile(
+    const std::string& filepath,
+    const KeyframeStreamFormat& format) {
+  stopStreamingKeyframes();
+
+  auto writer = std::make_unique<KeyframeStreamWriter>(filepath, format);
+  if (!writer->isOpen()) {
+    return;
+  }
+  streamWriter_ = std::move(writer);
+  streamSavedKeyframes();
+}
+
+void Recorder::stopStreamingKeyframes() {
+  if (!streamWriter_) {
+    return;
+  }
+  streamWriter_.reset();
+
+  savedKeyframes_.emplace_back(std::move(streamedKeyframe_));
+  streamedKeyframe_ = Keyframe{};
+  consolidateSavedKeyframes();
+}
+
+void Recorder::streamSavedKeyframes() {
+  for (const auto& keyframe : savedKeyframes_) {
+    streamWriter_->writeKeyframe(keyframe);
+  }
+  // state updates are only needed in the file, but the loads, creations and
+  // deletions are needed by whatever is written after streaming stops
+  for (const auto& keyframe : savedKeyframes_) {
+    addLoadsCreationsDeletions(keyframe, &streamedKeyframe_);
+  }
+  savedKeyframes_.clear();
 }
 
 rapidjson::Document Recorder::writeKeyframesToJsonDocument() {
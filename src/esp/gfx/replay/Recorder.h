@@ -6,16 +6,18 @@
 #define ESP_GFX_REPLAY_RECORDER_H_
 
 #include "Keyframe.h"
+#include "KeyframeStream.h"
+
+#include "esp/assets/Asset.h"
+#include "esp/assets/RenderAssetInstanceCreationInfo.h"
 
 #include <rapidjson/document.h>
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace esp {
-namespace assets {
-struct AssetInfo;
-struct RenderAssetInstanceCreationInfo;
-}  // namespace assets
 namespace scene {
 class SceneNode;
 }
@@ -100,6 +102,43 @@ class Recorder {
    */
   std::string writeSavedKeyframesToString();
 
+  /**
+   * @brief Save every @p interval -th keyframe as a snapshot, or pass 0 (the
+   * default) to never save snapshots.
+   *
+   * A snapshot keyframe holds the full scene instead of the changes since
+   * the previous keyframe (see @ref Keyframe::isSnapshot), so @ref Player
+   * can seek to it without applying the keyframes before it.
+   */
+  void setSnapshotInterval(int interval);
+
+  /**
+   * @brief Start writing keyframes to a binary keyframe stream, see
+   * @ref KeyframeStreamWriter.
+   *
+   * Keyframes saved so far are written first. From then on, every
+   * @ref saveKeyframe writes the keyframe to the file right away instead of
+   * keeping it in memory. Streaming to a new file stops streaming to the
+   * previous one.
+   * @param filepath
+   * @param format
+   */
+  void startStreamingKeyframesToFile(const std::string& filepath,
+                                     const KeyframeStreamFormat& format = {});
+
+  /**
+   * @brief Stop streaming keyframes and finish the file.
+   *
+   * Like after @ref writeSavedKeyframesToFile, the next saved keyframe
+   * re-creates all instances, so later files are self-contained.
+   */
+  void stopStreamingKeyframes();
+
+  /**
+   * @brief Whether keyframes are being streamed to a file.
+   */
+  bool isStreamingKeyframes() const { return bool(streamWriter_); }
+
   /**
    * @brief Reserved for unit-testing.
    */
@@ -108,7 +147,8 @@ class Recorder {
   }
 
  private:
-  // NodeDeletionHelper calls onDeleteRenderAssetInstance
+  // NodeDeletionHelper calls onDeleteRenderAssetInstance and
+  // onRenderAssetInstanceDirty
   friend class NodeDeletionHelper;
 
   // Helper for tracking render asset instances
@@ -117,29 +157,39 @@ class Recorder {
     RenderAssetInstanceKey instanceKey = ID_UNDEFINED;
     Corrade::Containers::Optional<RenderAssetInstanceState> recentState;
     NodeDeletionHelper* deletionHelper = nullptr;
+    esp::assets::RenderAssetInstanceCreationInfo creation;
+    // whether the node moved since its state was last sampled
+    bool isDirty = true;
   };
 
-  using KeyframeIterator = std::vector<Keyframe>::const_iterator;
-
   rapidjson::Document writeKeyframesToJsonDocument();
   void onDeleteRenderAssetInstance(const scene::SceneNode* node);
+  void onRenderAssetInstanceDirty(const scene::SceneNode* node);
   Keyframe& getKeyframe();
   void advanceKeyframe();
   RenderAssetInstanceKey getNewInstanceKey();
   int findInstance(const scene::SceneNode* queryNode);
-  RenderAssetInstanceState getInstanceState(const scene::SceneNode* node);
+  RenderAssetInstanceState getInstanceState(scene::SceneNode* node);
   void updateInstanceStates();
   void checkAndAddDeletion(Keyframe* keyframe,
                            RenderAssetInstanceKey instanceKey);
-  void addLoadsCreationsDeletions(KeyframeIterator begin,
-                                  KeyframeIterator end,
-                                  Keyframe* dest);
+  void addLoadsCreationsDeletions(const Keyframe& src, Keyframe* dest);
+  void makeSnapshot(Keyframe* keyframe);
   void consolidateSavedKeyframes();
+  void streamSavedKeyframes();
 
+  // unordered; deletion moves the last record into the freed slot
   std::vector<InstanceRecord> instanceRecords_;
+  std::unordered_map<const scene::SceneNode*, int> instanceSlots_;
   Keyframe currKeyframe_;
   std::vector<Keyframe> savedKeyframes_;
   RenderAssetInstanceKey nextInstanceKey_ = 0;
+  std::vector<esp::assets::AssetInfo> loadedAssets_;
+  int snapshotInterval_ = 0;
+  int numSavedKeyframes_ = 0;
+  std::unique_ptr<KeyframeStreamWriter> streamWriter_;
+  // loads, creations and deletions of all streamed keyframes
+  Keyframe streamedKeyframe_;
 };
 
 }  // namespace replay
@@ -14,6 +14,7 @@
 #include <Magnum/Math/Color.h>
 #include <Magnum/Math/FunctionsBatch.h>
 #include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Primitives/Plane.h>
@@ -40,8 +41,17 @@ struct DepthUnprojectionTest : Mn::GL::OpenGLTester {
   void testGpuDirect();
   void testGpuUnprojectExisting();
 
+  void testCpuTwoPass();
+  void testCpuClipNormalize();
+  void testCpuHalf();
+  void testCpuUnsignedShort();
+
   void benchmarkBaseline();
   void benchmarkCpu();
+  void benchmarkCpuTwoPass();
+  void benchmarkCpuFloat();
+  void benchmarkCpuHalf();
+  void benchmarkCpuUnsignedShort();
   void benchmarkGpuDirect();
   void benchmarkGpuUnprojectExisting();
 };
@@ -125,6 +135,29 @@ unprojectDepthNoBranch(const Mn::Vector2& unprojection,
   }
 }
 
+/* The separate far plane pass the fused unprojection replaced */
+CORRADE_NEVER_INLINE void unprojectDepthTwoPass(
+    const Mn::Vector2& unprojection,
+    Cr::Containers::ArrayView<Mn::Float> depth) {
+  unprojectDepthNoBranch(unprojection, depth);
+  const Mn::Float farDepth = unprojection[1] / (1.0f + unprojection[0]);
+  for (float& d : depth) {
+    if (d == farDepth)
+      d = 0.0f;
+  }
+}
+
+/* Depth buffer values with every tenth one on the far plane */
+Cr::Containers::Array<float> farPlaneDepth(std::size_t size) {
+  Cr::Containers::Array<float> depth{Cr::Containers::NoInit, size};
+  for (std::size_t i = 0; i != depth.size(); ++i)
+    depth[i] = i % 10 == 0 ? 1.0f : 0.5f + 0.5f * (i % 1000) / 1000.0f;
+  return depth;
+}
+
+const Mn::Vector2 ProcessingUnprojection = calculateDepthUnprojection(
+    Mn::Matrix4::perspectiveProjection(90.0_degf, 1.0f, 0.01f, 100.0f));
+
 const struct {
   const char* name;
   void (*unprojectorFull)(const Mn::Matrix4&, Cr::Containers::ArrayView<float>);
@@ -143,12 +176,23 @@ DepthUnprojectionTest::DepthUnprojectionTest() {
        &DepthUnprojectionTest::testGpuUnprojectExisting},
       Cr::Containers::arraySize(TestData));
 
+  addTests({&DepthUnprojectionTest::testCpuTwoPass,
+            &DepthUnprojectionTest::testCpuClipNormalize,
+            &DepthUnprojectionTest::testCpuHalf,
+            &DepthUnprojectionTest::testCpuUnsignedShort});
+
   addInstancedBenchmarks({&DepthUnprojectionTest::benchmarkBaseline}, 50,
                          Cr::Containers::arraySize(UnprojectBenchmarkData));
 
   addInstancedBenchmarks({&DepthUnprojectionTest::benchmarkCpu}, 50,
                          Cr::Containers::arraySize(UnprojectBenchmarkData));
 
+  addBenchmarks({&DepthUnprojectionTest::benchmarkCpuTwoPass,
+                 &DepthUnprojectionTest::benchmarkCpuFloat,
+                 &DepthUnprojectionTest::benchmarkCpuHalf,
+                 &DepthUnprojectionTest::benchmarkCpuUnsignedShort},
+                50);
+
   addBenchmarks({&DepthUnprojectionTest::benchmarkGpuDirect}, 50,
                 BenchmarkType::GpuTime);
 
@@ -258,6 +302,86 @@ void DepthUnprojectionTest::testGpuUnprojectExisting() {
                        Cr::TestSuite::Compare::around(data.depth * 0.0002f));
 }
 
+void DepthUnprojectionTest::testCpuTwoPass() {
+  Cr::Containers::Array<float> expected = farPlaneDepth(640 * 480);
+  Cr::Containers::Array<float> actual = farPlaneDepth(640 * 480);
+  unprojectDepthTwoPass(ProcessingUnprojection, expected);
+  /* In place, as the render targets do */
+  unprojectDepth(ProcessingUnprojection, actual);
+
+  for (std::size_t i = 0; i != actual.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(actual[i], expected[i]);
+  }
+  CORRADE_COMPARE(actual[0], 0.0f);
+}
+
+void DepthUnprojectionTest::testCpuClipNormalize() {
+  Cr::Containers::Array<float> depth = farPlaneDepth(640 * 480);
+  DepthProcessing processing;
+  processing.minDepth = 0.5f;
+  processing.maxDepth = 10.0f;
+  processing.normalize = true;
+  Cr::Containers::Array<float> output{Cr::Containers::NoInit, depth.size()};
+  unprojectDepth(ProcessingUnprojection, processing, depth, output);
+
+  Cr::Containers::Array<float> unprojected{Cr::Containers::NoInit,
+                                           depth.size()};
+  unprojectDepth(ProcessingUnprojection, {}, depth, unprojected);
+  for (std::size_t i = 0; i != depth.size(); ++i) {
+    CORRADE_ITERATION(i);
+    const float expected =
+        (Mn::Math::clamp(unprojected[i], 0.5f, 10.0f) - 0.5f) / 9.5f;
+    CORRADE_COMPARE_WITH(output[i], expected,
+                         Cr::TestSuite::Compare::around(1.0e-6f));
+  }
+  /* Far plane pixels are zeroed before they are clipped */
+  CORRADE_COMPARE(output[0], 0.0f);
+}
+
+void DepthUnprojectionTest::testCpuHalf() {
+  Cr::Containers::Array<float> depth = farPlaneDepth(640 * 480);
+  DepthProcessing processing;
+  processing.format = DepthFormat::Half;
+  Cr::Containers::Array<Mn::UnsignedShort> output{Cr::Containers::NoInit,
+                                                  depth.size()};
+  unprojectDepth(ProcessingUnprojection, processing, depth, output);
+
+  Cr::Containers::Array<float> unprojected{Cr::Containers::NoInit,
+                                           depth.size()};
+  unprojectDepth(ProcessingUnprojection, {}, depth, unprojected);
+  for (std::size_t i = 0; i != depth.size(); ++i) {
+    CORRADE_ITERATION(i);
+    /* Half floats have an 11 bit significand */
+    CORRADE_COMPARE_WITH(Mn::Math::unpackHalf(output[i]), unprojected[i],
+                         Cr::TestSuite::Compare::around(
+                             unprojected[i] * 1.0f / 1024.0f));
+  }
+}
+
+void DepthUnprojectionTest::testCpuUnsignedShort() {
+  Cr::Containers::Array<float> depth = farPlaneDepth(640 * 480);
+  DepthProcessing processing;
+  processing.maxDepth = 50.0f;
+  processing.format = DepthFormat::UnsignedShort;
+  /* In place, the output is smaller than the input */
+  Cr::Containers::Array<float> inOut = farPlaneDepth(depth.size());
+  unprojectDepth(ProcessingUnprojection, processing, inOut, inOut);
+  auto output = Cr::Containers::arrayCast<Mn::UnsignedShort>(inOut).prefix(
+      depth.size());
+
+  Cr::Containers::Array<float> unprojected{Cr::Containers::NoInit,
+                                           depth.size()};
+  unprojectDepth(ProcessingUnprojection, {}, depth, unprojected);
+  for (std::size_t i = 0; i != depth.size(); ++i) {
+    CORRADE_ITERATION(i);
+    const float millimeters = Mn::Math::min(unprojected[i], 50.0f) * 1000.0f;
+    CORRADE_COMPARE_WITH(float(output[i]), millimeters,
+                         Cr::TestSuite::Compare::around(0.5f + 1.0e-3f));
+  }
+  CORRADE_COMPARE(output[0], 0);
+}
+
 constexpr Mn::Vector2i BenchmarkSize{1536};
 
 void DepthUnprojectionTest::benchmarkBaseline() {
@@ -306,6 +430,55 @@ void DepthUnprojectionTest::benchmarkCpu() {
                      Cr::TestSuite::Compare::Greater);
 }
 
+void DepthUnprojectionTest::benchmarkCpuTwoPass() {
+  Cr::Containers::Array<float> depth =
+      farPlaneDepth(std::size_t(BenchmarkSize.product()));
+
+  CORRADE_BENCHMARK(1) { unprojectDepthTwoPass(ProcessingUnprojection, depth); }
+}
+
+void DepthUnprojectionTest::benchmarkCpuFloat() {
+  Cr::Containers::Array<float> depth =
+      farPlaneDepth(std::size_t(BenchmarkSize.product()));
+  DepthProcessing processing;
+  processing.maxDepth = 10.0f;
+  processing.normalize = true;
+  Cr::Containers::Array<float> output{Cr::Containers::NoInit, depth.size()};
+
+  CORRADE_BENCHMARK(1) {
+    unprojectDepth(ProcessingUnprojection, processing, depth, output);
+  }
+}
+
+void DepthUnprojectionTest::benchmarkCpuHalf() {
+  Cr::Containers::Array<float> depth =
+      farPlaneDepth(std::size_t(BenchmarkSize.product()));
+  DepthProcessing processing;
+  processing.maxDepth = 10.0f;
+  processing.normalize = true;
+  processing.format = DepthFormat::Half;
+  Cr::Containers::Array<Mn::UnsignedShort> output{Cr::Containers::NoInit,
+                                                  depth.size()};
+
+  CORRADE_BENCHMARK(1) {
+    unprojectDepth(ProcessingUnprojection, processing, depth, output);
+  }
+}
+
+void DepthUnprojectionTest::benchmarkCpuUnsignedShort() {
+  Cr::Containers::Array<float> depth =
+      farPlaneDepth(std::size_t(BenchmarkSize.product()));
+  DepthProcessing processing;
+  processing.maxDepth = 10.0f;
+  processing.format = DepthFormat::UnsignedShort;
+  Cr::Containers::Array<Mn::UnsignedShort> output{Cr::Containers::NoInit,
+                                                  depth.size()};
+
+  CORRADE_BENCHMARK(1) {
+    unprojectDepth(ProcessingUnprojection, processing, depth, output);
+  }
+}
+
 void DepthUnprojectionTest::benchmarkGpuDirect() {
   Mn::GL::Texture2D output{};
   output.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
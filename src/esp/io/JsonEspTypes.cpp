@@ -11,6 +11,10 @@ JsonGenericValue toJsonValue(const esp::gfx::replay::Keyframe& keyframe,
                              JsonAllocator& allocator) {
   JsonGenericValue obj(rapidjson::kObjectType);
 
+  if (keyframe.isSnapshot) {
+    esp::io::addMember(obj, "isSnapshot", true, allocator);
+  }
+
   esp::io::addMember(obj, "loads", keyframe.loads, allocator);
 
   if (!keyframe.creations.empty()) {
@@ -54,6 +58,7 @@ JsonGenericValue toJsonValue(const esp::gfx::replay::Keyframe& keyframe,
 
 bool fromJsonValue(const JsonGenericValue& obj,
                    esp::gfx::replay::Keyframe& keyframe) {
+  esp::io::readMember(obj, "isSnapshot", keyframe.isSnapshot);
   esp::io::readMember(obj, "loads", keyframe.loads);
 
   auto itr = obj.FindMember("creations");
@@ -1,5 +1,9 @@
 #include "esp/nav/GreedyFollower.h"
 
+#include <array>
+#include <map>
+
+#include <Corrade/Utility/Assert.h>
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 
@@ -60,11 +64,17 @@ float GreedyGeodesicFollowerImpl::computeReward(const scene::SceneNode& node,
                                                 const ShortestPath& path,
                                                 const size_t primLen) {
   const auto tryStepRes = tryStep(node, Mn::Vector3{path.requestedEnd});
+  return computeReward(path.geodesicDistance, tryStepRes, primLen);
+}
 
+float GreedyGeodesicFollowerImpl::computeReward(
+    const float geodesicDistance,
+    const TryStepResult& tryStepRes,
+    const size_t primLen) const {
   // Try to minimize geodesic distance to target
   // Divide by forwardAmount_ to make the reward structure independent of step
   // size
-  return (path.geodesicDistance - tryStepRes.postGeodesicDistance) /
+  return (geodesicDistance - tryStepRes.postGeodesicDistance) /
              forwardAmount_ +
          (
              // Prefer shortest primitives
@@ -136,23 +146,32 @@ GreedyGeodesicFollowerImpl::nextBestPrimAlong(const core::RigidState& state,
   return bestPrim;
 }
 
-bool GreedyGeodesicFollowerImpl::isThrashing() {
-  if (actions_.size() < thrashingThreshold_)
+namespace {
+// Whether the last thrashingThreshold actions alternate between LEFT and RIGHT
+bool isThrashing(const std::vector<GreedyGeodesicFollowerImpl::CODES>& actions,
+                 const int thrashingThreshold) {
+  using CODES = GreedyGeodesicFollowerImpl::CODES;
+  if (actions.size() < thrashingThreshold)
     return false;
 
-  CODES lastAct = actions_.back();
+  CODES lastAct = actions.back();
 
   bool thrashing = lastAct == CODES::LEFT || lastAct == CODES::RIGHT;
-  for (int i = 2; (i < (thrashingThreshold_ + 1)) && thrashing; ++i) {
-    thrashing = (actions_[actions_.size() - i] == CODES::RIGHT &&
+  for (int i = 2; (i < (thrashingThreshold + 1)) && thrashing; ++i) {
+    thrashing = (actions[actions.size() - i] == CODES::RIGHT &&
                  lastAct == CODES::LEFT) ||
-                (actions_[actions_.size() - i] == CODES::LEFT &&
+                (actions[actions.size() - i] == CODES::LEFT &&
                  lastAct == CODES::RIGHT);
-    lastAct = actions_[actions_.size() - i];
+    lastAct = actions[actions.size() - i];
   }
 
   return thrashing;
 }
+}  // namespace
+
+bool GreedyGeodesicFollowerImpl::isThrashing() {
+  return nav::isThrashing(actions_, thrashingThreshold_);
+}
 
 GreedyGeodesicFollowerImpl::CODES GreedyGeodesicFollowerImpl::nextActionAlong(
     const core::RigidState& start,
@@ -236,6 +255,253 @@ GreedyGeodesicFollowerImpl::findPath(const core::RigidState& start,
   return actions_;
 }
 
+namespace {
+// State of one (start, end) pair in findPaths
+struct Rollout {
+  scene::SceneNode* node;
+  scene::SceneNode *leftNode, *rightNode, *stepNode;
+  const GeodesicDistanceField* field;
+  Mn::Vector3 end;
+  float geodesicDistance;
+
+  // Primitive search state of the current step
+  bool planning;
+  float bestReward;
+  std::vector<GreedyGeodesicFollowerImpl::CODES> bestPrim, leftPrim, rightPrim;
+
+  std::vector<GreedyGeodesicFollowerImpl::CODES> actions;
+  // Rest of the primitive committed to when thrashing, in reverse order
+  std::vector<GreedyGeodesicFollowerImpl::CODES> thrashingActions;
+};
+}  // namespace
+
+std::vector<std::vector<GreedyGeodesicFollowerImpl::CODES>>
+GreedyGeodesicFollowerImpl::findPaths(
+    const std::vector<core::RigidState>& starts,
+    const std::vector<Mn::Vector3>& ends,
+    const unsigned int maxThreads) {
+  CORRADE_ASSERT(starts.size() == ends.size(),
+                 "GreedyGeodesicFollowerImpl::findPaths(): got"
+                     << starts.size() << "starts but" << ends.size() << "ends",
+                 {});
+  constexpr int maxActions = 5e3;
+  constexpr float goodEnoughRewardThresh = 0.99f;
+
+  // Same primitive count as the angle loop in nextBestPrimAlong
+  int maxTurns = 0;
+  for (float angle = 0; angle < M_PI; angle += turnAmount_) {
+    ++maxTurns;
+  }
+
+  // One distance field per distinct end
+  std::map<std::array<float, 3>, size_t> endToField;
+  std::vector<vec3f> fieldGoals;
+  std::vector<size_t> rolloutField(ends.size());
+  for (size_t i = 0; i < ends.size(); ++i) {
+    const auto it = endToField.emplace(
+        std::array<float, 3>{{ends[i].x(), ends[i].y(), ends[i].z()}},
+        fieldGoals.size());
+    if (it.second)
+      fieldGoals.emplace_back(cast<vec3f>(ends[i]));
+    rolloutField[i] = it.first->second;
+  }
+  const std::vector<GeodesicDistanceField::ptr> fields =
+      pathfinder_->buildGeodesicDistanceFields(
+          fieldGoals, 0.5f * forwardAmount_, maxThreads);
+
+  scene::SceneGraph rolloutScene;
+  scene::SceneNode& root = rolloutScene.getRootNode();
+  std::vector<Rollout> rollouts(starts.size());
+  std::vector<size_t> active;
+  for (size_t i = 0; i < rollouts.size(); ++i) {
+    Rollout& r = rollouts[i];
+    r.node = &root.createChild();
+    r.leftNode = &root.createChild();
+    r.rightNode = &root.createChild();
+    r.stepNode = &root.createChild();
+    r.node->setTranslation(starts[i].translation);
+    r.node->setRotation(starts[i].rotation);
+    r.field = fields[rolloutField[i]].get();
+    r.end = ends[i];
+    if (r.field) {
+      active.push_back(i);
+    } else {
+      r.actions.emplace_back(CODES::ERROR);
+    }
+  }
+
+  const auto takeAction = [this](scene::SceneNode* node, const CODES action) {
+    switch (action) {
+      case CODES::FORWARD:
+        moveForward_(node);
+        break;
+
+      case CODES::RIGHT:
+        turnRight_(node);
+        break;
+
+      case CODES::LEFT:
+        turnLeft_(node);
+        break;
+
+      default:
+        break;
+    }
+  };
+
+  std::vector<size_t> planned;
+  std::vector<const GeodesicDistanceField*> plannedFields;
+  std::vector<vec3f> plannedPositions;
+  std::vector<size_t> candidateRollouts;
+  std::vector<const GeodesicDistanceField*> candidateFields;
+  std::vector<vec3f> candidatePositions;
+  std::vector<char> candidateCollided;
+
+  while (!active.empty()) {
+    // Like nextActionAlong, pairs working off a committed primitive don't
+    // plan
+    planned.clear();
+    plannedFields.clear();
+    plannedPositions.clear();
+    for (const size_t i : active) {
+      Rollout& r = rollouts[i];
+      r.planning = false;
+      if (fixThrashing_ && !r.thrashingActions.empty())
+        continue;
+      planned.push_back(i);
+      plannedFields.push_back(r.field);
+      plannedPositions.emplace_back(
+          cast<vec3f>(r.node->MagnumObject::translation()));
+    }
+    const std::vector<float> plannedGeoDists = pathfinder_->geodesicDistances(
+        plannedFields, plannedPositions, maxThreads);
+
+    size_t numPlanning = 0;
+    for (size_t k = 0; k < planned.size(); ++k) {
+      Rollout& r = rollouts[planned[k]];
+      r.geodesicDistance = plannedGeoDists[k];
+      if (r.geodesicDistance == std::numeric_limits<float>::infinity()) {
+        r.actions.emplace_back(CODES::ERROR);
+        continue;
+      }
+      if (r.geodesicDistance < goalDist_) {
+        r.actions.emplace_back(CODES::STOP);
+        continue;
+      }
+
+      r.planning = true;
+      ++numPlanning;
+      r.bestReward = -collisionCost_;
+      r.bestPrim.clear();
+      r.leftPrim.clear();
+      r.rightPrim.clear();
+      r.leftNode->MagnumObject::setTransformation(
+          r.node->MagnumObject::transformation());
+      r.rightNode->MagnumObject::setTransformation(
+          r.node->MagnumObject::transformation());
+    }
+
+    // Evaluate the primitives with the same number of turns for all pairs at
+    // once, in the order nextBestPrimAlong would
+    for (int turn = 0; turn < maxTurns && numPlanning > 0; ++turn) {
+      candidateRollouts.clear();
+      candidateFields.clear();
+      candidatePositions.clear();
+      candidateCollided.clear();
+      for (const size_t i : planned) {
+        Rollout& r = rollouts[i];
+        if (!r.planning)
+          continue;
+        for (scene::SceneNode* sideNode : {r.leftNode, r.rightNode}) {
+          r.stepNode->MagnumObject::setTransformation(
+              sideNode->MagnumObject::transformation());
+          candidateCollided.push_back(moveForward_(r.stepNode));
+          candidatePositions.emplace_back(
+              cast<vec3f>(r.stepNode->MagnumObject::translation()));
+          candidateFields.push_back(r.field);
+          candidateRollouts.push_back(i);
+        }
+      }
+
+      const std::vector<float> candidateGeoDists =
+          pathfinder_->geodesicDistances(candidateFields, candidatePositions,
+                                         maxThreads);
+      const std::vector<float> candidateObsDists =
+          pathfinder_->distancesToClosestObstacle(
+              candidatePositions, 1.1 * closeToObsThreshold_, maxThreads);
+
+      for (size_t k = 0; k < candidatePositions.size(); k += 2) {
+        Rollout& r = rollouts[candidateRollouts[k]];
+        for (size_t side = 0; side < 2; ++side) {
+          const std::vector<CODES>& prim = side == 0 ? r.leftPrim : r.rightPrim;
+          const float reward = computeReward(
+              r.geodesicDistance,
+              {candidateGeoDists[k + side], candidateObsDists[k + side],
+               candidateCollided[k + side] != 0},
+              prim.size());
+          if (reward > r.bestReward) {
+            r.bestReward = reward;
+            r.bestPrim = prim;
+            r.bestPrim.emplace_back(CODES::FORWARD);
+          }
+        }
+
+        if (r.bestReward > goodEnoughRewardThresh) {
+          r.planning = false;
+          --numPlanning;
+          continue;
+        }
+
+        r.leftPrim.emplace_back(CODES::LEFT);
+        turnLeft_(r.leftNode);
+
+        r.rightPrim.emplace_back(CODES::RIGHT);
+        turnRight_(r.rightNode);
+      }
+    }
+
+    // Take the next action of every pair that is still going, choosing it
+    // the way nextActionAlong does
+    std::vector<size_t> stillActive;
+    for (const size_t i : active) {
+      Rollout& r = rollouts[i];
+      if (!r.actions.empty() && (r.actions.back() == CODES::STOP ||
+                                 r.actions.back() == CODES::ERROR))
+        continue;
+
+      CODES nextAction;
+      if (fixThrashing_ && !r.thrashingActions.empty()) {
+        nextAction = r.thrashingActions.back();
+        r.thrashingActions.pop_back();
+      } else if (r.bestPrim.size() == 0) {
+        r.actions.emplace_back(CODES::ERROR);
+        continue;
+      } else if (fixThrashing_ &&
+                 nav::isThrashing(r.actions, thrashingThreshold_)) {
+        r.thrashingActions = {r.bestPrim.rbegin(), r.bestPrim.rend()};
+        nextAction = r.thrashingActions.back();
+        r.thrashingActions.pop_back();
+      } else {
+        nextAction = r.bestPrim[0];
+      }
+
+      takeAction(r.node, nextAction);
+      r.actions.emplace_back(nextAction);
+      if (r.actions.size() < maxActions)
+        stillActive.push_back(i);
+    }
+    active.swap(stillActive);
+  }
+
+  std::vector<std::vector<CODES>> paths(rollouts.size());
+  for (size_t i = 0; i < rollouts.size(); ++i) {
+    std::vector<CODES>& actions = rollouts[i].actions;
+    if (actions.back() != CODES::ERROR && actions.size() < maxActions)
+      paths[i] = std::move(actions);
+  }
+  return paths;
+}
+
 GreedyGeodesicFollowerImpl::CODES GreedyGeodesicFollowerImpl::nextActionAlong(
     const Mn::Quaternion& currentRot,
     const Mn::Vector3& currentPos,
@@ -112,6 +112,36 @@ class GreedyGeodesicFollowerImpl {
   std::vector<CODES> findPath(const core::RigidState& start,
                               const Magnum::Vector3& end);
 
+  /**
+   * @brief Finds the full paths for many (start, end) pairs at once
+   *
+   * Each pair takes the actions that repeatedly calling @ref nextActionAlong
+   * would, including the thrashing fix, but the geodesic distance to each
+   * distinct end location is precomputed once as a @ref
+   * GeodesicDistanceField and reused for the whole rollout instead of a @ref
+   * PathFinder.findPath call per candidate primitive. All pairs are advanced
+   * in lockstep: the candidates with the same number of turns are evaluated
+   * for all pairs in one batch of navmesh queries that runs in parallel.
+   * Every pair is simulated on its own dummy nodes. The move functions are
+   * only called from the calling thread.
+   *
+   * As the distance field is an upper bound of the exact geodesic distance,
+   * the actions can differ slightly from those of @ref nextActionAlong.
+   *
+   * @warning Do not use this method if there is actuation noise.
+   *
+   * @param[in] starts The starting states
+   * @param[in] ends The end locations, one per start
+   * @param[in] maxThreads Upper bound on the worker threads. 0 uses all
+   *                       hardware threads.
+   *
+   * @return One action sequence per pair. Empty if no path was found.
+   */
+  std::vector<std::vector<CODES>> findPaths(
+      const std::vector<core::RigidState>& starts,
+      const std::vector<Magnum::Vector3>& ends,
+      unsigned int maxThreads = 0);
+
   /**
    * @brief Reset the planner.
    *
@@ -153,6 +183,10 @@ class GreedyGeodesicFollowerImpl {
                       const nav::ShortestPath& path,
                       const size_t primLen);
 
+  float computeReward(float geodesicDistance,
+                      const TryStepResult& tryStepRes,
+                      size_t primLen) const;
+
   bool isThrashing();
 
   std::vector<nav::GreedyGeodesicFollowerImpl::CODES> nextBestPrimAlong(
@@ -3,7 +3,14 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "PathFinder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <list>
 #include <numeric>
+#include <queue>
 #include <stack>
 #include <unordered_map>
 
@@ -22,8 +29,11 @@
 #include <limits>
 
 #include "esp/assets/MeshData.h"
+#include "esp/core/Parallel.h"
+#include "esp/core/Profiler.h"
 #include "esp/core/esp.h"
 
+#include "DetourCommon.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshBuilder.h"
 #include "DetourNavMeshQuery.h"
@@ -62,6 +72,40 @@ const std::vector<vec3f>& MultiGoalShortestPath::getRequestedEnds() const {
   return pimpl_->requestedEnds;
 }
 
+struct GeodesicDistanceField::Impl {
+  std::vector<vec3f> goals;
+
+  //! Goals snapped to the navmesh and the index of the polygon they are in
+  std::vector<vec3f> goalPoints;
+  std::vector<uint32_t> goalPolys;
+
+  //! Maps navmesh polygons to their index in polyNodeOffsets
+  std::unordered_map<dtPolyRef, uint32_t> polyToIndex;
+  std::vector<dtPolyRef> polyRefs;
+
+  //! The nodes on the boundary of polygon i are
+  //! polyNodes[polyNodeOffsets[i]..polyNodeOffsets[i + 1]]
+  std::vector<uint32_t> polyNodeOffsets;
+  std::vector<uint32_t> polyNodes;
+
+  std::vector<vec3f> nodePositions;
+  std::vector<float> nodeDistances;
+
+  //! navMeshHash() of the navmesh the field was built for
+  uint64_t navMeshHash = 0;
+};
+
+GeodesicDistanceField::GeodesicDistanceField()
+    : pimpl_{spimpl::make_unique_impl<Impl>()} {};
+
+const std::vector<vec3f>& GeodesicDistanceField::getGoals() const {
+  return pimpl_->goals;
+}
+
+size_t GeodesicDistanceField::getNumNodes() const {
+  return pimpl_->nodePositions.size();
+}
+
 namespace {
 template <typename T>
 std::tuple<dtStatus, dtPolyRef, vec3f> projectToPoly(
@@ -92,16 +136,21 @@ namespace impl {
 // Runs connected component analysis on the navmesh to figure out which polygons
 // are connected This gives O(1) lookup for if a path between two polygons
 // exists or not
+// Island ids are stored in a flat table indexed by the tile and polygon index
+// encoded in a dtPolyRef, so a lookup is a decode and two array reads.
 // Takes O(npolys) to construct
 class IslandSystem {
  public:
-  IslandSystem(const dtNavMesh* navMesh, const dtQueryFilter* filter) {
+  IslandSystem(const dtNavMesh* navMesh, const dtQueryFilter* filter)
+      : navMesh_(navMesh) {
+    allocate();
+
     std::vector<vec3f> islandVerts;
 
     // Iterate over all tiles
     for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
       const dtMeshTile* tile = navMesh->getTile(iTile);
-      if (!tile)
+      if (!tile || !tile->header)
         continue;
 
       // Iterate over all polygons in a tile
@@ -112,8 +161,8 @@ class IslandSystem {
         // If the polygon ref is valid, and we haven't seen it yet,
         // start connected component analysis from this polygon
         if (navMesh->isValidPolyRef(startRef) &&
-            (polyToIsland_.find(startRef) == polyToIsland_.end())) {
-          uint32_t newIslandId = islandRadius_.size();
+            polyIsland_[tileOffsets_[iTile] + jPoly] == ID_UNDEFINED) {
+          int newIslandId = islandRadius_.size();
           expandFrom(navMesh, filter, newIslandId, startRef, islandVerts);
 
           // The radius is calculated as the max deviation from the mean for all
@@ -135,38 +184,130 @@ class IslandSystem {
     }
   }
 
+  /**
+   * @brief Reads a table written by @ref save.
+   *
+   * @return nullptr if the file can't be read or the table doesn't match the
+   * tiles of @p navMesh.
+   */
+  static std::unique_ptr<IslandSystem> load(FILE* fp,
+                                            const dtNavMesh* navMesh) {
+    std::unique_ptr<IslandSystem> islands{new IslandSystem(navMesh)};
+    islands->allocate();
+
+    int counts[2] = {0, 0};  // numPolys, numIslands
+    if (fread(counts, sizeof(counts), 1, fp) != 1 ||
+        counts[0] != static_cast<int>(islands->polyIsland_.size()) ||
+        counts[1] < 0) {
+      return nullptr;
+    }
+    std::vector<unsigned int> salts(islands->tileSalts_.size());
+    if (!salts.empty() &&
+        fread(salts.data(), sizeof(unsigned int), salts.size(), fp) !=
+            salts.size()) {
+      return nullptr;
+    }
+    if (salts != islands->tileSalts_) {
+      return nullptr;
+    }
+
+    islands->islandRadius_.resize(counts[1]);
+    if ((!islands->polyIsland_.empty() &&
+         fread(islands->polyIsland_.data(), sizeof(int),
+               islands->polyIsland_.size(),
+               fp) != islands->polyIsland_.size()) ||
+        (!islands->islandRadius_.empty() &&
+         fread(islands->islandRadius_.data(), sizeof(float),
+               islands->islandRadius_.size(),
+               fp) != islands->islandRadius_.size())) {
+      return nullptr;
+    }
+    for (const int id : islands->polyIsland_) {
+      if (id < ID_UNDEFINED || id >= counts[1])
+        return nullptr;
+    }
+
+    return islands;
+  }
+
+  //! Writes the table for @ref load. The tile layout is implied by the navmesh
+  //! and only stored for validation.
+  void save(FILE* fp) const {
+    const int counts[2] = {static_cast<int>(polyIsland_.size()),
+                           static_cast<int>(islandRadius_.size())};
+    fwrite(counts, sizeof(counts), 1, fp);
+    fwrite(tileSalts_.data(), sizeof(unsigned int), tileSalts_.size(), fp);
+    fwrite(polyIsland_.data(), sizeof(int), polyIsland_.size(), fp);
+    fwrite(islandRadius_.data(), sizeof(float), islandRadius_.size(), fp);
+  }
+
   inline bool hasConnection(dtPolyRef startRef, dtPolyRef endRef) const {
     // If both polygons are on the same island, there must be a path between
     // them
-    auto itStart = polyToIsland_.find(startRef);
-    if (itStart == polyToIsland_.end())
-      return false;
+    const int startIsland = islandId(startRef);
+    return startIsland != ID_UNDEFINED && startIsland == islandId(endRef);
+  }
 
-    auto itEnd = polyToIsland_.find(endRef);
-    if (itEnd == polyToIsland_.end())
-      return false;
+  inline int islandId(dtPolyRef ref) const {
+    unsigned int salt = 0, iTile = 0, iPoly = 0;
+    navMesh_->decodePolyId(ref, salt, iTile, iPoly);
+    if (ref == 0 || iTile >= tileSalts_.size() || tileSalts_[iTile] != salt ||
+        iPoly >= tileOffsets_[iTile + 1] - tileOffsets_[iTile])
+      return ID_UNDEFINED;
 
-    return itStart->second == itEnd->second;
+    return polyIsland_[tileOffsets_[iTile] + iPoly];
   }
 
   inline float islandRadius(dtPolyRef ref) const {
-    auto itRef = polyToIsland_.find(ref);
-    if (itRef == polyToIsland_.end())
+    const int island = islandId(ref);
+    if (island == ID_UNDEFINED)
       return 0.0;
 
-    return islandRadius_[itRef->second];
+    return islandRadius_[island];
   }
 
  private:
-  std::unordered_map<dtPolyRef, uint32_t> polyToIsland_;
+  explicit IslandSystem(const dtNavMesh* navMesh) : navMesh_(navMesh) {}
+
+  // Sizes the tables for the tiles of navMesh_ with all polygons unassigned
+  void allocate() {
+    const int maxTiles = navMesh_->getMaxTiles();
+    tileSalts_.assign(maxTiles, 0);
+    tileOffsets_.assign(maxTiles + 1, 0);
+    for (int iTile = 0; iTile < maxTiles; ++iTile) {
+      const dtMeshTile* tile = navMesh_->getTile(iTile);
+      int polyCount = 0;
+      if (tile && tile->header) {
+        tileSalts_[iTile] = tile->salt;
+        polyCount = tile->header->polyCount;
+      }
+      tileOffsets_[iTile + 1] = tileOffsets_[iTile] + polyCount;
+    }
+    polyIsland_.assign(tileOffsets_.back(), ID_UNDEFINED);
+  }
+
+  // Island id slot of a polygon known to be valid
+  inline int& islandSlot(dtPolyRef ref) {
+    unsigned int salt = 0, iTile = 0, iPoly = 0;
+    navMesh_->decodePolyId(ref, salt, iTile, iPoly);
+    return polyIsland_[tileOffsets_[iTile] + iPoly];
+  }
+
+  const dtNavMesh* navMesh_;
+  //! Salt of every tile index, to reject refs into replaced tiles
+  std::vector<unsigned int> tileSalts_;
+  //! Offset of the first polygon of every tile index into polyIsland_
+  std::vector<uint32_t> tileOffsets_;
+  //! Island of every polygon, ID_UNDEFINED if it wasn't reached
+  std::vector<int> polyIsland_;
   std::vector<float> islandRadius_;
 
   void expandFrom(const dtNavMesh* navMesh,
                   const dtQueryFilter* filter,
-                  const uint32_t newIslandId,
+                  const int newIslandId,
                   const dtPolyRef& startRef,
                   std::vector<vec3f>& islandVerts) {
-    polyToIsland_.emplace(startRef, newIslandId);
+    islandSlot(startRef) = newIslandId;
     islandVerts.clear();
 
     // Force std::stack to be implemented via an std::vector as linked
@@ -193,7 +334,8 @@ class IslandSystem {
            iLink = tile->links[iLink].next) {
         dtPolyRef neighbourRef = tile->links[iLink].ref;
         // If we've already visited this poly, skip it!
-        if (polyToIsland_.find(neighbourRef) != polyToIsland_.end())
+        int& neighbourIsland = islandSlot(neighbourRef);
+        if (neighbourIsland != ID_UNDEFINED)
           continue;
 
         const dtMeshTile* neighbourTile = nullptr;
@@ -205,14 +347,513 @@ class IslandSystem {
         if (!filter->passFilter(neighbourRef, neighbourTile, neighbourPoly))
           continue;
 
-        polyToIsland_.emplace(neighbourRef, newIslandId);
+        neighbourIsland = newIslandId;
         stack.push(neighbourRef);
       }
     }
   }
 };
+
+// Evaluates the edge functions of the n triangles (x0, z0), (x1, z1),
+// (x2, z2) at (px, pz) into e0, e1, e2 and whether the point is inside each
+// triangle into inside. The comparisons are combined with & instead of &&
+// as GCC doesn't vectorize the branches of the latter.
+/* Clang doesn't have target_clones yet: https://reviews.llvm.org/D51650 */
+#if defined(CORRADE_TARGET_X86) && defined(__GNUC__) && __GNUC__ >= 6
+__attribute__((target_clones("default", "sse4.2", "avx2")))
+#endif
+void triangleEdgeFunctions(const uint32_t n,
+                           const float px,
+                           const float pz,
+                           const float* __restrict__ x0,
+                           const float* __restrict__ z0,
+                           const float* __restrict__ x1,
+                           const float* __restrict__ z1,
+                           const float* __restrict__ x2,
+                           const float* __restrict__ z2,
+                           float* __restrict__ e0,
+                           float* __restrict__ e1,
+                           float* __restrict__ e2,
+                           unsigned char* __restrict__ inside) {
+  for (uint32_t i = 0; i < n; ++i) {
+    e0[i] = (x1[i] - x0[i]) * (pz - z0[i]) - (z1[i] - z0[i]) * (px - x0[i]);
+    e1[i] = (x2[i] - x1[i]) * (pz - z1[i]) - (z2[i] - z1[i]) * (px - x1[i]);
+    e2[i] = (x0[i] - x2[i]) * (pz - z2[i]) - (z0[i] - z2[i]) * (px - x2[i]);
+    inside[i] = ((e0[i] >= 0) & (e1[i] >= 0) & (e2[i] >= 0)) |
+                ((e0[i] <= 0) & (e1[i] <= 0) & (e2[i] <= 0));
+  }
+}
+
+// Uniform xz grid over the detail triangles of all walkable navmesh polygons.
+// Finds the polygon a point stands on with a few point in triangle tests
+// instead of a findNearestPoly search. The triangles of each cell are stored
+// contiguously as structure of arrays so that the tests vectorize, see
+// triangleEdgeFunctions().
+// Takes O(ntris) to construct
+class PolyGridIndex {
+ public:
+  PolyGridIndex(const dtNavMesh* navMesh, const dtQueryFilter* filter) {
+    std::vector<Triangle> tris;
+    float bmin[2] = {std::numeric_limits<float>::max(),
+                     std::numeric_limits<float>::max()};
+    float bmax[2] = {-std::numeric_limits<float>::max(),
+                     -std::numeric_limits<float>::max()};
+
+    // Iterate over all tiles
+    for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+      const dtMeshTile* tile = navMesh->getTile(iTile);
+      if (!tile || !tile->header)
+        continue;
+
+      // Iterate over all polygons in a tile
+      for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+        const dtPoly* poly = &tile->polys[jPoly];
+        const dtPolyRef ref = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+        if (poly->getType() != DT_POLYTYPE_GROUND ||
+            !filter->passFilter(ref, tile, poly))
+          continue;
+
+        const uint32_t polyIdx = polyRefs_.size();
+        polyRefs_.push_back(ref);
+        polyClimb_.push_back(tile->header->walkableClimb);
+
+        // Same triangle iteration as getPolygonTriangles
+        const dtPolyDetail* pd = &tile->detailMeshes[jPoly];
+        for (int k = 0; k < pd->triCount; ++k) {
+          const unsigned char* t = &tile->detailTris[(pd->triBase + k) * 4];
+          Triangle tri;
+          tri.poly = polyIdx;
+          for (int m = 0; m < 3; ++m) {
+            const float* v =
+                t[m] < poly->vertCount
+                    ? &tile->verts[poly->verts[t[m]] * 3]
+                    : &tile->detailVerts[(pd->vertBase + t[m] -
+                                          poly->vertCount) *
+                                         3];
+            rcVcopy(tri.v[m], v);
+            bmin[0] = std::min(bmin[0], v[0]);
+            bmin[1] = std::min(bmin[1], v[2]);
+            bmax[0] = std::max(bmax[0], v[0]);
+            bmax[1] = std::max(bmax[1], v[2]);
+          }
+          tris.push_back(tri);
+        }
+      }
+    }
+    if (tris.empty())
+      return;
+
+    // Aim for a few triangles per cell, but keep the grid itself small
+    cellSize_ = 0.5f;
+    while ((bmax[0] - bmin[0]) * (bmax[1] - bmin[1]) /
+               (cellSize_ * cellSize_) >
+           (1 << 22)) {
+      cellSize_ *= 2;
+    }
+    origin_[0] = bmin[0];
+    origin_[1] = bmin[1];
+    width_ = static_cast<int>((bmax[0] - bmin[0]) / cellSize_) + 1;
+    height_ = static_cast<int>((bmax[1] - bmin[1]) / cellSize_) + 1;
+
+    // Counting sort of the triangles into every cell their bounds overlap
+    auto cellRange = [this](const Triangle& tri, int range[4]) {
+      const float xmin = std::min({tri.v[0][0], tri.v[1][0], tri.v[2][0]});
+      const float xmax = std::max({tri.v[0][0], tri.v[1][0], tri.v[2][0]});
+      const float zmin = std::min({tri.v[0][2], tri.v[1][2], tri.v[2][2]});
+      const float zmax = std::max({tri.v[0][2], tri.v[1][2], tri.v[2][2]});
+      range[0] = cellCoord(xmin, 0);
+      range[1] = cellCoord(xmax, 0);
+      range[2] = cellCoord(zmin, 1);
+      range[3] = cellCoord(zmax, 1);
+    };
+    cellOffsets_.assign(width_ * height_ + 1, 0);
+    int range[4];
+    for (const Triangle& tri : tris) {
+      cellRange(tri, range);
+      for (int z = range[2]; z <= range[3]; ++z)
+        for (int x = range[0]; x <= range[1]; ++x)
+          ++cellOffsets_[z * width_ + x + 1];
+    }
+    for (size_t i = 1; i < cellOffsets_.size(); ++i) {
+      cellOffsets_[i] += cellOffsets_[i - 1];
+    }
+
+    const size_t numEntries = cellOffsets_.back();
+    for (auto* coord : {&x0_, &z0_, &y0_, &x1_, &z1_, &y1_, &x2_, &z2_, &y2_})
+      coord->resize(numEntries);
+    triPoly_.resize(numEntries);
+    std::vector<uint32_t> fill(cellOffsets_.begin(), cellOffsets_.end() - 1);
+    for (const Triangle& tri : tris) {
+      cellRange(tri, range);
+      for (int z = range[2]; z <= range[3]; ++z) {
+        for (int x = range[0]; x <= range[1]; ++x) {
+          const uint32_t i = fill[z * width_ + x]++;
+          x0_[i] = tri.v[0][0];
+          y0_[i] = tri.v[0][1];
+          z0_[i] = tri.v[0][2];
+          x1_[i] = tri.v[1][0];
+          y1_[i] = tri.v[1][1];
+          z1_[i] = tri.v[1][2];
+          x2_[i] = tri.v[2][0];
+          y2_[i] = tri.v[2][1];
+          z2_[i] = tri.v[2][2];
+          triPoly_[i] = tri.poly;
+        }
+      }
+    }
+  }
+
+  // Finds the walkable polygon directly above or below pt whose surface is at
+  // most walkableClimb away from it. That's the case in which findNearestPoly
+  // has nothing better to find, so it returns the same polygon and point.
+  // Returns false if there is no such polygon; callers then fall back to
+  // findNearestPoly.
+  bool project(const vec3f& pt, dtPolyRef& ref, vec3f& projected) const {
+    float bestDy = std::numeric_limits<float>::max();
+    forEachCovering(pt[0], pt[2], [&](uint32_t j, float y) {
+      const float dy = std::abs(y - pt[1]);
+      if (dy <= polyClimb_[triPoly_[j]] && dy < bestDy) {
+        bestDy = dy;
+        ref = polyRefs_[triPoly_[j]];
+        projected = vec3f(pt[0], y, pt[2]);
+      }
+    });
+    return bestDy != std::numeric_limits<float>::max();
+  }
+
+  // Appends the heights of all walkable surfaces above or below (x, z)
+  void surfaceHeights(float x, float z, std::vector<float>& heights) const {
+    forEachCovering(x, z, [&heights](uint32_t, float y) {
+      heights.push_back(y);
+    });
+  }
+
+ private:
+  // Calls fn(entry, y) for every triangle entry covering (px, pz) in xz, with
+  // y the height of the triangle at that point
+  template <typename Fn>
+  void forEachCovering(float px, float pz, Fn&& fn) const {
+    if (cellOffsets_.empty())
+      return;
+    const int cx = static_cast<int>(std::floor((px - origin_[0]) / cellSize_));
+    const int cz = static_cast<int>(std::floor((pz - origin_[1]) / cellSize_));
+    if (cx < 0 || cz < 0 || cx >= width_ || cz >= height_)
+      return;
+    const uint32_t begin = cellOffsets_[cz * width_ + cx];
+    const uint32_t end = cellOffsets_[cz * width_ + cx + 1];
+
+    // Branch free edge function tests over the whole cell
+    thread_local EdgeScratch scratch;
+    const uint32_t n = end - begin;
+    scratch.resize(n);
+    triangleEdgeFunctions(n, px, pz, &x0_[begin], &z0_[begin], &x1_[begin],
+                          &z1_[begin], &x2_[begin], &z2_[begin],
+                          scratch.e0.data(), scratch.e1.data(),
+                          scratch.e2.data(), scratch.inside.data());
+
+    for (uint32_t i = 0; i < n; ++i) {
+      if (!scratch.inside[i])
+        continue;
+      const float e0 = scratch.e0[i], e1 = scratch.e1[i], e2 = scratch.e2[i];
+      const float area = e0 + e1 + e2;
+      if (std::abs(area) < 1e-12f)
+        continue;
+      // Barycentric interpolation of the height, e0 is opposite vertex 2
+      const uint32_t j = begin + i;
+      fn(j, (e1 * y0_[j] + e2 * y1_[j] + e0 * y2_[j]) / area);
+    }
+  }
+
+  // Per thread output of triangleEdgeFunctions() for one cell
+  struct EdgeScratch {
+    std::vector<float> e0, e1, e2;
+    std::vector<unsigned char> inside;
+
+    void resize(const uint32_t n) {
+      e0.resize(n);
+      e1.resize(n);
+      e2.resize(n);
+      inside.resize(n);
+    }
+  };
+
+  struct Triangle {
+    float v[3][3];
+    uint32_t poly;
+  };
+
+  int cellCoord(float coord, int axis) const {
+    const int c =
+        static_cast<int>(std::floor((coord - origin_[axis]) / cellSize_));
+    return std::max(0, std::min(c, (axis == 0 ? width_ : height_) - 1));
+  }
+
+  float cellSize_ = 0;
+  float origin_[2] = {0, 0};
+  int width_ = 0, height_ = 0;
+
+  std::vector<dtPolyRef> polyRefs_;
+  std::vector<float> polyClimb_;
+
+  //! Start of the triangles of each cell, in row major cell order
+  std::vector<uint32_t> cellOffsets_;
+  //! Triangle vertices per cell entry
+  std::vector<float> x0_, z0_, y0_, x1_, z1_, y1_, x2_, z2_, y2_;
+  std::vector<uint32_t> triPoly_;
+};
+
+// Distance to the closest navmesh boundary sampled on a regular xz grid. Each
+// grid node has one sample per walkable surface above or below it, so stacked
+// floors are kept apart (2.5D). Distances are saturated at maxDistance.
+struct ObstacleDistanceField {
+  float cellSize = 0;
+  float maxDistance = 0;
+  float origin[2] = {0, 0};
+  int width = 0;
+  int height = 0;
+  //! navMeshHash() of the navmesh the field was built for
+  uint64_t navMeshHash = 0;
+
+  //! Start of the samples of each node, in row major node order
+  std::vector<uint32_t> nodeOffsets;
+  std::vector<float> sampleHeights;
+  std::vector<float> sampleDistances;
+
+  // Bilinearly interpolates the distance at pt, which must lie on the
+  // navmesh. Returns false if a surrounding node has no sample close to the
+  // height of pt or is saturated, in which case the exact distance has to be
+  // computed instead.
+  bool lookup(const vec3f& pt, float& distance) const {
+    // Max height difference to a sample of the same surface
+    constexpr float maxSampleDy = 0.5;
+
+    const float fx = (pt[0] - origin[0]) / cellSize;
+    const float fz = (pt[2] - origin[1]) / cellSize;
+    const int x = static_cast<int>(std::floor(fx));
+    const int z = static_cast<int>(std::floor(fz));
+    if (x < 0 || z < 0 || x + 1 >= width || z + 1 >= height)
+      return false;
+
+    float corners[4];
+    for (int c = 0; c < 4; ++c) {
+      const int node = (z + c / 2) * width + x + c % 2;
+      float bestDy = maxSampleDy;
+      int best = -1;
+      for (uint32_t i = nodeOffsets[node]; i < nodeOffsets[node + 1]; ++i) {
+        const float dy = std::abs(sampleHeights[i] - pt[1]);
+        if (dy <= bestDy) {
+          bestDy = dy;
+          best = i;
+        }
+      }
+      if (best < 0 || sampleDistances[best] >= maxDistance)
+        return false;
+      corners[c] = sampleDistances[best];
+    }
+
+    const float tx = fx - x;
+    const float tz = fz - z;
+    distance = (1 - tz) * ((1 - tx) * corners[0] + tx * corners[1]) +
+               tz * ((1 - tx) * corners[2] + tx * corners[3]);
+    return true;
+  }
+};
+
+// Small counter based generator, so that every sample gets its own
+// deterministic stream no matter which thread draws it
+class SplitMix64 {
+ public:
+  explicit SplitMix64(uint64_t seed) : state_(seed) {}
+
+  uint64_t next() {
+    uint64_t z = (state_ += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  //! Uniform float in [0, 1)
+  float uniform() { return (next() >> 40) * (1.0f / (1u << 24)); }
+
+ private:
+  uint64_t state_;
+};
+
+// Area weighted sampling of points on the walkable navmesh triangles.
+// Triangles that can't pass a filter are excluded from the alias table up
+// front, so only the per point checks need rejection sampling.
+// Takes O(ntris) to construct and O(1) per sample
+class TriangleSampler {
+ public:
+  TriangleSampler(const dtNavMesh* navMesh,
+                  const dtQueryFilter* filter,
+                  const IslandSystem& islandSystem) {
+    for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+      const dtMeshTile* tile = navMesh->getTile(iTile);
+      if (!tile || !tile->header)
+        continue;
+
+      for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+        const dtPoly* poly = &tile->polys[jPoly];
+        const dtPolyRef ref = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+        if (poly->getType() != DT_POLYTYPE_GROUND ||
+            !filter->passFilter(ref, tile, poly))
+          continue;
+
+        const dtPolyDetail* pd = &tile->detailMeshes[jPoly];
+        for (int k = 0; k < pd->triCount; ++k) {
+          const unsigned char* t = &tile->detailTris[(pd->triBase + k) * 4];
+          Triangle tri;
+          for (int m = 0; m < 3; ++m) {
+            tri.v[m] = Eigen::Map<const vec3f>(
+                t[m] < poly->vertCount
+                    ? &tile->verts[poly->verts[t[m]] * 3]
+                    : &tile->detailVerts[(pd->vertBase + t[m] -
+                                          poly->vertCount) *
+                                         3]);
+          }
+          tri.area =
+              0.5f * (tri.v[1] - tri.v[0]).cross(tri.v[2] - tri.v[0]).norm();
+          if (tri.area <= 0)
+            continue;
+          tri.poly = ref;
+          tri.island = islandSystem.islandId(ref);
+          tri.islandRadius = islandSystem.islandRadius(ref);
+          tris_.push_back(tri);
+        }
+      }
+    }
+  }
+
+  struct Triangle {
+    vec3f v[3];
+    float area;
+    dtPolyRef poly;
+    int island;
+    float islandRadius;
+  };
+
+  // Selects the triangles that can contain points passing the filter and
+  // builds their alias table. Returns false if there are none. The table of
+  // the last filter is kept, as the same filter is usually used repeatedly.
+  bool prepare(const NavigablePointFilter& f) {
+    if (tableFilter_ && tableFilter_->islandId == f.islandId &&
+        tableFilter_->minIslandRadius == f.minIslandRadius &&
+        tableFilter_->minHeight == f.minHeight &&
+        tableFilter_->maxHeight == f.maxHeight) {
+      return !tableTris_.empty();
+    }
+    tableFilter_ = f;
+
+    tableTris_.clear();
+    std::vector<double> weights;
+    double totalWeight = 0;
+    for (uint32_t i = 0; i < tris_.size(); ++i) {
+      const Triangle& tri = tris_[i];
+      if ((f.islandId != ID_UNDEFINED && tri.island != f.islandId) ||
+          tri.islandRadius < f.minIslandRadius ||
+          std::max({tri.v[0][1], tri.v[1][1], tri.v[2][1]}) < f.minHeight ||
+          std::min({tri.v[0][1], tri.v[1][1], tri.v[2][1]}) > f.maxHeight)
+        continue;
+      tableTris_.push_back(i);
+      weights.push_back(tri.area);
+      totalWeight += tri.area;
+    }
+
+    // Vose's alias method
+    const size_t n = tableTris_.size();
+    prob_.assign(n, 1);
+    alias_.resize(n);
+    std::iota(alias_.begin(), alias_.end(), 0);
+    std::vector<uint32_t> small, large;
+    for (uint32_t i = 0; i < n; ++i) {
+      weights[i] *= n / totalWeight;
+      (weights[i] < 1 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+      const uint32_t s = small.back();
+      small.pop_back();
+      const uint32_t l = large.back();
+      prob_[s] = weights[s];
+      alias_[s] = l;
+      weights[l] -= 1 - weights[s];
+      if (weights[l] < 1) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    return n > 0;
+  }
+
+  // Draws a triangle from the prepared table using u in [0, 1), then a
+  // uniformly distributed point on it using rng
+  const Triangle& sample(float u, SplitMix64& rng, vec3f& pt) const {
+    const float scaled = u * prob_.size();
+    const uint32_t column =
+        std::min<uint32_t>(static_cast<uint32_t>(scaled), prob_.size() - 1);
+    const uint32_t i =
+        scaled - column < prob_[column] ? column : alias_[column];
+    const Triangle& tri = tris_[tableTris_[i]];
+
+    const float r1 = std::sqrt(rng.uniform());
+    const float r2 = rng.uniform();
+    pt = (1 - r1) * tri.v[0] + r1 * (1 - r2) * tri.v[1] + r1 * r2 * tri.v[2];
+    return tri;
+  }
+
+ private:
+  std::vector<Triangle> tris_;
+
+  Cr::Containers::Optional<NavigablePointFilter> tableFilter_;
+  std::vector<uint32_t> tableTris_;
+  std::vector<float> prob_;
+  std::vector<uint32_t> alias_;
+};
 }  // namespace impl
 
+namespace {
+// Output of buildTileNavData
+struct TileBuildResult {
+  unsigned char* navData = nullptr;
+  int navDataSize = 0;
+  int numVerts = 0;
+  int numPolys = 0;
+};
+
+// Tile layout and Recast config of a tiled build, kept around so that single
+// tiles can be rebuilt later on
+struct TiledBuildConfig {
+  NavMeshSettings settings;
+  //! Config of the whole mesh
+  rcConfig meshCfg{};
+  //! Config of a single tile including its border
+  rcConfig tileCfg{};
+  int tilesX = 0;
+  int tilesY = 0;
+  float tileWorldSize = 0;
+  float borderWorldSize = 0;
+};
+
+// A batch of built tiles that still has to be added to a navmesh. Owns the
+// tile data until it is handed over.
+struct TileUpdate {
+  TileUpdate() = default;
+  TileUpdate(TileUpdate&&) = default;
+  TileUpdate& operator=(TileUpdate&&) = delete;
+  ~TileUpdate() {
+    for (auto& result : results) {
+      dtFree(result.navData);
+    }
+  }
+
+  bool success = false;
+  //! Tile indices (y * tilesX + x)
+  std::vector<int> tiles;
+  //! Build result of each tile in tiles. navData is null for empty tiles.
+  std::vector<TileBuildResult> results;
+};
+}  // namespace
+
 struct PathFinder::Impl {
   Impl();
   ~Impl() = default;
@@ -226,11 +867,47 @@ struct PathFinder::Impl {
              const float* bmax);
   bool build(const NavMeshSettings& bs, const esp::assets::MeshData& mesh);
 
+  bool supportsTileUpdates() const { return bool(tiledBuild_); }
+  bool updateTilesAsync(const esp::assets::MeshData& mesh,
+                        const std::vector<std::pair<vec3f, vec3f>>& regions);
+  bool hasPendingTileUpdates() const { return pendingTileUpdate_.valid(); }
+  bool applyTileUpdates(bool wait);
+
   vec3f getRandomNavigablePoint(int maxTries);
 
+  std::vector<vec3f> sampleNavigablePoints(int numPoints,
+                                           uint32_t seed,
+                                           const NavigablePointFilter& filter,
+                                           int maxTries,
+                                           unsigned int maxThreads);
+
   bool findPath(ShortestPath& path);
   bool findPath(MultiGoalShortestPath& path);
 
+  int findPaths(std::vector<ShortestPath>& paths, unsigned int maxThreads);
+  void setPathSearchLimits(int maxPathPolys, int maxSearchNodes);
+  std::vector<float> geodesicDistances(const std::vector<vec3f>& starts,
+                                       const std::vector<vec3f>& ends,
+                                       unsigned int maxThreads);
+
+  GeodesicDistanceField::ptr buildGeodesicDistanceField(
+      const std::vector<vec3f>& goals,
+      float edgeSampleSpacing);
+  std::vector<GeodesicDistanceField::ptr> buildGeodesicDistanceFields(
+      const std::vector<vec3f>& goals,
+      float edgeSampleSpacing,
+      unsigned int maxThreads);
+  float geodesicDistance(const GeodesicDistanceField& field,
+                         const vec3f& pt) const;
+  std::vector<float> geodesicDistances(
+      const std::vector<const GeodesicDistanceField*>& fields,
+      const std::vector<vec3f>& pts,
+      unsigned int maxThreads);
+  bool saveGeodesicDistanceField(const GeodesicDistanceField& field,
+                                 const std::string& path) const;
+  GeodesicDistanceField::ptr loadGeodesicDistanceField(
+      const std::string& path) const;
+
   template <typename T>
   T tryStep(const T& start, const T& end, bool allowSliding);
 
@@ -249,6 +926,8 @@ struct PathFinder::Impl {
 
   float islandRadius(const vec3f& pt) const;
 
+  int islandId(const vec3f& pt) const;
+
   float distanceToClosestObstacle(const vec3f& pt,
                                   const float maxSearchRadius = 2.0) const;
   HitRecord closestObstacleSurfacePoint(
@@ -257,11 +936,30 @@ struct PathFinder::Impl {
 
   bool isNavigable(const vec3f& pt, const float maxYDelta = 0.5) const;
 
+  bool buildObstacleDistanceField(float cellSize, float maxDistance);
+  bool hasObstacleDistanceField() const { return obstacleField_ != nullptr; }
+  void clearObstacleDistanceField() { obstacleField_.reset(); }
+  bool saveObstacleDistanceField(const std::string& path) const;
+  bool loadObstacleDistanceField(const std::string& path);
+
+  std::vector<vec3f> snapPoints(const std::vector<vec3f>& pts,
+                                unsigned int maxThreads);
+  std::vector<bool> isNavigableBatch(const std::vector<vec3f>& pts,
+                                     float maxYDelta,
+                                     unsigned int maxThreads);
+  std::vector<float> distancesToClosestObstacle(
+      const std::vector<vec3f>& pts,
+      float maxSearchRadius,
+      unsigned int maxThreads);
+
   std::pair<vec3f, vec3f> bounds() const { return bounds_; };
 
   Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> getTopDownView(
       const float metersPerPixel,
       const float height);
+  std::vector<Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>>
+  getTopDownViews(const float metersPerPixel,
+                  const std::vector<float>& heights);
 
   const assets::MeshData::ptr getNavMeshData();
 
@@ -278,29 +976,106 @@ struct PathFinder::Impl {
   std::unique_ptr<dtQueryFilter> filter_ = nullptr;
   std::unique_ptr<impl::IslandSystem> islandSystem_ = nullptr;
 
+  //! Spatial index used by the batch point queries. Built on first use and
+  //! reset with navQuery_.
+  std::unique_ptr<impl::PolyGridIndex> polyIndex_ = nullptr;
+
+  //! Optional precomputed distance to the closest obstacle. Reset with
+  //! navQuery_.
+  std::unique_ptr<impl::ObstacleDistanceField> obstacleField_ = nullptr;
+
+  //! Area weighted triangle sampler for sampleNavigablePoints. Built on first
+  //! use and reset with navQuery_.
+  std::unique_ptr<impl::TriangleSampler> triangleSampler_ = nullptr;
+
+  //! One query object per batch worker thread, all sharing navMesh_ which is
+  //! read-only during queries. Grown on demand by findPaths and reset with
+  //! navQuery_.
+  std::vector<std::unique_ptr<dtNavMeshQuery, NavQueryDeleter>> workerQueries_;
+
+  //! Sizes the path buffers and search node pools of the queries grow up to
+  int maxPathPolys_;
+  int maxSearchNodes_;
+
   //! Holds triangulated geom/topo. Generated when queried. Reset with
   //! navQuery_.
   assets::MeshData::ptr meshData_ = nullptr;
 
+  //! The MAX_CACHED_TOP_DOWN_VIEWS most recently used top down maps keyed on
+  //! (metersPerPixel, height), most recent first. Reset with navQuery_ as the
+  //! maps are only valid for the navmesh they were rasterized from.
+  std::list<std::pair<std::pair<float, float>,
+                      Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>>>
+      topDownViewCache_;
+
   //! Sum of all NavMesh polygons. Computed on NavMesh load/recompute. See
   //! removeZeroAreaPolys.
   float navMeshArea_ = 0;
 
   std::pair<vec3f, vec3f> bounds_;
 
+  //! Layout of the last tiled build. Unset for single tile or loaded navmeshes,
+  //! which can't be updated tile by tile.
+  Cr::Containers::Optional<TiledBuildConfig> tiledBuild_;
+
+  //! Tiles being rebuilt in the background by updateTilesAsync
+  std::future<TileUpdate> pendingTileUpdate_;
+
+  //! Waits for and drops any pending tile update
+  void discardTileUpdates();
+
   void removeZeroAreaPolys();
 
-  bool initNavQuery();
+  /**
+   * @brief Recreates the navmesh query and everything derived from the
+   * navmesh.
+   *
+   * @param islandSystem Islands of the current navmesh, e.g. read from a
+   * navmesh file. Computed from the navmesh if nullptr.
+   */
+  bool initNavQuery(
+      std::unique_ptr<impl::IslandSystem> islandSystem = nullptr);
+
+  bool buildTiled(const NavMeshSettings& bs,
+                  const rcConfig& meshCfg,
+                  const float* verts,
+                  const int nverts,
+                  const int* tris,
+                  const int ntris);
+
+  // Same as the public findPath overloads but run against the given query
+  // object so that they can be called concurrently from worker threads
+  bool findPath(ShortestPath& path, dtNavMeshQuery* navQuery);
+  bool findPath(MultiGoalShortestPath& path, dtNavMeshQuery* navQuery);
+  GeodesicDistanceField::ptr buildGeodesicDistanceField(
+      const std::vector<vec3f>& goals,
+      float edgeSampleSpacing,
+      const dtNavMeshQuery* navQuery);
+  float geodesicDistance(const GeodesicDistanceField& field,
+                         const vec3f& pt,
+                         const dtNavMeshQuery* navQuery) const;
+
+  bool ensureWorkerQueries(unsigned int numWorkers);
+
+  // Projects pt onto the navmesh like projectToPoly, but uses polyIndex_ for
+  // points standing on the navmesh. Thread safe once polyIndex_ is built.
+  std::tuple<dtStatus, dtPolyRef, vec3f> projectToPolyIndexed(
+      const vec3f& pt) const;
+
+  const impl::PolyGridIndex& polyIndex();
 
   Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
-  findPathInternal(const vec3f& start,
+  findPathInternal(dtNavMeshQuery* navQuery,
+                   const vec3f& start,
                    dtPolyRef startRef,
                    const vec3f& pathStart,
                    const vec3f& end,
                    dtPolyRef endRef,
-                   const vec3f& pathEnd);
+                   const vec3f& pathEnd,
+                   bool& partial);
 
-  bool findPathSetup(MultiGoalShortestPath& path,
+  bool findPathSetup(dtNavMeshQuery* navQuery,
+                     MultiGoalShortestPath& path,
                      dtPolyRef& startRef,
                      vec3f& pathStart);
 };
@@ -332,56 +1107,72 @@ enum PolyFlags {
   POLYFLAGS_DISABLED = 0x04,  // disabled polygon
   POLYFLAGS_ALL = 0xffff      // all abilities
 };
-}  // namespace
 
-PathFinder::Impl::Impl() {
-  filter_ = std::make_unique<dtQueryFilter>();
-  filter_->setIncludeFlags(POLYFLAGS_WALK);
-  filter_->setExcludeFlags(0);
+// Queries start out with small path and search node buffers and grow them up
+// to these limits when a search runs out of space. dtNodePool indexes nodes
+// with 16 bits, so the node pool can't grow any further.
+constexpr int DEFAULT_PATH_POLYS = 256;
+constexpr int MAX_PATH_POLYS = 1 << 16;
+constexpr int DEFAULT_QUERY_NODES = 2048;
+constexpr int MAX_QUERY_NODES = 0xffff;
+
+// Per thread scratch buffers for path queries. They only ever grow, so once
+// warmed up the common case doesn't allocate.
+struct PathScratch {
+  std::vector<dtPolyRef> polys = std::vector<dtPolyRef>(DEFAULT_PATH_POLYS);
+};
+
+PathScratch& pathScratch() {
+  thread_local PathScratch scratch;
+  return scratch;
 }
 
-bool PathFinder::Impl::build(const NavMeshSettings& bs,
-                             const float* verts,
-                             const int nverts,
-                             const int* tris,
-                             const int ntris,
-                             const float* bmin,
-                             const float* bmax) {
-  Workspace ws;
-  rcContext ctx;
+// Grows the node pool of navQuery up to limit nodes after a search ran out
+// of nodes. Returns false if it is already at its limit.
+bool growNodePool(dtNavMeshQuery* navQuery,
+                  const dtNavMesh* navMesh,
+                  const int limit) {
+  const int maxNodes = navQuery->getNodePool()->getMaxNodes();
+  if (maxNodes >= limit)
+    return false;
+  return dtStatusSucceed(
+      navQuery->init(navMesh, std::min(2 * maxNodes, limit)));
+}
 
-  //
-  // Step 1. Initialize build config.
-  //
+// Grows a path buffer up to limit polygons after a search filled it up.
+// Returns false if it is already at its limit.
+bool growPathBuffer(std::vector<dtPolyRef>& polys, const int limit) {
+  if (polys.size() >= static_cast<size_t>(limit))
+    return false;
+  polys.resize(std::min<size_t>(2 * polys.size(), limit));
+  return true;
+}
 
-  // Init build configuration from GUI
-  rcConfig cfg{};
-  memset(&cfg, 0, sizeof(cfg));
-  cfg.cs = bs.cellSize;
-  cfg.ch = bs.cellHeight;
-  cfg.walkableSlopeAngle = bs.agentMaxSlope;
-  cfg.walkableHeight = static_cast<int>(ceilf(bs.agentHeight / cfg.ch));
-  cfg.walkableClimb = static_cast<int>(floorf(bs.agentMaxClimb / cfg.ch));
-  cfg.walkableRadius = static_cast<int>(ceilf(bs.agentRadius / cfg.cs));
-  cfg.maxEdgeLen = static_cast<int>(bs.edgeMaxLen / bs.cellSize);
-  cfg.maxSimplificationError = bs.edgeMaxError;
-  cfg.minRegionArea =
-      static_cast<int>(rcSqr(bs.regionMinSize));  // Note: area = size*size
-  cfg.mergeRegionArea =
-      static_cast<int>(rcSqr(bs.regionMergeSize));  // Note: area = size*size
-  cfg.maxVertsPerPoly = static_cast<int>(bs.vertsPerPoly);
-  cfg.detailSampleDist =
-      bs.detailSampleDist < 0.9f ? 0 : bs.cellSize * bs.detailSampleDist;
-  cfg.detailSampleMaxError = bs.cellHeight * bs.detailSampleMaxError;
+// The path scratch buffer of the calling thread, shrunk to limit polygons
+// if another path finder with a higher limit grew it
+std::vector<dtPolyRef>& pathBuffer(const int limit) {
+  std::vector<dtPolyRef>& polys = pathScratch().polys;
+  if (polys.size() > static_cast<size_t>(limit))
+    polys.resize(limit);
+  return polys;
+}
 
-  // Set the area where the navigation will be build.
-  // Here the bounds of the input mesh are used, but the
-  // area could be specified by an user defined box, etc.
-  rcVcopy(cfg.bmin, bmin);
-  rcVcopy(cfg.bmax, bmax);
-  rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
-  LOG(INFO) << "Building navmesh with " << cfg.width << "x" << cfg.height
-            << " cells";
+// Runs the Recast pipeline over the triangles in tris (indices into verts)
+// inside the area described by cfg and converts the result into Detour tile
+// data at tile coordinates (tileX, tileY). Returns false on error. If the area
+// contains nothing walkable, result.navData stays null.
+// Only uses local state, so tiles can be built concurrently.
+bool buildTileNavData(const NavMeshSettings& bs,
+                      const rcConfig& cfg,
+                      const float* verts,
+                      const int nverts,
+                      const int* tris,
+                      const int ntris,
+                      const int tileX,
+                      const int tileY,
+                      TileBuildResult& result) {
+  Workspace ws;
+  rcContext ctx;
 
   //
   // Step 2. Rasterize input polygon soup.
@@ -505,7 +1296,7 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
     return false;
   }
   // Partition the walkable surface into simple regions without holes.
-  if (!rcBuildRegions(&ctx, *ws.chf, 0, cfg.minRegionArea,
+  if (!rcBuildRegions(&ctx, *ws.chf, cfg.borderSize, cfg.minRegionArea,
                       cfg.mergeRegionArea)) {
     LOG(ERROR) << "Could not build watershed regions";
     return false;
@@ -532,6 +1323,10 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
     LOG(ERROR) << "Could not create contours";
     return false;
   }
+  // Nothing walkable in this area, e.g. an empty tile
+  if (ws.cset->nconts == 0) {
+    return true;
+  }
 
   //
   // Step 6. Build polygons mesh from contours.
@@ -570,106 +1365,498 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
   // access the data.
 
   //
-  // (Optional) Step 8. Create Detour data from Recast poly mesh.
+  // Step 8. Create Detour data from Recast poly mesh.
   //
 
-  // The GUI may allow more max points per polygon than Detour can handle.
-  // Only build the detour navmesh if we do not exceed the limit.
-  if (cfg.maxVertsPerPoly <= DT_VERTS_PER_POLYGON) {
-    unsigned char* navData = nullptr;
-    int navDataSize = 0;
-
-    // Update poly flags from areas.
-    for (int i = 0; i < ws.pmesh->npolys; ++i) {
-      if (ws.pmesh->areas[i] == RC_WALKABLE_AREA) {
-        ws.pmesh->areas[i] = POLYAREA_GROUND;
-      }
-      if (ws.pmesh->areas[i] == POLYAREA_GROUND) {
-        ws.pmesh->flags[i] = POLYFLAGS_WALK;
-      } else if (ws.pmesh->areas[i] == POLYAREA_DOOR) {
-        ws.pmesh->flags[i] = POLYFLAGS_WALK | POLYFLAGS_DOOR;
-      }
-    }
-
-    dtNavMeshCreateParams params{};
-    memset(&params, 0, sizeof(params));
-    params.verts = ws.pmesh->verts;
-    params.vertCount = ws.pmesh->nverts;
-    params.polys = ws.pmesh->polys;
-    params.polyAreas = ws.pmesh->areas;
-    params.polyFlags = ws.pmesh->flags;
-    params.polyCount = ws.pmesh->npolys;
-    params.nvp = ws.pmesh->nvp;
-    params.detailMeshes = ws.dmesh->meshes;
-    params.detailVerts = ws.dmesh->verts;
-    params.detailVertsCount = ws.dmesh->nverts;
-    params.detailTris = ws.dmesh->tris;
-    params.detailTriCount = ws.dmesh->ntris;
-    // params.offMeshConVerts = geom->getOffMeshConnectionVerts();
-    // params.offMeshConRad = geom->getOffMeshConnectionRads();
-    // params.offMeshConDir = geom->getOffMeshConnectionDirs();
-    // params.offMeshConAreas = geom->getOffMeshConnectionAreas();
-    // params.offMeshConFlags = geom->getOffMeshConnectionFlags();
-    // params.offMeshConUserID = geom->getOffMeshConnectionId();
-    // params.offMeshConCount = geom->getOffMeshConnectionCount();
-    params.walkableHeight = bs.agentHeight;
-    params.walkableRadius = bs.agentRadius;
-    params.walkableClimb = bs.agentMaxClimb;
-    rcVcopy(params.bmin, ws.pmesh->bmin);
-    rcVcopy(params.bmax, ws.pmesh->bmax);
-    params.cs = cfg.cs;
-    params.ch = cfg.ch;
-    params.buildBvTree = true;
-
-    if (!dtCreateNavMeshData(&params, &navData, &navDataSize)) {
-      LOG(ERROR) << "Could not build Detour navmesh";
-      return false;
-    }
-
-    navMesh_.reset(dtAllocNavMesh());
-    if (!navMesh_) {
-      dtFree(navData);
-      LOG(ERROR) << "Could not allocate Detour navmesh";
-      return false;
-    }
-
-    dtStatus status = 0;
-    status = navMesh_->init(navData, navDataSize, DT_TILE_FREE_DATA);
-    if (dtStatusFailed(status)) {
-      dtFree(navData);
-      LOG(ERROR) << "Could not init Detour navmesh";
-      return false;
+  // Update poly flags from areas.
+  for (int i = 0; i < ws.pmesh->npolys; ++i) {
+    if (ws.pmesh->areas[i] == RC_WALKABLE_AREA) {
+      ws.pmesh->areas[i] = POLYAREA_GROUND;
     }
-    if (!initNavQuery()) {
-      return false;
+    if (ws.pmesh->areas[i] == POLYAREA_GROUND) {
+      ws.pmesh->flags[i] = POLYFLAGS_WALK;
+    } else if (ws.pmesh->areas[i] == POLYAREA_DOOR) {
+      ws.pmesh->flags[i] = POLYFLAGS_WALK | POLYFLAGS_DOOR;
     }
   }
 
-  // Added as we also need to remove these on navmesh recomputation
-  removeZeroAreaPolys();
-
-  LOG(INFO) << "Created navmesh with " << ws.pmesh->nverts << " vertices "
-            << ws.pmesh->npolys << " polygons";
+  dtNavMeshCreateParams params{};
+  memset(&params, 0, sizeof(params));
+  params.verts = ws.pmesh->verts;
+  params.vertCount = ws.pmesh->nverts;
+  params.polys = ws.pmesh->polys;
+  params.polyAreas = ws.pmesh->areas;
+  params.polyFlags = ws.pmesh->flags;
+  params.polyCount = ws.pmesh->npolys;
+  params.nvp = ws.pmesh->nvp;
+  params.detailMeshes = ws.dmesh->meshes;
+  params.detailVerts = ws.dmesh->verts;
+  params.detailVertsCount = ws.dmesh->nverts;
+  params.detailTris = ws.dmesh->tris;
+  params.detailTriCount = ws.dmesh->ntris;
+  // params.offMeshConVerts = geom->getOffMeshConnectionVerts();
+  // params.offMeshConRad = geom->getOffMeshConnectionRads();
+  // params.offMeshConDir = geom->getOffMeshConnectionDirs();
+  // params.offMeshConAreas = geom->getOffMeshConnectionAreas();
+  // params.offMeshConFlags = geom->getOffMeshConnectionFlags();
+  // params.offMeshConUserID = geom->getOffMeshConnectionId();
+  // params.offMeshConCount = geom->getOffMeshConnectionCount();
+  params.walkableHeight = bs.agentHeight;
+  params.walkableRadius = bs.agentRadius;
+  params.walkableClimb = bs.agentMaxClimb;
+  params.tileX = tileX;
+  params.tileY = tileY;
+  params.tileLayer = 0;
+  rcVcopy(params.bmin, ws.pmesh->bmin);
+  rcVcopy(params.bmax, ws.pmesh->bmax);
+  params.cs = cfg.cs;
+  params.ch = cfg.ch;
+  params.buildBvTree = true;
+
+  if (!dtCreateNavMeshData(&params, &result.navData, &result.navDataSize)) {
+    LOG(ERROR) << "Could not build Detour navmesh";
+    return false;
+  }
 
+  result.numVerts = ws.pmesh->nverts;
+  result.numPolys = ws.pmesh->npolys;
   return true;
 }
 
-bool PathFinder::Impl::initNavQuery() {
-  // if we are reinitializing the NavQuery, then also reset the MeshData
-  meshData_.reset();
+// Tile column (axis 0) or row (axis 2) of the world coordinate coord, clamped
+// to the tile grid
+int tileCoord(const TiledBuildConfig& tb, float coord, int axis) {
+  const int numTiles = axis == 0 ? tb.tilesX : tb.tilesY;
+  const int t = static_cast<int>(
+      std::floor((coord - tb.meshCfg.bmin[axis]) / tb.tileWorldSize));
+  return std::max(0, std::min(t, numTiles - 1));
+}
 
-  navQuery_.reset(dtAllocNavMeshQuery());
-  dtStatus status = navQuery_->init(navMesh_.get(), 2048);
-  if (dtStatusFailed(status)) {
-    LOG(ERROR) << "Could not init Detour navmesh query";
-    return false;
+// Builds the given tiles in parallel. Triangles are bucketed into every tile
+// their xz bounds (plus the tile border) overlap, so each tile only runs
+// Recast on the geometry that can affect it.
+TileUpdate buildTiles(const TiledBuildConfig& tb,
+                      const float* verts,
+                      const int nverts,
+                      const int* tris,
+                      const int ntris,
+                      std::vector<int> tiles) {
+  TileUpdate update;
+  update.tiles = std::move(tiles);
+  update.results.resize(update.tiles.size());
+
+  std::vector<int> slotOfTile(tb.tilesX * tb.tilesY, -1);
+  for (size_t i = 0; i < update.tiles.size(); ++i) {
+    slotOfTile[update.tiles[i]] = i;
   }
 
-  islandSystem_ =
-      std::make_unique<impl::IslandSystem>(navMesh_.get(), filter_.get());
+  std::vector<std::vector<int>> tileTris(update.tiles.size());
+  for (int iTri = 0; iTri < ntris; ++iTri) {
+    const int* tri = &tris[iTri * 3];
+    float triMin[2] = {std::numeric_limits<float>::max(),
+                       std::numeric_limits<float>::max()};
+    float triMax[2] = {-std::numeric_limits<float>::max(),
+                       -std::numeric_limits<float>::max()};
+    for (int k = 0; k < 3; ++k) {
+      const float* v = &verts[tri[k] * 3];
+      triMin[0] = std::min(triMin[0], v[0]);
+      triMin[1] = std::min(triMin[1], v[2]);
+      triMax[0] = std::max(triMax[0], v[0]);
+      triMax[1] = std::max(triMax[1], v[2]);
+    }
+    const int x0 = tileCoord(tb, triMin[0] - tb.borderWorldSize, 0);
+    const int x1 = tileCoord(tb, triMax[0] + tb.borderWorldSize, 0);
+    const int y0 = tileCoord(tb, triMin[1] - tb.borderWorldSize, 2);
+    const int y1 = tileCoord(tb, triMax[1] + tb.borderWorldSize, 2);
+    for (int y = y0; y <= y1; ++y) {
+      for (int x = x0; x <= x1; ++x) {
+        const int slot = slotOfTile[y * tb.tilesX + x];
+        if (slot >= 0) {
+          tileTris[slot].insert(tileTris[slot].end(), tri, tri + 3);
+        }
+      }
+    }
+  }
 
-  return true;
-}
+  // Each tile only touches its own Recast workspace and result slot
+  std::atomic<bool> failed{false};
+  core::parallelFor(
+      update.tiles.size(), core::numWorkerThreads(update.tiles.size()),
+      [&](unsigned int, size_t i) {
+        const std::vector<int>& triIndices = tileTris[i];
+        if (triIndices.empty() || failed)
+          return;
+
+        const int x = update.tiles[i] % tb.tilesX;
+        const int y = update.tiles[i] / tb.tilesX;
+        rcConfig cfg = tb.tileCfg;
+        cfg.bmin[0] =
+            tb.meshCfg.bmin[0] + x * tb.tileWorldSize - tb.borderWorldSize;
+        cfg.bmin[2] =
+            tb.meshCfg.bmin[2] + y * tb.tileWorldSize - tb.borderWorldSize;
+        cfg.bmax[0] = tb.meshCfg.bmin[0] + (x + 1) * tb.tileWorldSize +
+                      tb.borderWorldSize;
+        cfg.bmax[2] = tb.meshCfg.bmin[2] + (y + 1) * tb.tileWorldSize +
+                      tb.borderWorldSize;
+
+        if (!buildTileNavData(tb.settings, cfg, verts, nverts,
+                              triIndices.data(), triIndices.size() / 3, x, y,
+                              update.results[i])) {
+          LOG(ERROR) << "Could not build navmesh tile " << x << "," << y;
+          failed = true;
+        }
+      });
+
+  update.success = !failed;
+  return update;
+}
+}  // namespace
+
+PathFinder::Impl::Impl()
+    : maxPathPolys_{MAX_PATH_POLYS}, maxSearchNodes_{MAX_QUERY_NODES} {
+  filter_ = std::make_unique<dtQueryFilter>();
+  filter_->setIncludeFlags(POLYFLAGS_WALK);
+  filter_->setExcludeFlags(0);
+}
+
+bool PathFinder::Impl::build(const NavMeshSettings& bs,
+                             const float* verts,
+                             const int nverts,
+                             const int* tris,
+                             const int ntris,
+                             const float* bmin,
+                             const float* bmax) {
+  discardTileUpdates();
+  tiledBuild_ = Cr::Containers::NullOpt;
+
+  //
+  // Step 1. Initialize build config.
+  //
+
+  // Init build configuration from GUI
+  rcConfig cfg{};
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.cs = bs.cellSize;
+  cfg.ch = bs.cellHeight;
+  cfg.walkableSlopeAngle = bs.agentMaxSlope;
+  cfg.walkableHeight = static_cast<int>(ceilf(bs.agentHeight / cfg.ch));
+  cfg.walkableClimb = static_cast<int>(floorf(bs.agentMaxClimb / cfg.ch));
+  cfg.walkableRadius = static_cast<int>(ceilf(bs.agentRadius / cfg.cs));
+  cfg.maxEdgeLen = static_cast<int>(bs.edgeMaxLen / bs.cellSize);
+  cfg.maxSimplificationError = bs.edgeMaxError;
+  cfg.minRegionArea =
+      static_cast<int>(rcSqr(bs.regionMinSize));  // Note: area = size*size
+  cfg.mergeRegionArea =
+      static_cast<int>(rcSqr(bs.regionMergeSize));  // Note: area = size*size
+  cfg.maxVertsPerPoly = static_cast<int>(bs.vertsPerPoly);
+  cfg.detailSampleDist =
+      bs.detailSampleDist < 0.9f ? 0 : bs.cellSize * bs.detailSampleDist;
+  cfg.detailSampleMaxError = bs.cellHeight * bs.detailSampleMaxError;
+
+  // Set the area where the navigation will be build.
+  // Here the bounds of the input mesh are used, but the
+  // area could be specified by an user defined box, etc.
+  rcVcopy(cfg.bmin, bmin);
+  rcVcopy(cfg.bmax, bmax);
+  rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
+
+  // The GUI may allow more max points per polygon than Detour can handle.
+  // Only build the detour navmesh if we do not exceed the limit.
+  if (cfg.maxVertsPerPoly > DT_VERTS_PER_POLYGON) {
+    LOG(ERROR) << "vertsPerPoly must be at most " << DT_VERTS_PER_POLYGON;
+    return false;
+  }
+
+  if (bs.tileSize > 0) {
+    if (!buildTiled(bs, cfg, verts, nverts, tris, ntris)) {
+      return false;
+    }
+  } else {
+    LOG(INFO) << "Building navmesh with " << cfg.width << "x" << cfg.height
+              << " cells";
+
+    TileBuildResult result;
+    if (!buildTileNavData(bs, cfg, verts, nverts, tris, ntris, 0, 0,
+                          result)) {
+      return false;
+    }
+    if (!result.navData) {
+      LOG(ERROR) << "Navmesh has no walkable area";
+      return false;
+    }
+
+    navMesh_.reset(dtAllocNavMesh());
+    if (!navMesh_) {
+      dtFree(result.navData);
+      LOG(ERROR) << "Could not allocate Detour navmesh";
+      return false;
+    }
+
+    dtStatus status = 0;
+    status =
+        navMesh_->init(result.navData, result.navDataSize, DT_TILE_FREE_DATA);
+    if (dtStatusFailed(status)) {
+      dtFree(result.navData);
+      LOG(ERROR) << "Could not init Detour navmesh";
+      return false;
+    }
+
+    LOG(INFO) << "Created navmesh with " << result.numVerts << " vertices "
+              << result.numPolys << " polygons";
+  }
+
+  if (!initNavQuery()) {
+    return false;
+  }
+
+  // Added as we also need to remove these on navmesh recomputation
+  removeZeroAreaPolys();
+
+  return true;
+}
+
+bool PathFinder::Impl::buildTiled(const NavMeshSettings& bs,
+                                  const rcConfig& meshCfg,
+                                  const float* verts,
+                                  const int nverts,
+                                  const int* tris,
+                                  const int ntris) {
+  TiledBuildConfig tb;
+  tb.settings = bs;
+  tb.meshCfg = meshCfg;
+  const int tileSize = static_cast<int>(bs.tileSize);
+  tb.tileWorldSize = tileSize * meshCfg.cs;
+  tb.tilesX = (meshCfg.width + tileSize - 1) / tileSize;
+  tb.tilesY = (meshCfg.height + tileSize - 1) / tileSize;
+  const int numTiles = tb.tilesX * tb.tilesY;
+  LOG(INFO) << "Building navmesh with " << meshCfg.width << "x"
+            << meshCfg.height << " cells in " << tb.tilesX << "x" << tb.tilesY
+            << " tiles";
+
+  // Poly refs are 32 bits, split between the tile and poly within the tile
+  const int tileBits =
+      std::min(static_cast<int>(dtIlog2(dtNextPow2(numTiles))), 14);
+  const int polyBits = 22 - tileBits;
+  if (numTiles > (1 << tileBits)) {
+    LOG(ERROR) << "Too many navmesh tiles (" << numTiles
+               << "), increase NavMeshSettings::tileSize";
+    return false;
+  }
+
+  dtNavMeshParams params{};
+  rcVcopy(params.orig, meshCfg.bmin);
+  params.tileWidth = tb.tileWorldSize;
+  params.tileHeight = tb.tileWorldSize;
+  params.maxTiles = 1 << tileBits;
+  params.maxPolys = 1 << polyBits;
+
+  // Each tile is rasterized with a border so that the erosion by the agent
+  // radius and the regions match up with its neighbours
+  tb.tileCfg = meshCfg;
+  tb.tileCfg.tileSize = tileSize;
+  tb.tileCfg.borderSize = tb.tileCfg.walkableRadius + 3;
+  tb.tileCfg.width = tb.tileCfg.tileSize + tb.tileCfg.borderSize * 2;
+  tb.tileCfg.height = tb.tileCfg.tileSize + tb.tileCfg.borderSize * 2;
+  tb.borderWorldSize = tb.tileCfg.borderSize * tb.tileCfg.cs;
+
+  std::vector<int> allTiles(numTiles);
+  std::iota(allTiles.begin(), allTiles.end(), 0);
+  TileUpdate update =
+      buildTiles(tb, verts, nverts, tris, ntris, std::move(allTiles));
+  if (!update.success) {
+    return false;
+  }
+
+  navMesh_.reset(dtAllocNavMesh());
+  if (!navMesh_) {
+    LOG(ERROR) << "Could not allocate Detour navmesh";
+    return false;
+  }
+  if (dtStatusFailed(navMesh_->init(&params))) {
+    LOG(ERROR) << "Could not init Detour navmesh";
+    return false;
+  }
+
+  // Stitch the tiles together. The navmesh takes ownership of the tile data
+  // and links the polygons along shared tile borders.
+  int numVerts = 0, numPolys = 0, numBuiltTiles = 0;
+  for (auto& result : update.results) {
+    if (!result.navData)
+      continue;
+    const dtStatus status = navMesh_->addTile(
+        result.navData, result.navDataSize, DT_TILE_FREE_DATA, 0, nullptr);
+    if (dtStatusFailed(status)) {
+      LOG(ERROR) << "Could not add navmesh tile";
+      return false;
+    }
+    result.navData = nullptr;
+    numVerts += result.numVerts;
+    numPolys += result.numPolys;
+    ++numBuiltTiles;
+  }
+
+  if (numBuiltTiles == 0) {
+    LOG(ERROR) << "Navmesh has no walkable area";
+    return false;
+  }
+
+  LOG(INFO) << "Created navmesh with " << numVerts << " vertices " << numPolys
+            << " polygons in " << numBuiltTiles << " tiles";
+
+  tiledBuild_ = tb;
+  return true;
+}
+
+bool PathFinder::Impl::updateTilesAsync(
+    const esp::assets::MeshData& mesh,
+    const std::vector<std::pair<vec3f, vec3f>>& regions) {
+  if (!tiledBuild_) {
+    LOG(ERROR) << "Navmesh tiles can only be updated after a tiled build";
+    return false;
+  }
+  if (mesh.vbo.empty() || mesh.ibo.empty()) {
+    LOG(ERROR) << "Cannot update navmesh tiles from an empty mesh";
+    return false;
+  }
+
+  // Keep updates ordered: a newer update has to be applied after the older
+  // one, otherwise the older one could overwrite its tiles
+  if (pendingTileUpdate_.valid()) {
+    LOG(ERROR) << "The pending navmesh tile update has to be applied first";
+    return false;
+  }
+
+  // A region affects every tile whose rasterized area, which includes the
+  // border, it overlaps
+  const TiledBuildConfig& tb = *tiledBuild_;
+  std::vector<char> dirty(tb.tilesX * tb.tilesY, 0);
+  for (const auto& region : regions) {
+    const vec3f& rmin = region.first;
+    const vec3f& rmax = region.second;
+    if (rmax[0] + tb.borderWorldSize < tb.meshCfg.bmin[0] ||
+        rmin[0] - tb.borderWorldSize > tb.meshCfg.bmax[0] ||
+        rmax[2] + tb.borderWorldSize < tb.meshCfg.bmin[2] ||
+        rmin[2] - tb.borderWorldSize > tb.meshCfg.bmax[2]) {
+      continue;
+    }
+    const int x0 = tileCoord(tb, rmin[0] - tb.borderWorldSize, 0);
+    const int x1 = tileCoord(tb, rmax[0] + tb.borderWorldSize, 0);
+    const int y0 = tileCoord(tb, rmin[2] - tb.borderWorldSize, 2);
+    const int y1 = tileCoord(tb, rmax[2] + tb.borderWorldSize, 2);
+    for (int y = y0; y <= y1; ++y) {
+      for (int x = x0; x <= x1; ++x) {
+        dirty[y * tb.tilesX + x] = 1;
+      }
+    }
+  }
+  std::vector<int> tiles;
+  for (size_t i = 0; i < dirty.size(); ++i) {
+    if (dirty[i])
+      tiles.push_back(i);
+  }
+  if (tiles.empty()) {
+    return true;
+  }
+  LOG(INFO) << "Rebuilding " << tiles.size() << " of " << dirty.size()
+            << " navmesh tiles";
+
+  // The background build works on its own copy of the geometry and config,
+  // so queries can keep running on the current navmesh in the meantime
+  std::vector<vec3f> verts = mesh.vbo;
+  std::vector<int> tris(mesh.ibo.begin(), mesh.ibo.end());
+  pendingTileUpdate_ = std::async(
+      std::launch::async,
+      [tb, tiles = std::move(tiles), verts = std::move(verts),
+       tris = std::move(tris)]() mutable {
+        return buildTiles(tb, verts[0].data(), verts.size(), tris.data(),
+                          tris.size() / 3, std::move(tiles));
+      });
+  return true;
+}
+
+bool PathFinder::Impl::applyTileUpdates(bool wait) {
+  if (!pendingTileUpdate_.valid()) {
+    return false;
+  }
+  if (!wait && pendingTileUpdate_.wait_for(std::chrono::seconds(0)) !=
+                   std::future_status::ready) {
+    return false;
+  }
+
+  TileUpdate update = pendingTileUpdate_.get();
+  if (!update.success) {
+    LOG(ERROR) << "Navmesh tile update failed, keeping the current navmesh";
+    return false;
+  }
+
+  // Swap all tiles of the update in one go so that no query ever sees a
+  // navmesh that is only partially updated
+  const int tilesX = tiledBuild_->tilesX;
+  bool success = true;
+  for (size_t i = 0; i < update.tiles.size(); ++i) {
+    const int x = update.tiles[i] % tilesX;
+    const int y = update.tiles[i] / tilesX;
+    const dtTileRef oldTile = navMesh_->getTileRefAt(x, y, 0);
+    if (oldTile) {
+      navMesh_->removeTile(oldTile, nullptr, nullptr);
+    }
+
+    TileBuildResult& result = update.results[i];
+    if (!result.navData)
+      continue;
+    const dtStatus status = navMesh_->addTile(
+        result.navData, result.navDataSize, DT_TILE_FREE_DATA, 0, nullptr);
+    if (dtStatusFailed(status)) {
+      LOG(ERROR) << "Could not add navmesh tile " << x << "," << y;
+      success = false;
+      continue;
+    }
+    result.navData = nullptr;
+  }
+
+  // Poly refs into the replaced tiles are stale now, so refresh everything
+  // derived from the navmesh like a full build does
+  if (!initNavQuery()) {
+    return false;
+  }
+  removeZeroAreaPolys();
+
+  return success;
+}
+
+void PathFinder::Impl::discardTileUpdates() {
+  if (pendingTileUpdate_.valid()) {
+    pendingTileUpdate_.get();
+  }
+}
+
+bool PathFinder::Impl::initNavQuery(
+    std::unique_ptr<impl::IslandSystem> islandSystem) {
+  // if we are reinitializing the NavQuery, then also reset the MeshData
+  meshData_.reset();
+  topDownViewCache_.clear();
+  polyIndex_.reset();
+  obstacleField_.reset();
+  triangleSampler_.reset();
+  workerQueries_.clear();
+
+  navQuery_.reset(dtAllocNavMeshQuery());
+  dtStatus status = navQuery_->init(
+      navMesh_.get(), std::min(DEFAULT_QUERY_NODES, maxSearchNodes_));
+  if (dtStatusFailed(status)) {
+    LOG(ERROR) << "Could not init Detour navmesh query";
+    return false;
+  }
+
+  if (islandSystem) {
+    islandSystem_ = std::move(islandSystem);
+  } else {
+    islandSystem_ =
+        std::make_unique<impl::IslandSystem>(navMesh_.get(), filter_.get());
+  }
+
+  return true;
+}
 
 bool PathFinder::Impl::build(const NavMeshSettings& bs,
                              const esp::assets::MeshData& mesh) {
@@ -698,7 +1885,10 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
 
 namespace {
 const int NAVMESHSET_MAGIC = 'M' << 24 | 'S' << 16 | 'E' << 8 | 'T';  //'MSET';
-const int NAVMESHSET_VERSION = 1;
+// Version 2 appends an island section after the tiles
+const int NAVMESHSET_VERSION = 2;
+const int NAVMESHSET_ISLANDS_MAGIC =
+    'I' << 24 | 'S' << 16 | 'L' << 8 | 'D';  //'ISLD';
 
 struct NavMeshSetHeader {
   int magic;
@@ -712,6 +1902,12 @@ struct NavMeshTileHeader {
   int dataSize;
 };
 
+struct NavMeshIslandsHeader {
+  int magic;
+  //! Navigable area, see PathFinder::Impl::removeZeroAreaPolys
+  float navMeshArea;
+};
+
 struct Triangle {
   std::vector<vec3f> v;
   Triangle() { v.resize(3); }
@@ -767,7 +1963,7 @@ void PathFinder::Impl::removeZeroAreaPolys() {
   for (int iTile = 0; iTile < navMesh_->getMaxTiles(); ++iTile) {
     const dtMeshTile* tile =
         const_cast<const dtNavMesh*>(navMesh_.get())->getTile(iTile);
-    if (!tile)
+    if (!tile || !tile->header)
       continue;
 
     // Iterate over all polygons in a tile
@@ -796,6 +1992,10 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
   if (!fp)
     return false;
 
+  // Only the source geometry of a build can be updated tile by tile
+  discardTileUpdates();
+  tiledBuild_ = Cr::Containers::NullOpt;
+
   // Read header.
   NavMeshSetHeader header{};
   size_t readLen = fread(&header, sizeof(NavMeshSetHeader), 1, fp);
@@ -807,7 +2007,7 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
     fclose(fp);
     return false;
   }
-  if (header.version != NAVMESHSET_VERSION) {
+  if (header.version < 1 || header.version > NAVMESHSET_VERSION) {
     fclose(fp);
     return false;
   }
@@ -861,14 +2061,32 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
     }
   }
 
+  // Zero area polys were already disabled in the saved tiles, so with the
+  // island section the navmesh is ready to use as is
+  std::unique_ptr<impl::IslandSystem> islandSystem = nullptr;
+  NavMeshIslandsHeader islandsHeader{};
+  if (header.version >= 2 &&
+      fread(&islandsHeader, sizeof(islandsHeader), 1, fp) == 1 &&
+      islandsHeader.magic == NAVMESHSET_ISLANDS_MAGIC) {
+    islandSystem = impl::IslandSystem::load(fp, mesh);
+  }
+
   fclose(fp);
 
   navMesh_.reset(mesh);
   bounds_ = std::make_pair(bmin, bmax);
 
-  removeZeroAreaPolys();
+  if (islandSystem) {
+    navMeshArea_ = islandsHeader.navMeshArea;
+  } else {
+    if (header.version >= 2) {
+      LOG(WARNING) << "Invalid island section in " << path
+                   << ", recomputing islands";
+    }
+    removeZeroAreaPolys();
+  }
 
-  return initNavQuery();
+  return initNavQuery(std::move(islandSystem));
 }
 
 bool PathFinder::Impl::saveNavMesh(const std::string& path) {
@@ -908,6 +2126,15 @@ bool PathFinder::Impl::saveNavMesh(const std::string& path) {
     fwrite(tile->data, tile->dataSize, 1, fp);
   }
 
+  // Store islands.
+  if (islandSystem_) {
+    NavMeshIslandsHeader islandsHeader{};
+    islandsHeader.magic = NAVMESHSET_ISLANDS_MAGIC;
+    islandsHeader.navMeshArea = navMeshArea_;
+    fwrite(&islandsHeader, sizeof(islandsHeader), 1, fp);
+    islandSystem_->save(fp);
+  }
+
   fclose(fp);
 
   return true;
@@ -950,6 +2177,77 @@ vec3f PathFinder::Impl::getRandomNavigablePoint(const int maxTries /*= 10*/) {
   }
 }
 
+std::vector<vec3f> PathFinder::Impl::sampleNavigablePoints(
+    const int numPoints,
+    const uint32_t seed,
+    const NavigablePointFilter& filter,
+    const int maxTries,
+    const unsigned int maxThreads) {
+  std::vector<vec3f> points(std::max(numPoints, 0),
+                            vec3f::Constant(Mn::Constants::nan()));
+  if (!isLoaded() || points.empty())
+    return points;
+
+  if (!triangleSampler_) {
+    triangleSampler_ = std::make_unique<impl::TriangleSampler>(
+        navMesh_.get(), filter_.get(), *islandSystem_);
+  }
+  if (!triangleSampler_->prepare(filter)) {
+    LOG(WARNING) << "No navigable area passes the point filter";
+    return points;
+  }
+  const impl::TriangleSampler& sampler = *triangleSampler_;
+
+  // The obstacle distance check searches with a query's node pool, so every
+  // worker needs its own query object
+  unsigned int numWorkers = core::numWorkerThreads(points.size(), maxThreads);
+  if (filter.minObstacleDistance > 0 && !ensureWorkerQueries(numWorkers)) {
+    numWorkers = static_cast<unsigned int>(workerQueries_.size()) + 1;
+  }
+
+  core::parallelFor(
+      points.size(), numWorkers, [&](unsigned int workerIdx, size_t i) {
+        impl::SplitMix64 rng(seed * 0x9e3779b97f4a7c15ull + i);
+        for (int iTry = 0; iTry < maxTries; ++iTry) {
+          // The first try of sample i is stratified into the i-th of
+          // numPoints equal slices of the alias table, which spreads the
+          // samples more evenly over the navmesh than independent draws
+          const float u = iTry == 0
+                              ? (i + rng.uniform()) / points.size()
+                              : rng.uniform();
+          vec3f pt;
+          const impl::TriangleSampler::Triangle& tri =
+              sampler.sample(std::min(u, 1.0f - 1e-7f), rng, pt);
+          if (pt[1] < filter.minHeight || pt[1] > filter.maxHeight)
+            continue;
+          if (filter.minObstacleDistance > 0) {
+            float distance = 0;
+            if (!obstacleField_ || !obstacleField_->lookup(pt, distance)) {
+              // only ensured to exist for every worker in this case
+              dtNavMeshQuery* query =
+                  workerIdx == 0 ? navQuery_.get()
+                                 : workerQueries_[workerIdx - 1].get();
+              vec3f hitPos, hitNormal;
+              query->findDistanceToWall(
+                  tri.poly, pt.data(), filter.minObstacleDistance,
+                  filter_.get(), &distance, hitPos.data(), hitNormal.data());
+            }
+            if (distance < filter.minObstacleDistance)
+              continue;
+          }
+          points[i] = pt;
+          break;
+        }
+      });
+
+  // Stratification orders the points by triangle, so shuffle them
+  impl::SplitMix64 rng(seed);
+  for (size_t i = points.size() - 1; i > 0; --i) {
+    std::swap(points[i], points[rng.next() % (i + 1)]);
+  }
+  return points;
+}
+
 namespace {
 float pathLength(const std::vector<vec3f>& points) {
   CORRADE_INTERNAL_ASSERT(points.size() > 0);
@@ -966,24 +2264,31 @@ float pathLength(const std::vector<vec3f>& points) {
 }  // namespace
 
 bool PathFinder::Impl::findPath(ShortestPath& path) {
+  return findPath(path, navQuery_.get());
+}
+
+bool PathFinder::Impl::findPath(ShortestPath& path, dtNavMeshQuery* navQuery) {
   MultiGoalShortestPath tmp;
   tmp.requestedStart = path.requestedStart;
   tmp.setRequestedEnds({path.requestedEnd});
 
-  bool status = findPath(tmp);
+  bool status = findPath(tmp, navQuery);
 
   path.geodesicDistance = tmp.geodesicDistance;
   path.points = std::move(tmp.points);
+  path.partial = tmp.partial;
   return status;
 }
 
 Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
-PathFinder::Impl::findPathInternal(const vec3f& start,
+PathFinder::Impl::findPathInternal(dtNavMeshQuery* navQuery,
+                                   const vec3f& start,
                                    dtPolyRef startRef,
                                    const vec3f& pathStart,
                                    const vec3f& end,
                                    dtPolyRef endRef,
-                                   const vec3f& pathEnd) {
+                                   const vec3f& pathEnd,
+                                   bool& partial) {
   // check if trivial path (start is same as end) and early return
   if (pathStart.isApprox(pathEnd)) {
     return std::make_tuple(0.0f, std::vector<vec3f>{pathStart, pathEnd});
@@ -994,22 +2299,47 @@ PathFinder::Impl::findPathInternal(const vec3f& start,
     return Cr::Containers::NullOpt;
   }
 
-  static const int MAX_POLYS = 256;
-  dtPolyRef polys[MAX_POLYS];
+  std::vector<dtPolyRef>& polys = pathBuffer(maxPathPolys_);
 
+  // Retry with larger buffers whenever the search runs out of space
   int numPolys = 0;
-  dtStatus status =
-      navQuery_->findPath(startRef, endRef, pathStart.data(), pathEnd.data(),
-                          filter_.get(), polys, &numPolys, MAX_POLYS);
-  if (status != DT_SUCCESS || numPolys == 0) {
+  dtStatus status = 0;
+  for (;;) {
+    status = navQuery->findPath(startRef, endRef, pathStart.data(),
+                                pathEnd.data(), filter_.get(), polys.data(),
+                                &numPolys, static_cast<int>(polys.size()));
+    if (dtStatusDetail(status, DT_BUFFER_TOO_SMALL) &&
+        growPathBuffer(polys, maxPathPolys_))
+      continue;
+    if (dtStatusDetail(status, DT_OUT_OF_NODES) &&
+        growNodePool(navQuery, navMesh_.get(), maxSearchNodes_))
+      continue;
+    break;
+  }
+
+  // At the limits, Detour still returns the corridor from the start towards
+  // the end as far as it got, so follow that one
+  const bool truncated = dtStatusDetail(status, DT_BUFFER_TOO_SMALL) ||
+                         dtStatusDetail(status, DT_OUT_OF_NODES);
+  if (truncated) {
+    LOG(WARNING) << "Path search from " << start.transpose() << " to "
+                 << end.transpose() << " exceeded the maximum path length";
+    partial = true;
+  }
+  if ((status != DT_SUCCESS && !(truncated && dtStatusSucceed(status))) ||
+      numPolys == 0) {
     return Cr::Containers::NullOpt;
   }
 
+  // The straight path has at most one corner per polygon plus its end points.
+  // For a partial corridor it ends at the point of the last polygon closest
+  // to end.
   int numPoints = 0;
-  std::vector<vec3f> points(MAX_POLYS);
-  status = navQuery_->findStraightPath(start.data(), end.data(), polys,
-                                       numPolys, points[0].data(), nullptr,
-                                       nullptr, &numPoints, MAX_POLYS);
+  std::vector<vec3f> points(numPolys + 2);
+  status = navQuery->findStraightPath(start.data(), end.data(), polys.data(),
+                                      numPolys, points[0].data(), nullptr,
+                                      nullptr, &numPoints,
+                                      static_cast<int>(points.size()));
   if (status != DT_SUCCESS || numPoints == 0) {
     return Corrade::Containers::NullOpt;
   }
@@ -1021,16 +2351,18 @@ PathFinder::Impl::findPathInternal(const vec3f& start,
   return std::make_tuple(length, std::move(points));
 }
 
-bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
+bool PathFinder::Impl::findPathSetup(dtNavMeshQuery* navQuery,
+                                     MultiGoalShortestPath& path,
                                      dtPolyRef& startRef,
                                      vec3f& pathStart) {
   path.geodesicDistance = std::numeric_limits<float>::infinity();
   path.points.clear();
+  path.partial = false;
 
   // find nearest polys and path
   dtStatus status = 0;
   std::tie(status, startRef, pathStart) =
-      projectToPoly(path.requestedStart, navQuery_.get(), filter_.get());
+      projectToPoly(path.requestedStart, navQuery, filter_.get());
 
   if (status != DT_SUCCESS || startRef == 0) {
     return false;
@@ -1043,7 +2375,7 @@ bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
     dtPolyRef endRef = 0;
     vec3f pathEnd;
     std::tie(status, endRef, pathEnd) =
-        projectToPoly(rqEnd, navQuery_.get(), filter_.get());
+        projectToPoly(rqEnd, navQuery, filter_.get());
 
     if (status != DT_SUCCESS || endRef == 0) {
       return false;
@@ -1057,9 +2389,14 @@ bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
 }
 
 bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
+  return findPath(path, navQuery_.get());
+}
+
+bool PathFinder::Impl::findPath(MultiGoalShortestPath& path,
+                                dtNavMeshQuery* navQuery) {
   dtPolyRef startRef = 0;
   vec3f pathStart;
-  if (!findPathSetup(path, startRef, pathStart))
+  if (!findPathSetup(navQuery, path, startRef, pathStart))
     return false;
 
   if (path.pimpl_->requestedEnds.size() > 1) {
@@ -1070,7 +2407,7 @@ bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
     ShortestPath prevPath;
     prevPath.requestedStart = path.requestedStart;
     prevPath.requestedEnd = path.pimpl_->prevRequestedStart;
-    findPath(prevPath);
+    findPath(prevPath, navQuery);
     const float movedAmount = prevPath.geodesicDistance;
 
     for (int i = 0; i < path.pimpl_->requestedEnds.size(); ++i) {
@@ -1091,74 +2428,1003 @@ bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
                      path.pimpl_->minTheoreticalDist[b];
             });
 
+  // A complete path to any end beats the truncated paths towards the others,
+  // however short those are, so the shortest partial path is only taken if
+  // no end can be reached
+  float partialDistance = std::numeric_limits<float>::infinity();
+  std::vector<vec3f> partialPoints;
   for (size_t i : ordering) {
     if (path.pimpl_->minTheoreticalDist[i] > path.geodesicDistance)
       continue;
 
-    const Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
+    bool partial = false;
+    Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
         findResult =
-            findPathInternal(path.requestedStart, startRef, pathStart,
-                             path.pimpl_->requestedEnds[i],
-                             path.pimpl_->endRefs[i], path.pimpl_->pathEnds[i]);
-
-    if (findResult && std::get<0>(*findResult) < path.geodesicDistance) {
-      path.pimpl_->minTheoreticalDist[i] = std::get<0>(*findResult);
-      path.geodesicDistance = std::get<0>(*findResult);
-      path.points = std::get<1>(*findResult);
+            findPathInternal(navQuery, path.requestedStart, startRef,
+                             pathStart, path.pimpl_->requestedEnds[i],
+                             path.pimpl_->endRefs[i], path.pimpl_->pathEnds[i],
+                             partial);
+    if (!findResult)
+      continue;
+
+    // The length of a truncated path doesn't bound the one to its end
+    const float distance = std::get<0>(*findResult);
+    if (partial) {
+      if (distance < partialDistance) {
+        partialDistance = distance;
+        partialPoints = std::move(std::get<1>(*findResult));
+      }
+    } else if (distance < path.geodesicDistance) {
+      path.pimpl_->minTheoreticalDist[i] = distance;
+      path.geodesicDistance = distance;
+      path.points = std::move(std::get<1>(*findResult));
     }
   }
 
+  if (path.geodesicDistance == std::numeric_limits<float>::infinity() &&
+      partialDistance < std::numeric_limits<float>::infinity()) {
+    path.geodesicDistance = partialDistance;
+    path.points = std::move(partialPoints);
+    path.partial = true;
+  }
+
   return path.geodesicDistance < std::numeric_limits<float>::infinity();
 }
 
-template <typename T>
-T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
-  static const int MAX_POLYS = 256;
-  dtPolyRef polys[MAX_POLYS];
+bool PathFinder::Impl::ensureWorkerQueries(const unsigned int numWorkers) {
+  // Worker 0 is the calling thread which uses navQuery_, so only the
+  // additional workers need their own query object
+  while (workerQueries_.size() + 1 < numWorkers) {
+    std::unique_ptr<dtNavMeshQuery, NavQueryDeleter> query{
+        dtAllocNavMeshQuery()};
+    const int maxNodes = std::min(DEFAULT_QUERY_NODES, maxSearchNodes_);
+    if (!query || dtStatusFailed(query->init(navMesh_.get(), maxNodes))) {
+      LOG(ERROR) << "Could not init Detour navmesh query for batch worker";
+      return false;
+    }
+    workerQueries_.emplace_back(std::move(query));
+  }
+  return true;
+}
 
-  dtStatus startStatus = 0, endStatus = 0;
-  dtPolyRef startRef = 0, endRef = 0;
-  vec3f pathStart;
-  std::tie(startStatus, startRef, pathStart) =
-      projectToPoly(start, navQuery_.get(), filter_.get());
-  std::tie(endStatus, endRef, std::ignore) =
-      projectToPoly(end, navQuery_.get(), filter_.get());
+void PathFinder::Impl::setPathSearchLimits(const int maxPathPolys,
+                                           const int maxSearchNodes) {
+  maxPathPolys_ = std::min(std::max(maxPathPolys, 1), MAX_PATH_POLYS);
+  maxSearchNodes_ = std::min(std::max(maxSearchNodes, 1), MAX_QUERY_NODES);
+  if (!isLoaded())
+    return;
+
+  // Node pools only ever grow on their own, so shrink the ones above the new
+  // limit. The path buffers are shrunk when they are next used.
+  const auto shrinkNodePool = [&](dtNavMeshQuery* query) {
+    if (query->getNodePool()->getMaxNodes() > maxSearchNodes_)
+      query->init(navMesh_.get(), maxSearchNodes_);
+  };
+  shrinkNodePool(navQuery_.get());
+  for (auto& query : workerQueries_)
+    shrinkNodePool(query.get());
+}
 
-  if (dtStatusFailed(startStatus) || dtStatusFailed(endStatus)) {
-    return start;
+int PathFinder::Impl::findPaths(std::vector<ShortestPath>& paths,
+                                const unsigned int maxThreads) {
+  if (!isLoaded())
+    return 0;
+
+  unsigned int numWorkers = core::numWorkerThreads(paths.size(), maxThreads);
+  if (!ensureWorkerQueries(numWorkers)) {
+    numWorkers = static_cast<unsigned int>(workerQueries_.size()) + 1;
   }
 
-  if (not islandSystem_->hasConnection(startRef, endRef)) {
-    return start;
+  std::atomic<int> numFound{0};
+  core::parallelFor(
+      paths.size(), numWorkers,
+      [this, &paths, &numFound](unsigned int workerIdx, size_t i) {
+        dtNavMeshQuery* query = workerIdx == 0
+                                    ? navQuery_.get()
+                                    : workerQueries_[workerIdx - 1].get();
+        if (findPath(paths[i], query))
+          ++numFound;
+      });
+
+  return numFound;
+}
+
+std::vector<float> PathFinder::Impl::geodesicDistances(
+    const std::vector<vec3f>& starts,
+    const std::vector<vec3f>& ends,
+    const unsigned int maxThreads) {
+  CORRADE_ASSERT(starts.size() == ends.size(),
+                 "PathFinder::geodesicDistances(): starts and ends must have "
+                 "the same size",
+                 {});
+
+  std::vector<ShortestPath> paths(starts.size());
+  for (size_t i = 0; i < starts.size(); ++i) {
+    paths[i].requestedStart = starts[i];
+    paths[i].requestedEnd = ends[i];
+  }
+  findPaths(paths, maxThreads);
+
+  std::vector<float> distances(paths.size(),
+                               std::numeric_limits<float>::infinity());
+  for (size_t i = 0; i < paths.size(); ++i) {
+    // Paths without points were not solved (e.g. no navmesh is loaded)
+    if (!paths[i].points.empty())
+      distances[i] = paths[i].geodesicDistance;
   }
+  return distances;
+}
 
-  vec3f endPoint;
-  int numPolys = 0;
-  navQuery_->moveAlongSurface(startRef, pathStart.data(), end.data(),
-                              filter_.get(), endPoint.data(), polys, &numPolys,
-                              MAX_POLYS, allowSliding);
-  // If there isn't any possible path between start and end, just return
-  // start, that is cleanest
-  if (numPolys == 0) {
-    return start;
+namespace {
+// Graph nodes shared between polygons are merged by their position, quantized
+// to 0.1mm
+struct QuantizedPoint {
+  int x, y, z;
+  bool operator==(const QuantizedPoint& other) const {
+    return x == other.x && y == other.y && z == other.z;
   }
+};
 
-  // According to recast's code
-  // (https://github.com/recastnavigation/recastnavigation/blob/master/Detour/Source/DetourNavMeshQuery.cpp#L2006-L2007),
-  // the endPoint is not guaranteed to be actually on the surface of the
-  // navmesh, it seems to be in 99.9% of cases for us, but there are some
-  // extreme edge cases where it won't be, so explicitly get the height of the
-  // surface at the endPoint and set its height to that.
-  // Note, this will never fail as endPoint is always within in the poly
-  // polys[numPolys - 1]
-  navQuery_->getPolyHeight(polys[numPolys - 1], endPoint.data(), &endPoint[1]);
+struct QuantizedPointHash {
+  size_t operator()(const QuantizedPoint& p) const {
+    size_t hash = std::hash<int>()(p.x);
+    hash = hash * 31 + std::hash<int>()(p.y);
+    hash = hash * 31 + std::hash<int>()(p.z);
+    return hash;
+  }
+};
 
-  // Hack to deal with infinitely thin walls in recast allowing you to
-  // transition between two different connected components
-  // First check to see if the endPoint as returned by `moveAlongSurface`
-  // is in the same connected component as the startRef according to
-  // findNearestPoly
-  std::tie(std::ignore, endRef, std::ignore) =
+class GraphNodeBuilder {
+ public:
+  explicit GraphNodeBuilder(std::vector<vec3f>& positions)
+      : positions_(positions) {}
+
+  uint32_t nodeAt(const vec3f& pt) {
+    constexpr float invQuantum = 1e4;
+    const QuantizedPoint key{static_cast<int>(std::lround(pt[0] * invQuantum)),
+                             static_cast<int>(std::lround(pt[1] * invQuantum)),
+                             static_cast<int>(std::lround(pt[2] * invQuantum))};
+    auto it = nodeIds_.find(key);
+    if (it != nodeIds_.end())
+      return it->second;
+
+    const uint32_t id = positions_.size();
+    positions_.emplace_back(pt);
+    nodeIds_.emplace(key, id);
+    return id;
+  }
+
+ private:
+  std::vector<vec3f>& positions_;
+  std::unordered_map<QuantizedPoint, uint32_t, QuantizedPointHash> nodeIds_;
+};
+
+const int GEODESICFIELD_MAGIC = 'G' << 24 | 'D' << 16 | 'F' << 8 | 'S';
+const int GEODESICFIELD_VERSION = 2;
+
+struct GeodesicFieldHeader {
+  int magic;
+  int version;
+  uint32_t polyRefSize;
+  uint32_t numGoals;
+  uint32_t numSnappedGoals;
+  uint32_t numPolys;
+  uint32_t numPolyNodes;
+  uint32_t numNodes;
+  uint64_t navMeshHash;
+};
+
+// FNV-1a hash of the tile layout and vertices of navMesh, which identifies
+// the navmesh fields saved to disk were built for. Only covers data Detour
+// doesn't modify once a tile is added, unlike the polygon links.
+uint64_t navMeshHash(const dtNavMesh* navMesh) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  const auto add = [&hash](const void* data, const size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash ^= bytes[i];
+      hash *= 0x100000001b3ull;
+    }
+  };
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+    const dtMeshHeader& h = *tile->header;
+    const int layout[] = {iTile, h.x, h.y, h.layer, h.polyCount, h.vertCount};
+    add(layout, sizeof(layout));
+    add(tile->verts, sizeof(float) * 3 * h.vertCount);
+  }
+  return hash;
+}
+
+// Whether exactly size bytes are left to read in fp. Checked before reading
+// arrays whose sizes come from a file header, so that a corrupt header
+// fails instead of allocating arbitrary amounts of memory.
+bool bytesLeftAre(FILE* fp, const uint64_t size) {
+  const long pos = ftell(fp);
+  if (pos < 0 || fseek(fp, 0, SEEK_END) != 0)
+    return false;
+  const long end = ftell(fp);
+  return fseek(fp, pos, SEEK_SET) == 0 && end >= pos &&
+         static_cast<uint64_t>(end - pos) == size;
+}
+
+template <typename T>
+bool writeArray(FILE* fp, const std::vector<T>& data) {
+  return data.empty() ||
+         fwrite(data.data(), sizeof(T), data.size(), fp) == data.size();
+}
+
+template <typename T>
+bool readArray(FILE* fp, std::vector<T>& data, const size_t size) {
+  data.resize(size);
+  return size == 0 || fread(data.data(), sizeof(T), size, fp) == size;
+}
+}  // namespace
+
+GeodesicDistanceField::ptr PathFinder::Impl::buildGeodesicDistanceField(
+    const std::vector<vec3f>& goals,
+    const float edgeSampleSpacing) {
+  return buildGeodesicDistanceField(goals, edgeSampleSpacing, navQuery_.get());
+}
+
+std::vector<GeodesicDistanceField::ptr>
+PathFinder::Impl::buildGeodesicDistanceFields(const std::vector<vec3f>& goals,
+                                              const float edgeSampleSpacing,
+                                              const unsigned int maxThreads) {
+  std::vector<GeodesicDistanceField::ptr> fields(goals.size());
+  if (!isLoaded())
+    return fields;
+
+  unsigned int numWorkers = core::numWorkerThreads(goals.size(), maxThreads);
+  if (!ensureWorkerQueries(numWorkers)) {
+    numWorkers = static_cast<unsigned int>(workerQueries_.size()) + 1;
+  }
+
+  core::parallelFor(
+      goals.size(), numWorkers, [&](unsigned int workerIdx, size_t i) {
+        dtNavMeshQuery* query = workerIdx == 0
+                                    ? navQuery_.get()
+                                    : workerQueries_[workerIdx - 1].get();
+        fields[i] =
+            buildGeodesicDistanceField({goals[i]}, edgeSampleSpacing, query);
+      });
+  return fields;
+}
+
+GeodesicDistanceField::ptr PathFinder::Impl::buildGeodesicDistanceField(
+    const std::vector<vec3f>& goals,
+    const float edgeSampleSpacing,
+    const dtNavMeshQuery* navQuery) {
+  if (!isLoaded())
+    return nullptr;
+
+  auto field = GeodesicDistanceField::create();
+  GeodesicDistanceField::Impl& f = *field->pimpl_;
+  f.goals = goals;
+  f.navMeshHash = navMeshHash(navMesh_.get());
+
+  const dtNavMesh* navMesh = navMesh_.get();
+  GraphNodeBuilder nodeBuilder{f.nodePositions};
+  std::vector<std::vector<uint32_t>> polyNodeSets;
+  // Polygons in other tiles don't share vertices with us, so the nodes along
+  // a tile border edge are handed to the linked polygon explicitly
+  std::vector<std::pair<dtPolyRef, uint32_t>> crossTileNodes;
+  std::vector<uint32_t> edgeNodes;
+
+  // Iterate over all tiles
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+
+    // Iterate over all polygons in a tile
+    for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+      const dtPoly* poly = &tile->polys[jPoly];
+      if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION)
+        continue;
+      const dtPolyRef polyRef = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+      if (!filter_->passFilter(polyRef, tile, poly))
+        continue;
+
+      f.polyToIndex.emplace(polyRef, f.polyRefs.size());
+      f.polyRefs.emplace_back(polyRef);
+      polyNodeSets.emplace_back();
+      std::vector<uint32_t>& polyNodes = polyNodeSets.back();
+
+      for (int iVert = 0; iVert < poly->vertCount; ++iVert) {
+        const vec3f a =
+            Eigen::Map<const vec3f>(&tile->verts[poly->verts[iVert] * 3]);
+        const vec3f b = Eigen::Map<const vec3f>(
+            &tile->verts[poly->verts[(iVert + 1) % poly->vertCount] * 3]);
+
+        // The edge's end point is added as the start of the next edge
+        edgeNodes.clear();
+        edgeNodes.emplace_back(nodeBuilder.nodeAt(a));
+
+        // Sample from the lexicographically smaller end point so that both
+        // polygons sharing this edge produce the same samples
+        const bool aFirst = std::lexicographical_compare(
+            a.data(), a.data() + 3, b.data(), b.data() + 3);
+        const vec3f& from = aFirst ? a : b;
+        const vec3f& to = aFirst ? b : a;
+        const int numSamples =
+            edgeSampleSpacing > 0
+                ? static_cast<int>((to - from).norm() / edgeSampleSpacing)
+                : 0;
+        for (int k = 1; k <= numSamples; ++k) {
+          const float t = static_cast<float>(k) / (numSamples + 1);
+          edgeNodes.emplace_back(nodeBuilder.nodeAt(from + t * (to - from)));
+        }
+        polyNodes.insert(polyNodes.end(), edgeNodes.begin(), edgeNodes.end());
+
+        // Iterate over all tile border links on this edge
+        const float edgeLengthSq = (b - a).squaredNorm();
+        for (unsigned int iLink = poly->firstLink; iLink != DT_NULL_LINK;
+             iLink = tile->links[iLink].next) {
+          const dtLink& link = tile->links[iLink];
+          if (link.edge != iVert || link.side == 0xff)
+            continue;
+
+          // bmin/bmax give the linked part of the edge in [0, 255] from a to b
+          const float tMin = link.bmin / 255.0f - 1e-3f;
+          const float tMax = link.bmax / 255.0f + 1e-3f;
+          edgeNodes.emplace_back(nodeBuilder.nodeAt(b));
+          for (const uint32_t node : edgeNodes) {
+            const float t =
+                edgeLengthSq > 0
+                    ? (f.nodePositions[node] - a).dot(b - a) / edgeLengthSq
+                    : 0.0f;
+            if (t >= tMin && t <= tMax)
+              crossTileNodes.emplace_back(link.ref, node);
+          }
+          edgeNodes.pop_back();
+        }
+      }
+    }
+  }
+
+  for (const auto& refAndNode : crossTileNodes) {
+    auto it = f.polyToIndex.find(refAndNode.first);
+    if (it != f.polyToIndex.end())
+      polyNodeSets[it->second].emplace_back(refAndNode.second);
+  }
+
+  const uint32_t numPolys = f.polyRefs.size();
+  const uint32_t numNodes = f.nodePositions.size();
+  f.polyNodeOffsets.assign(1, 0);
+  for (auto& polyNodes : polyNodeSets) {
+    std::sort(polyNodes.begin(), polyNodes.end());
+    polyNodes.erase(std::unique(polyNodes.begin(), polyNodes.end()),
+                    polyNodes.end());
+    f.polyNodes.insert(f.polyNodes.end(), polyNodes.begin(), polyNodes.end());
+    f.polyNodeOffsets.emplace_back(f.polyNodes.size());
+  }
+  polyNodeSets.clear();
+
+  // Invert the polygon -> nodes table so Dijkstra can find every polygon a
+  // node lies on
+  std::vector<uint32_t> nodePolyOffsets(numNodes + 1, 0);
+  for (const uint32_t node : f.polyNodes)
+    ++nodePolyOffsets[node + 1];
+  std::partial_sum(nodePolyOffsets.begin(), nodePolyOffsets.end(),
+                   nodePolyOffsets.begin());
+  std::vector<uint32_t> nodePolys(f.polyNodes.size());
+  std::vector<uint32_t> nodePolyFill(nodePolyOffsets.begin(),
+                                     nodePolyOffsets.end() - 1);
+  for (uint32_t iPoly = 0; iPoly < numPolys; ++iPoly) {
+    for (uint32_t k = f.polyNodeOffsets[iPoly];
+         k < f.polyNodeOffsets[iPoly + 1]; ++k) {
+      nodePolys[nodePolyFill[f.polyNodes[k]]++] = iPoly;
+    }
+  }
+
+  f.nodeDistances.assign(numNodes, std::numeric_limits<float>::infinity());
+  typedef std::pair<float, uint32_t> QueueEntry;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                      std::greater<QueueEntry>>
+      queue;
+
+  // Seed with the straight line distance from each goal to the nodes of the
+  // polygon it is in
+  for (const vec3f& goal : goals) {
+    dtStatus status = 0;
+    dtPolyRef goalRef = 0;
+    vec3f goalPoint;
+    std::tie(status, goalRef, goalPoint) =
+        projectToPoly(goal, navQuery, filter_.get());
+    auto it = f.polyToIndex.find(goalRef);
+    if (status != DT_SUCCESS || goalRef == 0 || it == f.polyToIndex.end()) {
+      LOG(WARNING) << "Could not snap goal " << goal.transpose()
+                   << " to the navmesh, ignoring it";
+      continue;
+    }
+
+    const uint32_t goalPoly = it->second;
+    f.goalPoints.emplace_back(goalPoint);
+    f.goalPolys.emplace_back(goalPoly);
+    for (uint32_t k = f.polyNodeOffsets[goalPoly];
+         k < f.polyNodeOffsets[goalPoly + 1]; ++k) {
+      const uint32_t node = f.polyNodes[k];
+      const float dist = (f.nodePositions[node] - goalPoint).norm();
+      if (dist < f.nodeDistances[node]) {
+        f.nodeDistances[node] = dist;
+        queue.emplace(dist, node);
+      }
+    }
+  }
+
+  // Polygons are convex, so any two nodes on the same polygon are connected
+  // by a straight line
+  while (!queue.empty()) {
+    const float dist = queue.top().first;
+    const uint32_t node = queue.top().second;
+    queue.pop();
+    if (dist > f.nodeDistances[node])
+      continue;
+
+    for (uint32_t i = nodePolyOffsets[node]; i < nodePolyOffsets[node + 1];
+         ++i) {
+      const uint32_t iPoly = nodePolys[i];
+      for (uint32_t k = f.polyNodeOffsets[iPoly];
+           k < f.polyNodeOffsets[iPoly + 1]; ++k) {
+        const uint32_t neighbour = f.polyNodes[k];
+        const float newDist =
+            dist +
+            (f.nodePositions[node] - f.nodePositions[neighbour]).norm();
+        if (newDist < f.nodeDistances[neighbour]) {
+          f.nodeDistances[neighbour] = newDist;
+          queue.emplace(newDist, neighbour);
+        }
+      }
+    }
+  }
+
+  LOG(INFO) << "Built geodesic distance field for " << f.goalPoints.size()
+            << " goals with " << numNodes << " nodes over " << numPolys
+            << " polygons";
+
+  return field;
+}
+
+float PathFinder::Impl::geodesicDistance(const GeodesicDistanceField& field,
+                                         const vec3f& pt) const {
+  return geodesicDistance(field, pt, navQuery_.get());
+}
+
+std::vector<float> PathFinder::Impl::geodesicDistances(
+    const std::vector<const GeodesicDistanceField*>& fields,
+    const std::vector<vec3f>& pts,
+    const unsigned int maxThreads) {
+  CORRADE_ASSERT(fields.size() == pts.size(),
+                 "PathFinder::geodesicDistances(): fields and pts must have "
+                 "the same size",
+                 {});
+
+  std::vector<float> distances(pts.size(),
+                               std::numeric_limits<float>::infinity());
+  if (!isLoaded())
+    return distances;
+
+  unsigned int numWorkers = core::numWorkerThreads(pts.size(), maxThreads);
+  if (!ensureWorkerQueries(numWorkers)) {
+    numWorkers = static_cast<unsigned int>(workerQueries_.size()) + 1;
+  }
+
+  core::parallelFor(
+      pts.size(), numWorkers, [&](unsigned int workerIdx, size_t i) {
+        dtNavMeshQuery* query = workerIdx == 0
+                                    ? navQuery_.get()
+                                    : workerQueries_[workerIdx - 1].get();
+        distances[i] = geodesicDistance(*fields[i], pts[i], query);
+      });
+  return distances;
+}
+
+float PathFinder::Impl::geodesicDistance(const GeodesicDistanceField& field,
+                                         const vec3f& pt,
+                                         const dtNavMeshQuery* navQuery) const {
+  const GeodesicDistanceField::Impl& f = *field.pimpl_;
+
+  dtPolyRef ptRef = 0;
+  dtStatus status = 0;
+  vec3f polyPt;
+  std::tie(status, ptRef, polyPt) =
+      projectToPoly(pt, navQuery, filter_.get());
+  if (status != DT_SUCCESS || ptRef == 0)
+    return std::numeric_limits<float>::infinity();
+
+  auto it = f.polyToIndex.find(ptRef);
+  if (it == f.polyToIndex.end())
+    return std::numeric_limits<float>::infinity();
+  const uint32_t polyIdx = it->second;
+
+  // Exact distance inside the polygon: either straight to a goal in the same
+  // polygon or straight to one of the polygon's nodes and on from there
+  float dist = std::numeric_limits<float>::infinity();
+  for (size_t i = 0; i < f.goalPolys.size(); ++i) {
+    if (f.goalPolys[i] == polyIdx)
+      dist = std::min(dist, (polyPt - f.goalPoints[i]).norm());
+  }
+  for (uint32_t k = f.polyNodeOffsets[polyIdx];
+       k < f.polyNodeOffsets[polyIdx + 1]; ++k) {
+    const uint32_t node = f.polyNodes[k];
+    dist = std::min(dist, f.nodeDistances[node] +
+                              (polyPt - f.nodePositions[node]).norm());
+  }
+
+  return dist;
+}
+
+bool PathFinder::Impl::saveGeodesicDistanceField(
+    const GeodesicDistanceField& field,
+    const std::string& path) const {
+  const GeodesicDistanceField::Impl& f = *field.pimpl_;
+
+  FILE* fp = fopen(path.c_str(), "wb");
+  if (!fp)
+    return false;
+
+  GeodesicFieldHeader header{};
+  header.magic = GEODESICFIELD_MAGIC;
+  header.version = GEODESICFIELD_VERSION;
+  header.polyRefSize = sizeof(dtPolyRef);
+  header.numGoals = f.goals.size();
+  header.numSnappedGoals = f.goalPoints.size();
+  header.numPolys = f.polyRefs.size();
+  header.numPolyNodes = f.polyNodes.size();
+  header.numNodes = f.nodePositions.size();
+  header.navMeshHash = f.navMeshHash;
+
+  const bool success =
+      fwrite(&header, sizeof(header), 1, fp) == 1 && writeArray(fp, f.goals) &&
+      writeArray(fp, f.goalPoints) && writeArray(fp, f.goalPolys) &&
+      writeArray(fp, f.polyRefs) && writeArray(fp, f.polyNodeOffsets) &&
+      writeArray(fp, f.polyNodes) && writeArray(fp, f.nodePositions) &&
+      writeArray(fp, f.nodeDistances);
+
+  fclose(fp);
+
+  return success;
+}
+
+GeodesicDistanceField::ptr PathFinder::Impl::loadGeodesicDistanceField(
+    const std::string& path) const {
+  if (!isLoaded())
+    return nullptr;
+
+  FILE* fp = fopen(path.c_str(), "rb");
+  if (!fp)
+    return nullptr;
+
+  GeodesicFieldHeader header{};
+  if (fread(&header, sizeof(header), 1, fp) != 1 ||
+      header.magic != GEODESICFIELD_MAGIC ||
+      header.version != GEODESICFIELD_VERSION ||
+      header.polyRefSize != sizeof(dtPolyRef)) {
+    fclose(fp);
+    return nullptr;
+  }
+  if (header.navMeshHash != navMeshHash(navMesh_.get())) {
+    LOG(ERROR) << "Geodesic distance field " << path
+               << " was built for a different navmesh";
+    fclose(fp);
+    return nullptr;
+  }
+  const uint64_t dataSize =
+      sizeof(vec3f) * (uint64_t{header.numGoals} + header.numSnappedGoals +
+                       header.numNodes) +
+      sizeof(uint32_t) * (uint64_t{header.numSnappedGoals} +
+                          header.numPolys + 1 + header.numPolyNodes) +
+      sizeof(dtPolyRef) * uint64_t{header.numPolys} +
+      sizeof(float) * uint64_t{header.numNodes};
+  if (!bytesLeftAre(fp, dataSize)) {
+    LOG(ERROR) << "Corrupt geodesic distance field " << path;
+    fclose(fp);
+    return nullptr;
+  }
+
+  auto field = GeodesicDistanceField::create();
+  GeodesicDistanceField::Impl& f = *field->pimpl_;
+  f.navMeshHash = header.navMeshHash;
+  const bool success =
+      readArray(fp, f.goals, header.numGoals) &&
+      readArray(fp, f.goalPoints, header.numSnappedGoals) &&
+      readArray(fp, f.goalPolys, header.numSnappedGoals) &&
+      readArray(fp, f.polyRefs, header.numPolys) &&
+      readArray(fp, f.polyNodeOffsets, header.numPolys + 1) &&
+      readArray(fp, f.polyNodes, header.numPolyNodes) &&
+      readArray(fp, f.nodePositions, header.numNodes) &&
+      readArray(fp, f.nodeDistances, header.numNodes);
+  fclose(fp);
+  if (!success)
+    return nullptr;
+
+  // Every index has to stay inside the arrays it indexes
+  const auto outside = [](const std::vector<uint32_t>& indices,
+                          const uint32_t size) {
+    return std::any_of(indices.begin(), indices.end(),
+                       [size](const uint32_t i) { return i >= size; });
+  };
+  if (f.polyNodeOffsets.front() != 0 ||
+      f.polyNodeOffsets.back() != header.numPolyNodes ||
+      !std::is_sorted(f.polyNodeOffsets.begin(), f.polyNodeOffsets.end()) ||
+      outside(f.polyNodes, header.numNodes) ||
+      outside(f.goalPolys, header.numPolys)) {
+    LOG(ERROR) << "Corrupt geodesic distance field " << path;
+    return nullptr;
+  }
+  for (uint32_t iPoly = 0; iPoly < header.numPolys; ++iPoly) {
+    if (!navMesh_->isValidPolyRef(f.polyRefs[iPoly])) {
+      LOG(ERROR) << "Geodesic distance field " << path
+                 << " was built for a different navmesh";
+      return nullptr;
+    }
+    f.polyToIndex.emplace(f.polyRefs[iPoly], iPoly);
+  }
+
+  return field;
+}
+
+namespace {
+const int OBSTACLEFIELD_MAGIC = 'O' << 24 | 'D' << 16 | 'F' << 8 | 'S';
+const int OBSTACLEFIELD_VERSION = 2;
+
+struct ObstacleFieldHeader {
+  int magic;
+  int version;
+  float cellSize;
+  float maxDistance;
+  float origin[2];
+  int width;
+  int height;
+  uint64_t navMeshHash;
+  uint32_t numSamples;
+};
+
+struct WallEdge {
+  float a[3];
+  float b[3];
+};
+}  // namespace
+
+bool PathFinder::Impl::buildObstacleDistanceField(const float cellSize,
+                                                  const float maxDistance) {
+  CORRADE_ASSERT(cellSize > 0 && maxDistance > 0,
+                 "PathFinder::buildObstacleDistanceField(): cellSize and "
+                 "maxDistance must be positive",
+                 false);
+  obstacleField_.reset();
+  if (!isLoaded())
+    return false;
+  const impl::PolyGridIndex& index = polyIndex();
+  const dtNavMesh* navMesh = navMesh_.get();
+
+  // Collect the walls, using the same definition as findDistanceToWall: polygon
+  // edges without a neighbour that passes the filter
+  std::vector<WallEdge> walls;
+  float bmin[2] = {std::numeric_limits<float>::max(),
+                   std::numeric_limits<float>::max()};
+  float bmax[2] = {-std::numeric_limits<float>::max(),
+                   -std::numeric_limits<float>::max()};
+  float walkableHeight = 0;
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+    walkableHeight = std::max(walkableHeight, tile->header->walkableHeight);
+
+    for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+      const dtPoly* poly = &tile->polys[jPoly];
+      const dtPolyRef ref = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+      if (poly->getType() != DT_POLYTYPE_GROUND ||
+          !filter_->passFilter(ref, tile, poly))
+        continue;
+
+      for (int j = 0; j < poly->vertCount; ++j) {
+        bool solid = true;
+        if (poly->neis[j] & DT_EXT_LINK) {
+          // Tile border
+          for (unsigned int k = poly->firstLink; k != DT_NULL_LINK;
+               k = tile->links[k].next) {
+            const dtLink& link = tile->links[k];
+            if (link.edge != j)
+              continue;
+            if (link.ref != 0) {
+              const dtMeshTile* neiTile = nullptr;
+              const dtPoly* neiPoly = nullptr;
+              navMesh->getTileAndPolyByRefUnsafe(link.ref, &neiTile, &neiPoly);
+              solid = !filter_->passFilter(link.ref, neiTile, neiPoly);
+            }
+            break;
+          }
+        } else if (poly->neis[j]) {
+          const unsigned int idx = poly->neis[j] - 1;
+          const dtPolyRef neiRef = navMesh->getPolyRefBase(tile) | idx;
+          solid = !filter_->passFilter(neiRef, tile, &tile->polys[idx]);
+        }
+
+        const float* va = &tile->verts[poly->verts[j] * 3];
+        const float* vb =
+            &tile->verts[poly->verts[(j + 1) % poly->vertCount] * 3];
+        bmin[0] = std::min(bmin[0], va[0]);
+        bmin[1] = std::min(bmin[1], va[2]);
+        bmax[0] = std::max(bmax[0], va[0]);
+        bmax[1] = std::max(bmax[1], va[2]);
+        if (solid) {
+          WallEdge wall;
+          rcVcopy(wall.a, va);
+          rcVcopy(wall.b, vb);
+          walls.push_back(wall);
+        }
+      }
+    }
+  }
+  if (bmin[0] > bmax[0]) {
+    LOG(ERROR) << "Navmesh has no walkable polygons";
+    return false;
+  }
+
+  auto field = std::make_unique<impl::ObstacleDistanceField>();
+  field->cellSize = cellSize;
+  field->maxDistance = maxDistance;
+  field->origin[0] = bmin[0];
+  field->origin[1] = bmin[1];
+  field->width =
+      static_cast<int>(std::ceil((bmax[0] - bmin[0]) / cellSize)) + 1;
+  field->height =
+      static_cast<int>(std::ceil((bmax[1] - bmin[1]) / cellSize)) + 1;
+  field->navMeshHash = navMeshHash(navMesh_.get());
+
+  // Bucket the walls into a grid with cells at least maxDistance wide, so all
+  // walls within maxDistance of a point are in the 3x3 cells around it
+  const float wallCellSize = std::max(maxDistance, cellSize);
+  const int wallGridWidth =
+      static_cast<int>((bmax[0] - bmin[0]) / wallCellSize) + 1;
+  const int wallGridHeight =
+      static_cast<int>((bmax[1] - bmin[1]) / wallCellSize) + 1;
+  auto wallCell = [&](float coord, int axis) {
+    const int c =
+        static_cast<int>(std::floor((coord - bmin[axis]) / wallCellSize));
+    return std::max(
+        0, std::min(c, (axis == 0 ? wallGridWidth : wallGridHeight) - 1));
+  };
+  std::vector<std::vector<uint32_t>> wallGrid(wallGridWidth * wallGridHeight);
+  for (uint32_t iWall = 0; iWall < walls.size(); ++iWall) {
+    const WallEdge& w = walls[iWall];
+    for (int z = wallCell(std::min(w.a[2], w.b[2]), 1);
+         z <= wallCell(std::max(w.a[2], w.b[2]), 1); ++z) {
+      for (int x = wallCell(std::min(w.a[0], w.b[0]), 0);
+           x <= wallCell(std::max(w.a[0], w.b[0]), 0); ++x) {
+        wallGrid[z * wallGridWidth + x].push_back(iWall);
+      }
+    }
+  }
+
+  // Walls count for a sample if they are at roughly the same height, which
+  // keeps floors stacked above each other apart
+  const float maxWallDy = 0.5f * walkableHeight;
+
+  // Sample every walkable surface at every grid node, row by row in parallel
+  std::vector<std::vector<uint32_t>> rowCounts(field->height);
+  std::vector<std::vector<float>> rowHeights(field->height);
+  std::vector<std::vector<float>> rowDistances(field->height);
+  core::parallelFor(
+      field->height, core::numWorkerThreads(field->height),
+      [&](unsigned int, size_t z) {
+        const float pz = field->origin[1] + z * cellSize;
+        const int wz = wallCell(pz, 1);
+        std::vector<float> heights;
+        rowCounts[z].assign(field->width, 0);
+        for (int x = 0; x < field->width; ++x) {
+          const float px = field->origin[0] + x * cellSize;
+          const int wx = wallCell(px, 0);
+
+          // Triangles sharing an edge report the same surface twice
+          heights.clear();
+          index.surfaceHeights(px, pz, heights);
+          std::sort(heights.begin(), heights.end());
+          heights.erase(std::unique(heights.begin(), heights.end(),
+                                    [](float a, float b) {
+                                      return std::abs(a - b) < 1e-2f;
+                                    }),
+                        heights.end());
+
+          for (const float py : heights) {
+            float distSqr = maxDistance * maxDistance;
+            for (int cz = std::max(0, wz - 1);
+                 cz <= std::min(wallGridHeight - 1, wz + 1); ++cz) {
+              for (int cx = std::max(0, wx - 1);
+                   cx <= std::min(wallGridWidth - 1, wx + 1); ++cx) {
+                for (const uint32_t iWall : wallGrid[cz * wallGridWidth + cx]) {
+                  const WallEdge& w = walls[iWall];
+                  if (std::min(w.a[1], w.b[1]) > py + maxWallDy ||
+                      std::max(w.a[1], w.b[1]) < py - maxWallDy)
+                    continue;
+                  const float pt[3] = {px, py, pz};
+                  float t = 0;
+                  distSqr = std::min(
+                      distSqr, dtDistancePtSegSqr2D(pt, w.a, w.b, t));
+                }
+              }
+            }
+            rowHeights[z].push_back(py);
+            rowDistances[z].push_back(std::sqrt(distSqr));
+          }
+          rowCounts[z][x] = heights.size();
+        }
+      });
+
+  field->nodeOffsets.reserve(field->width * field->height + 1);
+  field->nodeOffsets.push_back(0);
+  for (int z = 0; z < field->height; ++z) {
+    for (const uint32_t count : rowCounts[z]) {
+      field->nodeOffsets.push_back(field->nodeOffsets.back() + count);
+    }
+    field->sampleHeights.insert(field->sampleHeights.end(),
+                                rowHeights[z].begin(), rowHeights[z].end());
+    field->sampleDistances.insert(field->sampleDistances.end(),
+                                  rowDistances[z].begin(),
+                                  rowDistances[z].end());
+  }
+
+  LOG(INFO) << "Built obstacle distance field with " << field->width << "x"
+            << field->height << " nodes, " << field->sampleHeights.size()
+            << " samples and " << walls.size() << " walls";
+  obstacleField_ = std::move(field);
+  return true;
+}
+
+bool PathFinder::Impl::saveObstacleDistanceField(
+    const std::string& path) const {
+  if (!obstacleField_)
+    return false;
+  const impl::ObstacleDistanceField& f = *obstacleField_;
+
+  FILE* fp = fopen(path.c_str(), "wb");
+  if (!fp)
+    return false;
+
+  ObstacleFieldHeader header{};
+  header.magic = OBSTACLEFIELD_MAGIC;
+  header.version = OBSTACLEFIELD_VERSION;
+  header.cellSize = f.cellSize;
+  header.maxDistance = f.maxDistance;
+  header.origin[0] = f.origin[0];
+  header.origin[1] = f.origin[1];
+  header.width = f.width;
+  header.height = f.height;
+  header.navMeshHash = f.navMeshHash;
+  header.numSamples = f.sampleHeights.size();
+
+  const bool success = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+                       writeArray(fp, f.nodeOffsets) &&
+                       writeArray(fp, f.sampleHeights) &&
+                       writeArray(fp, f.sampleDistances);
+
+  fclose(fp);
+
+  return success;
+}
+
+bool PathFinder::Impl::loadObstacleDistanceField(const std::string& path) {
+  if (!isLoaded())
+    return false;
+
+  FILE* fp = fopen(path.c_str(), "rb");
+  if (!fp)
+    return false;
+
+  ObstacleFieldHeader header{};
+  if (fread(&header, sizeof(header), 1, fp) != 1 ||
+      header.magic != OBSTACLEFIELD_MAGIC ||
+      header.version != OBSTACLEFIELD_VERSION || header.width <= 0 ||
+      header.height <= 0 || !(header.cellSize > 0)) {
+    fclose(fp);
+    return false;
+  }
+  if (header.navMeshHash != navMeshHash(navMesh_.get())) {
+    LOG(ERROR) << "Obstacle distance field " << path
+               << " was built for a different navmesh";
+    fclose(fp);
+    return false;
+  }
+  const uint64_t numNodes = uint64_t{static_cast<uint32_t>(header.width)} *
+                            static_cast<uint32_t>(header.height);
+  const uint64_t dataSize = sizeof(uint32_t) * (numNodes + 1) +
+                            2 * sizeof(float) * uint64_t{header.numSamples};
+  // Node indices are ints in lookup()
+  if (numNodes >= std::numeric_limits<int>::max() ||
+      !bytesLeftAre(fp, dataSize)) {
+    LOG(ERROR) << "Corrupt obstacle distance field " << path;
+    fclose(fp);
+    return false;
+  }
+
+  auto field = std::make_unique<impl::ObstacleDistanceField>();
+  field->cellSize = header.cellSize;
+  field->maxDistance = header.maxDistance;
+  field->origin[0] = header.origin[0];
+  field->origin[1] = header.origin[1];
+  field->width = header.width;
+  field->height = header.height;
+  field->navMeshHash = header.navMeshHash;
+  const bool success =
+      readArray(fp, field->nodeOffsets, numNodes + 1) &&
+      readArray(fp, field->sampleHeights, header.numSamples) &&
+      readArray(fp, field->sampleDistances, header.numSamples);
+  fclose(fp);
+  if (!success)
+    return false;
+
+  if (field->nodeOffsets.front() != 0 ||
+      field->nodeOffsets.back() != header.numSamples ||
+      !std::is_sorted(field->nodeOffsets.begin(), field->nodeOffsets.end())) {
+    LOG(ERROR) << "Corrupt obstacle distance field " << path;
+    return false;
+  }
+
+  // distanceToClosestObstacle() looks the field up through the poly index
+  polyIndex();
+  obstacleField_ = std::move(field);
+  return true;
+}
+
+template <typename T>
+T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
+  std::vector<dtPolyRef>& polys = pathBuffer(maxPathPolys_);
+
+  dtStatus startStatus = 0, endStatus = 0;
+  dtPolyRef startRef = 0, endRef = 0;
+  vec3f pathStart;
+  std::tie(startStatus, startRef, pathStart) =
+      projectToPoly(start, navQuery_.get(), filter_.get());
+  std::tie(endStatus, endRef, std::ignore) =
+      projectToPoly(end, navQuery_.get(), filter_.get());
+
+  if (dtStatusFailed(startStatus) || dtStatusFailed(endStatus)) {
+    return start;
+  }
+
+  if (not islandSystem_->hasConnection(startRef, endRef)) {
+    return start;
+  }
+
+  vec3f endPoint;
+  int numPolys = 0;
+  // The last visited polygon is only correct if all of them fit in the
+  // buffer, so retry with a larger one if needed
+  dtStatus status = 0;
+  do {
+    status = navQuery_->moveAlongSurface(
+        startRef, pathStart.data(), end.data(), filter_.get(), endPoint.data(),
+        polys.data(), &numPolys, static_cast<int>(polys.size()),
+        allowSliding);
+  } while (dtStatusDetail(status, DT_BUFFER_TOO_SMALL) &&
+           growPathBuffer(polys, maxPathPolys_));
+  // If there isn't any possible path between start and end, just return
+  // start, that is cleanest
+  if (numPolys == 0) {
+    return start;
+  }
+
+  // According to recast's code
+  // (https://github.com/recastnavigation/recastnavigation/blob/master/Detour/Source/DetourNavMeshQuery.cpp#L2006-L2007),
+  // the endPoint is not guaranteed to be actually on the surface of the
+  // navmesh, it seems to be in 99.9% of cases for us, but there are some
+  // extreme edge cases where it won't be, so explicitly get the height of the
+  // surface at the endPoint and set its height to that.
+  // Note, this will never fail as endPoint is always within in the poly
+  // polys[numPolys - 1]
+  navQuery_->getPolyHeight(polys[numPolys - 1], endPoint.data(), &endPoint[1]);
+
+  // Hack to deal with infinitely thin walls in recast allowing you to
+  // transition between two different connected components
+  // First check to see if the endPoint as returned by `moveAlongSurface`
+  // is in the same connected component as the startRef according to
+  // findNearestPoly
+  std::tie(std::ignore, endRef, std::ignore) =
       projectToPoly(endPoint, navQuery_.get(), filter_.get());
   if (!this->islandSystem_->hasConnection(startRef, endRef)) {
     // There isn't a connection!  This happens when endPoint is on an edge
@@ -1200,6 +3466,18 @@ T PathFinder::Impl::snapPoint(const T& pt) {
   }
 }
 
+int PathFinder::Impl::islandId(const vec3f& pt) const {
+  dtPolyRef ptRef = 0;
+  dtStatus status = 0;
+  std::tie(status, ptRef, std::ignore) =
+      projectToPoly(pt, navQuery_.get(), filter_.get());
+  if (status != DT_SUCCESS || ptRef == 0) {
+    return ID_UNDEFINED;
+  } else {
+    return islandSystem_->islandId(ptRef);
+  }
+}
+
 float PathFinder::Impl::islandRadius(const vec3f& pt) const {
   dtPolyRef ptRef = 0;
   dtStatus status = 0;
@@ -1215,6 +3493,17 @@ float PathFinder::Impl::islandRadius(const vec3f& pt) const {
 float PathFinder::Impl::distanceToClosestObstacle(
     const vec3f& pt,
     const float maxSearchRadius /*= 2.0*/) const {
+  if (obstacleField_) {
+    dtPolyRef ptRef = 0;
+    dtStatus status = 0;
+    vec3f polyPt;
+    std::tie(status, ptRef, polyPt) = projectToPolyIndexed(pt);
+    if (status != DT_SUCCESS || ptRef == 0)
+      return std::numeric_limits<float>::infinity();
+    float distance = 0;
+    if (obstacleField_->lookup(polyPt, distance))
+      return std::min(distance, maxSearchRadius);
+  }
   return closestObstacleSurfacePoint(pt, maxSearchRadius).hitDist;
 }
 
@@ -1258,11 +3547,133 @@ bool PathFinder::Impl::isNavigable(const vec3f& pt,
   return true;
 }
 
+const impl::PolyGridIndex& PathFinder::Impl::polyIndex() {
+  if (!polyIndex_) {
+    polyIndex_ =
+        std::make_unique<impl::PolyGridIndex>(navMesh_.get(), filter_.get());
+  }
+  return *polyIndex_;
+}
+
+std::tuple<dtStatus, dtPolyRef, vec3f> PathFinder::Impl::projectToPolyIndexed(
+    const vec3f& pt) const {
+  dtPolyRef ref = 0;
+  vec3f projected;
+  if (polyIndex_ && polyIndex_->project(pt, ref, projected))
+    return std::make_tuple(DT_SUCCESS, ref, projected);
+  // findNearestPoly doesn't touch the query's node pool, so navQuery_ can be
+  // shared between threads here
+  return projectToPoly(pt, navQuery_.get(), filter_.get());
+}
+
+std::vector<vec3f> PathFinder::Impl::snapPoints(
+    const std::vector<vec3f>& pts,
+    const unsigned int maxThreads) {
+  std::vector<vec3f> snapped(pts.size(),
+                             vec3f::Constant(Mn::Constants::nan()));
+  if (!isLoaded())
+    return snapped;
+  polyIndex();
+
+  core::parallelFor(pts.size(), core::numWorkerThreads(pts.size(), maxThreads),
+                    [&](unsigned int, size_t i) {
+                      dtStatus status = 0;
+                      vec3f projectedPt;
+                      std::tie(status, std::ignore, projectedPt) =
+                          projectToPolyIndexed(pts[i]);
+                      if (dtStatusSucceed(status))
+                        snapped[i] = projectedPt;
+                    });
+  return snapped;
+}
+
+std::vector<bool> PathFinder::Impl::isNavigableBatch(
+    const std::vector<vec3f>& pts,
+    const float maxYDelta,
+    const unsigned int maxThreads) {
+  // std::vector<bool> packs bits, so the workers write bytes instead
+  std::vector<unsigned char> navigable(pts.size(), 0);
+  if (isLoaded()) {
+    polyIndex();
+    core::parallelFor(
+        pts.size(), core::numWorkerThreads(pts.size(), maxThreads),
+        [&](unsigned int, size_t i) {
+          const vec3f& pt = pts[i];
+          dtPolyRef ptRef = 0;
+          dtStatus status = 0;
+          vec3f polyPt;
+          std::tie(status, ptRef, polyPt) = projectToPolyIndexed(pt);
+          navigable[i] =
+              status == DT_SUCCESS && ptRef != 0 &&
+              std::abs(polyPt[1] - pt[1]) <= maxYDelta &&
+              (Eigen::Vector2f(pt[0], pt[2]) -
+               Eigen::Vector2f(polyPt[0], polyPt[2]))
+                      .norm() <= 1e-2;
+        });
+  }
+  return std::vector<bool>(navigable.begin(), navigable.end());
+}
+
+std::vector<float> PathFinder::Impl::distancesToClosestObstacle(
+    const std::vector<vec3f>& pts,
+    const float maxSearchRadius,
+    const unsigned int maxThreads) {
+  std::vector<float> distances(pts.size(),
+                               std::numeric_limits<float>::infinity());
+  if (!isLoaded())
+    return distances;
+  polyIndex();
+
+  // findDistanceToWall searches with the query's node pool, so every worker
+  // needs its own query object
+  unsigned int numWorkers = core::numWorkerThreads(pts.size(), maxThreads);
+  if (!ensureWorkerQueries(numWorkers)) {
+    numWorkers = static_cast<unsigned int>(workerQueries_.size()) + 1;
+  }
+
+  core::parallelFor(
+      pts.size(), numWorkers, [&](unsigned int workerIdx, size_t i) {
+        dtNavMeshQuery* query = workerIdx == 0
+                                    ? navQuery_.get()
+                                    : workerQueries_[workerIdx - 1].get();
+        dtPolyRef ptRef = 0;
+        dtStatus status = 0;
+        vec3f polyPt;
+        std::tie(status, ptRef, polyPt) = projectToPolyIndexed(pts[i]);
+        if (status != DT_SUCCESS || ptRef == 0)
+          return;
+        float distance = 0;
+        if (obstacleField_ && obstacleField_->lookup(polyPt, distance)) {
+          distances[i] = std::min(distance, maxSearchRadius);
+          return;
+        }
+        vec3f hitPos, hitNormal;
+        float hitDist = NAN;
+        query->findDistanceToWall(ptRef, polyPt.data(), maxSearchRadius,
+                                  filter_.get(), &hitDist, hitPos.data(),
+                                  hitNormal.data());
+        distances[i] = hitDist;
+      });
+  return distances;
+}
+
 typedef Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> MatrixXb;
 
+// Enough for one map per floor at a couple of resolutions
+constexpr size_t MAX_CACHED_TOP_DOWN_VIEWS = 8;
+
 Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>
 PathFinder::Impl::getTopDownView(const float metersPerPixel,
                                  const float height) {
+  return getTopDownViews(metersPerPixel, {height})[0];
+}
+
+std::vector<Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>>
+PathFinder::Impl::getTopDownViews(const float metersPerPixel,
+                                  const std::vector<float>& heights) {
+  // Same vertical slack as the isNavigable check this replaces
+  constexpr float maxYDelta = 0.5;
+
   std::pair<vec3f, vec3f> mapBounds = bounds();
   vec3f bound1 = mapBounds.first;
   vec3f bound2 = mapBounds.second;
@@ -1273,21 +3684,139 @@ PathFinder::Impl::getTopDownView(const float metersPerPixel,
   int zResolution = zspan / metersPerPixel;
   float startx = fmin(bound1[0], bound2[0]);
   float startz = fmin(bound1[2], bound2[2]);
-  MatrixXb topdownMap(zResolution, xResolution);
-
-  float curz = startz;
-  float curx = startx;
-  for (int h = 0; h < zResolution; h++) {
-    for (int w = 0; w < xResolution; w++) {
-      vec3f point = vec3f(curx, height, curz);
-      topdownMap(h, w) = isNavigable(point, 0.5);
-      curx = curx + metersPerPixel;
+
+  std::vector<MatrixXb> maps(heights.size());
+  // Heights missing from the cache, each rasterized once into a slice
+  std::vector<float> sliceHeights;
+  std::vector<int> mapSlices(heights.size(), -1);
+  for (size_t i = 0; i < heights.size(); ++i) {
+    const std::pair<float, float> key{metersPerPixel, heights[i]};
+    auto cached = std::find_if(
+        topDownViewCache_.begin(), topDownViewCache_.end(),
+        [&key](const std::pair<std::pair<float, float>, MatrixXb>& entry) {
+          return entry.first == key;
+        });
+    if (cached != topDownViewCache_.end()) {
+      topDownViewCache_.splice(topDownViewCache_.begin(), topDownViewCache_,
+                               cached);
+      maps[i] = cached->second;
+    } else {
+      const auto slice =
+          std::find(sliceHeights.begin(), sliceHeights.end(), heights[i]);
+      mapSlices[i] = slice - sliceHeights.begin();
+      if (slice == sliceHeights.end())
+        sliceHeights.push_back(heights[i]);
     }
-    curz = curz + metersPerPixel;
-    curx = startx;
+  }
+  if (sliceHeights.empty()) {
+    return maps;
   }
 
-  return topdownMap;
+  const std::vector<vec3f> noVerts;
+  const assets::MeshData::ptr meshData = getNavMeshData();
+  const std::vector<vec3f>& verts = meshData ? meshData->vbo : noVerts;
+  const float minHeight =
+      *std::min_element(sliceHeights.begin(), sliceHeights.end());
+  const float maxHeight =
+      *std::max_element(sliceHeights.begin(), sliceHeights.end());
+
+  // Bucket the triangles that can reach any of the slices by the rows whose
+  // sample line crosses them
+  auto rowOf = [startz, metersPerPixel](float z) {
+    return (z - startz) / metersPerPixel;
+  };
+  std::vector<std::vector<int>> rowTris(zResolution);
+  for (size_t iTri = 0; iTri + 2 < verts.size(); iTri += 3) {
+    const vec3f& a = verts[iTri];
+    const vec3f& b = verts[iTri + 1];
+    const vec3f& c = verts[iTri + 2];
+    if (std::min({a[1], b[1], c[1]}) - maxYDelta > maxHeight ||
+        std::max({a[1], b[1], c[1]}) + maxYDelta < minHeight) {
+      continue;
+    }
+    const int h0 = std::max(
+        0, static_cast<int>(std::ceil(rowOf(std::min({a[2], b[2], c[2]})))));
+    const int h1 = std::min(
+        zResolution - 1,
+        static_cast<int>(std::floor(rowOf(std::max({a[2], b[2], c[2]})))));
+    for (int h = h0; h <= h1; ++h) {
+      rowTris[h].push_back(iTri);
+    }
+  }
+
+  // Scan-convert each row independently. Row major storage keeps each
+  // worker's writes contiguous.
+  typedef Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      RowMajorMatrixXb;
+  std::vector<RowMajorMatrixXb> slices(
+      sliceHeights.size(),
+      RowMajorMatrixXb::Constant(zResolution, xResolution, false));
+  core::parallelFor(
+      zResolution, core::numWorkerThreads(zResolution),
+      [&](unsigned int, size_t h) {
+        const float z = startz + h * metersPerPixel;
+        for (const int iTri : rowTris[h]) {
+          // Intersect the sample line with the triangle edges to get the
+          // covered x interval and the heights at its ends. A line through a
+          // vertex hits two edges there, so keep the extreme hits.
+          float xs[2] = {std::numeric_limits<float>::max(),
+                         -std::numeric_limits<float>::max()};
+          float ys[2] = {0, 0};
+          for (int e = 0; e < 3; ++e) {
+            const vec3f& p = verts[iTri + e];
+            const vec3f& q = verts[iTri + (e + 1) % 3];
+            if ((z < p[2] && z < q[2]) || (z > p[2] && z > q[2]) ||
+                p[2] == q[2]) {
+              continue;
+            }
+            const float t = (z - p[2]) / (q[2] - p[2]);
+            const float x = p[0] + t * (q[0] - p[0]);
+            const float y = p[1] + t * (q[1] - p[1]);
+            if (x < xs[0]) {
+              xs[0] = x;
+              ys[0] = y;
+            }
+            if (x > xs[1]) {
+              xs[1] = x;
+              ys[1] = y;
+            }
+          }
+          if (xs[0] > xs[1]) {
+            continue;
+          }
+
+          const int w0 = std::max(
+              0,
+              static_cast<int>(std::ceil((xs[0] - startx) / metersPerPixel)));
+          const int w1 = std::min(
+              xResolution - 1,
+              static_cast<int>(std::floor((xs[1] - startx) / metersPerPixel)));
+          const float dx = xs[1] - xs[0];
+          for (int w = w0; w <= w1; ++w) {
+            const float x = startx + w * metersPerPixel;
+            const float y =
+                dx > 0 ? ys[0] + (x - xs[0]) / dx * (ys[1] - ys[0]) : ys[0];
+            for (size_t s = 0; s < sliceHeights.size(); ++s) {
+              if (std::abs(y - sliceHeights[s]) <= maxYDelta) {
+                slices[s](h, w) = true;
+              }
+            }
+          }
+        }
+      });
+
+  for (size_t i = 0; i < heights.size(); ++i) {
+    if (mapSlices[i] >= 0)
+      maps[i] = slices[mapSlices[i]];
+  }
+  for (size_t s = 0; s < sliceHeights.size(); ++s) {
+    topDownViewCache_.emplace_front(
+        std::make_pair(metersPerPixel, sliceHeights[s]), slices[s]);
+  }
+  while (topDownViewCache_.size() > MAX_CACHED_TOP_DOWN_VIEWS) {
+    topDownViewCache_.pop_back();
+  }
+  return maps;
 }
 
 const assets::MeshData::ptr PathFinder::Impl::getNavMeshData() {
@@ -1300,7 +3829,7 @@ const assets::MeshData::ptr PathFinder::Impl::getNavMeshData() {
     for (int iTile = 0; iTile < navMesh_->getMaxTiles(); ++iTile) {
       const dtMeshTile* tile =
           const_cast<const dtNavMesh*>(navMesh_.get())->getTile(iTile);
-      if (!tile)
+      if (!tile || !tile->header)
         continue;
 
       // Iterate over all polygons in a tile
@@ -1344,24 +3873,98 @@ bool PathFinder::build(const NavMeshSettings& bs,
   return pimpl_->build(bs, mesh);
 }
 
+bool PathFinder::supportsTileUpdates() const {
+  return pimpl_->supportsTileUpdates();
+}
+
+bool PathFinder::updateTilesAsync(
+    const esp::assets::MeshData& mesh,
+    const std::vector<std::pair<vec3f, vec3f>>& regions) {
+  return pimpl_->updateTilesAsync(mesh, regions);
+}
+
+bool PathFinder::hasPendingTileUpdates() const {
+  return pimpl_->hasPendingTileUpdates();
+}
+
+bool PathFinder::applyTileUpdates(const bool wait /*= false*/) {
+  return pimpl_->applyTileUpdates(wait);
+}
+
 vec3f PathFinder::getRandomNavigablePoint(const int maxTries /*= 10*/) {
   return pimpl_->getRandomNavigablePoint(maxTries);
 }
 
 bool PathFinder::findPath(ShortestPath& path) {
+  ESP_PROFILE_SCOPE("PathFinder::findPath");
   return pimpl_->findPath(path);
 }
 
 bool PathFinder::findPath(MultiGoalShortestPath& path) {
+  ESP_PROFILE_SCOPE("PathFinder::findPath");
   return pimpl_->findPath(path);
 }
 
+int PathFinder::findPaths(std::vector<ShortestPath>& paths,
+                          const unsigned int maxThreads) {
+  return pimpl_->findPaths(paths, maxThreads);
+}
+
+void PathFinder::setPathSearchLimits(const int maxPathPolys,
+                                     const int maxSearchNodes) {
+  pimpl_->setPathSearchLimits(maxPathPolys, maxSearchNodes);
+}
+
+std::vector<float> PathFinder::geodesicDistances(
+    const std::vector<vec3f>& starts,
+    const std::vector<vec3f>& ends,
+    const unsigned int maxThreads) {
+  return pimpl_->geodesicDistances(starts, ends, maxThreads);
+}
+
+GeodesicDistanceField::ptr PathFinder::buildGeodesicDistanceField(
+    const std::vector<vec3f>& goals,
+    const float edgeSampleSpacing) {
+  return pimpl_->buildGeodesicDistanceField(goals, edgeSampleSpacing);
+}
+
+float PathFinder::geodesicDistance(const GeodesicDistanceField& field,
+                                   const vec3f& pt) const {
+  return pimpl_->geodesicDistance(field, pt);
+}
+
+std::vector<GeodesicDistanceField::ptr> PathFinder::buildGeodesicDistanceFields(
+    const std::vector<vec3f>& goals,
+    const float edgeSampleSpacing,
+    const unsigned int maxThreads) {
+  return pimpl_->buildGeodesicDistanceFields(goals, edgeSampleSpacing,
+                                             maxThreads);
+}
+
+std::vector<float> PathFinder::geodesicDistances(
+    const std::vector<const GeodesicDistanceField*>& fields,
+    const std::vector<vec3f>& pts,
+    const unsigned int maxThreads) {
+  return pimpl_->geodesicDistances(fields, pts, maxThreads);
+}
+
+bool PathFinder::saveGeodesicDistanceField(const GeodesicDistanceField& field,
+                                           const std::string& path) const {
+  return pimpl_->saveGeodesicDistanceField(field, path);
+}
+
+GeodesicDistanceField::ptr PathFinder::loadGeodesicDistanceField(
+    const std::string& path) const {
+  return pimpl_->loadGeodesicDistanceField(path);
+}
+
 template vec3f PathFinder::tryStep<vec3f>(const vec3f&, const vec3f&);
 template Mn::Vector3 PathFinder::tryStep<Mn::Vector3>(const Mn::Vector3&,
                                                       const Mn::Vector3&);
 
 template <typename T>
 T PathFinder::tryStep(const T& start, const T& end) {
+  ESP_PROFILE_SCOPE("PathFinder::tryStep");
   return pimpl_->tryStep(start, end, /*allowSliding=*/true);
 }
 
@@ -1399,6 +4002,20 @@ void PathFinder::seed(uint32_t newSeed) {
   return pimpl_->seed(newSeed);
 }
 
+std::vector<vec3f> PathFinder::sampleNavigablePoints(
+    const int numPoints,
+    const uint32_t seed,
+    const NavigablePointFilter& filter,
+    const int maxTries,
+    const unsigned int maxThreads) {
+  return pimpl_->sampleNavigablePoints(numPoints, seed, filter, maxTries,
+                                       maxThreads);
+}
+
+int PathFinder::islandId(const vec3f& pt) const {
+  return pimpl_->islandId(pt);
+}
+
 float PathFinder::islandRadius(const vec3f& pt) const {
   return pimpl_->islandRadius(pt);
 }
@@ -1432,6 +4049,51 @@ Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> PathFinder::getTopDownView(
   return pimpl_->getTopDownView(metersPerPixel, height);
 }
 
+std::vector<Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>>
+PathFinder::getTopDownViews(const float metersPerPixel,
+                            const std::vector<float>& heights) {
+  return pimpl_->getTopDownViews(metersPerPixel, heights);
+}
+
+bool PathFinder::buildObstacleDistanceField(const float cellSize,
+                                            const float maxDistance) {
+  return pimpl_->buildObstacleDistanceField(cellSize, maxDistance);
+}
+
+bool PathFinder::hasObstacleDistanceField() const {
+  return pimpl_->hasObstacleDistanceField();
+}
+
+void PathFinder::clearObstacleDistanceField() {
+  pimpl_->clearObstacleDistanceField();
+}
+
+bool PathFinder::saveObstacleDistanceField(const std::string& path) const {
+  return pimpl_->saveObstacleDistanceField(path);
+}
+
+bool PathFinder::loadObstacleDistanceField(const std::string& path) {
+  return pimpl_->loadObstacleDistanceField(path);
+}
+
+std::vector<vec3f> PathFinder::snapPoints(const std::vector<vec3f>& pts,
+                                          const unsigned int maxThreads) {
+  return pimpl_->snapPoints(pts, maxThreads);
+}
+
+std::vector<bool> PathFinder::isNavigableBatch(const std::vector<vec3f>& pts,
+                                               const float maxYDelta,
+                                               const unsigned int maxThreads) {
+  return pimpl_->isNavigableBatch(pts, maxYDelta, maxThreads);
+}
+
+std::vector<float> PathFinder::distancesToClosestObstacle(
+    const std::vector<vec3f>& pts,
+    const float maxSearchRadius,
+    const unsigned int maxThreads) {
+  return pimpl_->distancesToClosestObstacle(pts, maxSearchRadius, maxThreads);
+}
+
 const assets::MeshData::ptr PathFinder::getNavMeshData() {
   return pimpl_->getNavMeshData();
 }
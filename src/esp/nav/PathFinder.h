@@ -5,6 +5,7 @@
 #ifndef ESP_NAV_PATHFINDER_H_
 #define ESP_NAV_PATHFINDER_H_
 
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -57,6 +58,15 @@ struct ShortestPath {
    */
   float geodesicDistance{};
 
+  /**
+   * @brief Whether the search ran out of path or search node buffer space
+   * even after growing the buffers to their limits.
+   *
+   * @note If true, @ref points leads from the start as far towards the end
+   * as the search got and @ref geodesicDistance is its length
+   */
+  bool partial{};
+
   ESP_SMART_POINTERS(ShortestPath)
 };
 
@@ -95,11 +105,51 @@ struct MultiGoalShortestPath {
    */
   float geodesicDistance{};
 
+  /**
+   * @brief Whether the path stops short of its end because no end could be
+   * reached within the path search limits, see @ref ShortestPath::partial
+   *
+   * Complete paths are always preferred, so this is only set if the search
+   * towards every reachable end ran out of buffer space.
+   */
+  bool partial{};
+
   friend class PathFinder;
 
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(MultiGoalShortestPath);
 };
 
+/**
+ * @brief Precomputed geodesic distance from any navigable point to the
+ * closest of a fixed set of goals. Built with @ref
+ * PathFinder.buildGeodesicDistanceField and queried with @ref
+ * PathFinder.geodesicDistance.
+ *
+ * Distances are propagated with Dijkstra over the navmesh polygon vertices
+ * and points sampled along polygon edges, then refined with the exact
+ * straight-line distance inside the polygon containing the query point. The
+ * result is an upper bound of the distance @ref PathFinder.findPath would
+ * return, with the error shrinking as the edge sample spacing decreases.
+ */
+class GeodesicDistanceField {
+ public:
+  GeodesicDistanceField();
+
+  /**
+   * @brief The goals the field was built for
+   */
+  const std::vector<vec3f>& getGoals() const;
+
+  /**
+   * @brief Number of graph nodes the distances are stored on
+   */
+  size_t getNumNodes() const;
+
+  friend class PathFinder;
+
+  ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(GeodesicDistanceField);
+};
+
 struct NavMeshSettings {
   //! Cell size in world units
   float cellSize{};
@@ -126,6 +176,9 @@ struct NavMeshSettings {
   float detailSampleDist{};
   //! Detail sample max error in voxel heights.
   float detailSampleMaxError{};
+  //! Tile size in voxels. If > 0, the navmesh is built as a grid of tiles in
+  //! parallel, otherwise as a single tile
+  float tileSize{};
   //! Bounds of the area to mesh
   vec3f navMeshBMin;
   vec3f navMeshBMax;
@@ -148,6 +201,7 @@ struct NavMeshSettings {
     vertsPerPoly = 6.0f;
     detailSampleDist = 6.0f;
     detailSampleMaxError = 1.0f;
+    tileSize = 0.0f;
     filterLowHangingObstacles = true;
     filterLedgeSpans = true;
     filterWalkableLowHeightSpans = true;
@@ -158,6 +212,28 @@ struct NavMeshSettings {
   ESP_SMART_POINTERS(NavMeshSettings)
 };
 
+/**
+ * @brief Constraints on the points drawn by @ref
+ * PathFinder::sampleNavigablePoints
+ */
+struct NavigablePointFilter {
+  //! Only sample from this island, see @ref PathFinder::islandId. @ref
+  //! ID_UNDEFINED samples from all islands
+  int islandId = ID_UNDEFINED;
+  //! Only sample from islands with at least this @ref
+  //! PathFinder::islandRadius
+  float minIslandRadius = 0;
+  //! Lowest allowed height (y) of a point
+  float minHeight = -std::numeric_limits<float>::infinity();
+  //! Highest allowed height (y) of a point
+  float maxHeight = std::numeric_limits<float>::infinity();
+  //! Minimum distance of a point to the closest obstacle, see @ref
+  //! PathFinder::distanceToClosestObstacle
+  float minObstacleDistance = 0;
+
+  ESP_SMART_POINTERS(NavigablePointFilter)
+};
+
 /** Loads and/or builds a navigation mesh and then performs path
  * finding and collision queries on that navmesh
  *
@@ -179,6 +255,54 @@ class PathFinder {
              const float* bmax);
   bool build(const NavMeshSettings& bs, const esp::assets::MeshData& mesh);
 
+  /**
+   * @brief Whether the navmesh can be updated tile by tile with @ref
+   * updateTilesAsync, i.e. whether it was built with @ref
+   * NavMeshSettings.tileSize > 0.
+   */
+  bool supportsTileUpdates() const;
+
+  /**
+   * @brief Starts rebuilding the navmesh tiles affected by changes to the
+   * scene geometry in a background thread.
+   *
+   * Only the tiles whose area overlaps one of @p regions are re-rasterized,
+   * using the build settings of the last tiled @ref build. Queries keep
+   * running on the current navmesh until the rebuilt tiles are swapped in by
+   * @ref applyTileUpdates. A pending update has to be applied before a new
+   * one can be started.
+   *
+   * @param mesh The complete updated source geometry. Geometry outside of the
+   * bounds of the original build is ignored.
+   * @param regions World space (min, max) boxes of the changed geometry, e.g.
+   * the old and the new bounding box of a moved object.
+   *
+   * @return False if the navmesh can't be updated tile by tile or an update
+   * is still pending.
+   */
+  bool updateTilesAsync(const esp::assets::MeshData& mesh,
+                        const std::vector<std::pair<vec3f, vec3f>>& regions);
+
+  /**
+   * @brief Whether tiles started by @ref updateTilesAsync have not been
+   * applied yet.
+   */
+  bool hasPendingTileUpdates() const;
+
+  /**
+   * @brief Swaps the tiles rebuilt by @ref updateTilesAsync into the navmesh
+   * all at once.
+   *
+   * Like a full @ref build, this invalidates paths, poly references and
+   * @ref GeodesicDistanceField instances computed on the previous navmesh.
+   *
+   * @param wait Whether to block until a running update is done. Otherwise
+   * nothing happens if it isn't done yet.
+   *
+   * @return Whether an update was applied.
+   */
+  bool applyTileUpdates(bool wait = false);
+
   /**
    * @brief Returns a random navigable point
    *
@@ -193,6 +317,36 @@ class PathFinder {
    */
   vec3f getRandomNavigablePoint(int maxTries = 10);
 
+  /**
+   * @brief Samples many navigable points at once, uniformly by area over the
+   * part of the navmesh that passes @p filter.
+   *
+   * Unlike @ref getRandomNavigablePoint, the result only depends on @p seed
+   * and the navmesh, not on the global random state or the number of
+   * threads. The first draw of every point is stratified over the navmesh
+   * area, so small batches cover the navmesh more evenly than independent
+   * draws. Islands, island radius and height band are filtered per triangle
+   * before sampling; the height band and obstacle distance are then checked
+   * per point by rejection. The obstacle distance uses the field from @ref
+   * buildObstacleDistanceField when there is one.
+   *
+   * @param[in] numPoints The number of points to sample
+   * @param[in] seed The random seed
+   * @param[in] filter Constraints on the sampled points
+   * @param[in] maxTries The number of draws per point before giving up on it
+   * @param[in] maxThreads Upper bound on the worker threads. 0 uses all
+   * hardware threads.
+   *
+   * @return @p numPoints points in random order. Points that could not be
+   * sampled within @p maxTries are `{NAN, NAN, NAN}`.
+   */
+  std::vector<vec3f> sampleNavigablePoints(
+      int numPoints,
+      uint32_t seed,
+      const NavigablePointFilter& filter = NavigablePointFilter(),
+      int maxTries = 100,
+      unsigned int maxThreads = 0);
+
   /**
    * @brief Finds the shortest path between two points on the navigation mesh
    *
@@ -220,6 +374,133 @@ class PathFinder {
    */
   bool findPath(MultiGoalShortestPath& path);
 
+  /**
+   * @brief Batched version of @ref findPath(ShortestPath&). Queries are
+   * spread over a pool of worker threads, each with its own navmesh query
+   * object against the shared navmesh.
+   *
+   * @param[inout] paths The @ref ShortestPath structures to solve. Each one
+   * is populated exactly as @ref findPath(ShortestPath&) would.
+   * @param[in] maxThreads The maximum number of worker threads. 0 uses all
+   * available hardware threads.
+   *
+   * @return The number of paths for which a path exists
+   */
+  int findPaths(std::vector<ShortestPath>& paths, unsigned int maxThreads = 0);
+
+  /**
+   * @brief Sets the limits the path buffers and search node pools of path
+   * queries grow up to.
+   *
+   * Searches start with small buffers and double them whenever they run out
+   * of space. Searches still running out at the limits return partial paths,
+   * see @ref ShortestPath::partial.
+   *
+   * @param[in] maxPathPolys The maximum number of polygons in a path, at
+   * most 65536
+   * @param[in] maxSearchNodes The maximum number of nodes a search visits, at
+   * most 65535
+   */
+  void setPathSearchLimits(int maxPathPolys = 65536,
+                           int maxSearchNodes = 65535);
+
+  /**
+   * @brief Computes the geodesic distance between each pair `(starts[i],
+   * ends[i])` in parallel. See @ref findPaths.
+   *
+   * @param[in] starts The starting points
+   * @param[in] ends The end points, must be the same size as @ref starts
+   * @param[in] maxThreads The maximum number of worker threads. 0 uses all
+   * available hardware threads.
+   *
+   * @return The geodesic distance for each pair. Will be inf for pairs where
+   * no path exists
+   */
+  std::vector<float> geodesicDistances(const std::vector<vec3f>& starts,
+                                       const std::vector<vec3f>& ends,
+                                       unsigned int maxThreads = 0);
+
+  /**
+   * @brief Precomputes the geodesic distance field to a fixed set of goals.
+   *
+   * @param[in] goals The goal points. Goals that can't be snapped to the
+   * navmesh are ignored.
+   * @param[in] edgeSampleSpacing The spacing of the extra graph nodes placed
+   * along polygon edges, in world units. Smaller values give more accurate
+   * distances at the cost of build time and memory. 0 uses polygon vertices
+   * only.
+   *
+   * @return The distance field or nullptr if no navmesh is loaded
+   */
+  GeodesicDistanceField::ptr buildGeodesicDistanceField(
+      const std::vector<vec3f>& goals,
+      float edgeSampleSpacing = 0.5);
+
+  /**
+   * @brief Looks up the geodesic distance from @ref pt to the closest goal of
+   * @ref field. Costs a single polygon lookup plus a scan of that polygon's
+   * nodes.
+   *
+   * @return The geodesic distance. Will be inf if no goal is reachable from
+   * @ref pt
+   */
+  float geodesicDistance(const GeodesicDistanceField& field,
+                         const vec3f& pt) const;
+
+  /**
+   * @brief Builds one distance field per goal in parallel, each worker
+   * thread using its own navmesh query. See @ref buildGeodesicDistanceField.
+   *
+   * @param[in] goals The goal of each field
+   * @param[in] edgeSampleSpacing See @ref buildGeodesicDistanceField
+   * @param[in] maxThreads The maximum number of worker threads. 0 uses all
+   * available hardware threads.
+   *
+   * @return The distance field for each goal, all nullptr if no navmesh is
+   * loaded
+   */
+  std::vector<GeodesicDistanceField::ptr> buildGeodesicDistanceFields(
+      const std::vector<vec3f>& goals,
+      float edgeSampleSpacing = 0.5,
+      unsigned int maxThreads = 0);
+
+  /**
+   * @brief Looks up the geodesic distance from each `pts[i]` to the goals of
+   * `fields[i]` in parallel, each worker thread using its own navmesh query.
+   * See @ref geodesicDistance.
+   *
+   * @param[in] fields The distance fields, must be the same size as @ref pts
+   * @param[in] pts The query points
+   * @param[in] maxThreads The maximum number of worker threads. 0 uses all
+   * available hardware threads.
+   *
+   * @return The geodesic distance for each point. Will be inf for points from
+   * which no goal is reachable
+   */
+  std::vector<float> geodesicDistances(
+      const std::vector<const GeodesicDistanceField*>& fields,
+      const std::vector<vec3f>& pts,
+      unsigned int maxThreads = 0);
+
+  /**
+   * @brief Saves a distance field so that it can be reused with the same
+   * navmesh. Conventionally stored next to the ``.navmesh`` file with
+   * extension ``.gdf``.
+   *
+   * @return Whether or not the field was successfully saved
+   */
+  bool saveGeodesicDistanceField(const GeodesicDistanceField& field,
+                                 const std::string& path) const;
+
+  /**
+   * @brief Loads a distance field saved by @ref saveGeodesicDistanceField.
+   *
+   * @return The distance field or nullptr if the file can't be read or was
+   * built for a different navmesh
+   */
+  GeodesicDistanceField::ptr loadGeodesicDistanceField(
+      const std::string& path) const;
+
   /**
    * @brief Attempts to move from @ref start to @ref end and returns the
    * navigable point closest to @ref end that is feasibly reachable from @ref
@@ -256,6 +537,9 @@ class PathFinder {
    * @param[in] path The saved navigation mesh file, generally has extension
    * ``.navmesh``
    *
+   * Islands and navigable area are read from the file when it has them,
+   * otherwise they are recomputed as for files of older versions.
+   *
    * @return Whether or not the navmesh was successfully loaded
    */
   bool loadNavMesh(const std::string& path);
@@ -263,6 +547,9 @@ class PathFinder {
   /**
    * @brief Saves a navigation mesh to later be loaded by @ref loadNavMesh
    *
+   * The file also stores the islands and navigable area, so loading it
+   * doesn't need to recompute them.
+   *
    * @param[in] path The name of the file, generally has extension ``.navmesh``
    *
    * @return Whether or not the navmesh was successfully saved
@@ -292,6 +579,17 @@ class PathFinder {
    */
   float islandRadius(const vec3f& pt) const;
 
+  /**
+   * @brief Returns the id of the connected component @p pt belongs to.
+   *
+   * Ids are only stable for a given navmesh.
+   *
+   * @param[in] pt The point to specify the connected component
+   *
+   * @return The island id, or @ref ID_UNDEFINED if @p pt is not on the navmesh
+   */
+  int islandId(const vec3f& pt) const;
+
   /**
    * @brief Finds the distance to the closest non-navigable location
    *
@@ -327,6 +625,79 @@ class PathFinder {
    */
   bool isNavigable(const vec3f& pt, const float maxYDelta = 0.5) const;
 
+  /**
+   * @brief Precomputes the distance to the closest obstacle on a 2.5D grid,
+   * so that @ref distanceToClosestObstacle and @ref
+   * distancesToClosestObstacle become bilinear lookups.
+   *
+   * Distances are computed once from the navmesh boundary edges at roughly
+   * the same height as each walkable surface sample. Points closer than
+   * @p cellSize to a node whose distance reaches @p maxDistance, or whose
+   * surrounding nodes have no matching sample, fall back to the exact
+   * search. The field is dropped whenever the navmesh changes.
+   *
+   * @param cellSize Spacing of the grid nodes in world units
+   * @param maxDistance Distance up to which the field is precomputed
+   *
+   * @return Whether the field could be built
+   */
+  bool buildObstacleDistanceField(float cellSize = 0.05,
+                                  float maxDistance = 1.0);
+
+  /**
+   * @brief Whether distance to obstacle queries use a precomputed field.
+   */
+  bool hasObstacleDistanceField() const;
+
+  /**
+   * @brief Drops the precomputed obstacle distance field, going back to exact
+   * queries.
+   */
+  void clearObstacleDistanceField();
+
+  /**
+   * @brief Saves the precomputed obstacle distance field, e.g. next to the
+   * navmesh as `<scene>.navmesh.odf`.
+   */
+  bool saveObstacleDistanceField(const std::string& path) const;
+
+  /**
+   * @brief Loads an obstacle distance field saved by @ref
+   * saveObstacleDistanceField. Fails if it was built for a different navmesh.
+   */
+  bool loadObstacleDistanceField(const std::string& path);
+
+  /**
+   * @brief Batched @ref snapPoint, run in parallel.
+   *
+   * Points standing on the navmesh are resolved with a uniform grid over the
+   * navmesh triangles instead of a nearest polygon search. All other points
+   * fall back to the same search as @ref snapPoint.
+   *
+   * @param pts The points to snap
+   * @param maxThreads Maximum number of worker threads, 0 for one per core
+   *
+   * @return The snapped points, `{NAN, NAN, NAN}` where snapping failed
+   */
+  std::vector<vec3f> snapPoints(const std::vector<vec3f>& pts,
+                                unsigned int maxThreads = 0);
+
+  /**
+   * @brief Batched @ref isNavigable, run in parallel using the same spatial
+   * index as @ref snapPoints.
+   */
+  std::vector<bool> isNavigableBatch(const std::vector<vec3f>& pts,
+                                     float maxYDelta = 0.5,
+                                     unsigned int maxThreads = 0);
+
+  /**
+   * @brief Batched @ref distanceToClosestObstacle, run in parallel using the
+   * same spatial index as @ref snapPoints.
+   */
+  std::vector<float> distancesToClosestObstacle(const std::vector<vec3f>& pts,
+                                                float maxSearchRadius = 2.0,
+                                                unsigned int maxThreads = 0);
+
   /**
    * Compute and return the total area of all NavMesh polygons
    */
@@ -337,10 +708,28 @@ class PathFinder {
    */
   std::pair<vec3f, vec3f> bounds() const;
 
+  /**
+   * @brief Returns a top down map of navigability at the given height.
+   *
+   * Pixel (h, w) samples the point (bounds().first.x() + w * metersPerPixel,
+   * height, bounds().first.z() + h * metersPerPixel) and is true if a navmesh
+   * triangle covers it within 0.5 of height, i.e. if @ref isNavigable would
+   * hold there. The map is rasterized from @ref getNavMeshData. The most
+   * recently used maps are cached; loading or recomputing the navmesh clears
+   * the cache.
+   */
   Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> getTopDownView(
       const float metersPerPixel,
       const float height);
 
+  /**
+   * @brief Same as @ref getTopDownView for several heights, e.g. one per
+   * floor, rasterized in a single pass over the navmesh.
+   */
+  std::vector<Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>>
+  getTopDownViews(const float metersPerPixel,
+                  const std::vector<float>& heights);
+
   /**
    * @brief Returns a MeshData object containing triangulated NavMesh polys. The
    * object is generated and stored if this is the first query.
@@ -27,6 +27,17 @@ constexpr struct {
 } MultiGoalBenchMarkData[]{{"path to closest of 1000", false},
                            {"cached path to closest of 1000", true}};
 
+constexpr struct {
+  const char* name;
+  bool batched;
+} BatchBenchmarkData[]{{"serial", false}, {"batched", true}};
+
+constexpr struct {
+  const char* name;
+  bool storedIslands;
+} LoadBenchmarkData[]{{"recomputed islands", false},
+                      {"stored islands", true}};
+
 struct PathFinderTest : Cr::TestSuite::Tester {
   explicit PathFinderTest();
 
@@ -36,6 +47,10 @@ struct PathFinderTest : Cr::TestSuite::Tester {
 
   void benchmarkSingleGoal();
   void benchmarkMultiGoal();
+  void benchmarkSampleNavigablePoints();
+  void benchmarkGeodesicDistances();
+  void benchmarkPointQueries();
+  void benchmarkLoadNavMesh();
 
   void testCaching();
 };
@@ -47,6 +62,12 @@ PathFinderTest::PathFinderTest() {
   addBenchmarks({&PathFinderTest::benchmarkSingleGoal}, 1000);
   addInstancedBenchmarks({&PathFinderTest::benchmarkMultiGoal}, 100,
                          Cr::Containers::arraySize(MultiGoalBenchMarkData));
+  addInstancedBenchmarks({&PathFinderTest::benchmarkSampleNavigablePoints,
+                          &PathFinderTest::benchmarkGeodesicDistances,
+                          &PathFinderTest::benchmarkPointQueries},
+                         10, Cr::Containers::arraySize(BatchBenchmarkData));
+  addInstancedBenchmarks({&PathFinderTest::benchmarkLoadNavMesh}, 10,
+                         Cr::Containers::arraySize(LoadBenchmarkData));
 }
 
 void PathFinderTest::bounds() {
@@ -202,6 +223,125 @@ void PathFinderTest::benchmarkMultiGoal() {
   CORRADE_VERIFY(status);
 }
 
+void PathFinderTest::benchmarkSampleNavigablePoints() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  auto&& data = BatchBenchmarkData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  constexpr int numPoints = 100000;
+  std::vector<esp::vec3f> points;
+  CORRADE_BENCHMARK(1) {
+    if (data.batched) {
+      points = pathFinder.sampleNavigablePoints(numPoints, 7);
+    } else {
+      points.clear();
+      for (int i = 0; i < numPoints; ++i) {
+        points.emplace_back(pathFinder.getRandomNavigablePoint());
+      }
+    }
+  };
+  CORRADE_COMPARE(points.size(), numPoints);
+}
+
+void PathFinderTest::benchmarkGeodesicDistances() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  auto&& data = BatchBenchmarkData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  constexpr int numQueries = 10000;
+  std::vector<esp::vec3f> starts, ends;
+  for (int i = 0; i < numQueries; ++i) {
+    starts.emplace_back(pathFinder.getRandomNavigablePoint());
+    ends.emplace_back(pathFinder.getRandomNavigablePoint());
+  }
+
+  std::vector<float> distances;
+  CORRADE_BENCHMARK(1) {
+    if (data.batched) {
+      distances = pathFinder.geodesicDistances(starts, ends);
+    } else {
+      distances.clear();
+      for (int i = 0; i < numQueries; ++i) {
+        esp::nav::ShortestPath path;
+        path.requestedStart = starts[i];
+        path.requestedEnd = ends[i];
+        pathFinder.findPath(path);
+        distances.push_back(path.geodesicDistance);
+      }
+    }
+  };
+  CORRADE_COMPARE(distances.size(), numQueries);
+}
+
+void PathFinderTest::benchmarkPointQueries() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  auto&& data = BatchBenchmarkData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  // Points slightly above the navmesh, like sampled episodes
+  constexpr int numQueries = 100000;
+  std::vector<esp::vec3f> points;
+  for (int i = 0; i < numQueries; ++i) {
+    points.emplace_back(pathFinder.getRandomNavigablePoint() +
+                        esp::vec3f(0, 0.1, 0));
+  }
+
+  std::vector<esp::vec3f> snapped;
+  std::vector<bool> navigable;
+  CORRADE_BENCHMARK(1) {
+    if (data.batched) {
+      snapped = pathFinder.snapPoints(points);
+      navigable = pathFinder.isNavigableBatch(points);
+    } else {
+      snapped.clear();
+      navigable.clear();
+      for (const esp::vec3f& point : points) {
+        snapped.emplace_back(pathFinder.snapPoint(point));
+        navigable.push_back(pathFinder.isNavigable(point));
+      }
+    }
+  };
+  CORRADE_COMPARE(snapped.size(), numQueries);
+  CORRADE_COMPARE(navigable.size(), numQueries);
+}
+
+void PathFinderTest::benchmarkLoadNavMesh() {
+  auto&& data = LoadBenchmarkData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  // Files without the island section recompute it on load
+  std::string filename = skokloster;
+  if (data.storedIslands) {
+    esp::nav::PathFinder pathFinder;
+    CORRADE_VERIFY(pathFinder.loadNavMesh(skokloster));
+    filename = Cr::Utility::Directory::join(
+        Cr::Utility::Directory::tmp(), "pathfinder_test_islands.navmesh");
+    CORRADE_VERIFY(pathFinder.saveNavMesh(filename));
+  }
+
+  bool loaded = false;
+  CORRADE_BENCHMARK(1) {
+    esp::nav::PathFinder pathFinder;
+    loaded = pathFinder.loadNavMesh(filename);
+  };
+  CORRADE_VERIFY(loaded);
+
+  if (data.storedIslands) {
+    Cr::Utility::Directory::rm(filename);
+  }
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(PathFinderTest)
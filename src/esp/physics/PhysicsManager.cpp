@@ -4,6 +4,7 @@
 
 #include "PhysicsManager.h"
 #include "esp/assets/CollisionMeshData.h"
+#include "esp/core/Profiler.h"
 
 #include <Magnum/Math/Range.h>
 
@@ -199,6 +200,7 @@ Magnum::Vector3 PhysicsManager::getGravity() const {
 }
 
 void PhysicsManager::stepPhysics(double dt) {
+  ESP_PROFILE_SCOPE("PhysicsManager::stepPhysics");
   // We don't step uninitialized physics sim...
   if (!initialized_) {
     return;
@@ -557,5 +559,34 @@ void PhysicsManager::setSemanticId(const int physObjectID,
   existingObjects_.at(physObjectID)->setSemanticId(semanticId);
 }
 
+void RaycastBatchResults::reset(size_t numRays) {
+  hits.assign(numRays, 0);
+  objectIds.assign(numRays, -1);
+  points.assign(numRays, Magnum::Vector3{});
+  normals.assign(numRays, Magnum::Vector3{});
+  rayDistances.assign(numRays, 0.0);
+}
+
+void PhysicsManager::castRays(
+    Corrade::Containers::ArrayView<const esp::geo::Ray> rays,
+    RaycastBatchResults& results,
+    double maxDistance,
+    CORRADE_UNUSED RaycastMode mode,
+    CORRADE_UNUSED unsigned int maxThreads) {
+  results.reset(rays.size());
+  for (size_t i = 0; i < rays.size(); ++i) {
+    RaycastResults rayResults = castRay(rays[i], maxDistance);
+    if (!rayResults.hasHits()) {
+      continue;
+    }
+    const RayHitInfo& hit = rayResults.hits.front();
+    results.hits[i] = 1;
+    results.objectIds[i] = hit.objectId;
+    results.points[i] = hit.point;
+    results.normals[i] = hit.normal;
+    results.rayDistances[i] = hit.rayDistance;
+  }
+}
+
 }  // namespace physics
 }  // namespace esp
@@ -15,6 +15,8 @@
 #include <string>
 #include <vector>
 
+#include <Corrade/Containers/ArrayView.h>
+
 /* Bullet Physics Integration */
 
 #include "RigidObject.h"
@@ -65,6 +67,45 @@ struct RaycastResults {
   ESP_SMART_POINTERS(RaycastResults)
 };
 
+//! Which hit of a ray @ref PhysicsManager::castRays reports.
+enum class RaycastMode {
+  //! The hit closest to the ray origin.
+  Closest,
+  //! Any hit. The search stops at the first hit found, which is cheaper but
+  //! not necessarily the closest one. Enough for visibility checks.
+  Any,
+};
+
+/**
+ * @brief Holds the hits of a batch of rays cast with @ref
+ * PhysicsManager::castRays, one entry per ray in every array.
+ *
+ * Reusing the same results for batches of the same size casts them without
+ * allocating. Entries of rays without a hit keep an object id of -1 and zero
+ * points, normals and distances.
+ */
+struct RaycastBatchResults {
+  //! The number of rays.
+  size_t size() const { return hits.size(); }
+
+  //! Sets the number of rays and clears the hits of all of them.
+  void reset(size_t numRays);
+
+  //! 1 if the ray hit something, 0 otherwise.
+  std::vector<Magnum::UnsignedByte> hits;
+  //! The id of the object hit by the ray. Stage hits are -1.
+  std::vector<int> objectIds;
+  //! The impact point in world space.
+  std::vector<Magnum::Vector3> points;
+  //! The collision object normal at the point of impact.
+  std::vector<Magnum::Vector3> normals;
+  //! Distance along the ray direction from the ray origin (in units of ray
+  //! length).
+  std::vector<double> rayDistances;
+
+  ESP_SMART_POINTERS(RaycastBatchResults)
+};
+
 // TODO: repurpose to manage multiple physical worlds. Currently represents
 // exactly one world.
 
@@ -939,6 +980,29 @@ class PhysicsManager {
     return results;
   }
 
+  /**
+   * @brief Cast a batch of rays into the collision world and keep one hit per
+   * ray.
+   *
+   * Implemented here with @ref castRay, one ray at a time.
+   *
+   * @param rays The rays to cast. Need not be unit length, but returned hit
+   * distances will be in units of ray length.
+   * @param[out] results Reset to the size of @p rays and filled with the hit
+   * of every ray.
+   * @param maxDistance The maximum distance along the ray direction to search.
+   * In units of ray length.
+   * @param mode Whether to report the closest hit of a ray or any hit.
+   * @param maxThreads Upper bound on the number of threads the rays are split
+   * across. 0 means std::thread::hardware_concurrency().
+   */
+  virtual void castRays(
+      Corrade::Containers::ArrayView<const esp::geo::Ray> rays,
+      RaycastBatchResults& results,
+      double maxDistance = 100.0,
+      RaycastMode mode = RaycastMode::Closest,
+      unsigned int maxThreads = 0);
+
   virtual int getNumActiveContactPoints() { return -1; }
 
  protected:
@@ -8,10 +8,104 @@
 #include "BulletPhysicsManager.h"
 #include "BulletRigidObject.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/Parallel.h"
+#include "esp/core/Profiler.h"
+
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 
 namespace esp {
 namespace physics {
 
+namespace {
+
+// Rays per work item of BulletPhysicsManager::castRays
+constexpr size_t RaycastChunkSize = 64;
+
+// Keeps the closest hit, or the first one found, making Bullet skip
+// everything after it the way it does once a hit at fraction 0 is found
+struct SingleHitRayResultCallback
+    : public btCollisionWorld::ClosestRayResultCallback {
+  SingleHitRayResultCallback(const btVector3& from,
+                             const btVector3& to,
+                             bool stopAtFirstHit)
+      : ClosestRayResultCallback(from, to), stopAtFirstHit(stopAtFirstHit) {}
+
+  btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult,
+                           bool normalInWorldSpace) override {
+    hitFraction = ClosestRayResultCallback::addSingleResult(
+        rayResult, normalInWorldSpace);
+    if (stopAtFirstHit) {
+      m_closestHitFraction = 0;
+    }
+    return m_closestHitFraction;
+  }
+
+  const bool stopAtFirstHit;
+  btScalar hitFraction = 1;
+};
+
+// Tests a ray against the collision objects whose broadphase bounds it
+// crosses, as btCollisionWorld::rayTest() does, but with a caller-owned
+// traversal stack: btDbvtBroadphase::rayTest() shares a single one, unless
+// Bullet is built thread safe.
+struct BroadphaseRayTester : public btDbvt::ICollide {
+  BroadphaseRayTester(const btVector3& from,
+                      const btVector3& to,
+                      btCollisionWorld::RayResultCallback& callback)
+      : callback_(callback) {
+    fromTransform_.setIdentity();
+    fromTransform_.setOrigin(from);
+    toTransform_.setIdentity();
+    toTransform_.setOrigin(to);
+  }
+
+  void Process(const btDbvtNode* leaf) {
+    if (callback_.m_closestHitFraction == btScalar(0)) {
+      return;
+    }
+    auto* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+    auto* object = static_cast<btCollisionObject*>(proxy->m_clientObject);
+    if (callback_.needsCollision(object->getBroadphaseHandle())) {
+      btCollisionWorld::rayTestSingle(
+          fromTransform_, toTransform_, object, object->getCollisionShape(),
+          object->getWorldTransform(), callback_);
+    }
+  }
+
+  btCollisionWorld::RayResultCallback& callback_;
+  btTransform fromTransform_;
+  btTransform toTransform_;
+};
+
+void rayTestBroadphase(const btDbvtBroadphase& broadphase,
+                       const btVector3& from,
+                       const btVector3& to,
+                       btCollisionWorld::RayResultCallback& callback,
+                       btAlignedObjectArray<const btDbvtNode*>& stack) {
+  const btVector3 ray = to - from;
+  const btVector3 direction = ray.normalized();
+  btVector3 directionInverse;
+  unsigned int signs[3];
+  for (int i = 0; i < 3; ++i) {
+    directionInverse[i] = direction[i] == btScalar(0)
+                              ? btScalar(BT_LARGE_FLOAT)
+                              : btScalar(1) / direction[i];
+    signs[i] = directionInverse[i] < 0;
+  }
+  const btScalar lambdaMax = direction.dot(ray);
+  const btVector3 aabbMin(0, 0, 0);
+  const btVector3 aabbMax(0, 0, 0);
+
+  BroadphaseRayTester tester(from, to, callback);
+  // the dynamic and the static set, as btDbvtBroadphase::rayTest()
+  for (const btDbvt& set : broadphase.m_sets) {
+    set.rayTestInternal(set.m_root, from, to, directionInverse, signs,
+                        lambdaMax, aabbMin, aabbMax, stack, tester);
+  }
+}
+
+}  // namespace
+
 BulletPhysicsManager::~BulletPhysicsManager() {
   LOG(INFO) << "Deconstructing BulletPhysicsManager";
 
@@ -117,6 +211,7 @@ Magnum::Vector3 BulletPhysicsManager::getGravity() const {
 }
 
 void BulletPhysicsManager::stepPhysics(double dt) {
+  ESP_PROFILE_SCOPE("BulletPhysicsManager::stepPhysics");
   // We don't step uninitialized physics sim...
   if (!initialized_) {
     return;
@@ -259,6 +354,63 @@ RaycastResults BulletPhysicsManager::castRay(const esp::geo::Ray& ray,
   return results;
 }
 
+void BulletPhysicsManager::castRays(
+    Corrade::Containers::ArrayView<const esp::geo::Ray> rays,
+    RaycastBatchResults& results,
+    double maxDistance,
+    RaycastMode mode,
+    unsigned int maxThreads) {
+  ESP_PROFILE_SCOPE("BulletPhysicsManager::castRays");
+  results.reset(rays.size());
+
+  const size_t numChunks =
+      (rays.size() + RaycastChunkSize - 1) / RaycastChunkSize;
+  const unsigned int numWorkers =
+      core::numWorkerThreads(numChunks, maxThreads);
+  std::vector<btAlignedObjectArray<const btDbvtNode*>> stacks(numWorkers);
+  std::atomic<size_t> numZeroLength{0};
+
+  core::parallelFor(
+      numChunks, numWorkers, [&](unsigned int worker, size_t chunk) {
+        const size_t begin = chunk * RaycastChunkSize;
+        const size_t end = std::min(begin + RaycastChunkSize, rays.size());
+        for (size_t i = begin; i < end; ++i) {
+          const esp::geo::Ray& ray = rays[i];
+          const double rayLength = ray.direction.length();
+          if (rayLength == 0) {
+            ++numZeroLength;
+            continue;
+          }
+          const btVector3 from(ray.origin);
+          const btVector3 to(ray.origin + ray.direction * maxDistance);
+
+          SingleHitRayResultCallback callback(from, to,
+                                              mode == RaycastMode::Any);
+          rayTestBroadphase(bBroadphase_, from, to, callback, stacks[worker]);
+          if (!callback.hasHit()) {
+            continue;
+          }
+          results.hits[i] = 1;
+          results.points[i] = Magnum::Vector3{callback.m_hitPointWorld};
+          results.normals[i] = Magnum::Vector3{callback.m_hitNormalWorld};
+          results.rayDistances[i] =
+              (callback.hitFraction * maxDistance) / rayLength;
+          // default to -1 for "scene collision" if we don't know which
+          // object was involved
+          auto found = collisionObjToObjIds_->find(callback.m_collisionObject);
+          if (found != collisionObjToObjIds_->end()) {
+            results.objectIds[i] = found->second;
+          }
+        }
+      });
+
+  if (numZeroLength) {
+    LOG(ERROR) << "BulletPhysicsManager::castRays : Cannot cast rays with "
+                  "zero length, skipped "
+               << numZeroLength << " of them.";
+  }
+}
+
 int BulletPhysicsManager::getNumActiveContactPoints() {
   int pointCount = 0;
   auto* dispatcher = bWorld_->getDispatcher();
@@ -184,6 +184,30 @@ class BulletPhysicsManager : public PhysicsManager {
   RaycastResults castRay(const esp::geo::Ray& ray,
                          double maxDistance = 100.0) override;
 
+  /**
+   * @brief Cast a batch of rays into the collision world and keep one hit per
+   * ray.
+   *
+   * Unlike @ref castRay, only the reported hit of each ray is kept, so a ray
+   * costs no allocation and no sort. The rays are split across threads, each
+   * walking the broadphase with its own traversal stack.
+   *
+   * @param rays The rays to cast. Need not be unit length, but returned hit
+   * distances will be in units of ray length.
+   * @param[out] results Reset to the size of @p rays and filled with the hit
+   * of every ray.
+   * @param maxDistance The maximum distance along the ray direction to search.
+   * In units of ray length.
+   * @param mode Whether to report the closest hit of a ray or any hit.
+   * @param maxThreads Upper bound on the number of threads the rays are split
+   * across. 0 means std::thread::hardware_concurrency().
+   */
+  void castRays(Corrade::Containers::ArrayView<const esp::geo::Ray> rays,
+                RaycastBatchResults& results,
+                double maxDistance = 100.0,
+                RaycastMode mode = RaycastMode::Closest,
+                unsigned int maxThreads = 0) override;
+
   // The number of contact points that were active during the last step. An
   // object resting on another object will involve several active contact
   // points. Once both objects are asleep, the contact points are inactive. This
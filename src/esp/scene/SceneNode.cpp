@@ -71,6 +71,11 @@ Mn::Vector3 SceneNode::absoluteTranslation() {
   return absoluteTransformation_.translation();
 }
 
+const Mn::Matrix4& SceneNode::getAbsoluteTransformation() {
+  setClean();
+  return absoluteTransformation_;
+}
+
 const Mn::Range3D& SceneNode::getAbsoluteAABB() const {
   if (aabb_)
     return *aabb_;
@@ -74,6 +74,10 @@ class SceneNode : public MagnumObject,
 
   Magnum::Vector3 absoluteTranslation();
 
+  //! Returns the absolute transformation, recomputing it only if the node or
+  //! one of its ancestors moved since it was last computed
+  const Magnum::Matrix4& getAbsoluteTransformation();
+
   //! recursively compute the cumulative bounding box of the full scene graph
   //! tree for which this node is the root
   const Magnum::Range3D& computeCumulativeBB();
@@ -8,6 +8,7 @@
 #include <cmath>
 
 #include "CameraSensor.h"
+#include "esp/core/Profiler.h"
 #include "esp/gfx/DepthUnprojection.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/sim/Simulator.h"
@@ -27,10 +28,20 @@ void CameraSensorSpec::sanityCheck() {
                  "CameraSensorSpec::sanityCheck(): sensorSpec does not have "
                  "SensorSubType "
                  "Pinhole or Orthographic", );
+  CORRADE_ASSERT(depthProcessing == gfx::DepthProcessing{} ||
+                     (sensorType == SensorType::Depth && !gpu2gpuTransfer),
+                 "CameraSensorSpec::sanityCheck(): depth processing needs a "
+                 "depth sensor without gpu2gpu transfer", );
+  CORRADE_ASSERT(!depthProcessing.normalize ||
+                     (depthProcessing.maxDepth > depthProcessing.minDepth &&
+                      depthProcessing.maxDepth != Mn::Constants::inf()),
+                 "CameraSensorSpec::sanityCheck(): normalized depth needs a "
+                 "finite depth range", );
 }
 
 bool CameraSensorSpec::operator==(const CameraSensorSpec& a) const {
   return VisualSensorSpec::operator==(a) && channels == a.channels &&
+         depthProcessing == a.depthProcessing &&
          observationSpace == a.observationSpace;
 }
 
@@ -106,7 +117,17 @@ bool CameraSensor::getObservationSpace(ObservationSpace& space) {
   if (cameraSensorSpec_->sensorType == SensorType::Semantic) {
     space.dataType = core::DataType::DT_UINT32;
   } else if (cameraSensorSpec_->sensorType == SensorType::Depth) {
-    space.dataType = core::DataType::DT_FLOAT;
+    switch (cameraSensorSpec_->depthProcessing.format) {
+      case gfx::DepthFormat::Float:
+        space.dataType = core::DataType::DT_FLOAT;
+        break;
+      case gfx::DepthFormat::Half:
+        space.dataType = core::DataType::DT_FLOAT16;
+        break;
+      case gfx::DepthFormat::UnsignedShort:
+        space.dataType = core::DataType::DT_UINT16;
+        break;
+    }
   }
   return true;
 }
@@ -128,62 +149,158 @@ bool CameraSensor::getObservation(sim::Simulator& sim, Observation& obs) {
   return true;
 }
 
-bool CameraSensor::drawObservation(sim::Simulator& sim) {
-  if (!hasRenderTarget()) {
-    return false;
+void CameraSensor::updateRenderTarget(sim::Simulator& sim) {
+  // the resolution changed since the target was bound, swap it for one of
+  // the new size; the old one goes back to the renderer's pool
+  if (renderTarget().framebufferSize() != framebufferSize()) {
+    sim.getRenderer()->bindRenderTarget(*this);
   }
+}
+
+bool CameraSensor::drawObservation(sim::Simulator& sim) {
+  ESP_PROFILE_SCOPE("CameraSensor::drawObservation");
+  return drawObservations(sim, {this}) > 0;
+}
 
-  renderTarget().renderEnter();
+size_t CameraSensor::drawObservations(
+    sim::Simulator& sim,
+    const std::vector<CameraSensor*>& sensors) {
+  ESP_PROFILE_SCOPE("CameraSensor::drawObservations");
+  const bool separateSemanticScene =
+      &sim.getActiveSemanticSceneGraph() != &sim.getActiveSceneGraph();
+
+  // Sensors drawing the active scene graph, and the semantic sensors that
+  // draw a separate semantic scene graph before an objects only pass
+  std::vector<VisualSensor*> sceneSensors;
+  std::vector<VisualSensor*> semanticSensors;
+  for (CameraSensor* sensor : sensors) {
+    if (!sensor->hasRenderTarget()) {
+      continue;
+    }
+    sensor->updateRenderTarget(sim);
+    sensor->renderTarget().renderEnter();
+    if (separateSemanticScene &&
+        sensor->cameraSensorSpec_->sensorType == SensorType::Semantic) {
+      semanticSensors.push_back(sensor);
+    } else {
+      sceneSensors.push_back(sensor);
+    }
+  }
 
   gfx::RenderCamera::Flags flags;
   if (sim.isFrustumCullingEnabled())
     flags |= gfx::RenderCamera::Flag::FrustumCulling;
 
   gfx::Renderer::ptr renderer = sim.getRenderer();
-  if (cameraSensorSpec_->sensorType == SensorType::Semantic) {
+  if (!sceneSensors.empty()) {
+    renderer->draw(sceneSensors, sim.getActiveSceneGraph(), flags);
+  }
+  if (!semanticSensors.empty()) {
     // TODO: check sim has semantic scene graph
-    renderer->draw(*this, sim.getActiveSemanticSceneGraph(), flags);
-    if (&sim.getActiveSemanticSceneGraph() != &sim.getActiveSceneGraph()) {
-      flags |= gfx::RenderCamera::Flag::ObjectsOnly;
-      renderer->draw(*this, sim.getActiveSceneGraph(), flags);
-    }
-  } else {
-    // SensorType is Depth or any other type
-    renderer->draw(*this, sim.getActiveSceneGraph(), flags);
+    renderer->draw(semanticSensors, sim.getActiveSemanticSceneGraph(), flags);
+    renderer->draw(semanticSensors, sim.getActiveSceneGraph(),
+                   flags | gfx::RenderCamera::Flag::ObjectsOnly);
   }
 
-  renderTarget().renderExit();
+  for (VisualSensor* sensor : sceneSensors) {
+    sensor->renderTarget().renderExit();
+  }
+  for (VisualSensor* sensor : semanticSensors) {
+    sensor->renderTarget().renderExit();
+  }
+  return sceneSensors.size() + semanticSensors.size();
+}
 
-  return true;
+void CameraSensor::prepareObservationBuffer(Observation& obs) {
+  // Make sure we have memory, of the current resolution and format. Buffers
+  // of the old pool still held by observations stay valid.
+  ObservationSpace space;
+  getObservationSpace(space);
+  if (bufferPool_ == nullptr || bufferPool_->shape() != space.shape ||
+      bufferPool_->dataType() != space.dataType) {
+    bufferPool_ = core::BufferPool::create(space.shape, space.dataType);
+  }
+  // a buffer no earlier observation still holds, so those stay valid
+  obs.buffer = bufferPool_->acquire();
 }
 
-void CameraSensor::readObservation(Observation& obs) {
-  // Make sure we have memory
-  if (buffer_ == nullptr) {
-    // TODO: check if our sensor was resized and resize our buffer if needed
-    ObservationSpace space;
-    getObservationSpace(space);
-    buffer_ = core::Buffer::create(space.shape, space.dataType);
+Magnum::MutableImageView2D CameraSensor::observationView(
+    Corrade::Containers::ArrayView<void> data) {
+  Magnum::PixelFormat format = Magnum::PixelFormat::RGBA8Unorm;
+  if (cameraSensorSpec_->sensorType == SensorType::Semantic) {
+    format = Magnum::PixelFormat::R32UI;
+  } else if (cameraSensorSpec_->sensorType == SensorType::Depth) {
+    switch (cameraSensorSpec_->depthProcessing.format) {
+      case gfx::DepthFormat::Float:
+        format = Magnum::PixelFormat::R32F;
+        break;
+      case gfx::DepthFormat::Half:
+        format = Magnum::PixelFormat::R16F;
+        break;
+      case gfx::DepthFormat::UnsignedShort:
+        format = Magnum::PixelFormat::R16UI;
+        break;
+    }
   }
-  obs.buffer = buffer_;
+  return Magnum::MutableImageView2D{format, renderTarget().framebufferSize(),
+                                    data};
+}
+
+void CameraSensor::readObservation(Observation& obs) {
+  ESP_PROFILE_SCOPE("CameraSensor::readObservation");
+  prepareObservationBuffer(obs);
 
   // TODO: have different classes for the different types of sensors
   // TODO: do we need to flip axis?
   if (cameraSensorSpec_->sensorType == SensorType::Semantic) {
-    renderTarget().readFrameObjectId(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::R32UI, renderTarget().framebufferSize(),
-        obs.buffer->data});
+    renderTarget().readFrameObjectId(observationView(obs.buffer->data));
   } else if (cameraSensorSpec_->sensorType == SensorType::Depth) {
-    renderTarget().readFrameDepth(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::R32F, renderTarget().framebufferSize(),
-        obs.buffer->data});
+    renderTarget().readFrameDepth(observationView(obs.buffer->data));
   } else {
-    renderTarget().readFrameRgba(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::RGBA8Unorm, renderTarget().framebufferSize(),
-        obs.buffer->data});
+    renderTarget().readFrameRgba(observationView(obs.buffer->data));
   }
 }
 
+#ifndef MAGNUM_TARGET_WEBGL
+bool CameraSensor::readObservationAsync() {
+  if (!hasRenderTarget())
+    return false;
+
+  if (cameraSensorSpec_->sensorType == SensorType::Semantic) {
+    renderTarget().readFrameObjectIdAsync();
+  } else if (cameraSensorSpec_->sensorType == SensorType::Depth) {
+    renderTarget().readFrameDepthAsync();
+  } else {
+    renderTarget().readFrameRgbaAsync();
+  }
+  return true;
+}
+
+bool CameraSensor::mapObservation(Observation& obs) {
+  ESP_PROFILE_SCOPE("CameraSensor::mapObservation");
+  if (!hasRenderTarget())
+    return false;
+
+  prepareObservationBuffer(obs);
+  renderTarget().mapReadFrame();
+  return true;
+}
+
+void CameraSensor::copyMappedObservation(Observation& obs) {
+  renderTarget().copyReadFrame(observationView(obs.buffer->data));
+}
+
+void CameraSensor::copyMappedObservation(
+    Corrade::Containers::ArrayView<void> data) {
+  renderTarget().copyReadFrame(observationView(data));
+}
+
+void CameraSensor::unmapObservation() {
+  if (hasRenderTarget())
+    renderTarget().unmapReadFrame();
+}
+#endif
+
 Corrade::Containers::Optional<Magnum::Vector2> CameraSensor::depthUnprojection()
     const {
   // projectionMatrix_ is managed by implementation class and is set whenever
@@ -191,5 +308,14 @@ Corrade::Containers::Optional<Magnum::Vector2> CameraSensor::depthUnprojection()
   return {gfx::calculateDepthUnprojection(projectionMatrix_)};
 }  // CameraSensor::depthUnprojection
 
+Corrade::Containers::Optional<gfx::DepthProcessing>
+CameraSensor::depthProcessing() const {
+  if (cameraSensorSpec_->sensorType != SensorType::Depth ||
+      cameraSensorSpec_->depthProcessing == gfx::DepthProcessing{}) {
+    return Corrade::Containers::NullOpt;
+  }
+  return {cameraSensorSpec_->depthProcessing};
+}  // CameraSensor::depthProcessing
+
 }  // namespace sensor
 }  // namespace esp
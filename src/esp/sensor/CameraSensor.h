@@ -5,6 +5,7 @@
 #ifndef ESP_SENSOR_CAMERASENSOR_H_
 #define ESP_SENSOR_CAMERASENSOR_H_
 
+#include <Magnum/ImageView.h>
 #include <Magnum/Math/ConfigurationValue.h>
 #include "VisualSensor.h"
 #include "esp/core/esp.h"
@@ -14,6 +15,10 @@ namespace sensor {
 
 struct CameraSensorSpec : public VisualSensorSpec {
   int channels = 4;
+  // Clipping, normalization and output format of depth sensors. Anything
+  // but the default unprojects depth on the CPU with all of it fused into one
+  // pass, see gfx::unprojectDepth()
+  gfx::DepthProcessing depthProcessing;
   // description of Sensor observation space as gym.spaces.Dict()
   std::string observationSpace = "";
   CameraSensorSpec();
@@ -72,6 +77,13 @@ class CameraSensor : public VisualSensor {
   Corrade::Containers::Optional<Magnum::Vector2> depthUnprojection()
       const override;
 
+  /**
+   * @brief Returns the depth post processing of the sensor spec if this is a
+   * depth sensor and it is not the default, see @ref gfx::DepthProcessing
+   */
+  Corrade::Containers::Optional<gfx::DepthProcessing> depthProcessing()
+      const override;
+
   /**
    * @brief Draw an observation to the frame buffer using simulator's renderer
    * @return true if success, otherwise false (e.g., frame buffer is not set)
@@ -80,6 +92,37 @@ class CameraSensor : public VisualSensor {
    */
   bool drawObservation(sim::Simulator& sim) override;
 
+  /**
+   * @brief Draw the observations of several camera sensors, equivalent to
+   * calling @ref drawObservation() on each of them
+   *
+   * Sensors sharing a pose and projection, such as color, depth and semantic
+   * sensors mounted together, are culled once and reuse the visible draw
+   * list, see @ref gfx::Renderer::draw().
+   * @return the number of sensors drawn
+   * @param[in] sim Instance of Simulator class for which the observations
+   *                need to be drawn
+   * @param[in] sensors Sensors to draw; those without a render target are
+   * skipped
+   */
+  static size_t drawObservations(sim::Simulator& sim,
+                                 const std::vector<CameraSensor*>& sensors);
+
+#ifndef MAGNUM_TARGET_WEBGL
+  bool readObservationAsync() override;
+  bool mapObservation(Observation& obs) override;
+  void copyMappedObservation(Observation& obs) override;
+
+  /**
+   * @brief Copies the pixels mapped by @ref mapObservation() into @p data
+   * instead of this sensor's own buffers, e.g. into one slice of a batched
+   * observation. Makes no GL calls, so it can run on a worker thread.
+   * @param[out] data Memory for exactly one observation of this sensor
+   */
+  void copyMappedObservation(Corrade::Containers::ArrayView<void> data);
+  void unmapObservation() override;
+#endif
+
   /**
    * @brief Modify the zoom matrix for perspective and ortho cameras
    * @param factor Modification amount.
@@ -206,6 +249,25 @@ class CameraSensor : public VisualSensor {
    */
   virtual void readObservation(Observation& obs);
 
+  /**
+   * @brief Rebinds the render target through the simulator's renderer if
+   * the sensor's resolution no longer matches it
+   */
+  void updateRenderTarget(sim::Simulator& sim);
+
+  /**
+   * @brief Points @p obs to the next free buffer of this sensor's buffer
+   * pool, reallocating the pool on first use or after a resolution change
+   */
+  void prepareObservationBuffer(Observation& obs);
+
+  /**
+   * @brief View of observation memory in the pixel format this sensor type
+   * reads
+   */
+  Magnum::MutableImageView2D observationView(
+      Corrade::Containers::ArrayView<void> data);
+
   /**
    * @brief This camera's projection matrix. Should be recomputeulated every
    * time size changes.
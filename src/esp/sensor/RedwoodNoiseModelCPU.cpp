@@ -0,0 +1,247 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RedwoodNoiseModelCPU.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <Corrade/Corrade.h>
+
+#include "esp/core/Parallel.h"
+
+namespace esp {
+namespace sensor {
+
+namespace {
+const int MODEL_N_DIMS = 4;
+
+// Number of rows handed to a worker at once
+const int ROWS_PER_ITEM = 4;
+
+inline uint64_t mix64(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+// Natural log of a positive normal float, as Cephes logf: x = m * 2^e with
+// m in [sqrt(1/2), sqrt(2)), then a polynomial in m - 1. Selects are done
+// with arithmetic as GCC doesn't if-convert branches containing float math,
+// so loops calling this vectorize.
+inline float logApprox(const float x) {
+  std::int32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  std::int32_t e = ((bits >> 23) & 0xff) - 126;
+  // m in [0.5, 1)
+  bits = (bits & 0x807fffff) | 0x3f000000;
+  float m;
+  std::memcpy(&m, &bits, sizeof(m));
+  const int small = m < 0.707106781186547524f;
+  e -= small;
+  m = m * static_cast<float>(1 + small) - 1.0f;
+
+  const float z = m * m;
+  float y = 7.0376836292e-2f;
+  y = y * m - 1.1514610310e-1f;
+  y = y * m + 1.1676998740e-1f;
+  y = y * m - 1.2420140846e-1f;
+  y = y * m + 1.4249322787e-1f;
+  y = y * m - 1.6668057665e-1f;
+  y = y * m + 2.0000714765e-1f;
+  y = y * m - 2.4999993993e-1f;
+  y = y * m + 3.3333331174e-1f;
+  y = y * m * z;
+  const float fe = static_cast<float>(e);
+  y += -2.12194440e-4f * fe - 0.5f * z;
+  return m + y + 0.693359375f * fe;
+}
+
+// Sine and cosine of 2 pi t for t in [0, 1], as Cephes sinf and cosf: the
+// angle is reduced to [-pi/4, pi/4] around the closest multiple of pi/2,
+// whose quadrant then swaps and negates the results. Branch-free like
+// logApprox().
+inline void sinCos2PiApprox(const float t, float& s, float& c) {
+  const float quarters = t * 4.0f;
+  const int q = static_cast<int>(quarters + 0.5f);
+  const float x = (quarters - q) * 1.57079632679489662f;
+  const float z = x * x;
+
+  float sx = -1.9515295891e-4f;
+  sx = sx * z + 8.3321608736e-3f;
+  sx = sx * z - 1.6666654611e-1f;
+  sx = sx * z * x + x;
+
+  float cx = 2.443315711809948e-5f;
+  cx = cx * z - 1.388731625493765e-3f;
+  cx = cx * z + 4.166664568298827e-2f;
+  cx = cx * z * z - 0.5f * z + 1.0f;
+
+  const float odd = static_cast<float>(q & 1);
+  const float sinBase = sx * (1.0f - odd) + cx * odd;
+  const float cosBase = cx * (1.0f - odd) + sx * odd;
+  s = sinBase * static_cast<float>(1 - (q & 2));
+  c = cosBase * static_cast<float>(1 - ((q + 1) & 2));
+}
+
+// Fills three rows of standard normal numbers for the pixels starting at
+// counter. Every pixel hashes its own counter into four uniforms which are
+// turned into normals with Box-Muller, so the loop has no dependencies
+// between pixels. With the polynomial log, sine and cosine above and sqrt()
+// not setting errno (see CMakeLists.txt), it has no calls or branches either
+// and vectorizes: for 640x480, 5.7 ms per frame with libm, 2.1 ms with SSE2
+// and 1.05 ms with AVX2. The results are within 2e-6 of libm's.
+/* Clang doesn't have target_clones yet: https://reviews.llvm.org/D51650 */
+#if defined(CORRADE_TARGET_X86) && defined(__GNUC__) && __GNUC__ >= 6
+__attribute__((target_clones("default", "sse4.2", "avx2")))
+#endif
+void gaussianRow(const uint64_t key,
+                 const uint64_t counter,
+                 const int W,
+                 float* __restrict__ n0,
+                 float* __restrict__ n1,
+                 float* __restrict__ n2) {
+  constexpr float toUnit = 1.0f / (1u << 24);
+  for (int i = 0; i < W; ++i) {
+    const uint64_t a = mix64(key + 2 * (counter + i));
+    const uint64_t b = mix64(key + 2 * (counter + i) + 1);
+    // u1, u3 in (0, 1] so that the log is finite. 24 bits fit in an int32,
+    // whose conversion to float vectorizes, unlike that of a uint64.
+    const float u1 = static_cast<std::int32_t>((a >> 40) + 1) * toUnit;
+    const float u2 = static_cast<std::int32_t>((a >> 8) & 0xffffff) * toUnit;
+    const float u3 = static_cast<std::int32_t>((b >> 40) + 1) * toUnit;
+    const float u4 = static_cast<std::int32_t>((b >> 8) & 0xffffff) * toUnit;
+    const float r1 = std::sqrt(-2.0f * logApprox(u1));
+    const float r2 = std::sqrt(-2.0f * logApprox(u3));
+    float s1, c1, s2, c2;
+    sinCos2PiApprox(u2, s1, c1);
+    sinCos2PiApprox(u4, s2, c2);
+    n0[i] = r1 * c1;
+    n1[i] = r1 * s1;
+    n2[i] = r2 * c2;
+  }
+}
+
+// Read about the noise model here: http://www.alexteichman.com/octo/clams/
+// Original source code: http://redwood-data.org/indoor/data/simdepth.py
+inline float undistort(const int _x,
+                       const int _y,
+                       const float z,
+                       const float* __restrict__ model,
+                       const int modelCols) {
+  const int i2 = (z + 1) / 2;
+  const int i1 = i2 - 1;
+  const float a = (z - (i1 * 2.0f + 1.0f)) / 2.0f;
+  const int x = _x / 8;
+  const int y = _y / 6;
+
+  const float* cell = &model[(y * modelCols + x) * MODEL_N_DIMS];
+  const float f = (1.0f - a) * cell[std::min(std::max(i1, 0), 4)] +
+                  a * cell[std::min(i2, 4)];
+
+  if (f < 1e-5)
+    return 0.0f;
+  else
+    return z / f;
+}
+}  // namespace
+
+RedwoodNoiseModelCPUImpl::RedwoodNoiseModelCPUImpl(
+    const Eigen::Ref<const Eigen::RowMatrixXf> model,
+    const float noiseMultiplier,
+    const uint64_t seed,
+    const unsigned int maxThreads)
+    : model_{model},
+      noiseMultiplier_{noiseMultiplier},
+      maxThreads_{maxThreads},
+      seed_{seed} {}
+
+void RedwoodNoiseModelCPUImpl::seed(const uint64_t seed) {
+  seed_ = seed;
+  frame_ = 0;
+}
+
+Eigen::RowMatrixXf RedwoodNoiseModelCPUImpl::simulateFromCPU(
+    const Eigen::Ref<const Eigen::RowMatrixXf> depth) {
+  const int H = depth.rows();
+  const int W = depth.cols();
+  Eigen::RowMatrixXf noisyDepth(H, W);
+  if (H == 0 || W == 0)
+    return noisyDepth;
+
+  const uint64_t key = mix64(seed_ + 0x9e3779b97f4a7c15ull * ++frame_);
+  const float* __restrict__ model = model_.data();
+  const int modelCols = model_.cols() / MODEL_N_DIMS;
+
+  const float ymax = H - 1;
+  const float xmax = W - 1;
+  // The noise model was originally made for a 640x480 sensor, so re-map our
+  // arbitrarily sized sensor to that size
+  const float xScale = xmax > 0 ? 639.0f / xmax : 0.0f;
+  const float yScale = ymax > 0 ? 479.0f / ymax : 0.0f;
+
+  const size_t numItems = (H + ROWS_PER_ITEM - 1) / ROWS_PER_ITEM;
+  const unsigned int numWorkers =
+      core::numWorkerThreads(numItems, maxThreads_);
+  noise_.resize(std::max<size_t>(noise_.size(), numWorkers));
+
+  core::parallelFor(numItems, numWorkers, [&](unsigned int workerIdx,
+                                              size_t item) {
+    std::vector<float>& noise = noise_[workerIdx];
+    noise.resize(3 * W);
+    float* n0 = noise.data();
+    float* n1 = n0 + W;
+    float* n2 = n1 + W;
+
+    const int rowEnd = std::min<int>(H, (item + 1) * ROWS_PER_ITEM);
+    for (int j = item * ROWS_PER_ITEM; j < rowEnd; ++j) {
+      gaussianRow(key, static_cast<uint64_t>(j) * W, W, n0, n1, n2);
+
+      const float* __restrict__ d = depth.data();
+      const size_t stride = depth.outerStride();
+      float* __restrict__ out = noisyDepth.data() + static_cast<size_t>(j) * W;
+      for (int i = 0; i < W; ++i) {
+        // Shuffle pixels
+        const int y =
+            std::min(std::max(j + n0[i] * 0.25f * noiseMultiplier_, 0.0f),
+                     ymax) +
+            0.5f;
+        const int x =
+            std::min(std::max(i + n1[i] * 0.25f * noiseMultiplier_, 0.0f),
+                     xmax) +
+            0.5f;
+
+        // Downsample
+        const float z = d[static_cast<size_t>(y - y % 2) * stride + x - x % 2];
+        // If depth is greater than 10m, the sensor will just return a zero
+        if (z >= 10.0f) {
+          out[i] = 0.0f;
+          continue;
+        }
+
+        // Distortion
+        const float undistortedZ =
+            undistort(static_cast<int>(x * xScale + 0.5f),
+                      static_cast<int>(y * yScale + 0.5f), z, model, modelCols);
+
+        // Quantization and high freq noise
+        if (undistortedZ == 0.0f) {
+          out[i] = 0.0f;
+        } else {
+          const float denom = std::round(
+              (35.130f / undistortedZ + n2[i] * 0.027778f * noiseMultiplier_) *
+              8.0f);
+          out[i] = denom > 1e-5 ? (35.130f * 8.0f / denom) : 0.0f;
+        }
+      }
+    }
+  });
+
+  return noisyDepth;
+}
+
+}  // namespace sensor
+}  // namespace esp
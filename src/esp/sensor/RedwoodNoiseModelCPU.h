@@ -0,0 +1,80 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SENSOR_REDWOODNOISEMODELCPU_H_
+#define ESP_SENSOR_REDWOODNOISEMODELCPU_H_
+
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace sensor {
+
+/**
+ * Provides a native CPU implementation of the Redwood Noise Model for
+ * PrimSense Depth sensors, for machines without CUDA. Produces the same
+ * distribution as @ref RedwoodNoiseModelGPUImpl.
+ *
+ * Rows are processed in parallel and the random numbers of every pixel are
+ * derived from the seed, the number of the simulated frame and the pixel
+ * index with a counter based generator, so the output only depends on the
+ * seed and the call sequence, not on the number of threads.
+ *
+ * See @ref RedwoodNoiseModelGPUImpl for the model reference.
+ */
+struct RedwoodNoiseModelCPUImpl {
+  /**
+   * @brief Constructor
+   * @param model             The distortion model from
+   *                          http://redwood-data.org/indoor/data/dist-model.txt
+   *                          The 3rd dimension is assumed to have been
+   *                          flattened into the second
+   * @param noiseMultiplier   Multiplier for the Gaussian random-variables. This
+   *                          can be used to increase or decrease the noise
+   *                          level
+   * @param seed              The random seed
+   * @param maxThreads        Upper bound on the worker threads. 0 uses all
+   *                          hardware threads
+   */
+  RedwoodNoiseModelCPUImpl(const Eigen::Ref<const Eigen::RowMatrixXf> model,
+                           const float noiseMultiplier,
+                           const uint64_t seed = 0,
+                           const unsigned int maxThreads = 0);
+
+  /**
+   * @brief Simulates noisy depth from clean depth.
+   *
+   * Every call draws new noise; the n-th call after construction or @ref
+   * seed always draws the same noise.
+   *
+   * @param[in] depth  Clean depth, i.e. depth from habitat's depth shader
+   * @return Simulated noisy depth
+   */
+  Eigen::RowMatrixXf simulateFromCPU(
+      const Eigen::Ref<const Eigen::RowMatrixXf> depth);
+
+  /**
+   * @brief Restarts the noise sequence from @p seed
+   */
+  void seed(uint64_t seed);
+
+ private:
+  Eigen::RowMatrixXf model_;
+  const float noiseMultiplier_;
+  const unsigned int maxThreads_;
+  uint64_t seed_;
+  //! Number of frames simulated since the last seed
+  uint64_t frame_ = 0;
+
+  //! Per worker thread scratch rows of Gaussian random numbers
+  std::vector<std::vector<float>> noise_;
+
+  ESP_SMART_POINTERS(RedwoodNoiseModelCPUImpl)
+};
+
+}  // namespace sensor
+}  // namespace esp
+
+#endif  // ESP_SENSOR_REDWOODNOISEMODELCPU_H_
@@ -8,6 +8,7 @@
 #include "esp/core/esp.h"
 
 #include "esp/core/Buffer.h"
+#include "esp/core/BufferPool.h"
 #include "esp/scene/SceneNode.h"
 
 namespace esp {
@@ -115,7 +116,8 @@ class Sensor : public Magnum::SceneGraph::AbstractFeature3D {
 
  protected:
   SensorSpec::ptr spec_ = nullptr;
-  core::Buffer::ptr buffer_ = nullptr;
+  // observation buffers, reused once the observations are released
+  core::BufferPool::ptr bufferPool_ = nullptr;
 
   ESP_SMART_POINTERS(Sensor)
 };
@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "esp/gfx/RenderTarget.h"
+#include "esp/gfx/RenderTargetPool.h"
 
 namespace esp {
 namespace sensor {
@@ -64,13 +65,26 @@ VisualSensor::VisualSensor(scene::SceneNode& node, VisualSensorSpec::ptr spec)
 
 VisualSensor::~VisualSensor() {
   LOG(INFO) << "Deconstructing VisualSensor";
+  releaseRenderTarget();
 }
 
-void VisualSensor::bindRenderTarget(gfx::RenderTarget::uptr&& tgt) {
+void VisualSensor::bindRenderTarget(
+    gfx::RenderTarget::uptr&& tgt,
+    const std::shared_ptr<gfx::RenderTargetPool>& pool) {
   if (tgt->framebufferSize() != framebufferSize())
     throw std::runtime_error("RenderTarget is not the correct size");
 
+  releaseRenderTarget();
   tgt_ = std::move(tgt);
+  tgtPool_ = pool;
+}
+
+void VisualSensor::releaseRenderTarget() {
+  if (auto pool = tgtPool_.lock()) {
+    pool->release(std::move(tgt_));
+  }
+  tgt_ = nullptr;
+  tgtPool_.reset();
 }
 
 bool VisualSensor::displayObservation(sim::Simulator& sim) {
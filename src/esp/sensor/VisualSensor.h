@@ -10,13 +10,15 @@
 
 #include "esp/core/esp.h"
 
+#include "esp/gfx/DepthUnprojection.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/sensor/Sensor.h"
 
 namespace esp {
 namespace gfx {
 class RenderTarget;
-}
+class RenderTargetPool;
+}  // namespace gfx
 
 namespace sensor {
 
@@ -73,6 +75,19 @@ class VisualSensor : public Sensor {
     return Corrade::Containers::NullOpt;
   };
 
+  /**
+   * @brief Returns the post processing fused into the CPU depth
+   * unprojection of this sensor, see @ref gfx::unprojectDepth()
+   *
+   * If set, depth is unprojected on the CPU instead of by a
+   * @ref gfx::DepthShader. Will always be @ref Corrade::Containers::NullOpt
+   * for the base sensor class.
+   */
+  virtual Corrade::Containers::Optional<gfx::DepthProcessing>
+  depthProcessing() const {
+    return Corrade::Containers::NullOpt;
+  }
+
   /**
    * @brief Checks to see if this sensor has a RenderTarget bound or not
    */
@@ -81,8 +96,19 @@ class VisualSensor : public Sensor {
   /**
    * @brief Binds the given given RenderTarget to the sensor.  The sensor takes
    * ownership of the RenderTarget
+   * @param tgt The render target, sized as @ref framebufferSize()
+   * @param pool If set, the pool @p tgt came from. It gets the target back
+   * when the sensor is rebound or destroyed, if it still exists then.
    */
-  void bindRenderTarget(std::unique_ptr<gfx::RenderTarget>&& tgt);
+  void bindRenderTarget(
+      std::unique_ptr<gfx::RenderTarget>&& tgt,
+      const std::shared_ptr<gfx::RenderTargetPool>& pool = nullptr);
+
+  /**
+   * @brief Gives the render target back to the pool it came from, or
+   * destroys it if there is none. The sensor has no render target afterwards.
+   */
+  void releaseRenderTarget();
 
   /**
    * @brief Returns a reference to the sensors render target
@@ -103,6 +129,40 @@ class VisualSensor : public Sensor {
     return false;
   }
 
+  /**
+   * @brief Starts reading the last drawn observation back from the GPU
+   * without waiting for it to finish rendering.
+   *
+   * Allows drawing several sensors before the first readback blocks. Finish
+   * with @ref mapObservation(), @ref copyMappedObservation() and @ref
+   * unmapObservation().
+   * @return false if the sensor doesn't support asynchronous reads
+   */
+  virtual bool readObservationAsync() { return false; }
+
+  /**
+   * @brief Waits for the read started by @ref readObservationAsync() and
+   * points @p obs to this sensor's observation buffer. The pixels are only
+   * copied into it by @ref copyMappedObservation().
+   * @return true if success, otherwise false
+   */
+  virtual bool mapObservation(CORRADE_UNUSED Observation& obs) {
+    return false;
+  }
+
+  /**
+   * @brief Copies the pixels mapped by @ref mapObservation() into @p obs,
+   * including any CPU post processing such as depth unprojection.
+   *
+   * Makes no GL calls, so it can run on a worker thread.
+   */
+  virtual void copyMappedObservation(CORRADE_UNUSED Observation& obs) {}
+
+  /**
+   * @brief Releases the pixels mapped by @ref mapObservation()
+   */
+  virtual void unmapObservation() {}
+
   /**
    * @brief Sets resolution of Sensor's sensorSpec
    */
@@ -157,6 +217,7 @@ class VisualSensor : public Sensor {
   Mn::Deg hfov_ = 90.0_degf;
 
   std::unique_ptr<gfx::RenderTarget> tgt_;
+  std::weak_ptr<gfx::RenderTargetPool> tgtPool_;
   VisualSensorSpec::ptr visualSensorSpec_ =
       std::dynamic_pointer_cast<VisualSensorSpec>(spec_);
   ESP_SMART_POINTERS(VisualSensor)
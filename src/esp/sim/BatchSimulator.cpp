@@ -0,0 +1,208 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BatchSimulator.h"
+
+#include <cstring>
+
+#include <Magnum/GL/Context.h>
+
+#include "esp/core/Parallel.h"
+#include "esp/gfx/Renderer.h"
+#include "esp/sensor/CameraSensor.h"
+
+namespace esp {
+namespace sim {
+
+BatchSimulator::BatchSimulator(
+    const std::vector<SimulatorConfiguration>& cfgs,
+    const agent::AgentConfiguration& agentConfig,
+    metadata::MetadataMediator::ptr metadataMediator) {
+  CORRADE_ASSERT(!cfgs.empty(),
+                 "BatchSimulator::BatchSimulator(): no environments", );
+  const SimulatorConfiguration& firstCfg = cfgs.front();
+  if (!metadataMediator) {
+    metadataMediator = metadata::MetadataMediator::create(firstCfg);
+  }
+
+  if (firstCfg.createRenderer) {
+    if (!Magnum::GL::Context::hasCurrent()) {
+      context_ = gfx::WindowlessContext::create_unique(firstCfg.gpuDeviceId);
+    }
+    gfx::Renderer::Flags flags;
+    if (!firstCfg.requiresTextures)
+      flags |= gfx::Renderer::Flag::NoTextures;
+    renderer_ = gfx::Renderer::create(flags);
+  }
+  // one asset cache, so every mesh and texture is loaded once
+  resourceManager_ =
+      std::make_shared<assets::ResourceManager>(metadataMediator);
+
+  environments_.reserve(cfgs.size());
+  for (const SimulatorConfiguration& cfg : cfgs) {
+    environments_.emplace_back(Simulator::create(cfg, metadataMediator,
+                                                 renderer_, resourceManager_));
+    environments_.back()->addAgent(agentConfig);
+  }
+  LOG(INFO) << "BatchSimulator: created " << environments_.size()
+            << " environments";
+}
+
+BatchSimulator::~BatchSimulator() {
+  LOG(INFO) << "Deconstructing BatchSimulator";
+  bufferPools_.clear();
+  // the environments release their GL objects while the context still exists
+  environments_.clear();
+  resourceManager_ = nullptr;
+  renderer_ = nullptr;
+}
+
+void BatchSimulator::reset() {
+  for (Simulator::ptr& env : environments_) {
+    env->reset();
+  }
+}
+
+std::vector<bool> BatchSimulator::act(const std::vector<std::string>& actions,
+                                      unsigned int maxThreads) {
+  CORRADE_ASSERT(actions.size() == environments_.size(),
+                 "BatchSimulator::act(): expected" << environments_.size()
+                                                   << "actions but got"
+                                                   << actions.size(),
+                 {});
+  // not std::vector<bool>, so workers write separate bytes
+  std::vector<char> success(actions.size(), 1);
+  core::parallelFor(
+      environments_.size(),
+      core::numWorkerThreads(environments_.size(), maxThreads),
+      [&](unsigned int, size_t envIdx) {
+        if (!actions[envIdx].empty()) {
+          success[envIdx] =
+              environments_[envIdx]->getAgent(0)->act(actions[envIdx]);
+        }
+      });
+  return std::vector<bool>(success.begin(), success.end());
+}
+
+void BatchSimulator::stepWorld(double dt) {
+  for (Simulator::ptr& env : environments_) {
+    env->stepWorld(dt);
+  }
+}
+
+int BatchSimulator::getObservations(
+    std::map<std::string, sensor::Observation>& observations,
+    unsigned int maxThreads) {
+  observations.clear();
+  if (!renderer_) {
+    return 0;
+  }
+  const size_t numEnvs = environments_.size();
+
+  // The batch holds the same sensors in every environment, take their layout
+  // from the first one
+  std::vector<std::string> uuids;
+  std::vector<core::Buffer*> batchBuffers;
+  for (const auto& it :
+       environments_.front()->getAgent(0)->getSensorSuite().getSensors()) {
+    sensor::ObservationSpace space;
+    if (!it.second->isVisualSensor() ||
+        !it.second->getObservationSpace(space)) {
+      continue;
+    }
+    std::vector<size_t> shape{numEnvs, space.shape[0], space.shape[1]};
+    // depth and semantic are read as a single channel whatever the spec
+    // says, keep the batch tightly packed
+    const sensor::SensorType sensorType =
+        it.second->specification()->sensorType;
+    if (sensorType != sensor::SensorType::Depth &&
+        sensorType != sensor::SensorType::Semantic) {
+      shape.push_back(space.shape[2]);
+    }
+    // reallocated if the sensors were resized
+    core::BufferPool::ptr& pool = bufferPools_[it.first];
+    if (!pool || pool->shape() != shape ||
+        pool->dataType() != space.dataType) {
+      pool = core::BufferPool::create(shape, space.dataType);
+    }
+    core::Buffer::ptr buffer = pool->acquire();
+    batchBuffers.push_back(buffer.get());
+    observations[it.first].buffer = std::move(buffer);
+    uuids.push_back(it.first);
+  }
+  const size_t numSensors = uuids.size();
+
+  std::vector<std::vector<sensor::CameraSensor*>> sensors(numEnvs);
+  for (size_t envIdx = 0; envIdx < numEnvs; ++envIdx) {
+    const auto& envSensors =
+        environments_[envIdx]->getAgent(0)->getSensorSuite().getSensors();
+    for (const std::string& uuid : uuids) {
+      auto found = envSensors.find(uuid);
+      auto* cameraSensor =
+          found == envSensors.end()
+              ? nullptr
+              : dynamic_cast<sensor::CameraSensor*>(found->second.get());
+      CORRADE_ASSERT(cameraSensor && cameraSensor->hasRenderTarget(),
+                     "BatchSimulator::getObservations(): environment"
+                         << envIdx << "has no camera sensor" << uuid.c_str(),
+                     0);
+      sensors[envIdx].push_back(cameraSensor);
+    }
+  }
+
+  // The slice of a batched observation belonging to one environment
+  auto slice = [&](size_t sensorIdx, size_t envIdx) {
+    core::Buffer& buffer = *batchBuffers[sensorIdx];
+    const size_t sliceSize = buffer.data.size() / numEnvs;
+    return buffer.data.slice(envIdx * sliceSize, (envIdx + 1) * sliceSize);
+  };
+
+#ifndef MAGNUM_TARGET_WEBGL
+  // Draw everything and start every readback first, so the GPU stays busy
+  // while the first ones are waited on
+  for (size_t envIdx = 0; envIdx < numEnvs; ++envIdx) {
+    sensor::CameraSensor::drawObservations(*environments_[envIdx],
+                                           sensors[envIdx]);
+    for (sensor::CameraSensor* cameraSensor : sensors[envIdx]) {
+      cameraSensor->readObservationAsync();
+    }
+  }
+
+  // Map on this thread, copy (and unproject depth) on the workers
+  for (size_t envIdx = 0; envIdx < numEnvs; ++envIdx) {
+    for (sensor::CameraSensor* cameraSensor : sensors[envIdx]) {
+      cameraSensor->renderTarget().mapReadFrame();
+    }
+  }
+  core::parallelFor(numEnvs * numSensors,
+                    core::numWorkerThreads(numEnvs * numSensors, maxThreads),
+                    [&](unsigned int, size_t item) {
+                      const size_t envIdx = item / numSensors;
+                      const size_t sensorIdx = item % numSensors;
+                      sensors[envIdx][sensorIdx]->copyMappedObservation(
+                          slice(sensorIdx, envIdx));
+                    });
+  for (size_t envIdx = 0; envIdx < numEnvs; ++envIdx) {
+    for (sensor::CameraSensor* cameraSensor : sensors[envIdx]) {
+      cameraSensor->unmapObservation();
+    }
+  }
+#else
+  // No pixel buffer mapping, read each sensor synchronously
+  static_cast<void>(maxThreads);
+  for (size_t envIdx = 0; envIdx < numEnvs; ++envIdx) {
+    for (size_t sensorIdx = 0; sensorIdx < numSensors; ++sensorIdx) {
+      sensor::Observation obs;
+      sensors[envIdx][sensorIdx]->getObservation(*environments_[envIdx], obs);
+      auto dst = slice(sensorIdx, envIdx);
+      std::memcpy(dst.data(), obs.buffer->data.data(), dst.size());
+    }
+  }
+#endif
+
+  return observations.size();
+}
+
+}  // namespace sim
+}  // namespace esp
@@ -0,0 +1,113 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SIM_BATCHSIMULATOR_H_
+#define ESP_SIM_BATCHSIMULATOR_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "esp/agent/Agent.h"
+#include "esp/core/BufferPool.h"
+#include "esp/core/esp.h"
+#include "esp/gfx/WindowlessContext.h"
+#include "esp/sensor/Sensor.h"
+
+#include "Simulator.h"
+
+namespace esp {
+namespace sim {
+
+/**
+ * @brief Runs a batch of environments in one process, sharing one GL context,
+ * one renderer and one asset cache.
+ *
+ * Every environment is a full @ref Simulator with its own scene graph,
+ * physics, navmesh and a single agent, but meshes and textures are loaded
+ * once and reused by every environment showing them. Observations of all
+ * environments are read back into one contiguous buffer per sensor, with the
+ * environment as the leading dimension.
+ */
+class BatchSimulator {
+ public:
+  /**
+   * @brief Constructor
+   * @param cfgs One configuration per environment. The GPU device and
+   * whether textures are required are taken from the first one.
+   * @param agentConfig The agent, including its sensors, created in every
+   * environment
+   * @param metadataMediator Shared by all environments, created from the
+   * first configuration if not given
+   */
+  BatchSimulator(const std::vector<SimulatorConfiguration>& cfgs,
+                 const agent::AgentConfiguration& agentConfig,
+                 metadata::MetadataMediator::ptr metadataMediator = nullptr);
+
+  ~BatchSimulator();
+
+  size_t numEnvironments() const { return environments_.size(); }
+
+  /**
+   * @brief The simulator of one environment, for anything not batched
+   */
+  Simulator& environment(size_t envIdx) { return *environments_[envIdx]; }
+
+  /**
+   * @brief Resets every environment
+   */
+  void reset();
+
+  /**
+   * @brief Applies one action to the agent of every environment
+   *
+   * Environments are independent, so they are stepped in parallel.
+   * @param actions One action name per environment, an empty name leaves
+   * that agent in place
+   * @param maxThreads Upper bound on the worker threads, 0 means one per core
+   * @return For every environment, whether its action was known
+   */
+  std::vector<bool> act(const std::vector<std::string>& actions,
+                        unsigned int maxThreads = 0);
+
+  /**
+   * @brief Steps the physics of every environment by @p dt
+   */
+  void stepWorld(double dt = 1.0 / 60.0);
+
+  /**
+   * @brief Renders every sensor of every environment and reads them back
+   * into one batched observation per sensor uuid
+   *
+   * Each observation buffer is shaped [numEnvironments, height, width,
+   * channels], without the channel dimension for depth and semantic
+   * sensors. All environments are drawn before any readback is waited on,
+   * and the copies out of the read pixel buffers run on worker threads.
+   * Observations come from a @ref core::BufferPool, so held ones stay valid
+   * while later ones are rendered.
+   * @param[out] observations Cleared and filled with one observation per
+   * sensor uuid
+   * @param maxThreads Upper bound on the worker threads, 0 means one per core
+   * @return The number of observations
+   */
+  int getObservations(std::map<std::string, sensor::Observation>& observations,
+                      unsigned int maxThreads = 0);
+
+ private:
+  // Declared before everything owning GL objects so it is destroyed last
+  gfx::WindowlessContext::uptr context_ = nullptr;
+  std::shared_ptr<gfx::Renderer> renderer_ = nullptr;
+  std::shared_ptr<assets::ResourceManager> resourceManager_ = nullptr;
+  std::vector<Simulator::ptr> environments_;
+
+  // batched observation buffers by sensor uuid
+  std::map<std::string, core::BufferPool::ptr> bufferPools_;
+
+  ESP_SMART_POINTERS(BatchSimulator)
+};
+
+}  // namespace sim
+}  // namespace esp
+
+#endif  // ESP_SIM_BATCHSIMULATOR_H_
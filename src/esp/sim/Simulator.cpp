@@ -4,6 +4,9 @@
 
 #include "Simulator.h"
 
+#include <future>
+#include <limits>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -13,6 +16,7 @@
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/GL/Context.h>
 
+#include "esp/core/Profiler.h"
 #include "esp/core/esp.h"
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/RenderCamera.h"
@@ -48,6 +52,21 @@ Simulator::Simulator(const SimulatorConfiguration& cfg,
   reconfigure(cfg);
 }
 
+Simulator::Simulator(const SimulatorConfiguration& cfg,
+                     metadata::MetadataMediator::ptr _metadataMediator,
+                     std::shared_ptr<gfx::Renderer> renderer,
+                     std::shared_ptr<assets::ResourceManager> resourceManager)
+    : renderer_{std::move(renderer)},
+      resourceManager_{std::move(resourceManager)},
+      metadataMediator_{std::move(_metadataMediator)},
+      random_{core::Random::create(cfg.randomSeed)},
+      requiresTextures_{Cr::Containers::NullOpt} {
+  CORRADE_ASSERT(!cfg.createRenderer || Magnum::GL::Context::hasCurrent(),
+                 "Simulator::Simulator(): a shared renderer needs a current "
+                 "GL context", );
+  reconfigure(cfg);
+}
+
 Simulator::~Simulator() {
   LOG(INFO) << "Deconstructing Simulator";
   close();
@@ -90,7 +109,7 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
   // assign MM to RM on create or reconfigure
   if (!resourceManager_) {
     resourceManager_ =
-        std::make_unique<assets::ResourceManager>(metadataMediator_);
+        std::make_shared<assets::ResourceManager>(metadataMediator_);
     if (cfg.createRenderer) {
       // needs to be called after ResourceManager exists but before any assets
       // have been loaded
@@ -806,6 +825,19 @@ esp::physics::RaycastResults Simulator::castRay(const esp::geo::Ray& ray,
   return esp::physics::RaycastResults();
 }
 
+void Simulator::castRays(
+    Corrade::Containers::ArrayView<const esp::geo::Ray> rays,
+    esp::physics::RaycastBatchResults& results,
+    float maxDistance,
+    esp::physics::RaycastMode mode,
+    const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->castRays(rays, results, maxDistance, mode);
+    return;
+  }
+  results.reset(rays.size());
+}
+
 void Simulator::setObjectBBDraw(bool drawBB,
                                 const int objectID,
                                 const int sceneID) {
@@ -825,6 +857,7 @@ void Simulator::setObjectSemanticId(uint32_t semanticId,
 }
 
 double Simulator::stepWorld(const double dt) {
+  ESP_PROFILE_SCOPE("Simulator::stepWorld");
   if (physicsManager_ != nullptr) {
     physicsManager_->stepPhysics(dt);
   }
@@ -863,6 +896,117 @@ bool Simulator::recomputeNavMesh(nav::PathFinder& pathfinder,
                  "loaded without renderer initialization.",
                  false);
 
+  std::map<int, std::pair<vec3f, vec3f>> staticObjectBounds;
+  assets::MeshData::uptr joinedMesh =
+      joinNavMeshGeometry(includeStaticObjects, staticObjectBounds);
+
+  if (!pathfinder.build(navMeshSettings, *joinedMesh)) {
+    LOG(ERROR) << "Failed to build navmesh";
+    return false;
+  }
+  navMeshStaticObjectBounds_ = std::move(staticObjectBounds);
+  pendingNavMeshStaticObjectBounds_ = Cr::Containers::NullOpt;
+
+  if (&pathfinder == pathfinder_.get()) {
+    if (isNavMeshVisualizationActive()) {
+      // if updating pathfinder_ instance, refresh the visualization.
+      setNavMeshVisualization(false);  // first clear the old instance
+      setNavMeshVisualization(true);
+    }
+  }
+
+  LOG(INFO) << "reconstruct navmesh successful";
+  return true;
+}
+
+bool Simulator::updateNavMeshAsync(nav::PathFinder& pathfinder) {
+  CORRADE_ASSERT(config_.createRenderer,
+                 "Simulator::updateNavMeshAsync: "
+                 "SimulatorConfiguration::createRenderer is false. Scene "
+                 "geometry is required to update the navmesh.",
+                 false);
+  if (!pathfinder.supportsTileUpdates()) {
+    LOG(ERROR) << "Navmesh must be recomputed with NavMeshSettings::tileSize "
+                  "> 0 to be updated incrementally";
+    return false;
+  }
+
+  std::map<int, std::pair<vec3f, vec3f>> staticObjectBounds;
+  assets::MeshData::uptr joinedMesh =
+      joinNavMeshGeometry(true, staticObjectBounds);
+
+  // The navmesh changes wherever a STATIC object was added, removed or moved
+  auto boundsChanged = [](const std::pair<vec3f, vec3f>& a,
+                          const std::pair<vec3f, vec3f>& b) {
+    return (a.first - b.first).cwiseAbs().maxCoeff() > 1e-4 ||
+           (a.second - b.second).cwiseAbs().maxCoeff() > 1e-4;
+  };
+  auto changedRegionsSince =
+      [&](const std::map<int, std::pair<vec3f, vec3f>>& previousBounds) {
+        std::vector<std::pair<vec3f, vec3f>> changedRegions;
+        for (const auto& prev : previousBounds) {
+          auto current = staticObjectBounds.find(prev.first);
+          if (current == staticObjectBounds.end() ||
+              boundsChanged(current->second, prev.second)) {
+            changedRegions.push_back(prev.second);
+          }
+        }
+        for (const auto& current : staticObjectBounds) {
+          auto prev = previousBounds.find(current.first);
+          if (prev == previousBounds.end() ||
+              boundsChanged(current.second, prev->second)) {
+            changedRegions.push_back(current.second);
+          }
+        }
+        return changedRegions;
+      };
+
+  // A pending update already covers the changes up to its bounds
+  std::vector<std::pair<vec3f, vec3f>> changedRegions = changedRegionsSince(
+      pendingNavMeshStaticObjectBounds_ ? *pendingNavMeshStaticObjectBounds_
+                                        : navMeshStaticObjectBounds_);
+  if (changedRegions.empty()) {
+    return true;
+  }
+
+  // Updates are applied in order, so the pending one goes in first. If it
+  // failed, the changes since the current navmesh are redone instead.
+  if (pathfinder.hasPendingTileUpdates() &&
+      !applyNavMeshUpdates(pathfinder, true)) {
+    changedRegions = changedRegionsSince(navMeshStaticObjectBounds_);
+  }
+
+  if (!pathfinder.updateTilesAsync(*joinedMesh, changedRegions)) {
+    return false;
+  }
+  pendingNavMeshStaticObjectBounds_ = std::move(staticObjectBounds);
+  return true;
+}
+
+bool Simulator::applyNavMeshUpdates(nav::PathFinder& pathfinder, bool wait) {
+  if (!pathfinder.applyTileUpdates(wait)) {
+    // Unless it is still running, the update failed and is gone
+    if (!pathfinder.hasPendingTileUpdates()) {
+      pendingNavMeshStaticObjectBounds_ = Cr::Containers::NullOpt;
+    }
+    return false;
+  }
+  if (pendingNavMeshStaticObjectBounds_) {
+    navMeshStaticObjectBounds_ = std::move(*pendingNavMeshStaticObjectBounds_);
+    pendingNavMeshStaticObjectBounds_ = Cr::Containers::NullOpt;
+  }
+
+  if (&pathfinder == pathfinder_.get() && isNavMeshVisualizationActive()) {
+    setNavMeshVisualization(false);
+    setNavMeshVisualization(true);
+  }
+  return true;
+}
+
+assets::MeshData::uptr Simulator::joinNavMeshGeometry(
+    bool includeStaticObjects,
+    std::map<int, std::pair<vec3f, vec3f>>& staticObjectBounds) {
+  staticObjectBounds.clear();
   assets::MeshData::uptr joinedMesh = assets::MeshData::create_unique();
   auto stageInitAttrs = physicsManager_->getStageInitAttributes();
   if (stageInitAttrs != nullptr) {
@@ -899,28 +1043,18 @@ bool Simulator::recomputeNavMesh(nav::PathFinder& pathfinder,
               joinedObjectMesh->ibo[ix] + prevNumVerts;
         }
         joinedMesh->vbo.reserve(joinedObjectMesh->vbo.size() + prevNumVerts);
+        vec3f bmin = vec3f::Constant(std::numeric_limits<float>::max());
+        vec3f bmax = vec3f::Constant(-std::numeric_limits<float>::max());
         for (auto& vert : joinedObjectMesh->vbo) {
           joinedMesh->vbo.push_back(objectTransform * vert);
+          bmin = bmin.cwiseMin(joinedMesh->vbo.back());
+          bmax = bmax.cwiseMax(joinedMesh->vbo.back());
         }
+        staticObjectBounds[objectID] = std::make_pair(bmin, bmax);
       }
     }
   }
-
-  if (!pathfinder.build(navMeshSettings, *joinedMesh)) {
-    LOG(ERROR) << "Failed to build navmesh";
-    return false;
-  }
-
-  if (&pathfinder == pathfinder_.get()) {
-    if (isNavMeshVisualizationActive()) {
-      // if updating pathfinder_ instance, refresh the visualization.
-      setNavMeshVisualization(false);  // first clear the old instance
-      setNavMeshVisualization(true);
-    }
-  }
-
-  LOG(INFO) << "reconstruct navmesh successful";
-  return true;
+  return joinedMesh;
 }
 
 bool Simulator::setNavMeshVisualization(bool visualize) {
@@ -1201,17 +1335,73 @@ bool Simulator::getAgentObservation(const int agentId,
 int Simulator::getAgentObservations(
     const int agentId,
     std::map<std::string, sensor::Observation>& observations) {
+  ESP_PROFILE_SCOPE("Simulator::getAgentObservations");
   observations.clear();
   agent::Agent::ptr ag = getAgent(agentId);
   if (ag != nullptr) {
     const std::map<std::string, sensor::Sensor::ptr>& sensors =
         ag->getSensorSuite().getSensors();
+#ifndef MAGNUM_TARGET_WEBGL
+    // Draw every camera sensor at once, so co-located ones share culling,
+    // and start each readback before waiting on any of them, so the GPU
+    // renders the next sensor while the previous one is transferred. The CPU
+    // side copy (and depth unprojection) of each mapped frame then runs on a
+    // worker thread while the next frame is mapped.
+    std::vector<sensor::CameraSensor*> cameraSensors;
+    for (const std::pair<const std::string, sensor::Sensor::ptr>& s : sensors) {
+      if (auto* cameraSensor =
+              dynamic_cast<sensor::CameraSensor*>(s.second.get())) {
+        cameraSensors.push_back(cameraSensor);
+      }
+    }
+    sensor::CameraSensor::drawObservations(*this, cameraSensors);
+
+    std::vector<std::pair<const std::string*, sensor::VisualSensor*>> pending;
     for (const std::pair<const std::string, sensor::Sensor::ptr>& s : sensors) {
+      if (auto* cameraSensor =
+              dynamic_cast<sensor::CameraSensor*>(s.second.get())) {
+        if (cameraSensor->readObservationAsync()) {
+          pending.emplace_back(&s.first, cameraSensor);
+          continue;
+        }
+      }
       sensor::Observation obs;
       if (s.second->getObservation(*this, obs)) {
         observations[s.first] = obs;
       }
     }
+
+    std::vector<sensor::Observation> pendingObs(pending.size());
+    std::vector<std::future<void>> copies;
+    copies.reserve(pending.size());
+    for (size_t i = 0; i < pending.size(); ++i) {
+      sensor::VisualSensor* visualSensor = pending[i].second;
+      sensor::Observation* obs = &pendingObs[i];
+      if (!visualSensor->mapObservation(*obs)) {
+        continue;
+      }
+      copies.emplace_back(
+          std::async(std::launch::async, [visualSensor, obs]() {
+            visualSensor->copyMappedObservation(*obs);
+          }));
+    }
+    for (std::future<void>& copy : copies) {
+      copy.wait();
+    }
+    for (size_t i = 0; i < pending.size(); ++i) {
+      if (pendingObs[i].buffer != nullptr) {
+        pending[i].second->unmapObservation();
+        observations[*pending[i].first] = pendingObs[i];
+      }
+    }
+#else
+    for (const std::pair<const std::string, sensor::Sensor::ptr>& s : sensors) {
+      sensor::Observation obs;
+      if (s.second->getObservation(*this, obs)) {
+        observations[s.first] = obs;
+      }
+    }
+#endif
   }
   return observations.size();
 }
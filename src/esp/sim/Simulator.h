@@ -48,6 +48,19 @@ class Simulator {
   explicit Simulator(
       const SimulatorConfiguration& cfg,
       metadata::MetadataMediator::ptr _metadataMediator = nullptr);
+
+  /**
+   * @brief Constructs a simulator that shares its renderer and loaded assets
+   * with other simulators in the same process, see @ref BatchSimulator.
+   *
+   * A GL context has to be current already, the simulator doesn't create
+   * one. Light setups are stored in the shared @p resourceManager and so are
+   * common to all of them.
+   */
+  Simulator(const SimulatorConfiguration& cfg,
+            metadata::MetadataMediator::ptr _metadataMediator,
+            std::shared_ptr<gfx::Renderer> renderer,
+            std::shared_ptr<assets::ResourceManager> resourceManager);
   virtual ~Simulator();
 
   /**
@@ -583,6 +596,30 @@ class Simulator {
                                        float maxDistance = 100.0,
                                        int sceneID = 0);
 
+  /**
+   * @brief Raycast a batch of rays into the collision world of a scene and
+   * keep one hit per ray.
+   *
+   * Note: A default @ref physics::PhysicsManager has no collision world, so
+   * physics must be enabled for this feature. Without it no ray hits.
+   *
+   * @param rays The rays to cast. Need not be unit length, but returned hit
+   * distances will be in units of ray length.
+   * @param[out] results Reset to the size of @p rays and filled with the hit
+   * of every ray.
+   * @param maxDistance The maximum distance along the ray direction to search.
+   * In units of ray length.
+   * @param mode Whether to report the closest hit of a ray or any hit.
+   * @param sceneID !! Not used currently !! Specifies which physical scene of
+   * the object.
+   */
+  void castRays(Corrade::Containers::ArrayView<const esp::geo::Ray> rays,
+                esp::physics::RaycastBatchResults& results,
+                float maxDistance = 100.0,
+                esp::physics::RaycastMode mode =
+                    esp::physics::RaycastMode::Closest,
+                int sceneID = 0);
+
   /**
    * @brief the physical world has a notion of time which passes during
    * animation/simulation/action/etc... Step the physical world forward in time
@@ -628,6 +665,37 @@ class Simulator {
                         const nav::NavMeshSettings& navMeshSettings,
                         bool includeStaticObjects = false);
 
+  /**
+   * @brief Start updating the navmesh of the referenced @ref nav::PathFinder
+   * after STATIC objects were added, removed or moved.
+   *
+   * Only the navmesh tiles overlapping the old and new bounding boxes of the
+   * changed objects are rebuilt, in a background thread. The result is
+   * swapped in by @ref applyNavMeshUpdates. Changes are tracked relative to
+   * a pending update, if any, and otherwise to the navmesh of the last
+   * @ref recomputeNavMesh call or applied update, so an update that failed is
+   * redone. If there are further changes, a pending update is applied first,
+   * blocking until it is done.
+   *
+   * @param pathfinder The pathfinder object to update. Its navmesh must have
+   * been computed by @ref recomputeNavMesh with @ref
+   * nav::NavMeshSettings.tileSize > 0.
+   * @return Whether or not the update could be started. If not, use @ref
+   * recomputeNavMesh instead.
+   */
+  bool updateNavMeshAsync(nav::PathFinder& pathfinder);
+
+  /**
+   * @brief Swap a navmesh update started by @ref updateNavMeshAsync into the
+   * referenced @ref nav::PathFinder.
+   *
+   * @param pathfinder The pathfinder object to update.
+   * @param wait Whether to block until the update is done. Otherwise nothing
+   * happens if it is still running.
+   * @return Whether or not an update was applied.
+   */
+  bool applyNavMeshUpdates(nav::PathFinder& pathfinder, bool wait = false);
+
   /**
    * @brief Set visualization of the current NavMesh @ref pathfinder_ on or off.
    *
@@ -936,6 +1004,16 @@ class Simulator {
 
   void reconfigureReplayManager(bool enableGfxReplaySave);
 
+  /**
+   * @brief Join the collision geometry of the stage and optionally all STATIC
+   * objects into one mesh for navmesh computation.
+   * @param includeStaticObjects Whether to add the STATIC objects.
+   * @param staticObjectBounds [out] World space bounds of each added object.
+   */
+  assets::MeshData::uptr joinNavMeshGeometry(
+      bool includeStaticObjects,
+      std::map<int, std::pair<vec3f, vec3f>>& staticObjectBounds);
+
   gfx::WindowlessContext::uptr context_ = nullptr;
   std::shared_ptr<gfx::Renderer> renderer_ = nullptr;
   // CANNOT make the specification of resourceManager_ above the context_!
@@ -944,7 +1022,7 @@ class Simulator {
   // If you switch the order, you will have the error:
   // GL::Context::current(): no current context from Magnum
   // during the deconstruction
-  std::unique_ptr<assets::ResourceManager> resourceManager_ = nullptr;
+  std::shared_ptr<assets::ResourceManager> resourceManager_ = nullptr;
 
   /**
    * @brief Owns and manages the metadata/attributes managers
@@ -983,6 +1061,17 @@ class Simulator {
   int navMeshVisPrimID_ = esp::ID_UNDEFINED;
   esp::scene::SceneNode* navMeshVisNode_ = nullptr;
 
+  //! World space bounds of the STATIC objects baked into the navmesh by the
+  //! last recomputeNavMesh call or update applied by applyNavMeshUpdates
+  std::map<int, std::pair<vec3f, vec3f>> navMeshStaticObjectBounds_;
+
+  //! Bounds of the STATIC objects in the update started by the last
+  //! updateNavMeshAsync call. Committed to navMeshStaticObjectBounds_ once
+  //! the update is applied and dropped if it fails, so that failed updates
+  //! are retried by the next one.
+  Corrade::Containers::Optional<std::map<int, std::pair<vec3f, vec3f>>>
+      pendingNavMeshStaticObjectBounds_;
+
   //! Maps holding IDs and Names of trajectory visualizations
   std::map<std::string, int> trajVisIDByName;
   std::map<int, std::string> trajVisNameByID;
@@ -3,8 +3,11 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <gtest/gtest.h>
+#include <thread>
 
+#include "esp/core/BufferPool.h"
 #include "esp/core/Configuration.h"
+#include "esp/core/Profiler.h"
 #include "esp/core/esp.h"
 
 using namespace esp::core;
@@ -18,3 +21,102 @@ TEST(CoreTest, ConfigurationTest) {
   EXPECT_EQ(cfg.get<int>("myInt"), 10);
   EXPECT_EQ(cfg.get<std::string>("myString"), "test");
 }
+
+TEST(CoreTest, BufferPoolTest) {
+  BufferPool pool({4, 3}, DataType::DT_FLOAT, 2);
+  EXPECT_EQ(pool.size(), 2);
+  EXPECT_EQ(pool.numFree(), 2);
+
+  Buffer::ptr first = pool.acquire();
+  EXPECT_EQ(first->shape, (std::vector<size_t>{4, 3}));
+  EXPECT_EQ(first->data.size(), 4 * 3 * sizeof(float));
+  EXPECT_EQ(pool.numFree(), 1);
+
+  // a pinned buffer is never handed out again
+  Buffer::ptr second = pool.acquire();
+  EXPECT_NE(first, second);
+  Buffer::ptr third = pool.acquire();
+  EXPECT_NE(third, first);
+  EXPECT_NE(third, second);
+  EXPECT_EQ(pool.size(), 3);
+
+  // released buffers are reused in turn
+  const Buffer* released = first.get();
+  first = nullptr;
+  EXPECT_EQ(pool.numFree(), 1);
+  EXPECT_EQ(pool.acquire().get(), released);
+  EXPECT_EQ(pool.size(), 3);
+}
+
+TEST(CoreTest, ProfilerTest) {
+  Profiler::clear();
+  {
+    // disabled by default, records nothing
+    ESP_PROFILE_SCOPE("disabled");
+  }
+  EXPECT_TRUE(Profiler::events().empty());
+
+  Profiler::setEnabled(true);
+  for (int i = 0; i != 3; ++i) {
+    ESP_PROFILE_SCOPE("outer");
+    ESP_PROFILE_SCOPE("inner");
+  }
+  std::thread worker{[] {
+    ESP_PROFILE_SCOPE("worker");
+    Profiler::record(Profiler::internName("runtime"), 0, 2000000);
+  }};
+  worker.join();
+  Profiler::setEnabled(false);
+
+  std::vector<Profiler::Stats> stats = Profiler::stats();
+  ASSERT_EQ(stats.size(), 4);
+  // most total time first
+  EXPECT_EQ(stats[0].name, "runtime");
+  EXPECT_EQ(stats[0].count, 1);
+  EXPECT_DOUBLE_EQ(stats[0].totalMs, 2.0);
+  for (const Profiler::Stats& s : stats) {
+    if (s.name == "outer" || s.name == "inner") {
+      EXPECT_EQ(s.count, 3);
+    }
+    EXPECT_LE(s.minMs, s.meanMs);
+    EXPECT_LE(s.meanMs, s.maxMs);
+  }
+
+  const std::string trace = Profiler::chromeTrace();
+  EXPECT_NE(trace.find("\"name\":\"worker\""), std::string::npos);
+  EXPECT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+
+  // only the most recent events are kept
+  Profiler::setCapacity(2);
+  Profiler::setEnabled(true);
+  for (int i = 0; i != 5; ++i) {
+    ESP_PROFILE_SCOPE("ring");
+  }
+  Profiler::setEnabled(false);
+  EXPECT_EQ(Profiler::events().size(), 2);
+
+  Profiler::setCapacity(1 << 16);
+  EXPECT_TRUE(Profiler::events().empty());
+}
+
+TEST(CoreTest, ProfilerShortLivedThreadsTest) {
+  Profiler::clear();
+  Profiler::setEnabled(true);
+  const std::size_t numBuffers = Profiler::numThreadBuffers();
+  // threads exiting hand their ring to the next ones instead of each
+  // keeping one alive
+  for (int i = 0; i != 100; ++i) {
+    std::thread first{[] { ESP_PROFILE_SCOPE("shortLived"); }};
+    std::thread second{[] { ESP_PROFILE_SCOPE("shortLived"); }};
+    first.join();
+    second.join();
+  }
+  Profiler::setEnabled(false);
+  EXPECT_LE(Profiler::numThreadBuffers(), numBuffers + 2);
+
+  std::vector<Profiler::Stats> stats = Profiler::stats();
+  ASSERT_EQ(stats.size(), 1);
+  EXPECT_EQ(stats[0].count, 200);
+
+  Profiler::clear();
+}
@@ -12,9 +12,11 @@
 #include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/Range.h>
 #include <gtest/gtest.h>
+#include <random>
 #include <string>
 
 #include "esp/assets/ResourceManager.h"
+#include "esp/gfx/FrustumCulling.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/WindowlessContext.h"
@@ -43,8 +45,19 @@ struct CullingTest : Cr::TestSuite::Tester {
   // tests
   void computeAbsoluteAABB();
   void frustumCulling();
+  void cullAABBs();
+
+  // benchmarks
+  void benchmarkRangeFrustum();
+  void benchmarkCullAABBs();
+  void benchmarkCullAABBsThreaded();
 
  protected:
+  // fills aabbs_ and frustum_ with many boxes, few of them visible
+  void setupBoxes();
+
+  Mn::Frustum frustum_;
+  std::vector<Mn::Range3D> aabbs_;
   esp::gfx::WindowlessContext::uptr context_ = nullptr;
   std::unique_ptr<ResourceManager> resourceManager_ = nullptr;
   SceneManager::uptr sceneManager_ = nullptr;
@@ -53,7 +66,11 @@ struct CullingTest : Cr::TestSuite::Tester {
 CullingTest::CullingTest() {
   // clang-format off
   addTests({&CullingTest::computeAbsoluteAABB,
-            &CullingTest::frustumCulling});
+            &CullingTest::frustumCulling,
+            &CullingTest::cullAABBs});
+  addBenchmarks({&CullingTest::benchmarkRangeFrustum,
+                 &CullingTest::benchmarkCullAABBs,
+                 &CullingTest::benchmarkCullAABBsThreaded}, 10);
   // clang-format on
 }
 
@@ -270,6 +287,151 @@ void CullingTest::frustumCulling() {
                       FrustumCulling} /* enable frustum culling */);
   target->renderExit();
   CORRADE_COMPARE(numVisibleObjects, numVisibleObjectsGroundTruth);
+
+  // ============== Test 4 ==================
+  // cull once and draw the visible list with another camera sharing the pose
+  // and projection, as done for co-located sensors
+  esp::gfx::RenderCamera& otherCamera =
+      *(new esp::gfx::RenderCamera(cameraNode));
+  otherCamera.setProjectionMatrix(frameBufferSize.x(), frameBufferSize.y(),
+                                  0.01f, 100.0f, 39.6_degf);
+  CORRADE_COMPARE(otherCamera.cameraMatrix(), renderCamera.cameraMatrix());
+
+  esp::gfx::RenderCamera::DrawableTransforms visibleDrawables =
+      renderCamera.visibleDrawables(
+          drawables, {esp::gfx::RenderCamera::Flag::FrustumCulling});
+  CORRADE_COMPARE(visibleDrawables.size(), numVisibleObjectsGroundTruth);
+
+  target->renderEnter();
+  Mn::GL::SampleQuery q{Mn::GL::SampleQuery::Target::AnySamplesPassed};
+  q.begin();
+  numVisibleObjects = otherCamera.draw(visibleDrawables);
+  q.end();
+  target->renderExit();
+  CORRADE_VERIFY(q.result<bool>());
+  CORRADE_COMPARE(numVisibleObjects, numVisibleObjectsGroundTruth);
+  CORRADE_COMPARE(otherCamera.getPreviousNumVisibleDrawables(),
+                  numVisibleObjectsGroundTruth);
+}
+
+void CullingTest::setupBoxes() {
+  if (!aabbs_.empty()) {
+    return;
+  }
+  // a camera in the middle of a cluttered scene, looking down -Z
+  frustum_ = Mn::Frustum::fromMatrix(
+      Mn::Matrix4::perspectiveProjection(90.0_degf, 4.0f / 3.0f, 0.01f,
+                                         100.0f) *
+      Mn::Matrix4::lookAt({0.5f, 1.5f, 0.0f}, {0.5f, 1.5f, -1.0f},
+                          Mn::Vector3::yAxis())
+          .inverted());
+
+  // fixed seed, so the benchmarks are comparable between runs
+  std::mt19937 rng{0};
+  std::uniform_real_distribution<float> position{-50.0f, 50.0f};
+  std::uniform_real_distribution<float> size{0.05f, 2.0f};
+  aabbs_.clear();
+  for (int i = 0; i != 100000; ++i) {
+    const Mn::Vector3 min{position(rng), position(rng), position(rng)};
+    const Mn::Vector3 extent{size(rng), size(rng), size(rng)};
+    aabbs_.emplace_back(min, min + extent);
+  }
+}
+
+void CullingTest::cullAABBs() {
+  setupBoxes();
+
+  esp::gfx::AABBArrays arrays;
+  arrays.resize(aabbs_.size());
+  std::vector<Mn::UnsignedByte> planeIndices(aabbs_.size());
+  std::vector<int> expectedPlaneIndices(aabbs_.size());
+  for (size_t i = 0; i != aabbs_.size(); ++i) {
+    arrays.set(i, aabbs_[i]);
+    planeIndices[i] = expectedPlaneIndices[i] = i % 6;
+  }
+  std::vector<Mn::UnsignedByte> visible(aabbs_.size());
+
+  // the second round starts from the planes the first one reported
+  for (int round = 0; round != 2; ++round) {
+    CORRADE_ITERATION(round);
+    const size_t numVisible = esp::gfx::cullAABBs(
+        frustum_, arrays, {planeIndices.data(), planeIndices.size()},
+        {visible.data(), visible.size()});
+
+    size_t expectedNumVisible = 0;
+    for (size_t i = 0; i != aabbs_.size(); ++i) {
+      Cr::Containers::Optional<int> culledPlane = esp::gfx::rangeFrustum(
+          aabbs_[i], frustum_, expectedPlaneIndices[i]);
+      if (culledPlane) {
+        expectedPlaneIndices[i] = *culledPlane;
+      } else {
+        ++expectedNumVisible;
+      }
+      if (bool(visible[i]) == bool(culledPlane) ||
+          planeIndices[i] != expectedPlaneIndices[i]) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(bool(visible[i]), !culledPlane);
+        CORRADE_COMPARE(int(planeIndices[i]), expectedPlaneIndices[i]);
+      }
+    }
+    CORRADE_VERIFY(numVisible > 0);
+    CORRADE_VERIFY(numVisible < aabbs_.size() / 2);
+    CORRADE_COMPARE(numVisible, expectedNumVisible);
+  }
+}
+
+void CullingTest::benchmarkRangeFrustum() {
+  setupBoxes();
+  std::vector<int> planeIndices(aabbs_.size());
+  size_t numVisible = 0;
+  CORRADE_BENCHMARK(1) {
+    for (size_t i = 0; i != aabbs_.size(); ++i) {
+      Cr::Containers::Optional<int> culledPlane =
+          esp::gfx::rangeFrustum(aabbs_[i], frustum_, planeIndices[i]);
+      if (culledPlane) {
+        planeIndices[i] = *culledPlane;
+      } else {
+        ++numVisible;
+      }
+    }
+  }
+  CORRADE_VERIFY(numVisible > 0);
+}
+
+void CullingTest::benchmarkCullAABBs() {
+  setupBoxes();
+  esp::gfx::AABBArrays arrays;
+  arrays.resize(aabbs_.size());
+  for (size_t i = 0; i != aabbs_.size(); ++i) {
+    arrays.set(i, aabbs_[i]);
+  }
+  std::vector<Mn::UnsignedByte> planeIndices(aabbs_.size());
+  std::vector<Mn::UnsignedByte> visible(aabbs_.size());
+  size_t numVisible = 0;
+  CORRADE_BENCHMARK(1) {
+    numVisible += esp::gfx::cullAABBs(
+        frustum_, arrays, {planeIndices.data(), planeIndices.size()},
+        {visible.data(), visible.size()}, 1);
+  }
+  CORRADE_VERIFY(numVisible > 0);
+}
+
+void CullingTest::benchmarkCullAABBsThreaded() {
+  setupBoxes();
+  esp::gfx::AABBArrays arrays;
+  arrays.resize(aabbs_.size());
+  for (size_t i = 0; i != aabbs_.size(); ++i) {
+    arrays.set(i, aabbs_[i]);
+  }
+  std::vector<Mn::UnsignedByte> planeIndices(aabbs_.size());
+  std::vector<Mn::UnsignedByte> visible(aabbs_.size());
+  size_t numVisible = 0;
+  CORRADE_BENCHMARK(1) {
+    numVisible += esp::gfx::cullAABBs(
+        frustum_, arrays, {planeIndices.data(), planeIndices.size()},
+        {visible.data(), visible.size()});
+  }
+  CORRADE_VERIFY(numVisible > 0);
 }
 }  // namespace
 }  // namespace Test
@@ -8,6 +8,7 @@
 #include "esp/assets/ResourceManager.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/gfx/WindowlessContext.h"
+#include "esp/gfx/replay/KeyframeStream.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/gfx/replay/Recorder.h"
 #include "esp/gfx/replay/ReplayManager.h"
@@ -20,7 +21,9 @@
 #include <Magnum/Math/Range.h>
 
 #include <gtest/gtest.h>
+#include <chrono>
 #include <fstream>
+#include <numeric>
 #include <string>
 
 namespace Cr = Corrade;
@@ -120,6 +123,91 @@ TEST(GfxReplayTest, recorder) {
   ASSERT(keyframes[2].userTransforms.count("my_user_transform"));
   ASSERT(keyframes[2].userTransforms.at("my_user_transform").translation ==
          Mn::Vector3(4.f, 5.f, 6.f));
+
+  // with a snapshot every 2 keyframes, keyframes #0 and #2 hold the full
+  // scene
+  esp::gfx::replay::Recorder snapshotRecorder;
+  snapshotRecorder.setSnapshotInterval(2);
+  node = resourceManager.loadAndCreateRenderAssetInstance(
+      info, creation, &sceneManager_, tempIDs);
+  ASSERT(node);
+  snapshotRecorder.onLoadRenderAsset(info);
+  snapshotRecorder.onCreateRenderAssetInstance(node, creation);
+  for (int i = 0; i < 3; ++i) {
+    node->setTranslation(Mn::Vector3(float(i), 0.f, 0.f));
+    snapshotRecorder.saveKeyframe();
+  }
+  const auto& snapshotKeyframes = snapshotRecorder.debugGetSavedKeyframes();
+  ASSERT_EQ(snapshotKeyframes.size(), 3u);
+  EXPECT_TRUE(snapshotKeyframes[0].isSnapshot);
+  EXPECT_FALSE(snapshotKeyframes[1].isSnapshot);
+  EXPECT_TRUE(snapshotKeyframes[2].isSnapshot);
+  EXPECT_EQ(snapshotKeyframes[2].loads.size(), 1u);
+  EXPECT_EQ(snapshotKeyframes[2].creations.size(), 1u);
+  ASSERT_EQ(snapshotKeyframes[2].stateUpdates.size(), 1u);
+  EXPECT_EQ(
+      snapshotKeyframes[2].stateUpdates[0].second.absTransform.translation,
+      Mn::Vector3(2.f, 0.f, 0.f));
+  delete node;
+}
+
+// measure the recording overhead per keyframe with many instances, few of
+// them moving, and of deleting them all
+TEST(GfxReplayTest, recorderBenchmark) {
+  using Clock = std::chrono::steady_clock;
+  constexpr int numInstances = 10000;
+  constexpr int numMoving = 100;
+  constexpr int numKeyframes = 100;
+
+  esp::scene::SceneGraph sceneGraph;
+  auto& rootNode = sceneGraph.getRootNode();
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Corrade::Containers::NullOpt,
+      esp::assets::RenderAssetInstanceCreationInfo::Flags{}, "");
+
+  esp::gfx::replay::Recorder recorder;
+  std::vector<esp::scene::SceneNode*> nodes;
+  for (int i = 0; i < numInstances; ++i) {
+    auto& node = rootNode.createChild();
+    node.setTranslation(Mn::Vector3(float(i % 100), 0.f, float(i / 100)));
+    recorder.onCreateRenderAssetInstance(&node, creation);
+    nodes.push_back(&node);
+  }
+  recorder.saveKeyframe();
+
+  auto start = Clock::now();
+  for (int k = 0; k < numKeyframes; ++k) {
+    for (int i = 0; i < numMoving; ++i) {
+      nodes[(k * numMoving + i) % numInstances]->translate(
+          Mn::Vector3(0.f, 0.01f, 0.f));
+    }
+    recorder.saveKeyframe();
+  }
+  const double saveMs =
+      std::chrono::duration<double, std::milli>(Clock::now() - start)
+          .count() /
+      numKeyframes;
+
+  // only the moved instances got state updates
+  const auto& keyframes = recorder.debugGetSavedKeyframes();
+  ASSERT_EQ(keyframes.size(), std::size_t(numKeyframes + 1));
+  EXPECT_EQ(keyframes.front().stateUpdates.size(), std::size_t(numInstances));
+  EXPECT_EQ(keyframes.back().stateUpdates.size(), std::size_t(numMoving));
+
+  start = Clock::now();
+  for (auto* node : nodes) {
+    delete node;
+  }
+  const double deleteMs =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  recorder.saveKeyframe();
+  EXPECT_EQ(recorder.debugGetSavedKeyframes().back().deletions.size(),
+            std::size_t(numInstances));
+
+  LOG(INFO) << "GfxReplayTest::recorderBenchmark: " << numInstances
+            << " instances, " << numMoving << " moving per keyframe: "
+            << saveMs << " ms per saveKeyframe, " << deleteMs
+            << " ms to delete all";
 }
 
 // construct some render keyframes and play them using replay::Player
@@ -276,6 +364,104 @@ TEST(GfxReplayTest, player) {
   }
 }
 
+// seek back and forth through keyframes using built and recorded snapshots
+TEST(GfxReplayTest, playerSnapshots) {
+  using esp::gfx::replay::Keyframe;
+  using esp::gfx::replay::RenderAssetInstanceState;
+
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  auto cfg = esp::sim::SimulatorConfiguration{};
+  auto MM = MetadataMediator::create(cfg);
+  // must declare these in this order due to avoid deallocation errors
+  ResourceManager resourceManager(MM);
+  SceneManager sceneManager_;
+  std::string boxFile =
+      Cr::Utility::Directory::join(TEST_ASSETS, "objects/transform_box.glb");
+
+  int sceneID = sceneManager_.initSceneGraph();
+  auto& sceneGraph = sceneManager_.getSceneGraph(sceneID);
+  auto& rootNode = sceneGraph.getRootNode();
+  int numberOfChildren = getNumberOfChildrenOfRoot(rootNode);
+
+  int numCreated = 0;
+  auto callback =
+      [&](const esp::assets::AssetInfo& assetInfo,
+          const esp::assets::RenderAssetInstanceCreationInfo& creation) {
+        std::vector<int> tempIDs{sceneID, esp::ID_UNDEFINED};
+        ++numCreated;
+        return resourceManager.loadAndCreateRenderAssetInstance(
+            assetInfo, creation, &sceneManager_, tempIDs);
+      };
+  esp::gfx::replay::Player player(callback);
+  player.setSnapshotInterval(4);
+
+  esp::assets::AssetInfo info = esp::assets::AssetInfo::fromPath(boxFile);
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      boxFile, Corrade::Containers::NullOpt,
+      esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD, "");
+
+  // instance 0 lives throughout and moves every keyframe, instance 1 lives
+  // from keyframe 5 to 9, keyframe 12 is a recorded snapshot
+  auto stateAt = [](int k) {
+    return RenderAssetInstanceState{
+        {Mn::Vector3(float(k), 0.f, 0.f),
+         Mn::Quaternion(Mn::Math::IdentityInit)},
+        k};
+  };
+  const int numKeyframes = 16;
+  std::vector<Keyframe> keyframes(numKeyframes);
+  keyframes[0].loads.push_back(info);
+  keyframes[0].creations.emplace_back(0, creation);
+  keyframes[5].creations.emplace_back(1, creation);
+  keyframes[10].deletions.push_back(1);
+  for (int k = 0; k < numKeyframes; ++k) {
+    keyframes[k].stateUpdates.emplace_back(0, stateAt(k));
+    if (k >= 5 && k < 10) {
+      keyframes[k].stateUpdates.emplace_back(1, stateAt(k));
+    }
+  }
+  keyframes[12].isSnapshot = true;
+  keyframes[12].loads.push_back(info);
+  keyframes[12].creations.emplace_back(0, creation);
+  player.debugSetKeyframes(std::move(keyframes));
+
+  auto expectFrame = [&](int k) {
+    const int numInstances = k >= 5 && k < 10 ? 2 : 1;
+    EXPECT_EQ(getNumberOfChildrenOfRoot(rootNode),
+              numberOfChildren + numInstances);
+    const auto* child = rootNode.children().first();
+    for (int i = 0; i < numberOfChildren; ++i) {
+      child = child->nextSibling();
+    }
+    for (; child; child = child->nextSibling()) {
+      const auto* node = static_cast<const esp::scene::SceneNode*>(child);
+      EXPECT_EQ(node->translation(), Mn::Vector3(float(k), 0.f, 0.f));
+      EXPECT_EQ(node->getSemanticId(), k);
+    }
+  };
+
+  for (int k = 0; k < numKeyframes; ++k) {
+    player.setKeyframeIndex(k);
+    expectFrame(k);
+  }
+  EXPECT_EQ(numCreated, 2);
+
+  // instance 0 survives all seeks and is never re-created, instance 1 is
+  // re-created when seeking from outside its lifetime to 11, 6, 8 and 7
+  for (const int k : {13, 1, 11, 6, 3, 15, 8, 9, 12, 0, 7}) {
+    player.setKeyframeIndex(k);
+    expectFrame(k);
+  }
+  EXPECT_EQ(numCreated, 6);
+
+  player.setKeyframeIndex(-1);
+  EXPECT_EQ(getNumberOfChildrenOfRoot(rootNode), numberOfChildren);
+}
+
 TEST(GfxReplayTest, playerReadMissingFile) {
   auto dummyCallback =
       [&](const esp::assets::AssetInfo& assetInfo,
@@ -315,6 +501,131 @@ TEST(GfxReplayTest, playerReadInvalidFile) {
   }
 }
 
+// write keyframes to a binary stream and read them back in and out of order
+TEST(GfxReplayTest, keyframeStream) {
+  using esp::gfx::replay::Keyframe;
+  using esp::gfx::replay::KeyframeStreamFormat;
+  using esp::gfx::replay::KeyframeStreamReader;
+  using esp::gfx::replay::KeyframeStreamWriter;
+  using esp::gfx::replay::RenderAssetInstanceState;
+  using esp::gfx::replay::Transform;
+
+  auto testFilepath =
+      Corrade::Utility::Directory::join(DATA_DIR, "./gfx_replay_test.bin");
+
+  esp::assets::AssetInfo assetInfo;
+  assetInfo.filepath = "box.glb";
+  assetInfo.virtualUnitToMeters = 2.0f;
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Mn::Vector3{1.f, 2.f, 3.f},
+      esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD,
+      "lights");
+
+  const int numKeyframes = 21;
+  const int numInstances = 5;
+  std::vector<Keyframe> keyframes(numKeyframes);
+  keyframes[0].loads.push_back(assetInfo);
+  for (int i = 0; i < numInstances; ++i) {
+    keyframes[0].creations.emplace_back(i, creation);
+  }
+  keyframes[10].deletions.push_back(3);
+  for (int k = 0; k < numKeyframes; ++k) {
+    for (int i = 0; i < numInstances; ++i) {
+      // instance i moves every i-th keyframe, 3 is deleted at keyframe 10
+      if ((i == 3 && k >= 10) || (k > 0 && i > 0 && k % (i + 1))) {
+        continue;
+      }
+      Transform transform{
+          Mn::Vector3{0.1f * k, -2.5f * i, 1000.0f + 0.01f * k * i},
+          Mn::Quaternion::rotation(Mn::Deg(15.0f * k + 40.0f * i),
+                                   Mn::Vector3{1.f, -2.f, 0.5f}.normalized())};
+      keyframes[k].stateUpdates.emplace_back(
+          i, RenderAssetInstanceState{transform, k % 3 ? i : -1});
+    }
+    keyframes[k].userTransforms["agent"] =
+        Transform{Mn::Vector3{0.123456f * k, 1.f, 2.f}, Mn::Quaternion{}};
+  }
+
+  KeyframeStreamFormat format;
+  format.intraInterval = 4;
+  {
+    KeyframeStreamWriter writer(testFilepath, format);
+    ASSERT_TRUE(writer.isOpen());
+    for (const auto& keyframe : keyframes) {
+      writer.writeKeyframe(keyframe);
+    }
+
+    // readable before the index is written, up to the last keyframe
+    KeyframeStreamReader unclosedReader(testFilepath);
+    ASSERT_TRUE(unclosedReader.isOpen());
+    EXPECT_EQ(unclosedReader.getNumKeyframes(), numKeyframes);
+    Keyframe keyframe;
+    EXPECT_TRUE(unclosedReader.readKeyframe(numKeyframes - 1, keyframe));
+  }
+
+  EXPECT_TRUE(KeyframeStreamReader::isKeyframeStream(testFilepath));
+  KeyframeStreamReader reader(testFilepath);
+  ASSERT_TRUE(reader.isOpen());
+  ASSERT_EQ(reader.getNumKeyframes(), numKeyframes);
+  EXPECT_EQ(reader.format().intraInterval, 4u);
+
+  // in order, then seeking back and forth across intra keyframes
+  std::vector<int> order(numKeyframes);
+  std::iota(order.begin(), order.end(), 0);
+  order.insert(order.end(), {17, 2, 9, 9, 20, 0, 13, 14, 5});
+  for (const int k : order) {
+    Keyframe keyframe;
+    ASSERT_TRUE(reader.readKeyframe(k, keyframe));
+    const auto& expected = keyframes[k];
+
+    ASSERT_EQ(keyframe.loads.size(), expected.loads.size());
+    for (std::size_t i = 0; i < expected.loads.size(); ++i) {
+      EXPECT_EQ(keyframe.loads[i].filepath, expected.loads[i].filepath);
+      EXPECT_EQ(keyframe.loads[i].virtualUnitToMeters,
+                expected.loads[i].virtualUnitToMeters);
+    }
+    ASSERT_EQ(keyframe.creations.size(), expected.creations.size());
+    for (std::size_t i = 0; i < expected.creations.size(); ++i) {
+      EXPECT_EQ(keyframe.creations[i].first, expected.creations[i].first);
+      EXPECT_EQ(keyframe.creations[i].second.filepath, creation.filepath);
+      EXPECT_EQ(*keyframe.creations[i].second.scale, *creation.scale);
+      EXPECT_EQ(keyframe.creations[i].second.flags, creation.flags);
+      EXPECT_EQ(keyframe.creations[i].second.lightSetupKey,
+                creation.lightSetupKey);
+    }
+    EXPECT_EQ(keyframe.deletions, expected.deletions);
+
+    ASSERT_EQ(keyframe.stateUpdates.size(), expected.stateUpdates.size());
+    for (std::size_t i = 0; i < expected.stateUpdates.size(); ++i) {
+      const auto& state = keyframe.stateUpdates[i].second;
+      const auto& expectedState = expected.stateUpdates[i].second;
+      EXPECT_EQ(keyframe.stateUpdates[i].first,
+                expected.stateUpdates[i].first);
+      EXPECT_EQ(state.semanticId, expectedState.semanticId);
+      const Mn::Vector3 translationError = Mn::Math::abs(
+          state.absTransform.translation -
+          expectedState.absTransform.translation);
+      EXPECT_LE(translationError.max(), format.translationPrecision);
+      // same rotation, up to the sign of the quaternion
+      const float cosHalfAngle = Mn::Math::dot(
+          state.absTransform.rotation, expectedState.absTransform.rotation);
+      EXPECT_GE(Mn::Math::abs(cosHalfAngle), 0.9999f);
+    }
+
+    ASSERT_EQ(keyframe.userTransforms.size(), 1u);
+    EXPECT_EQ(keyframe.userTransforms["agent"],
+              expected.userTransforms.at("agent"));
+  }
+
+  // remove file created for this test
+  bool success = Corrade::Utility::Directory::rm(testFilepath);
+  if (!success) {
+    LOG(WARNING) << "GfxReplayTest::keyframeStream : unable to remove "
+                    "temporary test file "
+                 << testFilepath;
+  }
+}
+
 // test recording and playback through the simulator interface
 TEST(GfxReplayTest, simulatorIntegration) {
   std::string boxFile =
@@ -356,3 +667,58 @@ TEST(GfxReplayTest, simulatorIntegration) {
                  << testFilepath;
   }
 }
+
+// test streaming to a binary file and playback through the simulator
+// interface
+TEST(GfxReplayTest, simulatorStreaming) {
+  std::string boxFile =
+      Cr::Utility::Directory::join(TEST_ASSETS, "objects/transform_box.glb");
+  auto testFilepath =
+      Corrade::Utility::Directory::join(DATA_DIR, "./gfx_replay_test.bin");
+
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = boxFile;
+  simConfig.enableGfxReplaySave = true;
+
+  auto sim = Simulator::create_unique(simConfig);
+  auto& sceneGraph = sim->getActiveSceneGraph();
+  auto& rootNode = sceneGraph.getRootNode();
+  auto prevNumberOfChildrenOfRoot = getNumberOfChildrenOfRoot(rootNode);
+
+  const auto recorder = sim->getGfxReplayManager()->getRecorder();
+  EXPECT_TRUE(recorder);
+  // keyframes saved before streaming starts are written first
+  recorder->saveKeyframe();
+  recorder->startStreamingKeyframesToFile(testFilepath);
+  EXPECT_TRUE(recorder->isStreamingKeyframes());
+  recorder->addUserTransformToKeyframe("camera", Mn::Vector3{1.f, 2.f, 3.f},
+                                       Mn::Quaternion{});
+  recorder->saveKeyframe();
+  EXPECT_TRUE(recorder->debugGetSavedKeyframes().empty());
+  recorder->stopStreamingKeyframes();
+  EXPECT_FALSE(recorder->isStreamingKeyframes());
+
+  auto player = sim->getGfxReplayManager()->readKeyframesFromFile(testFilepath);
+  EXPECT_TRUE(player);
+  EXPECT_EQ(player->getNumKeyframes(), 2);
+  player->setKeyframeIndex(1);
+  // second copy of box was loaded
+  EXPECT_EQ(getNumberOfChildrenOfRoot(rootNode),
+            prevNumberOfChildrenOfRoot + 1);
+  Mn::Vector3 userTranslation;
+  Mn::Quaternion userRotation;
+  EXPECT_TRUE(
+      player->getUserTransform("camera", &userTranslation, &userRotation));
+  EXPECT_EQ(userTranslation, Mn::Vector3(1.f, 2.f, 3.f));
+
+  player = nullptr;
+  EXPECT_EQ(getNumberOfChildrenOfRoot(rootNode), prevNumberOfChildrenOfRoot);
+
+  // remove file created for this test
+  bool success = Corrade::Utility::Directory::rm(testFilepath);
+  if (!success) {
+    LOG(WARNING) << "GfxReplayTest::simulatorStreaming : unable to remove "
+                    "temporary test file "
+                 << testFilepath;
+  }
+}
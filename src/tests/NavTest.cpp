@@ -4,6 +4,7 @@
 
 #include <Corrade/Utility/Directory.h>
 #include <gtest/gtest.h>
+#include <algorithm>
 
 #include "esp/assets/MeshData.h"
 #include "esp/core/esp.h"
@@ -106,6 +107,189 @@ TEST(NavTest, PathFinderTestCases) {
   CHECK_LE(std::abs(testPath.geodesicDistance -
                     (testPath.requestedStart - testPath.requestedEnd).norm()),
            0.001);
+  CHECK(!testPath.partial);
+}
+
+TEST(NavTest, PathFinderTestLongPaths) {
+  PathFinder pf;
+  pf.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh"));
+  pf.seed(0);
+
+  // Paths between the corners of the navmesh bounds cross most of the
+  // navmesh and must not be truncated by the path buffers
+  const std::pair<vec3f, vec3f> bounds = pf.bounds();
+  for (int i = 0; i < 100; ++i) {
+    ShortestPath path;
+    path.requestedStart = pf.snapPoint(bounds.first);
+    path.requestedEnd = pf.getRandomNavigablePoint();
+    if (pf.findPath(path)) {
+      EXPECT_FALSE(path.partial);
+      EXPECT_LT(path.geodesicDistance, std::numeric_limits<float>::infinity());
+      EXPECT_GE(path.points.size(), 2);
+    }
+    path.requestedStart = pf.snapPoint(bounds.second);
+    if (pf.findPath(path)) {
+      EXPECT_FALSE(path.partial);
+    }
+  }
+
+  // With limits too small to reach most ends, a multi-goal search takes the
+  // closest end it can reach completely over the truncated paths towards the
+  // others, and only falls back to a partial path if no end is reachable
+  pf.setPathSearchLimits(4, 8);
+  const vec3f start = pf.getRandomNavigablePoint();
+  std::vector<vec3f> reachableEnds, unreachableEnds;
+  float reachableDistance = std::numeric_limits<float>::infinity();
+  for (int i = 0; i < 100; ++i) {
+    ShortestPath path;
+    path.requestedStart = start;
+    path.requestedEnd = pf.getRandomNavigablePoint();
+    if (!pf.findPath(path))
+      continue;
+    if (path.partial) {
+      unreachableEnds.push_back(path.requestedEnd);
+    } else {
+      reachableEnds.push_back(path.requestedEnd);
+      reachableDistance = std::min(reachableDistance, path.geodesicDistance);
+    }
+  }
+  if (reachableEnds.empty()) {
+    ShortestPath path;
+    path.requestedStart = start;
+    // Jitter the point just enough so that it isn't exactly the same
+    path.requestedEnd = start + vec3f(0.01, 0.0, 0.01);
+    ASSERT_TRUE(pf.findPath(path));
+    ASSERT_FALSE(path.partial);
+    reachableEnds.push_back(path.requestedEnd);
+    reachableDistance = path.geodesicDistance;
+  }
+  ASSERT_FALSE(unreachableEnds.empty());
+
+  // partial is set for the chosen end, whichever order the ends are tried in
+  std::vector<vec3f> mixedEnds = unreachableEnds;
+  mixedEnds.insert(mixedEnds.end(), reachableEnds.begin(),
+                   reachableEnds.end());
+  for (int reversed = 0; reversed != 2; ++reversed) {
+    if (reversed)
+      std::reverse(mixedEnds.begin(), mixedEnds.end());
+    MultiGoalShortestPath path;
+    path.requestedStart = start;
+    path.setRequestedEnds(mixedEnds);
+    ASSERT_TRUE(pf.findPath(path));
+    EXPECT_FALSE(path.partial);
+    EXPECT_NEAR(path.geodesicDistance, reachableDistance, 1e-4);
+  }
+
+  MultiGoalShortestPath path;
+  path.requestedStart = start;
+  path.setRequestedEnds(unreachableEnds);
+  ASSERT_TRUE(pf.findPath(path));
+  EXPECT_TRUE(path.partial);
+  EXPECT_GE(path.points.size(), 2);
+  pf.setPathSearchLimits();
+}
+
+TEST(NavTest, PathFinderTestSearchLimits) {
+  PathFinder pf;
+  pf.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh"));
+  pf.seed(0);
+
+  // The longest of a few random paths
+  ShortestPath reference;
+  for (int i = 0; i < 20; ++i) {
+    ShortestPath path;
+    path.requestedStart = pf.getRandomNavigablePoint();
+    path.requestedEnd = pf.getRandomNavigablePoint();
+    if (pf.findPath(path) &&
+        path.geodesicDistance > reference.geodesicDistance)
+      reference = path;
+  }
+  ASSERT_GT(reference.points.size(), 2);
+  ASSERT_FALSE(reference.partial);
+
+  // Too few polygons and nodes to reach the end: the path gets as far as the
+  // search did
+  pf.setPathSearchLimits(4, 8);
+  ShortestPath path;
+  path.requestedStart = reference.requestedStart;
+  path.requestedEnd = reference.requestedEnd;
+  ASSERT_TRUE(pf.findPath(path));
+  EXPECT_TRUE(path.partial);
+  ASSERT_GE(path.points.size(), 2);
+  EXPECT_TRUE(path.points.front().isApprox(reference.points.front()));
+  EXPECT_FALSE(path.points.back().isApprox(reference.points.back()));
+  EXPECT_LT(path.geodesicDistance, reference.geodesicDistance);
+
+  // The buffers were shrunk to the limits above, so this only succeeds if
+  // they grow again
+  pf.setPathSearchLimits();
+  ASSERT_TRUE(pf.findPath(path));
+  EXPECT_FALSE(path.partial);
+  EXPECT_EQ(path.points.size(), reference.points.size());
+  EXPECT_NEAR(path.geodesicDistance, reference.geodesicDistance, 1e-4);
+}
+
+TEST(NavTest, PathFinderTopDownView) {
+  PathFinder pf;
+  pf.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh"));
+
+  constexpr float metersPerPixel = 0.1;
+  const std::pair<vec3f, vec3f> bounds = pf.bounds();
+  const float height = bounds.first[1];
+  const auto map = pf.getTopDownView(metersPerPixel, height);
+  ASSERT_GT(map.size(), 0);
+
+  Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> navigable(map.rows(),
+                                                                 map.cols());
+  for (int h = 0; h < map.rows(); ++h) {
+    for (int w = 0; w < map.cols(); ++w) {
+      const vec3f pt(bounds.first[0] + w * metersPerPixel, height,
+                     bounds.first[2] + h * metersPerPixel);
+      navigable(h, w) = pf.isNavigable(pt, 0.5);
+    }
+  }
+  EXPECT_GT(map.count(), 0);
+
+  // The rasterized map must agree exactly with isNavigable away from the
+  // navmesh boundary. Next to it the two may differ: isNavigable accepts
+  // points up to 1cm outside a polygon and snaps to the nearest polygon only,
+  // so a pixel whose 3x3 neighbourhood straddles the boundary in either map
+  // is an edge pixel and not checked.
+  int numEdge = 0;
+  for (int h = 0; h < map.rows(); ++h) {
+    for (int w = 0; w < map.cols(); ++w) {
+      const int h0 = std::max(h - 1, 0), w0 = std::max(w - 1, 0);
+      const int rows = std::min(h + 1, int(map.rows()) - 1) - h0 + 1;
+      const int cols = std::min(w + 1, int(map.cols()) - 1) - w0 + 1;
+      const auto mapBlock = map.block(h0, w0, rows, cols);
+      const auto navigableBlock = navigable.block(h0, w0, rows, cols);
+      if ((mapBlock.any() && !mapBlock.all()) ||
+          (navigableBlock.any() && !navigableBlock.all())) {
+        ++numEdge;
+        continue;
+      }
+      EXPECT_EQ(map(h, w), navigable(h, w)) << "at pixel " << h << "," << w;
+    }
+  }
+  EXPECT_LT(numEdge, map.size());
+
+  // Several slices in one pass give the same maps, and repeated queries are
+  // served from the cache
+  const auto maps =
+      pf.getTopDownViews(metersPerPixel, {height, height + 1.0f, height});
+  ASSERT_EQ(maps.size(), 3);
+  EXPECT_EQ(maps[0], map);
+  EXPECT_EQ(maps[2], map);
+  EXPECT_EQ(maps[1], pf.getTopDownView(metersPerPixel, height + 1.0f));
+
+  // Maps evicted from the bounded cache are rasterized again
+  for (int i = 0; i < 16; ++i) {
+    pf.getTopDownView(metersPerPixel, height + 0.1f * i);
+  }
+  EXPECT_EQ(pf.getTopDownView(metersPerPixel, height), map);
 }
 
 TEST(NavTest, PathFinderTestNonNavigable) {
@@ -147,6 +331,76 @@ TEST(NavTest, PathFinderTestSeed) {
   ASSERT_TRUE(firstPoint3 != secondPoint3);
 }
 
+TEST(NavTest, PathFinderSampleNavigablePoints) {
+  PathFinder pf;
+  pf.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh"));
+
+  constexpr int numPoints = 100000;
+  const std::vector<vec3f> pts = pf.sampleNavigablePoints(numPoints, 7);
+  ASSERT_EQ(pts.size(), numPoints);
+  for (const vec3f& pt : pts) {
+    ASSERT_TRUE(pf.isNavigable(pt));
+  }
+
+  // Only the seed decides the points, not the thread count or the global
+  // random state
+  pf.seed(123);
+  EXPECT_EQ(pf.sampleNavigablePoints(numPoints, 7, {}, 100, 1), pts);
+  EXPECT_NE(pf.sampleNavigablePoints(numPoints, 8), pts);
+
+
+  NavigablePointFilter filter;
+  filter.islandId = pf.islandId(pts[0]);
+  filter.minHeight = pts[0][1] - 0.5f;
+  filter.maxHeight = pts[0][1] + 0.5f;
+  filter.minObstacleDistance = 0.3f;
+  const std::vector<vec3f> filtered =
+      pf.sampleNavigablePoints(1000, 7, filter);
+  for (const vec3f& pt : filtered) {
+    ASSERT_FALSE(std::isnan(pt[0]));
+    EXPECT_EQ(pf.islandId(pt), filter.islandId);
+    EXPECT_GE(pt[1], filter.minHeight);
+    EXPECT_LE(pt[1], filter.maxHeight);
+    EXPECT_GE(pf.distanceToClosestObstacle(pt, 1.0), 0.3f - 1e-3f);
+  }
+
+  // Nothing passes an impossible filter
+  filter.minIslandRadius = 1e6;
+  for (const vec3f& pt : pf.sampleNavigablePoints(10, 7, filter)) {
+    EXPECT_TRUE(std::isnan(pt[0]));
+  }
+}
+
+TEST(NavTest, PathFinderSaveLoadIslands) {
+  const std::string oldFile = Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh");
+  const std::string newFile =
+      Cr::Utility::Directory::join(DATA_DIR, "nav_test_islands.navmesh");
+
+  // Files without the island section fall back to recomputing it
+  PathFinder oldPf;
+  ASSERT_TRUE(oldPf.loadNavMesh(oldFile));
+  ASSERT_TRUE(oldPf.saveNavMesh(newFile));
+
+  PathFinder newPf;
+  ASSERT_TRUE(newPf.loadNavMesh(newFile));
+
+  EXPECT_EQ(newPf.getNavigableArea(), oldPf.getNavigableArea());
+  const std::vector<vec3f> pts = oldPf.sampleNavigablePoints(1000, 0);
+  for (size_t i = 0; i < pts.size(); ++i) {
+    EXPECT_EQ(newPf.islandId(pts[i]), oldPf.islandId(pts[i]));
+    EXPECT_EQ(newPf.islandRadius(pts[i]), oldPf.islandRadius(pts[i]));
+
+    ShortestPath oldPath, newPath;
+    oldPath.requestedStart = newPath.requestedStart = pts[i];
+    oldPath.requestedEnd = newPath.requestedEnd = pts[(i + 1) % pts.size()];
+    EXPECT_EQ(newPf.findPath(newPath), oldPf.findPath(oldPath));
+    EXPECT_EQ(newPath.geodesicDistance, oldPath.geodesicDistance);
+  }
+  Cr::Utility::Directory::rm(newFile);
+}
+
 TEST(NavTest, PathFinderTestMeshData) {
   PathFinder pf;
   pf.loadNavMesh(Cr::Utility::Directory::join(
@@ -167,3 +421,232 @@ TEST(NavTest, PathFinderTestMeshData) {
   ASSERT_EQ(meshData->vbo.size(), 63);
   ASSERT_EQ(meshData->ibo.size(), 63);
 }
+
+TEST(NavTest, PathFinderTestTiledMeshData) {
+  PathFinder source;
+  source.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh"));
+  const esp::assets::MeshData::ptr sourceMesh = source.getNavMeshData();
+  ASSERT_TRUE(sourceMesh);
+
+  // A tiled navmesh has empty tile slots, which must be skipped
+  esp::nav::NavMeshSettings settings;
+  settings.tileSize = 64;
+  PathFinder pf;
+  ASSERT_TRUE(pf.build(settings, *sourceMesh));
+  const esp::assets::MeshData::ptr meshData = pf.getNavMeshData();
+  ASSERT_TRUE(meshData);
+  EXPECT_GT(meshData->vbo.size(), 0);
+  EXPECT_EQ(meshData->vbo.size() % 3, 0);
+  EXPECT_GT(pf.getNavigableArea(), 0);
+}
+
+TEST(NavTest, PathFinderBatchGeodesicDistances) {
+  PathFinder pf;
+  pf.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh"));
+  pf.seed(0);
+
+  constexpr int numQueries = 10000;
+  std::vector<vec3f> starts, ends;
+  for (int i = 0; i < numQueries; ++i) {
+    starts.emplace_back(pf.getRandomNavigablePoint());
+    ends.emplace_back(pf.getRandomNavigablePoint());
+  }
+
+  std::vector<float> serialDistances;
+  for (int i = 0; i < numQueries; ++i) {
+    ShortestPath path;
+    path.requestedStart = starts[i];
+    path.requestedEnd = ends[i];
+    pf.findPath(path);
+    serialDistances.push_back(path.geodesicDistance);
+  }
+
+  const std::vector<float> batchDistances = pf.geodesicDistances(starts, ends);
+
+  // Batched queries must match the serial ones exactly
+  ASSERT_EQ(batchDistances.size(), numQueries);
+  for (int i = 0; i < numQueries; ++i) {
+    ASSERT_EQ(batchDistances[i], serialDistances[i]);
+  }
+
+  // A single worker thread must also give identical results
+  std::vector<ShortestPath> paths(numQueries);
+  for (int i = 0; i < numQueries; ++i) {
+    paths[i].requestedStart = starts[i];
+    paths[i].requestedEnd = ends[i];
+  }
+  pf.findPaths(paths, 1);
+  for (int i = 0; i < numQueries; ++i) {
+    ASSERT_EQ(paths[i].geodesicDistance, serialDistances[i]);
+  }
+}
+
+TEST(NavTest, PathFinderBatchPointQueries) {
+  PathFinder pf;
+  pf.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh"));
+  pf.seed(0);
+
+  // Mostly points on the navmesh, like sampled episodes, plus some off it
+  constexpr int numQueries = 100000;
+  core::Random random(0);
+  const std::pair<vec3f, vec3f> bounds = pf.bounds();
+  std::vector<vec3f> pts;
+  for (int i = 0; i < numQueries; ++i) {
+    if (i % 10 == 0) {
+      pts.emplace_back(random.uniform_float(bounds.first[0], bounds.second[0]),
+                       random.uniform_float(bounds.first[1], bounds.second[1]),
+                       random.uniform_float(bounds.first[2], bounds.second[2]));
+    } else {
+      pts.emplace_back(pf.getRandomNavigablePoint() + vec3f(0, 0.1, 0));
+    }
+  }
+
+  std::vector<vec3f> serialSnapped;
+  std::vector<bool> serialNavigable;
+  for (const vec3f& pt : pts) {
+    serialSnapped.emplace_back(pf.snapPoint(pt));
+    serialNavigable.push_back(pf.isNavigable(pt));
+  }
+
+  const std::vector<vec3f> snapped = pf.snapPoints(pts);
+  const std::vector<bool> navigable = pf.isNavigableBatch(pts);
+
+  // Results may only differ where several polygons are equally close
+  ASSERT_EQ(snapped.size(), numQueries);
+  ASSERT_EQ(navigable.size(), numQueries);
+  int numMismatched = 0;
+  for (int i = 0; i < numQueries; ++i) {
+    numMismatched += navigable[i] != serialNavigable[i] ||
+                     std::isnan(snapped[i][0]) !=
+                         std::isnan(serialSnapped[i][0]) ||
+                     (!std::isnan(snapped[i][0]) &&
+                      !snapped[i].isApprox(serialSnapped[i], 1e-3));
+  }
+  EXPECT_LT(numMismatched, numQueries / 1000);
+
+  std::vector<vec3f> onMesh;
+  for (int i = 0; i < 1000; ++i) {
+    if (i % 10 != 0)
+      onMesh.push_back(pts[i]);
+  }
+  const std::vector<float> distances = pf.distancesToClosestObstacle(onMesh);
+  for (size_t i = 0; i < onMesh.size(); ++i) {
+    EXPECT_NEAR(distances[i], pf.distanceToClosestObstacle(onMesh[i]), 1e-3);
+  }
+}
+
+TEST(NavTest, PathFinderObstacleDistanceField) {
+  PathFinder pf;
+  pf.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh"));
+  pf.seed(0);
+
+  std::vector<vec3f> pts;
+  std::vector<float> exact;
+  for (int i = 0; i < 1000; ++i) {
+    pts.emplace_back(pf.getRandomNavigablePoint());
+    exact.push_back(pf.distanceToClosestObstacle(pts.back()));
+  }
+
+  ASSERT_TRUE(pf.buildObstacleDistanceField(0.05, 1.0));
+  ASSERT_TRUE(pf.hasObstacleDistanceField());
+
+  // Interpolation error is bounded by the grid spacing. Walls that the exact
+  // search can't reach through the navmesh may rarely make a difference.
+  // Points the field can't answer fall back to the exact search, for which
+  // the batch snaps points with its own index, so allow for float error.
+  const std::vector<float> batch = pf.distancesToClosestObstacle(pts);
+  int numMismatched = 0;
+  for (size_t i = 0; i < pts.size(); ++i) {
+    numMismatched +=
+        std::abs(pf.distanceToClosestObstacle(pts[i]) - exact[i]) > 0.1;
+    EXPECT_NEAR(batch[i], pf.distanceToClosestObstacle(pts[i]), 1e-4);
+  }
+  EXPECT_LT(numMismatched, pts.size() / 100);
+
+  const std::string fieldFile =
+      Cr::Utility::Directory::join(DATA_DIR, "nav_test_field.odf");
+  ASSERT_TRUE(pf.saveObstacleDistanceField(fieldFile));
+  pf.clearObstacleDistanceField();
+  EXPECT_FALSE(pf.hasObstacleDistanceField());
+  ASSERT_TRUE(pf.loadObstacleDistanceField(fieldFile));
+  for (size_t i = 0; i < pts.size(); ++i) {
+    EXPECT_NEAR(pf.distanceToClosestObstacle(pts[i]), batch[i], 1e-4);
+  }
+
+  // A fresh PathFinder that only ever loaded the field answers the same
+  PathFinder fresh;
+  fresh.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh"));
+  ASSERT_TRUE(fresh.loadObstacleDistanceField(fieldFile));
+  for (size_t i = 0; i < pts.size(); ++i) {
+    EXPECT_NEAR(fresh.distanceToClosestObstacle(pts[i]), batch[i], 1e-4);
+  }
+
+  // A field only fits the navmesh it was built for
+  PathFinder other;
+  other.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/van-gogh-room.navmesh"));
+  EXPECT_FALSE(other.loadObstacleDistanceField(fieldFile));
+  Cr::Utility::Directory::rm(fieldFile);
+}
+
+TEST(NavTest, PathFinderGeodesicDistanceField) {
+  PathFinder pf;
+  pf.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.navmesh"));
+  pf.seed(0);
+
+  const std::vector<vec3f> goals{pf.getRandomNavigablePoint(),
+                                 pf.getRandomNavigablePoint()};
+  const float spacing = 0.1f;
+  GeodesicDistanceField::ptr field =
+      pf.buildGeodesicDistanceField(goals, spacing);
+  ASSERT_TRUE(field);
+  ASSERT_GT(field->getNumNodes(), 0);
+
+  MultiGoalShortestPath path;
+  path.setRequestedEnds(goals);
+  for (int i = 0; i < 1000; ++i) {
+    path.requestedStart = pf.getRandomNavigablePoint();
+    const bool foundPath = pf.findPath(path);
+    const float fieldDistance =
+        pf.geodesicDistance(*field, path.requestedStart);
+    if (!foundPath) {
+      EXPECT_EQ(fieldDistance, std::numeric_limits<float>::infinity());
+      continue;
+    }
+    // Field paths are straight lines through the polygons, so they can't be
+    // shorter than the exact path, up to float error. Where the exact path
+    // crosses an edge between two samples, the field path goes through the
+    // closest sample instead, at most spacing / 2 to the side. That adds
+    // at most one spacing if both ends are right next to the edge, and only
+    // second order amounts on longer legs.
+    EXPECT_GE(fieldDistance, path.geodesicDistance - 1e-3);
+    EXPECT_LE(fieldDistance, 1.02 * path.geodesicDistance + spacing);
+  }
+
+  const std::string fieldFile =
+      Cr::Utility::Directory::join(DATA_DIR, "./nav_test_field.gdf");
+  ASSERT_TRUE(pf.saveGeodesicDistanceField(*field, fieldFile));
+  GeodesicDistanceField::ptr loadedField =
+      pf.loadGeodesicDistanceField(fieldFile);
+  ASSERT_TRUE(loadedField);
+  EXPECT_EQ(loadedField->getGoals(), goals);
+  for (int i = 0; i < 100; ++i) {
+    const vec3f pt = pf.getRandomNavigablePoint();
+    EXPECT_EQ(pf.geodesicDistance(*loadedField, pt),
+              pf.geodesicDistance(*field, pt));
+  }
+
+  // A field can't be loaded on top of a different navmesh
+  PathFinder otherPf;
+  otherPf.loadNavMesh(Cr::Utility::Directory::join(
+      SCENE_DATASETS, "habitat-test-scenes/van-gogh-room.navmesh"));
+  EXPECT_FALSE(otherPf.loadGeodesicDistanceField(fieldFile));
+
+  Cr::Utility::Directory::rm(fieldFile);
+}
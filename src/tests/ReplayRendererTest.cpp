@@ -0,0 +1,243 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "configure.h"
+
+#include "utils/replayrenderer/ReplayRenderer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/PixelFormat.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+using esp::gfx::replay::CameraSpec;
+using esp::gfx::replay::CameraType;
+using esp::gfx::replay::DiskFrameSink;
+using esp::gfx::replay::RenderedFrame;
+using esp::gfx::replay::SharedMemoryFrameRing;
+
+namespace {
+
+// Writes json to a file in DATA_DIR and loads the camera specs from it
+bool loadCameraSpecsFromString(const std::string& json,
+                               std::vector<CameraSpec>& cameras) {
+  const std::string filepath =
+      Cr::Utility::Directory::join(DATA_DIR, "replay_renderer_test.json");
+  {
+    std::ofstream out(filepath);
+    out << json;
+  }
+  const bool loaded = esp::gfx::replay::loadCameraSpecs(filepath, cameras);
+  Cr::Utility::Directory::rm(filepath);
+  return loaded;
+}
+
+}  // namespace
+
+TEST(ReplayRendererTest, npyHeader) {
+  const std::string header =
+      esp::gfx::replay::npyHeader(CameraType::Color, {640, 480});
+  ASSERT_GT(header.size(), 10);
+  EXPECT_EQ(header.substr(0, 6), "\x93NUMPY");
+  // version 1.0
+  EXPECT_EQ(header[6], 1);
+  EXPECT_EQ(header[7], 0);
+  // little-endian length of the dict following the preamble
+  const std::size_t dictSize = std::uint8_t(header[8]) |
+                               std::size_t(std::uint8_t(header[9])) << 8;
+  EXPECT_EQ(dictSize, header.size() - 10);
+  // the pixels start 64-byte aligned
+  EXPECT_EQ(header.size() % 64, 0);
+  EXPECT_EQ(header.back(), '\n');
+  EXPECT_NE(header.find("'descr': '|u1'"), std::string::npos);
+  EXPECT_NE(header.find("'fortran_order': False"), std::string::npos);
+  EXPECT_NE(header.find("'shape': (480, 640, 4)"), std::string::npos);
+
+  const std::string depthHeader =
+      esp::gfx::replay::npyHeader(CameraType::Depth, {32, 16});
+  EXPECT_EQ(depthHeader.size() % 64, 0);
+  EXPECT_NE(depthHeader.find("'descr': '<f4'"), std::string::npos);
+  EXPECT_NE(depthHeader.find("'shape': (16, 32)"), std::string::npos);
+
+  const std::string semanticHeader =
+      esp::gfx::replay::npyHeader(CameraType::Semantic, {32, 16});
+  EXPECT_EQ(semanticHeader.size() % 64, 0);
+  EXPECT_NE(semanticHeader.find("'descr': '<u4'"), std::string::npos);
+  EXPECT_NE(semanticHeader.find("'shape': (16, 32)"), std::string::npos);
+}
+
+TEST(ReplayRendererTest, loadCameraSpecs) {
+  std::vector<CameraSpec> cameras;
+  ASSERT_TRUE(loadCameraSpecsFromString(
+      R"({"cameras": [{"uuid": "rgb"},
+                      {"uuid": "depth", "type": "depth", "width": 32,
+                       "height": 16, "hfov": 60, "near": 0.1, "far": 10,
+                       "user_transform": "agent", "position": [0, 1.5, 0],
+                       "orientation": [1, 0, 0, 0]}]})",
+      cameras));
+  ASSERT_EQ(cameras.size(), 2);
+  EXPECT_EQ(cameras[0].uuid, "rgb");
+  EXPECT_EQ(cameras[0].type, CameraType::Color);
+  EXPECT_EQ(cameras[0].resolution, Mn::Vector2i(640, 480));
+  EXPECT_EQ(cameras[1].type, CameraType::Depth);
+  EXPECT_EQ(cameras[1].resolution, Mn::Vector2i(32, 16));
+  EXPECT_EQ(float(cameras[1].hfov), 60.0f);
+  EXPECT_EQ(cameras[1].userTransform, "agent");
+  EXPECT_EQ(cameras[1].position, Mn::Vector3(0, 1.5f, 0));
+}
+
+TEST(ReplayRendererTest, loadCameraSpecsErrors) {
+  // a failed load leaves the cameras as they are
+  std::vector<CameraSpec> cameras(1);
+  cameras[0].uuid = "unchanged";
+
+  EXPECT_FALSE(esp::gfx::replay::loadCameraSpecs(
+      Cr::Utility::Directory::join(DATA_DIR, "file_that_does_not_exist.json"),
+      cameras));
+  EXPECT_FALSE(loadCameraSpecsFromString(R"({"cameras": [)", cameras));
+  EXPECT_FALSE(loadCameraSpecsFromString(R"({})", cameras));
+  EXPECT_FALSE(loadCameraSpecsFromString(R"({"cameras": {}})", cameras));
+  EXPECT_FALSE(loadCameraSpecsFromString(R"({"cameras": [{"type": "color"}]})",
+                                         cameras));
+  EXPECT_FALSE(loadCameraSpecsFromString(R"({"cameras": [{"uuid": ""}]})",
+                                         cameras));
+  EXPECT_FALSE(loadCameraSpecsFromString(
+      R"({"cameras": [{"uuid": "ir", "type": "infrared"}]})", cameras));
+  EXPECT_FALSE(loadCameraSpecsFromString(
+      R"({"cameras": [{"uuid": "rgb", "width": 0}]})", cameras));
+  EXPECT_FALSE(loadCameraSpecsFromString(
+      R"({"cameras": [{"uuid": "rgb"}, {"uuid": "rgb"}]})", cameras));
+
+  ASSERT_EQ(cameras.size(), 1);
+  EXPECT_EQ(cameras[0].uuid, "unchanged");
+}
+
+TEST(ReplayRendererTest, diskFrameSink) {
+  namespace Directory = Cr::Utility::Directory;
+  const std::string outputDir =
+      Directory::join(DATA_DIR, "replay_renderer_test_frames");
+  CameraSpec camera;
+  camera.uuid = "depth";
+  camera.type = CameraType::Depth;
+  camera.resolution = {2, 2};
+
+  DiskFrameSink sink{outputDir};
+  ASSERT_TRUE(sink.start({"replay"}, {camera}));
+  const std::string cameraDir =
+      Directory::join(Directory::join(outputDir, "replay"), "depth");
+  EXPECT_TRUE(Directory::isDirectory(cameraDir));
+
+  const float pixels[4]{0.5f, 1.0f, 1.5f, 2.0f};
+  const Mn::ImageView2D image{Mn::PixelFormat::R32F, camera.resolution,
+                              Cr::Containers::arrayView(pixels)};
+  ASSERT_TRUE(sink.write(RenderedFrame{0, "replay", 3, 0, camera, image}));
+
+  const std::string filepath = Directory::join(cameraDir, "000003.npy");
+  const std::string header =
+      esp::gfx::replay::npyHeader(camera.type, camera.resolution);
+  const auto data = Directory::read(filepath);
+  ASSERT_EQ(data.size(), header.size() + sizeof(pixels));
+  EXPECT_EQ(std::string(data.data(), header.size()), header);
+
+  Directory::rm(filepath);
+  Directory::rm(cameraDir);
+  Directory::rm(Directory::join(outputDir, "replay"));
+  Directory::rm(outputDir);
+}
+
+TEST(ReplayRendererTest, sharedMemoryFrameRingWraparound) {
+  constexpr std::uint32_t numSlots = 2;
+  constexpr int numFrames = 7;
+  const std::string name = "/replay_renderer_test_" + std::to_string(getpid());
+  CameraSpec camera;
+  camera.uuid = "depth";
+  camera.type = CameraType::Depth;
+  camera.resolution = {2, 2};
+
+  SharedMemoryFrameRing ring{name, numSlots,
+                             esp::gfx::replay::frameSize(camera)};
+  ASSERT_TRUE(ring.isOpen());
+
+  // Map the ring again, as a consumer process would
+  const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  ASSERT_GE(fd, 0);
+  struct stat st {};
+  ASSERT_EQ(fstat(fd, &st), 0);
+  void* memory =
+      mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  shm_unlink(name.c_str());
+  ASSERT_NE(memory, MAP_FAILED);
+  auto* header = static_cast<SharedMemoryFrameRing::Header*>(memory);
+  EXPECT_EQ(std::string(header->magic), SharedMemoryFrameRing::Magic);
+  EXPECT_EQ(header->numSlots, numSlots);
+  const std::size_t headerSize =
+      (sizeof(SharedMemoryFrameRing::Header) + 63) / 64 * 64;
+
+  auto writeFrame = [&](int keyframeIndex) {
+    float pixels[4];
+    std::fill(pixels, pixels + 4, float(keyframeIndex));
+    const Mn::ImageView2D image{Mn::PixelFormat::R32F, camera.resolution,
+                                Cr::Containers::arrayView(pixels)};
+    return ring.write(RenderedFrame{0, "replay", keyframeIndex, 0, camera,
+                                    image});
+  };
+
+  // Fill the ring without consuming anything
+  for (int i = 0; i < int(numSlots); ++i) {
+    ASSERT_TRUE(writeFrame(i));
+  }
+  EXPECT_EQ(header->writeIndex.load(), numSlots);
+  EXPECT_EQ(header->readIndex.load(), 0);
+
+  // Further writes wait for the consumer to free slots, and every frame
+  // comes out in order after the slots wrap around
+  std::vector<float> consumed;
+  std::thread consumer{[&]() {
+    for (std::uint64_t n = 0; n < numFrames; ++n) {
+      char* slot = static_cast<char*>(memory) + headerSize +
+                   header->slotStride * (n % header->numSlots);
+      auto* slotHeader =
+          reinterpret_cast<SharedMemoryFrameRing::SlotHeader*>(slot);
+      while (slotHeader->sequence.load(std::memory_order_acquire) != n + 1) {
+        std::this_thread::yield();
+      }
+      EXPECT_EQ(slotHeader->keyframeIndex, int(n));
+      EXPECT_EQ(slotHeader->byteSize, 4 * sizeof(float));
+      const float* pixels = reinterpret_cast<const float*>(
+          slot + sizeof(SharedMemoryFrameRing::SlotHeader));
+      consumed.push_back(pixels[3]);
+      header->readIndex.store(n + 1, std::memory_order_release);
+    }
+  }};
+  for (int i = numSlots; i < numFrames; ++i) {
+    EXPECT_TRUE(writeFrame(i));
+  }
+  consumer.join();
+
+  ASSERT_EQ(consumed.size(), numFrames);
+  for (int i = 0; i < numFrames; ++i) {
+    EXPECT_EQ(consumed[i], float(i));
+  }
+  EXPECT_FALSE(header->isFinished.load());
+  ring.finish();
+  EXPECT_TRUE(header->isFinished.load());
+
+  munmap(memory, st.st_size);
+}
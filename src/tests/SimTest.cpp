@@ -3,6 +3,7 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/DebugTools/CompareImage.h>
@@ -13,6 +14,7 @@
 #include <string>
 
 #include "esp/assets/ResourceManager.h"
+#include "esp/gfx/RenderTargetPool.h"
 #include "esp/physics/RigidObject.h"
 #include "esp/sensor/CameraSensor.h"
 #include "esp/sim/Simulator.h"
@@ -115,6 +117,7 @@ struct SimTest : Cr::TestSuite::Tester {
   void basic();
   void reconfigure();
   void reset();
+  void renderTargetPool();
   void getSceneRGBAObservation();
   void getSceneWithLightingRGBAObservation();
   void getDefaultLightingRGBAObservation();
@@ -123,6 +126,7 @@ struct SimTest : Cr::TestSuite::Tester {
   void updateObjectLightSetupRGBAObservation();
   void multipleLightingSetupsRGBAObservation();
   void recomputeNavmeshWithStaticObjects();
+  void updateNavmeshWithStaticObjects();
   void loadingObjectTemplates();
   void buildingPrimAssetObjectTemplates();
   void addSensorToObject();
@@ -151,7 +155,8 @@ SimTest::SimTest() {
   // clang-format off
   addTests({&SimTest::basic,
             &SimTest::reconfigure,
-            &SimTest::reset});
+            &SimTest::reset,
+            &SimTest::renderTargetPool});
             //test instances test both mechanisms for constructing simulator
   addInstancedTests({
             &SimTest::getSceneRGBAObservation,
@@ -162,6 +167,7 @@ SimTest::SimTest() {
             &SimTest::updateObjectLightSetupRGBAObservation,
             &SimTest::multipleLightingSetupsRGBAObservation,
             &SimTest::recomputeNavmeshWithStaticObjects,
+            &SimTest::updateNavmeshWithStaticObjects,
             &SimTest::loadingObjectTemplates,
             &SimTest::buildingPrimAssetObjectTemplates,
             &SimTest::addSensorToObject}, Cr::Containers::arraySize(SimulatorBuilder) );
@@ -248,6 +254,49 @@ void SimTest::reset() {
   testReset(simulator_mm);
 }
 
+void SimTest::renderTargetPool() {
+  auto simulator = getSimulator(*this, vangogh);
+  esp::gfx::RenderTargetPool::ptr pool =
+      simulator->getRenderer()->renderTargetPool();
+
+  auto spec = CameraSensorSpec::create();
+  spec->uuid = "pooled";
+  spec->resolution = {64, 64};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {spec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  auto* sensor = dynamic_cast<CameraSensor*>(
+      agent->getSensorSuite().get("pooled").get());
+  CORRADE_VERIFY(sensor);
+  const esp::gfx::RenderTarget* target = &sensor->renderTarget();
+  const size_t numAllocated = pool->numAllocated();
+
+  // rebinding at the same size keeps the target
+  simulator->getRenderer()->bindRenderTarget(*sensor);
+  CORRADE_COMPARE(&sensor->renderTarget(), target);
+  CORRADE_COMPARE(pool->numAllocated(), numAllocated);
+
+  // a resolution change swaps the target when drawing and pools the old one
+  sensor->setHeight(32);
+  sensor->setWidth(48);
+  Observation observation;
+  CORRADE_VERIFY(sensor->getObservation(*simulator, observation));
+  CORRADE_COMPARE(sensor->renderTarget().framebufferSize(),
+                  (Mn::Vector2i{48, 32}));
+  CORRADE_COMPARE(observation.buffer->shape,
+                  (std::vector<size_t>{32, 48, 4}));
+  CORRADE_COMPARE(pool->numAllocated(), numAllocated + 1);
+  CORRADE_COMPARE(pool->numFree(), 1);
+
+  // changing it back allocates nothing
+  sensor->setHeight(64);
+  sensor->setWidth(64);
+  CORRADE_VERIFY(sensor->getObservation(*simulator, observation));
+  CORRADE_COMPARE(&sensor->renderTarget(), target);
+  CORRADE_COMPARE(pool->numAllocated(), numAllocated + 1);
+  CORRADE_COMPARE(pool->numFree(), 1);
+}
+
 void SimTest::checkPinholeCameraRGBAObservation(
     Simulator& simulator,
     const std::string& groundTruthImageFile,
@@ -511,6 +560,80 @@ void SimTest::recomputeNavmeshWithStaticObjects() {
       simulator->getPathFinder()->isNavigable(randomNavPoint + offset, 0.2));
 }
 
+void SimTest::updateNavmeshWithStaticObjects() {
+  Corrade::Utility::Debug()
+      << "Starting Test : updateNavmeshWithStaticObjects ";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, skokloster, esp::NO_LIGHT_KEY);
+  auto objectAttribsMgr = simulator->getObjectAttributesManager();
+  auto pathfinder = simulator->getPathFinder();
+
+  // the navmesh must be tiled to be updated incrementally
+  esp::nav::NavMeshSettings navMeshSettings;
+  navMeshSettings.setDefaults();
+  simulator->recomputeNavMesh(*pathfinder, navMeshSettings, true);
+  CORRADE_VERIFY(!pathfinder->supportsTileUpdates());
+  CORRADE_VERIFY(!simulator->updateNavMeshAsync(*pathfinder));
+
+  navMeshSettings.tileSize = 64;
+  CORRADE_VERIFY(
+      simulator->recomputeNavMesh(*pathfinder, navMeshSettings, true));
+  CORRADE_VERIFY(pathfinder->supportsTileUpdates());
+
+  esp::vec3f randomNavPoint = pathfinder->getRandomNavigablePoint();
+  while (pathfinder->distanceToClosestObstacle(randomNavPoint) < 1.0 ||
+         randomNavPoint[1] > 1.0) {
+    randomNavPoint = pathfinder->getRandomNavigablePoint();
+  }
+  const float navigableArea = pathfinder->getNavigableArea();
+
+  // adding a static object only takes effect once the update is applied
+  auto objs = objectAttribsMgr->getObjectHandlesBySubstring("nested_box");
+  int objectID = simulator->addObjectByHandle(objs[0]);
+  simulator->setTranslation(Magnum::Vector3{randomNavPoint}, objectID);
+  simulator->setObjectMotionType(esp::physics::MotionType::STATIC, objectID);
+  CORRADE_VERIFY(simulator->updateNavMeshAsync(*pathfinder));
+  CORRADE_VERIFY(pathfinder->isNavigable(randomNavPoint, 0.1));
+  CORRADE_VERIFY(simulator->applyNavMeshUpdates(*pathfinder, true));
+  CORRADE_VERIFY(!pathfinder->hasPendingTileUpdates());
+  CORRADE_VERIFY(!pathfinder->isNavigable(randomNavPoint, 0.1));
+
+  // nothing changed, so there is nothing to update
+  CORRADE_VERIFY(simulator->updateNavMeshAsync(*pathfinder));
+  CORRADE_VERIFY(!pathfinder->hasPendingTileUpdates());
+
+  // moving it away and back before the update is applied keeps it in place
+  esp::vec3f otherNavPoint = pathfinder->getRandomNavigablePoint();
+  while (pathfinder->distanceToClosestObstacle(otherNavPoint) < 1.0 ||
+         otherNavPoint[1] > 1.0 ||
+         (otherNavPoint - randomNavPoint).norm() < 2.0) {
+    otherNavPoint = pathfinder->getRandomNavigablePoint();
+  }
+  // STATIC objects can't be moved, so switch to KINEMATIC in between
+  auto moveStaticObject = [&](const esp::vec3f& position) {
+    simulator->setObjectMotionType(esp::physics::MotionType::KINEMATIC,
+                                   objectID);
+    simulator->setTranslation(Magnum::Vector3{position}, objectID);
+    simulator->setObjectMotionType(esp::physics::MotionType::STATIC, objectID);
+  };
+  moveStaticObject(otherNavPoint);
+  CORRADE_VERIFY(simulator->updateNavMeshAsync(*pathfinder));
+  moveStaticObject(randomNavPoint);
+  CORRADE_VERIFY(simulator->updateNavMeshAsync(*pathfinder));
+  CORRADE_VERIFY(simulator->applyNavMeshUpdates(*pathfinder, true));
+  CORRADE_VERIFY(!pathfinder->isNavigable(randomNavPoint, 0.1));
+  CORRADE_VERIFY(pathfinder->isNavigable(otherNavPoint, 0.1));
+
+  // removing it again restores the original navmesh
+  simulator->removeObject(objectID);
+  CORRADE_VERIFY(simulator->updateNavMeshAsync(*pathfinder));
+  CORRADE_VERIFY(simulator->applyNavMeshUpdates(*pathfinder, true));
+  CORRADE_VERIFY(pathfinder->isNavigable(randomNavPoint, 0.1));
+  CORRADE_COMPARE_WITH(pathfinder->getNavigableArea(), navigableArea,
+                       Cr::TestSuite::Compare::around(0.01f));
+}
+
 void SimTest::loadingObjectTemplates() {
   Corrade::Utility::Debug() << "Starting Test : loadingObjectTemplates ";
   auto&& data = SimulatorBuilder[testCaseInstanceId()];
@@ -0,0 +1,535 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ReplayRenderer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/PixelFormat.h>
+
+#include "esp/assets/ResourceManager.h"
+#include "esp/core/Parallel.h"
+#include "esp/gfx/DepthUnprojection.h"
+#include "esp/gfx/RenderCamera.h"
+#include "esp/gfx/RenderTarget.h"
+#include "esp/gfx/Renderer.h"
+#include "esp/gfx/WindowlessContext.h"
+#include "esp/gfx/replay/Player.h"
+#include "esp/io/json.h"
+#include "esp/metadata/MetadataMediator.h"
+#include "esp/scene/SceneManager.h"
+#include "esp/sim/SimulatorConfiguration.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+constexpr char SharedMemoryFrameRing::Magic[8];
+constexpr std::uint32_t SharedMemoryFrameRing::Version;
+
+namespace {
+
+Mn::PixelFormat pixelFormat(CameraType type) {
+  switch (type) {
+    case CameraType::Color:
+      return Mn::PixelFormat::RGBA8Unorm;
+    case CameraType::Depth:
+      return Mn::PixelFormat::R32F;
+    case CameraType::Semantic:
+      return Mn::PixelFormat::R32UI;
+  }
+  CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+}
+
+bool parseCameraType(const std::string& name, CameraType& type) {
+  if (name == "color") {
+    type = CameraType::Color;
+  } else if (name == "depth") {
+    type = CameraType::Depth;
+  } else if (name == "semantic") {
+    type = CameraType::Semantic;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// NumPy .npy: the header, then the C-order data
+bool writeNpy(const std::string& filepath, const RenderedFrame& frame) {
+  const std::string header = npyHeader(frame.camera.type, frame.image.size());
+  std::ofstream file(filepath, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  file.write(header.data(), header.size());
+  file.write(static_cast<const char*>(frame.image.data().data()),
+             frame.image.data().size());
+  return bool(file);
+}
+
+// Name of the directory the frames of a replay go to
+std::string replayName(const std::string& filepath) {
+  return Cr::Utility::Directory::splitExtension(
+             Cr::Utility::Directory::filename(filepath))
+      .first;
+}
+
+// Everything a worker needs to render replays on its own thread. The GL
+// context is created first and destroyed last, after the GL objects.
+struct Worker {
+  Worker(const ReplayRendererConfiguration& cfg,
+         metadata::MetadataMediator::ptr metadataMediator,
+         bool requiresTextures)
+      : context{WindowlessContext::create_unique(cfg.gpuDevice)},
+        renderer{Renderer::create(requiresTextures
+                                      ? Renderer::Flags{}
+                                      : Renderer::Flags{
+                                            Renderer::Flag::NoTextures})},
+        metadataMediator{std::move(metadataMediator)},
+        resourceManager{this->metadataMediator},
+        sceneID{sceneManager.initSceneGraph()},
+        player{[this](const assets::AssetInfo& assetInfo,
+                      const assets::RenderAssetInstanceCreationInfo& creation) {
+          std::vector<int> tempIDs{sceneID, ID_UNDEFINED};
+          return resourceManager.loadAndCreateRenderAssetInstance(
+              assetInfo, creation, &sceneManager, tempIDs);
+        }} {
+    resourceManager.setRequiresTextures(requiresTextures);
+
+    // The camera nodes live next to the replayed instances, which the Player
+    // creates and deletes under the root
+    auto& rootNode = sceneManager.getSceneGraph(sceneID).getRootNode();
+    for (const CameraSpec& spec : cfg.cameras) {
+      Camera camera;
+      camera.node = &rootNode.createChild();
+      camera.renderCamera = new RenderCamera{*camera.node};
+      camera.renderCamera->setProjectionMatrix(
+          spec.resolution.x(), spec.resolution.y(), spec.near, spec.far,
+          spec.hfov);
+
+      RenderTarget::Flags flags;
+      switch (spec.type) {
+        case CameraType::Color:
+          flags = RenderTarget::Flag::RgbaBuffer;
+          break;
+        case CameraType::Depth:
+          flags = RenderTarget::Flag::DepthTexture;
+          break;
+        case CameraType::Semantic:
+          flags = RenderTarget::Flag::ObjectIdBuffer;
+          break;
+      }
+      camera.renderTarget = std::make_unique<RenderTarget>(
+          spec.resolution,
+          calculateDepthUnprojection(camera.renderCamera->projectionMatrix()),
+          nullptr, flags);
+      camera.pixels = Cr::Containers::Array<char>(frameSize(spec));
+      cameras.push_back(std::move(camera));
+    }
+  }
+
+  struct Camera {
+    scene::SceneNode* node = nullptr;
+    // owned by node
+    RenderCamera* renderCamera = nullptr;
+    std::unique_ptr<RenderTarget> renderTarget;
+    Cr::Containers::Array<char> pixels;
+    // whether the user transform the camera follows was seen in this replay
+    bool hasPose = false;
+  };
+
+  WindowlessContext::uptr context;
+  Renderer::ptr renderer;
+  metadata::MetadataMediator::ptr metadataMediator;
+  // declared in this order to avoid deallocation errors: the Player deletes
+  // its nodes before the scene graph holding them is gone
+  assets::ResourceManager resourceManager;
+  scene::SceneManager sceneManager;
+  int sceneID;
+  Player player;
+  std::vector<Camera> cameras;
+};
+
+// Places the camera for the current keyframe. Cameras following a user
+// transform missing from the keyframe keep their last pose.
+bool updateCameraPose(const CameraSpec& spec,
+                      const Player& player,
+                      Worker::Camera& camera) {
+  Mn::Vector3 translation;
+  Mn::Quaternion rotation;
+  if (spec.userTransform.empty()) {
+    camera.hasPose = true;
+  } else if (player.getUserTransform(spec.userTransform, &translation,
+                                     &rotation)) {
+    camera.hasPose = true;
+  } else {
+    return camera.hasPose;
+  }
+  camera.node->setTranslation(translation +
+                              rotation.transformVector(spec.position));
+  camera.node->setRotation(rotation * spec.orientation);
+  return true;
+}
+
+bool renderReplay(const ReplayRendererConfiguration& cfg,
+                  Worker& worker,
+                  FrameSink& sink,
+                  int replayIndex,
+                  const std::string& filepath,
+                  const std::string& replayName) {
+  Player& player = worker.player;
+  player.readKeyframesFromFile(filepath);
+  if (!player.getNumKeyframes()) {
+    LOG(ERROR) << "ReplayRenderer: no keyframes read from " << filepath;
+    return false;
+  }
+  for (auto& camera : worker.cameras) {
+    camera.hasPose = false;
+  }
+
+  auto& sceneGraph = worker.sceneManager.getSceneGraph(worker.sceneID);
+  for (int keyframeIndex = 0; keyframeIndex < player.getNumKeyframes();
+       keyframeIndex += cfg.keyframeStride) {
+    player.setKeyframeIndex(keyframeIndex);
+
+    for (int cameraIndex = 0; cameraIndex < int(cfg.cameras.size());
+         ++cameraIndex) {
+      const CameraSpec& spec = cfg.cameras[cameraIndex];
+      Worker::Camera& camera = worker.cameras[cameraIndex];
+      if (!updateCameraPose(spec, player, camera)) {
+        continue;
+      }
+
+      RenderTarget& target = *camera.renderTarget;
+      target.renderEnter();
+      worker.renderer->draw(*camera.renderCamera, sceneGraph);
+      target.renderExit();
+
+      const Mn::MutableImageView2D view{
+          pixelFormat(spec.type), spec.resolution,
+          Cr::Containers::arrayView(camera.pixels)};
+      switch (spec.type) {
+        case CameraType::Color:
+          target.readFrameRgba(view);
+          break;
+        case CameraType::Depth:
+          target.readFrameDepth(view);
+          break;
+        case CameraType::Semantic:
+          target.readFrameObjectId(view);
+          break;
+      }
+
+      sink.write(RenderedFrame{replayIndex, replayName, keyframeIndex,
+                               cameraIndex, spec, view});
+    }
+  }
+
+  player.close();
+  return true;
+}
+
+}  // namespace
+
+std::string npyHeader(const CameraType type, const Mn::Vector2i& size) {
+  std::ostringstream dict;
+  dict << "{'descr': ";
+  switch (type) {
+    case CameraType::Color:
+      dict << "'|u1', 'fortran_order': False, 'shape': (" << size.y() << ", "
+           << size.x() << ", 4), }";
+      break;
+    case CameraType::Depth:
+      dict << "'<f4', 'fortran_order': False, 'shape': (" << size.y() << ", "
+           << size.x() << "), }";
+      break;
+    case CameraType::Semantic:
+      dict << "'<u4', 'fortran_order': False, 'shape': (" << size.y() << ", "
+           << size.x() << "), }";
+      break;
+  }
+  // magic, version and header length, then the dict padded with spaces and
+  // terminated by a newline
+  constexpr std::size_t preambleSize = 10;
+  std::string dictString = dict.str();
+  dictString.append(63 - (preambleSize + dictString.size()) % 64, ' ');
+  dictString += '\n';
+
+  const std::uint16_t dictSize = std::uint16_t(dictString.size());
+  const char preamble[preambleSize] = {
+      '\x93', 'N', 'U', 'M', 'P', 'Y', 1, 0, char(dictSize & 0xff),
+      char(dictSize >> 8)};
+  return std::string(preamble, preambleSize) + dictString;
+}
+
+std::size_t frameSize(const CameraSpec& camera) {
+  return std::size_t(camera.resolution.product()) *
+         Mn::pixelSize(pixelFormat(camera.type));
+}
+
+bool loadCameraSpecs(const std::string& filepath,
+                     std::vector<CameraSpec>& cameras) {
+  if (!Cr::Utility::Directory::exists(filepath)) {
+    LOG(ERROR) << "loadCameraSpecs: file " << filepath << " not found.";
+    return false;
+  }
+  try {
+    const io::JsonDocument d = io::parseJsonFile(filepath);
+    if (!d.IsObject() || !d.HasMember("cameras") || !d["cameras"].IsArray()) {
+      LOG(ERROR) << "loadCameraSpecs: " << filepath
+                 << " has no \"cameras\" array.";
+      return false;
+    }
+
+    std::vector<CameraSpec> specs;
+    for (const auto& obj : d["cameras"].GetArray()) {
+      CameraSpec spec;
+      if (!obj.IsObject() || !io::readMember(obj, "uuid", spec.uuid) ||
+          spec.uuid.empty()) {
+        LOG(ERROR) << "loadCameraSpecs: camera " << specs.size() << " in "
+                   << filepath << " has no uuid.";
+        return false;
+      }
+      std::string type = "color";
+      io::readMember(obj, "type", type);
+      if (!parseCameraType(type, spec.type)) {
+        LOG(ERROR) << "loadCameraSpecs: camera " << spec.uuid
+                   << " has unknown type " << type << ".";
+        return false;
+      }
+      io::readMember(obj, "width", spec.resolution.x());
+      io::readMember(obj, "height", spec.resolution.y());
+      float hfov = float(spec.hfov);
+      io::readMember(obj, "hfov", hfov);
+      spec.hfov = Mn::Deg{hfov};
+      io::readMember(obj, "near", spec.near);
+      io::readMember(obj, "far", spec.far);
+      io::readMember(obj, "user_transform", spec.userTransform);
+      io::readMember(obj, "position", spec.position);
+      io::readMember(obj, "orientation", spec.orientation);
+      spec.orientation = spec.orientation.normalized();
+      if (spec.resolution.min() <= 0) {
+        LOG(ERROR) << "loadCameraSpecs: camera " << spec.uuid
+                   << " has an empty resolution.";
+        return false;
+      }
+      for (const CameraSpec& other : specs) {
+        if (other.uuid == spec.uuid) {
+          LOG(ERROR) << "loadCameraSpecs: duplicate camera " << spec.uuid
+                     << ".";
+          return false;
+        }
+      }
+      specs.push_back(std::move(spec));
+    }
+    cameras = std::move(specs);
+  } catch (...) {
+    LOG(ERROR) << "loadCameraSpecs: failed to parse " << filepath << ".";
+    return false;
+  }
+  return true;
+}
+
+DiskFrameSink::DiskFrameSink(const std::string& outputDir)
+    : outputDir_{outputDir} {}
+
+bool DiskFrameSink::start(const std::vector<std::string>& replayNames,
+                          const std::vector<CameraSpec>& cameras) {
+  namespace Directory = Cr::Utility::Directory;
+  for (const std::string& replayName : replayNames) {
+    for (const CameraSpec& camera : cameras) {
+      const std::string dir = Directory::join(
+          Directory::join(outputDir_, replayName), camera.uuid);
+      if (!Directory::mkpath(dir)) {
+        LOG(ERROR) << "DiskFrameSink: can't create " << dir;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool DiskFrameSink::write(const RenderedFrame& frame) {
+  namespace Directory = Cr::Utility::Directory;
+  const std::string dir = Directory::join(
+      Directory::join(outputDir_, frame.replayName), frame.camera.uuid);
+  std::ostringstream filename;
+  filename.fill('0');
+  filename.width(6);
+  filename << frame.keyframeIndex;
+  const std::string filepath = Directory::join(dir, filename.str() + ".npy");
+  if (!writeNpy(filepath, frame)) {
+    LOG(ERROR) << "DiskFrameSink: can't write " << filepath;
+    return false;
+  }
+  return true;
+}
+
+SharedMemoryFrameRing::SharedMemoryFrameRing(const std::string& name,
+                                             std::uint32_t numSlots,
+                                             std::size_t slotSize) {
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+                "the ring needs lock-free atomics to be shared");
+  ASSERT(numSlots > 0);
+  // keep every slot header aligned to a cache line
+  const std::size_t headerSize = (sizeof(Header) + 63) / 64 * 64;
+  const std::size_t slotStride =
+      (sizeof(SlotHeader) + slotSize + 63) / 64 * 64;
+  const std::size_t size = headerSize + slotStride * numSlots;
+
+  const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+  if (fd < 0) {
+    LOG(ERROR) << "SharedMemoryFrameRing: can't open " << name << ": "
+               << std::strerror(errno);
+    return;
+  }
+  void* memory = MAP_FAILED;
+  if (ftruncate(fd, size) == 0) {
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (memory == MAP_FAILED) {
+    LOG(ERROR) << "SharedMemoryFrameRing: can't map " << size
+               << " bytes of " << name << ": " << std::strerror(errno);
+    return;
+  }
+
+  char* bytes = static_cast<char*>(memory);
+  for (std::uint32_t i = 0; i < numSlots; ++i) {
+    new (bytes + headerSize + slotStride * i) SlotHeader{};
+  }
+  // the magic goes last, consumers check it before anything else
+  header_ = new (memory) Header{};
+  header_->version = Version;
+  header_->numSlots = numSlots;
+  header_->slotSize = slotSize;
+  header_->slotStride = slotStride;
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(header_->magic, Magic, sizeof(Magic));
+  mappedSize_ = size;
+}
+
+SharedMemoryFrameRing::~SharedMemoryFrameRing() {
+  if (header_) {
+    munmap(header_, mappedSize_);
+  }
+}
+
+bool SharedMemoryFrameRing::write(const RenderedFrame& frame) {
+  if (!header_) {
+    return false;
+  }
+  const std::size_t byteSize = frame.image.data().size();
+  if (byteSize > header_->slotSize) {
+    LOG(ERROR) << "SharedMemoryFrameRing: frame of " << byteSize
+               << " bytes doesn't fit in slots of " << header_->slotSize;
+    return false;
+  }
+
+  const std::uint64_t index = header_->writeIndex++;
+  while (index - header_->readIndex.load(std::memory_order_acquire) >=
+         header_->numSlots) {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+
+  const std::size_t headerSize = (sizeof(Header) + 63) / 64 * 64;
+  char* slot = reinterpret_cast<char*>(header_) + headerSize +
+               header_->slotStride * (index % header_->numSlots);
+  auto* slotHeader = reinterpret_cast<SlotHeader*>(slot);
+  slotHeader->replayIndex = frame.replayIndex;
+  slotHeader->keyframeIndex = frame.keyframeIndex;
+  slotHeader->cameraIndex = frame.cameraIndex;
+  slotHeader->type = std::int32_t(frame.camera.type);
+  slotHeader->width = frame.image.size().x();
+  slotHeader->height = frame.image.size().y();
+  slotHeader->byteSize = byteSize;
+  std::memcpy(slot + sizeof(SlotHeader), frame.image.data().data(), byteSize);
+  slotHeader->sequence.store(index + 1, std::memory_order_release);
+  return true;
+}
+
+void SharedMemoryFrameRing::finish() {
+  if (header_) {
+    header_->isFinished.store(1, std::memory_order_release);
+  }
+}
+
+ReplayRenderer::ReplayRenderer(const ReplayRendererConfiguration& cfg,
+                               FrameSink& sink)
+    : cfg_{cfg}, sink_{sink} {
+  ASSERT(cfg_.keyframeStride > 0);
+}
+
+unsigned int ReplayRenderer::numWorkers(std::size_t numReplays) const {
+  return core::numWorkerThreads(numReplays, cfg_.numWorkers);
+}
+
+int ReplayRenderer::render(const std::vector<std::string>& replayFilepaths) {
+  const unsigned int numWorkers = this->numWorkers(replayFilepaths.size());
+  bool requiresTextures = false;
+  for (const CameraSpec& camera : cfg_.cameras) {
+    requiresTextures |= camera.type == CameraType::Color;
+  }
+
+  std::vector<std::string> replayNames;
+  replayNames.reserve(replayFilepaths.size());
+  for (const std::string& filepath : replayFilepaths) {
+    replayNames.push_back(replayName(filepath));
+  }
+  if (!sink_.start(replayNames, cfg_.cameras)) {
+    sink_.finish();
+    return int(replayFilepaths.size());
+  }
+
+  sim::SimulatorConfiguration simConfig;
+  simConfig.sceneDatasetConfigFile = cfg_.sceneDatasetConfigFile;
+
+  // Each worker renders replays until there are none left. GL contexts and
+  // the resources loaded in them can't be shared between threads, so a
+  // worker is created on, and destroyed by, the thread it runs on.
+  std::atomic<std::size_t> nextReplay{0};
+  std::atomic<int> numFailed{0};
+  core::parallelFor(
+      numWorkers, numWorkers, [&](unsigned int workerIndex, std::size_t) {
+        std::size_t replayIndex = nextReplay++;
+        if (replayIndex >= replayFilepaths.size()) {
+          return;
+        }
+        Worker worker{cfg_, metadata::MetadataMediator::create(simConfig),
+                      requiresTextures};
+        for (; replayIndex < replayFilepaths.size();
+             replayIndex = nextReplay++) {
+          LOG(INFO) << "ReplayRenderer: worker " << workerIndex
+                    << " rendering " << replayFilepaths[replayIndex];
+          if (!renderReplay(cfg_, worker, sink_, int(replayIndex),
+                            replayFilepaths[replayIndex],
+                            replayNames[replayIndex])) {
+            ++numFailed;
+          }
+        }
+      });
+
+  sink_.finish();
+  return numFailed;
+}
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,291 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_UTILS_REPLAYRENDERER_REPLAYRENDERER_H_
+#define ESP_UTILS_REPLAYRENDERER_REPLAYRENDERER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Corrade/Utility/Macros.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Angle.h>
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/Vector2.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+/**
+ * @brief What a @ref CameraSpec renders
+ */
+enum class CameraType {
+  //! RGBA8 color
+  Color,
+  //! 32-bit float depth, in meters
+  Depth,
+  //! 32-bit unsigned semantic id of every pixel
+  Semantic,
+};
+
+/**
+ * @brief A camera rendered at every keyframe of every replay
+ */
+struct CameraSpec {
+  //! Unique name of the camera, used in the output paths
+  std::string uuid;
+  CameraType type = CameraType::Color;
+  //! width and height in pixels
+  Magnum::Vector2i resolution{640, 480};
+  Magnum::Deg hfov{90.0f};
+  float near = 0.01f;
+  float far = 1000.0f;
+  /**
+   * @brief Name of the replay user transform the camera is attached to
+   *
+   * See @ref Recorder::addUserTransformToKeyframe. If empty, @ref position
+   * and @ref orientation are in world space.
+   */
+  std::string userTransform;
+  //! Position relative to @ref userTransform
+  Magnum::Vector3 position;
+  //! Orientation relative to @ref userTransform
+  Magnum::Quaternion orientation;
+};
+
+/** @brief Size of a frame rendered by @p camera, in bytes */
+std::size_t frameSize(const CameraSpec& camera);
+
+/**
+ * @brief Reads camera specs from a JSON file
+ * @return false and logs an error if the file is invalid
+ *
+ * The file holds an array of cameras:
+ *
+ * @code{.json}
+ * {"cameras": [{"uuid": "rgb", "type": "color", "width": 640, "height": 480,
+ *               "hfov": 90, "near": 0.01, "far": 1000,
+ *               "user_transform": "agent", "position": [0, 1.5, 0],
+ *               "orientation": [1, 0, 0, 0]}]}
+ * @endcode
+ *
+ * All members but uuid are optional, orientations are wxyz.
+ */
+bool loadCameraSpecs(const std::string& filepath,
+                     std::vector<CameraSpec>& cameras);
+
+/**
+ * @brief NumPy .npy version 1.0 header of a frame of @p size pixels rendered
+ * by a camera of @p type
+ *
+ * The magic, version, header length and a dict with the frame's dtype and
+ * shape, padded with spaces so that the pixels following it start at a
+ * multiple of 64 bytes.
+ */
+std::string npyHeader(CameraType type, const Magnum::Vector2i& size);
+
+/**
+ * @brief A frame rendered by @ref ReplayRenderer
+ */
+struct RenderedFrame {
+  //! index in the list passed to @ref ReplayRenderer::render
+  int replayIndex;
+  //! replay filename without extension
+  std::string replayName;
+  int keyframeIndex;
+  //! index in @ref ReplayRendererConfiguration::cameras
+  int cameraIndex;
+  const CameraSpec& camera;
+  //! Pixels, RGBA8Unorm, R32F or R32UI depending on the camera type
+  Magnum::ImageView2D image;
+};
+
+/**
+ * @brief Destination of the frames rendered by @ref ReplayRenderer
+ *
+ * @ref write() is called concurrently by all workers of the renderer.
+ */
+class FrameSink {
+ public:
+  virtual ~FrameSink() = default;
+
+  /**
+   * @brief Called once before any frame is written, on the thread calling
+   * @ref ReplayRenderer::render
+   * @param replayNames @ref RenderedFrame::replayName of every replay
+   * @param cameras     The cameras the frames are rendered by
+   * @return false if the sink can't take the frames, which cancels rendering
+   */
+  virtual bool start(CORRADE_UNUSED const std::vector<std::string>& replayNames,
+                     CORRADE_UNUSED const std::vector<CameraSpec>& cameras) {
+    return true;
+  }
+
+  /**
+   * @brief Consumes @p frame, whose pixels are only valid during the call
+   * @return false if the frame was dropped
+   */
+  virtual bool write(const RenderedFrame& frame) = 0;
+
+  /** @brief Called once all replays are rendered */
+  virtual void finish() {}
+
+  ESP_SMART_POINTERS(FrameSink)
+};
+
+/**
+ * @brief Writes frames to disk, one file per camera and keyframe
+ *
+ * Frames go to `<outputDir>/<replayName>/<camera uuid>/<keyframe>.npy` as
+ * NumPy arrays, with the shape, type and row order of the observations of
+ * the corresponding sensor in the Python API. All directories are created
+ * in @ref start(), so workers only write files.
+ */
+class DiskFrameSink : public FrameSink {
+ public:
+  explicit DiskFrameSink(const std::string& outputDir);
+
+  bool start(const std::vector<std::string>& replayNames,
+             const std::vector<CameraSpec>& cameras) override;
+  bool write(const RenderedFrame& frame) override;
+
+ private:
+  std::string outputDir_;
+
+  ESP_SMART_POINTERS(DiskFrameSink)
+};
+
+/**
+ * @brief Writes frames to a ring of slots in POSIX shared memory
+ *
+ * The shared memory object starts with a @ref Header followed by
+ * @ref Header::numSlots slots, each a @ref SlotHeader followed by
+ * @ref Header::slotSize bytes of pixels, @ref Header::slotStride bytes
+ * apart. Frame n is written to slot n modulo the number of slots. A consumer
+ * reads frame n once its slot's @ref SlotHeader::sequence is n + 1, then sets
+ * @ref Header::readIndex to n + 1 to free the slot. Writers wait for a free
+ * slot, so a consumer that falls behind slows rendering down instead of
+ * losing frames. @ref Header::isFinished is set once all replays are
+ * rendered.
+ *
+ * The shared memory object outlives the renderer; the consumer is expected
+ * to unlink it.
+ */
+class SharedMemoryFrameRing : public FrameSink {
+ public:
+  static constexpr char Magic[8] = {'H', 'S', 'F', 'R', 'I', 'N', 'G', '\0'};
+  static constexpr std::uint32_t Version = 1;
+
+  /** @brief Start of the shared memory object */
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t numSlots;
+    std::uint64_t slotSize;
+    std::uint64_t slotStride;
+    //! number of frames claimed by writers
+    std::atomic<std::uint64_t> writeIndex;
+    //! number of frames consumed, advanced by the consumer
+    std::atomic<std::uint64_t> readIndex;
+    std::atomic<std::uint32_t> isFinished;
+  };
+
+  /** @brief Start of every slot */
+  struct SlotHeader {
+    //! index of the frame in the slot plus one, once it is written
+    std::atomic<std::uint64_t> sequence;
+    std::int32_t replayIndex;
+    std::int32_t keyframeIndex;
+    std::int32_t cameraIndex;
+    //! a @ref CameraType
+    std::int32_t type;
+    std::int32_t width;
+    std::int32_t height;
+    std::uint64_t byteSize;
+  };
+
+  /**
+   * @brief Creates or replaces the shared memory object @p name
+   * @param name      Name as for `shm_open()`, starting with a slash
+   * @param numSlots  Number of frames the ring holds
+   * @param slotSize  Size of the largest frame, in bytes
+   *
+   * Check @ref isOpen() for success.
+   */
+  SharedMemoryFrameRing(const std::string& name,
+                        std::uint32_t numSlots,
+                        std::size_t slotSize);
+  ~SharedMemoryFrameRing() override;
+
+  /** @brief Whether the shared memory object was created and mapped */
+  bool isOpen() const { return header_ != nullptr; }
+
+  bool write(const RenderedFrame& frame) override;
+  void finish() override;
+
+ private:
+  Header* header_ = nullptr;
+  std::size_t mappedSize_ = 0;
+
+  ESP_SMART_POINTERS(SharedMemoryFrameRing)
+};
+
+/**
+ * @brief Settings of a @ref ReplayRenderer
+ */
+struct ReplayRendererConfiguration {
+  std::vector<CameraSpec> cameras;
+  //! scene dataset the replayed assets are loaded with
+  std::string sceneDatasetConfigFile = "default";
+  int gpuDevice = 0;
+  //! number of replays rendered in parallel, 0 for one per core
+  unsigned int numWorkers = 0;
+  //! render every keyframeStride-th keyframe only
+  int keyframeStride = 1;
+};
+
+/**
+ * @brief Renders replays written by @ref Recorder without a simulator
+ *
+ * Every worker owns a windowless GL context, a @ref ResourceManager, a bare
+ * scene graph and a @ref Player. Replays are handed out to workers one at a
+ * time. A worker reuses its scene graph and the assets it already loaded for
+ * every replay it renders, so each asset is loaded once per worker. The
+ * replayed scene is rendered by every camera at every keyframe.
+ */
+class ReplayRenderer {
+ public:
+  ReplayRenderer(const ReplayRendererConfiguration& cfg, FrameSink& sink);
+
+  /** @brief Number of workers @ref render() uses for @p numReplays */
+  unsigned int numWorkers(std::size_t numReplays) const;
+
+  /**
+   * @brief Renders every replay in @p replayFilepaths
+   * @return number of replays that couldn't be read, all of them if the sink
+   * failed to start
+   */
+  int render(const std::vector<std::string>& replayFilepaths);
+
+ private:
+  ReplayRendererConfiguration cfg_;
+  FrameSink& sink_;
+
+  ESP_SMART_POINTERS(ReplayRenderer)
+};
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_UTILS_REPLAYRENDERER_REPLAYRENDERER_H_
@@ -0,0 +1,111 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Directory.h>
+
+#include "ReplayRenderer.h"
+
+#include "esp/core/esp.h"
+
+namespace Cr = Corrade;
+
+using namespace esp::gfx::replay;
+
+// A replay file, or every file in a directory
+std::vector<std::string> listReplays(const std::string& path) {
+  namespace Directory = Cr::Utility::Directory;
+  if (!Directory::isDirectory(path)) {
+    return {path};
+  }
+  std::vector<std::string> filepaths;
+  for (const std::string& filename :
+       Directory::list(path, Directory::Flag::SkipDirectories |
+                                 Directory::Flag::SkipDotAndDotDot |
+                                 Directory::Flag::SortAscending)) {
+    filepaths.push_back(Directory::join(path, filename));
+  }
+  return filepaths;
+}
+
+int main(int argc, char** argv) {
+  Cr::Utility::Arguments args;
+  args.addArgument("replays")
+      .setHelp("replays", "replay file, or directory of replay files")
+      .addOption("cameras")
+      .setHelp("cameras", "JSON file of the camera specs to render")
+      .addOption("output-dir", "frames")
+      .setHelp("output-dir", "directory the frames are written to")
+      .addOption("shm-name")
+      .setHelp("shm-name",
+               "write frames to a shared memory ring of this name instead "
+               "of to disk, e.g. /replayframes")
+      .addOption("shm-slots", "64")
+      .setHelp("shm-slots", "number of frames the shared memory ring holds")
+      .addOption("dataset", "default")
+      .setHelp("dataset", "dataset configuration file to load assets with")
+      .addOption("workers", "0")
+      .setHelp("workers",
+               "number of replays rendered in parallel, 0 for one per core")
+      .addOption("gpu-device", "0")
+      .setHelp("gpu-device", "GPU device the workers render on")
+      .addOption("keyframe-stride", "1")
+      .setHelp("keyframe-stride", "render every n-th keyframe only")
+      .setGlobalHelp(
+          "Renders gfx-replay files recorded by habitat-sim, without a "
+          "simulator, with the cameras given in a JSON file")
+      .parse(argc, argv);
+
+  ReplayRendererConfiguration cfg;
+  if (!loadCameraSpecs(args.value("cameras"), cfg.cameras)) {
+    return 1;
+  }
+  if (cfg.cameras.empty()) {
+    LOG(ERROR) << "No cameras in " << args.value("cameras");
+    return 1;
+  }
+  cfg.sceneDatasetConfigFile = args.value("dataset");
+  cfg.numWorkers = args.value<unsigned int>("workers");
+  cfg.gpuDevice = args.value<int>("gpu-device");
+  cfg.keyframeStride = std::max(1, args.value<int>("keyframe-stride"));
+
+  const std::vector<std::string> replays = listReplays(args.value("replays"));
+  if (replays.empty()) {
+    LOG(ERROR) << "No replays in " << args.value("replays");
+    return 1;
+  }
+
+  FrameSink::uptr sink;
+  if (!args.value("shm-name").empty()) {
+    std::size_t slotSize = 0;
+    for (const CameraSpec& camera : cfg.cameras) {
+      slotSize = std::max(slotSize, frameSize(camera));
+    }
+    auto ring = SharedMemoryFrameRing::create_unique(
+        args.value("shm-name"),
+        std::max(1u, args.value<unsigned int>("shm-slots")), slotSize);
+    if (!ring->isOpen()) {
+      return 1;
+    }
+    sink = std::move(ring);
+  } else {
+    sink = DiskFrameSink::create_unique(args.value("output-dir"));
+  }
+
+  ReplayRenderer renderer{cfg, *sink};
+  LOG(INFO) << "Rendering " << replays.size() << " replays with "
+            << cfg.cameras.size() << " cameras on "
+            << renderer.numWorkers(replays.size()) << " workers";
+  const int numFailed = renderer.render(replays);
+  if (numFailed) {
+    LOG(ERROR) << numFailed << " of " << replays.size()
+               << " replays couldn't be read";
+    return 2;
+  }
+  return 0;
+}
@@ -180,3 +180,70 @@ def test_greedy_follower(test_navmesh, move_filter_fn, action_noise, pbar):
 
     if not test_all:
         assert test_spl / NUM_TESTS >= ACCEPTABLE_SPLS[(move_filter_fn, action_noise)]
+
+
+@pytest.mark.parametrize("test_navmesh", test_navmeshes)
+def test_greedy_follower_batched(test_navmesh):
+    if not osp.exists(test_navmesh):
+        pytest.skip(f"{test_navmesh} not found")
+
+    pathfinder = habitat_sim.PathFinder()
+    pathfinder.load_nav_mesh(test_navmesh)
+    assert pathfinder.is_loaded
+
+    scene_graph = habitat_sim.SceneGraph()
+    agent = habitat_sim.Agent(scene_graph.get_root_node().create_child())
+    agent.controls.move_filter_fn = pathfinder.try_step
+    agent.agent_config.action_space["turn_left"].actuation.amount = TURN_DEGREE
+    agent.agent_config.action_space["turn_right"].actuation.amount = TURN_DEGREE
+
+    follower = habitat_sim.GreedyGeodesicFollower(
+        pathfinder,
+        agent,
+        forward_key="move_forward",
+        left_key="turn_left",
+        right_key="turn_right",
+    )
+
+    points = pathfinder.sample_navigable_points(2 * NUM_TESTS, 0)
+    start_states, goals, gt_geos = [], [], []
+    for i in range(NUM_TESTS):
+        path = habitat_sim.ShortestPath()
+        path.requested_start = points[2 * i]
+        path.requested_end = points[2 * i + 1]
+        if not pathfinder.find_path(path) or path.geodesic_distance < 2.0:
+            continue
+
+        state = habitat_sim.AgentState()
+        state.position = points[2 * i]
+        start_states.append(state)
+        goals.append(points[2 * i + 1])
+        gt_geos.append(path.geodesic_distance)
+
+    action_lists = follower.find_paths(start_states, goals)
+    assert len(action_lists) == len(start_states)
+
+    # Replaying the actions must reach the goal as reliably as find_path
+    test_spl = 0.0
+    for state, goal_pos, gt_geo, action_list in zip(
+        start_states, goals, gt_geos, action_lists
+    ):
+        if action_list is None:
+            continue
+
+        agent.state = state
+        agent_distance = 0.0
+        last_xyz = state.position
+        for action in action_list[:-1]:
+            agent.act(action)
+            agent_distance += np.linalg.norm(last_xyz - agent.state.position)
+            last_xyz = agent.state.position
+
+        path = habitat_sim.ShortestPath()
+        path.requested_start = agent.state.position
+        path.requested_end = goal_pos
+        pathfinder.find_path(path)
+        if path.geodesic_distance <= follower.forward_spec.amount:
+            test_spl += gt_geo / max(gt_geo, agent_distance)
+
+    assert test_spl / len(start_states) >= ACCEPTABLE_SPLS[("try_step", False)]
@@ -146,3 +146,29 @@ def test_navmesh_area(test_scene):
             assert math.isclose(recomputedNavMeshArea1, 565.1781616210938)
         elif test_scene.endswith("van-gogh-room.glb"):
             assert math.isclose(recomputedNavMeshArea1, 9.17772102355957)
+
+
+@pytest.mark.parametrize("test_scene", test_scenes)
+def test_recompute_navmesh_tiled(test_scene):
+    if not osp.exists(test_scene):
+        pytest.skip(f"{test_scene} not found")
+
+    cfg_settings = examples.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = test_scene
+    hab_cfg = examples.settings.make_cfg(cfg_settings)
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        navmesh_settings = habitat_sim.NavMeshSettings()
+        navmesh_settings.set_defaults()
+        assert sim.recompute_navmesh(sim.pathfinder, navmesh_settings)
+        single_tile_area = sim.pathfinder.navigable_area
+
+        # a tiled build should cover (almost) the same surface
+        navmesh_settings.tile_size = 64
+        assert sim.recompute_navmesh(sim.pathfinder, navmesh_settings)
+        assert sim.pathfinder.is_loaded
+        tiled_area = sim.pathfinder.navigable_area
+        assert abs(tiled_area - single_tile_area) < 0.05 * single_tile_area
+
+        for _ in range(10):
+            pt = sim.pathfinder.get_random_navigable_point()
+            assert sim.pathfinder.is_navigable(pt)
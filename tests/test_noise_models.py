@@ -4,6 +4,7 @@
 # This source code is licensed under the MIT license found in the
 # LICENSE file in the root directory of this source tree.
 
+import time
 from os import path as osp
 
 import numpy as np
@@ -12,6 +13,7 @@ import pytest
 import habitat_sim
 from habitat_sim.sensors.noise_models import redwood_depth_noise_model
 from habitat_sim.sensors.noise_models.redwood_depth_noise_model import (
+    NativeRedwoodNoiseModelCPUImpl,
     RedwoodDepthNoiseModel,
     RedwoodNoiseModelCPUImpl,
 )
@@ -45,3 +47,69 @@ def test_compare_gpu_cpu_redwood_depth(noise_multiplier: float, tolerance: float
     cpu_depth = np.mean(np.stack(cpu_depths, 0), 0)
 
     assert np.abs(cuda_depth - cpu_depth).mean() <= tolerance
+
+
+def _load_redwood_model():
+    return np.load(
+        osp.join(
+            osp.dirname(redwood_depth_noise_model.__file__),
+            "data",
+            "redwood-depth-dist-model.npy",
+        )
+    )
+
+
+@pytest.mark.parametrize("noise_multiplier,tolerance", [(0.0, 1e-5), (1.0, 5e-2)])
+def test_compare_native_numba_redwood_depth(noise_multiplier: float, tolerance: float):
+    depth = np.linspace(0, 20, num=(256 * 256), dtype=np.float32).reshape(256, 256)
+
+    native_impl = NativeRedwoodNoiseModelCPUImpl(
+        _load_redwood_model(), noise_multiplier, 0
+    )
+    numba_impl = RedwoodNoiseModelCPUImpl(
+        _load_redwood_model(), noise_multiplier=noise_multiplier
+    )
+
+    NUM_SIMS = 20
+    native_depth = np.mean(
+        np.stack([native_impl.simulate_from_cpu(depth) for _ in range(NUM_SIMS)]), 0
+    )
+    numba_depth = np.mean(
+        np.stack([numba_impl.simulate(depth) for _ in range(NUM_SIMS)]), 0
+    )
+
+    assert np.abs(native_depth - numba_depth).mean() <= tolerance
+
+
+def test_native_redwood_depth_deterministic():
+    depth = np.linspace(0, 20, num=(256 * 256), dtype=np.float32).reshape(256, 256)
+    single = NativeRedwoodNoiseModelCPUImpl(_load_redwood_model(), 1.0, 5, 1)
+    multi = NativeRedwoodNoiseModelCPUImpl(_load_redwood_model(), 1.0, 5, 0)
+
+    first = single.simulate_from_cpu(depth)
+    assert np.array_equal(first, multi.simulate_from_cpu(depth))
+    assert not np.array_equal(first, single.simulate_from_cpu(depth))
+
+    single.seed(5)
+    assert np.array_equal(first, single.simulate_from_cpu(depth))
+
+
+def test_redwood_depth_cpu_benchmark():
+    depth = np.random.uniform(0, 12, size=(480, 640)).astype(np.float32)
+    native_impl = NativeRedwoodNoiseModelCPUImpl(_load_redwood_model(), 1.0, 0)
+    numba_impl = RedwoodNoiseModelCPUImpl(_load_redwood_model(), noise_multiplier=1.0)
+    # Compile the numba path before timing it
+    numba_impl.simulate(depth)
+
+    NUM_SIMS = 50
+    start = time.perf_counter()
+    for _ in range(NUM_SIMS):
+        numba_impl.simulate(depth)
+    numba_fps = NUM_SIMS / (time.perf_counter() - start)
+
+    start = time.perf_counter()
+    for _ in range(NUM_SIMS):
+        native_impl.simulate_from_cpu(depth)
+    native_fps = NUM_SIMS / (time.perf_counter() - start)
+
+    assert native_fps > numba_fps
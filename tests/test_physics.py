@@ -425,3 +425,80 @@ def test_raycast():
             sim.set_stage_is_collidable(False)
             raycast_results = sim.cast_ray(test_ray_1)
             assert not raycast_results.has_hits()
+
+
+@pytest.mark.skipif(
+    not osp.exists("data/scene_datasets/habitat-test-scenes/apartment_1.glb"),
+    reason="Requires the habitat-test-scenes",
+)
+def test_raycast_batch():
+    cfg_settings = examples.settings.default_sim_settings.copy()
+
+    # configure some settings in case defaults change
+    cfg_settings["scene"] = "data/scene_datasets/habitat-test-scenes/apartment_1.glb"
+
+    # enable the physics simulator
+    cfg_settings["enable_physics"] = True
+
+    # loading the physical scene
+    hab_cfg = examples.settings.make_cfg(cfg_settings)
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        obj_mgr = sim.get_object_template_manager()
+
+        if (
+            sim.get_physics_simulation_library()
+            != habitat_sim.physics.PhysicsSimulationLibrary.NONE
+        ):
+            cube_prim_handle = obj_mgr.get_template_handles("cube")[0]
+            cube_obj_id = sim.add_object_by_handle(cube_prim_handle)
+            sim.set_translation(mn.Vector3(3.0, 0, 0), cube_obj_id)
+
+            # a fan of rays around the cube, plus one of zero length
+            angles = np.linspace(-math.pi, math.pi, 500)
+            directions = np.stack(
+                [np.cos(angles), np.zeros_like(angles), np.sin(angles)], axis=1
+            )
+            directions[7] = 0
+            origin = np.array([0.0, 0.0, 0.0])
+
+            results = sim.cast_rays(origin, directions)
+            assert len(results) == len(directions)
+            assert results.hits.any()
+            assert not results.hits[7]
+            assert results.object_ids[7] == -1
+
+            # the closest hit of every ray is the first hit of cast_ray
+            for i, direction in enumerate(directions):
+                if i == 7:
+                    continue
+                ray = habitat_sim.geo.Ray(mn.Vector3(origin), mn.Vector3(direction))
+                single = sim.cast_ray(ray)
+                assert results.hits[i] == single.has_hits()
+                if not single.has_hits():
+                    continue
+                hit = single.hits[0]
+                assert results.object_ids[i] == hit.object_id
+                assert np.allclose(results.points[i], hit.point, atol=1e-4)
+                assert np.allclose(results.normals[i], hit.normal, atol=1e-4)
+                assert abs(results.ray_distances[i] - hit.ray_distance) < 1e-4
+
+            # reused results are overwritten; a ray has any hit exactly when it
+            # has a closest one, and no hit is closer than the closest
+            closest_hits = results.hits.copy()
+            closest_distances = results.ray_distances.copy()
+            any_results = sim.cast_rays(
+                np.tile(origin, (len(directions), 1)),
+                directions,
+                mode=habitat_sim.physics.RaycastMode.ANY,
+                results=results,
+            )
+            assert any_results is results
+            assert np.array_equal(any_results.hits, closest_hits)
+            assert np.all(
+                any_results.ray_distances[closest_hits]
+                >= closest_distances[closest_hits] - 1e-4
+            )
+
+            # nothing is hit beyond the maximum distance
+            short_results = sim.cast_rays(origin, directions, max_distance=0.01)
+            assert not short_results.hits.any()
@@ -4,6 +4,7 @@ from os import path as osp
 
 import magnum as mn
 import numpy as np
+import pytest
 
 import examples.settings
 import habitat_sim
@@ -246,3 +247,34 @@ def test_object_template_editing():
 
             obj_init_template = sim.get_object_initialization_template(object_id)
             assert obj_init_template.render_asset_handle.endswith("sphere.glb")
+
+
+@pytest.mark.gfxtest
+@pytest.mark.skipif(
+    not osp.exists("data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"),
+    reason="Requires the habitat-test-scenes",
+)
+def test_batch_simulator(make_cfg_settings):
+    make_cfg_settings["semantic_sensor"] = False
+    hab_cfg = examples.settings.make_cfg(make_cfg_settings)
+    sensor_specs = hab_cfg.agents[0].sensor_specifications
+
+    # identically seeded environments start in the same state
+    batch = habitat_sim.sim.BatchSimulator([hab_cfg.sim_cfg] * 3, sensor_specs)
+    assert batch.num_environments == 3
+
+    obs = {k: np.asarray(v) for k, v in batch.get_observations().items()}
+    height, width = make_cfg_settings["height"], make_cfg_settings["width"]
+    assert obs["color_sensor"].shape == (3, height, width, 4)
+    assert obs["depth_sensor"].shape == (3, height, width)
+    for env_obs in obs.values():
+        assert np.array_equal(env_obs[0], env_obs[1])
+        assert np.array_equal(env_obs[0], env_obs[2])
+
+    assert all(batch.act(["turnLeft", "", "turnLeft"]))
+    moved = {k: np.asarray(v) for k, v in batch.get_observations().items()}
+    # the earlier observations are still held and must not be overwritten
+    assert np.array_equal(obs["color_sensor"][0], obs["color_sensor"][1])
+    assert np.array_equal(moved["color_sensor"][0], moved["color_sensor"][2])
+    assert not np.array_equal(moved["color_sensor"][0], moved["color_sensor"][1])
+    assert np.array_equal(moved["color_sensor"][1], obs["color_sensor"][1])